@@ -0,0 +1,222 @@
+/******************************************************************************/
+/*!
+\file		BroadPhaseBench.cpp
+\author 	DigiPen
+\par    	email: digipen\@digipen.edu
+\date   	February 01, 20xx
+\brief
+Microbenchmark for SpatialHash. Enemy against enemy collision, the case
+the hero only loop can't grow into, for 100, 2k, 20k and 100k enemies at
+the density of the test level (one per 16 cells). Compares testing every
+pair with CollisionIntersection_RectRect against the spatial hash's
+candidate pairs, and checks that both find the same hits. Then the one
+hero against all of them: the narrow phase against every box, the swept
+boxes filtered against the hero's first, and the object collision stage's
+way, every enemy tracked in the hash from tick to tick. That one is timed
+in two parts, the upkeep (SweptCells and FindMoved over every enemy, then
+moving the ones that changed cell, with the enemies walking) and the
+query for the hero with its narrow phase. Build it together with
+SpatialHash.cpp, SimKernels.cpp, LevelArena.cpp and PlatformCollision.cpp,
+no Alpha Engine needed:
+
+	BroadPhaseBench [ticks]
+
+Prints one line per case: enemies, variant, ns per enemy per tick, hits.
+The hero variants are per enemy too, for one query a tick; the upkeep's
+last column is the enemies moved per tick.
+
+Copyright (C) 20xx DigiPen Institute of Technology.
+Reproduction or disclosure of this file or its contents without the
+prior written consent of DigiPen Institute of Technology is prohibited.
+ */
+/******************************************************************************/
+
+#include "../PlatformTypes.h"
+#include "../PlatformCollision.h"
+#include "../SimKernels.h"
+#include "../SpatialHash.h"
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+const float			DT			= 1.0f / 60.0f;
+const float			MARGIN		= 1.0f / 64.0f;
+
+/******************************************************************************/
+/*!
+	As the world sweeps them for the broad phase
+*/
+/******************************************************************************/
+static SimAABB SweptBox(const SimAABB& box, const SimVec2& vel)
+{
+	float dx = vel.x * DT, dy = vel.y * DT;
+	return { { box.min.x + (dx < 0.0f ? dx : 0.0f) - MARGIN, box.min.y + (dy < 0.0f ? dy : 0.0f) - MARGIN },
+			 { box.max.x + (dx > 0.0f ? dx : 0.0f) + MARGIN, box.max.y + (dy > 0.0f ? dy : 0.0f) + MARGIN } };
+}
+
+static double NsPerEnemy(std::chrono::steady_clock::time_point start, unsigned int runs, unsigned int n)
+{
+	double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+	return ns / ((double)runs * n);
+}
+
+/******************************************************************************/
+/*!
+
+*/
+/******************************************************************************/
+int main(int argc, char** argv)
+{
+	const unsigned int	SIZES[]		= { 100, 2000, 20000, 100000 };
+	const unsigned int	ticks		= argc > 1 ? (unsigned int)atoi(argv[1]) : 200;
+	const unsigned int	enemyMask	= SpatialTypeBit(TYPE_OBJECT_ENEMY1);
+
+	srand(7);
+	printf("enemies\tvariant\tns_per_enemy_tick\thits\n");
+	for (unsigned int n : SIZES)
+	{
+		float side = sqrtf((float)n * 16.0f);
+		std::vector<SimAABB> boxes(n);
+		std::vector<SimVec2> vels(n);
+		for (unsigned int i = 0; i < n; ++i) {
+			float x = (float)rand() / RAND_MAX * side, y = (float)rand() / RAND_MAX * side;
+			boxes[i] = { { x - 0.5f, y - 0.5f }, { x + 0.5f, y + 0.5f } };
+			vels[i] = { rand() % 2 ? MOVE_VELOCITY_ENEMY : -MOVE_VELOCITY_ENEMY, 0.0f };
+		}
+
+		// every pair, only for the sizes that finish
+		unsigned int bruteHits = 0;
+		bool brute = n <= 20000;
+		unsigned int runs = brute ? (unsigned int)(ticks * 2000ull * 2000ull / ((unsigned long long)n * n)) : 0;
+		runs = brute && runs < 1 ? 1 : runs;
+		if (brute) {
+			auto start = std::chrono::steady_clock::now();
+			for (unsigned int r = 0; r < runs; ++r)
+			{
+				bruteHits = 0;
+				for (unsigned int i = 0; i < n; ++i)
+					for (unsigned int j = i + 1; j < n; ++j)
+						bruteHits += CollisionIntersection_RectRect(boxes[i], vels[i], boxes[j], vels[j], DT);
+			}
+			printf("%u\tall_pairs\t%.3f\t%u\n", n, NsPerEnemy(start, runs, n), bruteHits);
+		}
+
+		SpatialHash hash;
+		LevelArena scratch;
+		std::vector<SpatialPair> pairs;
+		unsigned int hits = 0;
+		runs = ticks * 2000 / n;
+		runs = runs < 5 ? 5 : runs;
+		auto start = std::chrono::steady_clock::now();
+		for (unsigned int r = 0; r < runs; ++r)
+		{
+			hash.Clear();
+			for (unsigned int i = 0; i < n; ++i)
+				hash.Insert(TYPE_OBJECT_ENEMY1, i, SweptBox(boxes[i], vels[i]));
+			hash.Build(scratch);
+			hash.FindPairs(enemyMask, enemyMask, &pairs);
+
+			hits = 0;
+			for (const SpatialPair& pair : pairs)
+			{
+				// the same type on both sides comes out both ways
+				unsigned int i = hash.GetProxy(pair.a).row, j = hash.GetProxy(pair.b).row;
+				if (i < j)
+					hits += CollisionIntersection_RectRect(boxes[i], vels[i], boxes[j], vels[j], DT);
+			}
+		}
+		printf("%u\tspatial_hash\t%.3f\t%u%s\n", n, NsPerEnemy(start, runs, n), hits,
+			   brute && hits != bruteHits ? "\tMISMATCH" : "");
+
+		// the hero, overlapping the first enemy so there is a hit to find
+		SimAABB heroBox{ { boxes[0].min.x + 0.25f, boxes[0].min.y + 0.25f }, { boxes[0].max.x + 0.25f, boxes[0].max.y + 0.25f } };
+		SimVec2 heroVel{ MOVE_VELOCITY_HERO, 0.0f };
+		SimAABB heroSwept = SweptBox(heroBox, heroVel);
+		unsigned int heroRuns = ticks;
+
+		unsigned int allHits = 0;
+		start = std::chrono::steady_clock::now();
+		for (unsigned int r = 0; r < heroRuns; ++r)
+		{
+			allHits = 0;
+			for (unsigned int i = 0; i < n; ++i)
+				allHits += CollisionIntersection_RectRect(boxes[i], vels[i], heroBox, heroVel, DT);
+		}
+		printf("%u\thero_all\t%.3f\t%u\n", n, NsPerEnemy(start, heroRuns, n), allHits);
+
+		// the enemies as columns, walking for the upkeep
+		std::vector<float> minX(n), minY(n), maxX(n), maxY(n), velX(n), velY(n);
+		for (unsigned int i = 0; i < n; ++i) {
+			minX[i] = boxes[i].min.x;	minY[i] = boxes[i].min.y;
+			maxX[i] = boxes[i].max.x;	maxY[i] = boxes[i].max.y;
+			velX[i] = vels[i].x;		velY[i] = vels[i].y;
+		}
+		SpatialHash tracked;
+		for (unsigned int i = 0; i < n; ++i)
+			tracked.Track(SpatialKey(TYPE_OBJECT_ENEMY1, i), SweptBox(boxes[i], vels[i]));
+
+		std::vector<int> cellX(n), cellY(n);
+		std::vector<unsigned int> moved;
+		unsigned long long movedTotal = 0;
+		start = std::chrono::steady_clock::now();
+		for (unsigned int r = 0; r < heroRuns; ++r)
+		{
+			for (unsigned int i = 0; i < n; ++i) {
+				minX[i] += velX[i] * DT;	maxX[i] += velX[i] * DT;
+			}
+			SweptCellBatch batch{ minX.data(), minY.data(), maxX.data(), maxY.data(), velX.data(), velY.data(), n };
+			SweptCells(batch, DT, MARGIN, cellX.data(), cellY.data());
+			moved.clear();
+			tracked.FindMoved(TYPE_OBJECT_ENEMY1, 0, cellX.data(), cellY.data(), n, &moved);
+			for (unsigned int i : moved)
+			{
+				SimAABB box{ { minX[i], minY[i] }, { maxX[i], maxY[i] } };
+				tracked.Track(SpatialKey(TYPE_OBJECT_ENEMY1, i), SweptBox(box, vels[i]));
+			}
+			movedTotal += moved.size();
+		}
+		printf("%u\thero_tracked_upkeep\t%.3f\t%llu\n", n, NsPerEnemy(start, heroRuns, n), movedTotal / heroRuns);
+
+		// back where the other variants have them, for the same hits
+		for (unsigned int i = 0; i < n; ++i)
+			tracked.Track(SpatialKey(TYPE_OBJECT_ENEMY1, i), SweptBox(boxes[i], vels[i]));
+		std::vector<unsigned int> keys;
+		start = std::chrono::steady_clock::now();
+		for (unsigned int r = 0; r < heroRuns; ++r)
+		{
+			tracked.Query(heroSwept, &keys);
+
+			hits = 0;
+			for (unsigned int key : keys)
+			{
+				unsigned int i = SpatialKeyId(key);
+				hits += CollisionIntersection_RectRect(boxes[i], vels[i], heroBox, heroVel, DT);
+			}
+		}
+		printf("%u\thero_tracked_query\t%.3f\t%u%s\n", n, NsPerEnemy(start, heroRuns, n), hits,
+			   hits != allHits ? "\tMISMATCH" : "");
+
+		std::vector<unsigned int> contacts;
+		start = std::chrono::steady_clock::now();
+		for (unsigned int r = 0; r < heroRuns; ++r)
+		{
+			contacts.clear();
+			for (unsigned int i = 0; i < n; ++i)
+			{
+				SimAABB swept = SweptBox(boxes[i], vels[i]);
+				if (!(swept.max.x < heroSwept.min.x || swept.min.x > heroSwept.max.x ||
+					  swept.max.y < heroSwept.min.y || swept.min.y > heroSwept.max.y))
+					contacts.push_back(i);
+			}
+
+			hits = 0;
+			for (unsigned int i : contacts)
+				hits += CollisionIntersection_RectRect(boxes[i], vels[i], heroBox, heroVel, DT);
+		}
+		printf("%u\thero_swept_boxes\t%.3f\t%u%s\n", n, NsPerEnemy(start, heroRuns, n), hits,
+			   hits != allHits ? "\tMISMATCH" : "");
+	}
+	return 0;
+}
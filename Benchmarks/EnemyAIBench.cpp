@@ -0,0 +1,174 @@
+/******************************************************************************/
+/*!
+\file		EnemyAIBench.cpp
+\author 	DigiPen
+\par    	email: digipen\@digipen.edu
+\date   	February 01, 20xx
+\brief
+Microbenchmark for UpdateEnemyAI. Compares the per enemy switch the game
+used before against the bucketed, table driven update for 100, 2k, 20k
+and 100k enemies patrolling a 512x256 map of broken platforms, and checks
+that both leave every enemy in the same state. Movement is a plain x
+integration with a wall flag at the platform ends, enough to keep the
+enemies cycling through every state. Build it together with EnemyAI.cpp,
+EntityTable.cpp, InstancePool.cpp, TileMap.cpp, LevelArena.cpp and
+SimKernels.cpp, no Alpha Engine needed:
+
+	EnemyAIBench [ticks]
+
+Prints one line per case: enemies, variant, ns per enemy per tick.
+
+Copyright (C) 20xx DigiPen Institute of Technology.
+Reproduction or disclosure of this file or its contents without the
+prior written consent of DigiPen Institute of Technology is prohibited.
+ */
+/******************************************************************************/
+
+#include "../PlatformTypes.h"
+#include "../EntityTable.h"
+#include "../EnemyAI.h"
+#include "../TileMap.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+
+const int			MAP_WIDTH	= 512;
+const int			MAP_HEIGHT	= 256;
+const float			DT			= 1.0f / 60.0f;
+
+/******************************************************************************/
+/*!
+	The state machine the game used before the behaviour table
+*/
+/******************************************************************************/
+static void LegacyStateMachine(EntityTable& e, const CollisionGrid& grid, unsigned int i, float dt)
+{
+	bool check = false;
+	switch (e.state[i]) {
+	case (STATE_GOING_LEFT):
+		switch (e.innerState[i]) {
+		case (INNER_STATE_ON_ENTER):
+			e.velX[i] = -MOVE_VELOCITY_ENEMY;
+			e.innerState[i] = INNER_STATE_ON_UPDATE;
+			break;
+		case (INNER_STATE_ON_UPDATE):
+			check = (e.posX[i] - (int)e.posX[i] <= 0.5f) ? !CollisionGridCell(grid, (int)e.posX[i] - 1, (int)e.posY[i] - 1) : false;
+			if ((e.gridCollisionFlag[i] & COLLISION_LEFT) == COLLISION_LEFT || check) {
+				e.counter[i] = ENEMY_IDLE_TIME;
+				e.innerState[i] = INNER_STATE_ON_EXIT;
+				e.velX[i] = 0;
+			}
+			break;
+		case (INNER_STATE_ON_EXIT):
+			e.counter[i] -= dt;
+			if (e.counter[i] < 0.0) {
+				e.state[i] = STATE_GOING_RIGHT;
+				e.innerState[i] = INNER_STATE_ON_ENTER;
+			}
+			break;
+		}
+		break;
+	case (STATE_GOING_RIGHT):
+		switch (e.innerState[i]) {
+		case (INNER_STATE_ON_ENTER):
+			e.velX[i] = MOVE_VELOCITY_ENEMY;
+			e.innerState[i] = INNER_STATE_ON_UPDATE;
+			break;
+		case (INNER_STATE_ON_UPDATE):
+			check = (e.posX[i] - (int)e.posX[i] >= 0.5f) ? !CollisionGridCell(grid, (int)e.posX[i] + 1, (int)e.posY[i] - 1) : false;
+			if ((e.gridCollisionFlag[i] & COLLISION_RIGHT) == COLLISION_RIGHT || check) {
+				e.counter[i] = ENEMY_IDLE_TIME;
+				e.innerState[i] = INNER_STATE_ON_EXIT;
+				e.velX[i] = 0;
+			}
+			break;
+		case (INNER_STATE_ON_EXIT):
+			e.counter[i] -= dt;
+			if (e.counter[i] < 0.0) {
+				e.state[i] = STATE_GOING_LEFT;
+				e.innerState[i] = INNER_STATE_ON_ENTER;
+			}
+			break;
+		}
+		break;
+	default:
+		break;
+	}
+}
+
+//Walks every enemy, flagging a wall when the cell ahead is solid
+static void Move(EntityTable& t, const CollisionGrid& grid, float dt)
+{
+	for (unsigned int i = 0; i < t.count; ++i)
+	{
+		t.posX[i] += t.velX[i] * dt;
+		int ahead = (int)(t.posX[i] + (t.velX[i] < 0.0f ? -0.5f : 0.5f));
+		bool wall = CollisionGridCell(grid, ahead, (int)t.posY[i]) != 0;
+		t.gridCollisionFlag[i] = wall ? (t.velX[i] < 0.0f ? COLLISION_LEFT : COLLISION_RIGHT) : 0;
+	}
+}
+
+/******************************************************************************/
+/*!
+
+*/
+/******************************************************************************/
+int main(int argc, char** argv)
+{
+	const unsigned int	SIZES[]		= { 100, 2000, 20000, 100000 };
+	const unsigned int	ticks		= argc > 1 ? (unsigned int)atoi(argv[1]) : 600;
+
+	// a platform every 8 rows, cut every 32 cells, with the odd wall on it
+	TileMap map;
+	map.Create(MAP_WIDTH, MAP_HEIGHT, false);
+	srand(7);
+	for (int x = 0; x < MAP_WIDTH; ++x)
+		for (int y = 0; y < MAP_HEIGHT; ++y) {
+			bool solid = x == 0 || x == MAP_WIDTH - 1 || (y % 8 == 0 && x % 32 < 24) ||
+						 (y % 8 == 1 && x % 32 < 24 && rand() % 24 == 0);
+			map.SetCell(x, y, solid ? TYPE_OBJECT_COLLISION : TYPE_OBJECT_EMPTY);
+		}
+	const CollisionGrid& grid = map.GetCollisionGrid();
+	//no hero, so nothing chases: the switch only knows the patrol states
+	const EnemyAIContext ai{ &grid, false, 0.0f, 0.0f };
+
+	printf("enemies\tvariant\tns_per_enemy_tick\n");
+	for (unsigned int n : SIZES)
+	{
+		unsigned int runs = ticks * 2000 / n;
+		if (runs < 60)
+			runs = 60;
+
+		EntityTable legacy, table;
+		legacy.Create(TYPE_OBJECT_ENEMY1, n);
+		table.Create(TYPE_OBJECT_ENEMY1, n);
+		for (unsigned int i = 0; i < n; ++i) {
+			SimVec2 pos = { 1.5f + (float)(rand() % 22) + (float)(rand() % (MAP_WIDTH / 32)) * 32.0f,
+							1.5f + (float)(rand() % (MAP_HEIGHT / 8)) * 8.0f };
+			SimVec2 vel = { 0.0f, 0.0f };
+			legacy.Add(1.0f, pos, vel, 0.0f, rand() % 2 ? STATE_GOING_LEFT : STATE_GOING_RIGHT);
+		}
+		table.CopyFrom(legacy);
+
+		double legacyNs = 0.0, tableNs = 0.0;
+		for (unsigned int r = 0; r < runs; ++r)
+		{
+			auto start = std::chrono::steady_clock::now();
+			for (unsigned int i = 0; i < n; ++i)
+				LegacyStateMachine(legacy, grid, i, DT);
+			auto mid = std::chrono::steady_clock::now();
+			UpdateEnemyAI(table, ai, 0, n, DT);
+			auto stop = std::chrono::steady_clock::now();
+			legacyNs += std::chrono::duration<double, std::nano>(mid - start).count();
+			tableNs += std::chrono::duration<double, std::nano>(stop - mid).count();
+
+			Move(legacy, grid, DT);
+			Move(table, grid, DT);
+		}
+
+		bool same = table.IsIdentical(legacy);
+		printf("%u\tlegacy_switch\t%.3f\n", n, legacyNs / ((double)runs * n));
+		printf("%u\tbehaviour_table\t%.3f%s\n", n, tableNs / ((double)runs * n), same ? "" : "\tMISMATCH");
+	}
+	return 0;
+}
@@ -0,0 +1,147 @@
+/******************************************************************************/
+/*!
+\file		GridCollisionBench.cpp
+\author 	DigiPen
+\par    	email: digipen\@digipen.edu
+\date   	February 01, 20xx
+\brief
+Microbenchmark for CheckGridCollisionBatch. Compares the per instance
+query the game used before (8 bounds checked lookups through an int**
+column array) against the batch query on the TileMap bitmap at every SIMD
+level this CPU supports, for 100, 2k, 20k and 100k agents scattered over
+a 512x256 map. Build it together with SimKernels.cpp, no Alpha Engine
+needed (TileMap.cpp and LevelArena.cpp too):
+
+	GridCollisionBench [ticks]
+
+Prints one line per case: agents, variant, ns per agent per tick.
+
+Copyright (C) 20xx DigiPen Institute of Technology.
+Reproduction or disclosure of this file or its contents without the
+prior written consent of DigiPen Institute of Technology is prohibited.
+ */
+/******************************************************************************/
+
+#include "../PlatformTypes.h"
+#include "../SimKernels.h"
+#include "../TileMap.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+const int			MAP_WIDTH	= 512;
+const int			MAP_HEIGHT	= 256;
+
+/******************************************************************************/
+/*!
+	The map layout and query the game used before the padded grid
+*/
+/******************************************************************************/
+static int **sLegacyMap;
+
+static int LegacyGetCellValue(int X, int Y)
+{
+	if (X < 0 || X >= MAP_WIDTH || Y < 0 || Y >= MAP_HEIGHT) {
+		return 0;
+	}
+	return sLegacyMap[X][Y];
+}
+
+static int LegacyCheck(float PosX, float PosY, float scaleX, float scaleY)
+{
+	int flag = 0;
+	if (LegacyGetCellValue((int)(PosX + scaleX / 4.0f), (int)(PosY + scaleY / 2.0f)) == 1 ||
+		LegacyGetCellValue((int)(PosX - scaleX / 4.0f), (int)(PosY + scaleY / 2.0f)) == 1)
+		flag |= COLLISION_TOP;
+	if (LegacyGetCellValue((int)(PosX + scaleX / 4.0f), (int)(PosY - scaleY / 2.0f)) == 1 ||
+		LegacyGetCellValue((int)(PosX - scaleX / 4.0f), (int)(PosY - scaleY / 2.0f)) == 1)
+		flag |= COLLISION_BOTTOM;
+	if (LegacyGetCellValue((int)(PosX - scaleX / 2.0f), (int)(PosY + scaleY / 4.0f)) == 1 ||
+		LegacyGetCellValue((int)(PosX - scaleX / 2.0f), (int)(PosY - scaleY / 4.0f)) == 1)
+		flag |= COLLISION_LEFT;
+	if (LegacyGetCellValue((int)(PosX + scaleX / 2.0f), (int)(PosY + scaleY / 4.0f)) == 1 ||
+		LegacyGetCellValue((int)(PosX + scaleX / 2.0f), (int)(PosY - scaleY / 4.0f)) == 1)
+		flag |= COLLISION_RIGHT;
+	return flag;
+}
+
+static int sSink = 0;
+
+/******************************************************************************/
+/*!
+
+*/
+/******************************************************************************/
+int main(int argc, char** argv)
+{
+	const unsigned int	SIZES[]		= { 100, 2000, 20000, 100000 };
+	const unsigned int	ticks		= argc > 1 ? (unsigned int)atoi(argv[1]) : 2000;
+	const SIMD_LEVEL	best		= SimKernelsDetectLevel();
+
+	// a bordered map with a platform every 8 rows and some noise
+	TileMap map;
+	map.Create(MAP_WIDTH, MAP_HEIGHT, false);
+	sLegacyMap = new int* [MAP_WIDTH];
+	srand(7);
+	for (int x = 0; x < MAP_WIDTH; ++x) {
+		sLegacyMap[x] = new int[MAP_HEIGHT];
+		for (int y = 0; y < MAP_HEIGHT; ++y) {
+			bool solid = x == 0 || y == 0 || x == MAP_WIDTH - 1 || y == MAP_HEIGHT - 1 ||
+						 (y % 8 == 0 && x % 32 < 24) || rand() % 16 == 0;
+			sLegacyMap[x][y] = solid ? 1 : 0;
+			map.SetCell(x, y, solid ? TYPE_OBJECT_COLLISION : TYPE_OBJECT_EMPTY);
+		}
+	}
+	const CollisionGrid& grid = map.GetCollisionGrid();
+
+	printf("agents\tvariant\tns_per_agent_tick\n");
+	for (unsigned int n : SIZES)
+	{
+		// scale the tick count down so every case takes about as long
+		unsigned int runs = ticks * 2000 / n;
+		if (runs < 10)
+			runs = 10;
+
+		std::vector<float> posX(n), posY(n), scale(n, 1.0f);
+		std::vector<int> flags(n), reference(n);
+		for (unsigned int i = 0; i < n; ++i) {
+			posX[i] = (float)rand() / RAND_MAX * MAP_WIDTH;
+			posY[i] = (float)rand() / RAND_MAX * MAP_HEIGHT;
+		}
+
+		auto start = std::chrono::steady_clock::now();
+		for (unsigned int r = 0; r < runs; ++r)
+			for (unsigned int i = 0; i < n; ++i)
+				reference[i] = LegacyCheck(posX[i], posY[i], scale[i], scale[i]);
+		auto stop = std::chrono::steady_clock::now();
+		sSink += reference[n / 2];
+		double ns = std::chrono::duration<double, std::nano>(stop - start).count();
+		printf("%u\tlegacy_int_pp\t%.3f\n", n, ns / ((double)runs * n));
+
+		for (int level = SIMD_LEVEL_SCALAR; level <= best; ++level)
+		{
+			SimKernelsSetLevel((SIMD_LEVEL)level);
+
+			start = std::chrono::steady_clock::now();
+			for (unsigned int r = 0; r < runs; ++r)
+				CheckGridCollisionBatch(grid, posX.data(), posY.data(), scale.data(), flags.data(), n);
+			stop = std::chrono::steady_clock::now();
+			sSink += flags[n / 2];
+			ns = std::chrono::duration<double, std::nano>(stop - start).count();
+
+			unsigned int mismatches = 0;
+			for (unsigned int i = 0; i < n; ++i)
+				mismatches += flags[i] != reference[i];
+			printf("%u\tbatch_%s\t%.3f%s\n", n, SimKernelsLevelName((SIMD_LEVEL)level),
+				   ns / ((double)runs * n), mismatches ? "\tMISMATCH" : "");
+		}
+	}
+
+	for (int x = 0; x < MAP_WIDTH; ++x)
+		delete[] sLegacyMap[x];
+	delete[] sLegacyMap;
+
+	// keeps the optimizer from dropping the loops
+	return sSink == 12345 ? 1 : 0;
+}
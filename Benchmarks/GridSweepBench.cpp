@@ -0,0 +1,178 @@
+/******************************************************************************/
+/*!
+\file		GridSweepBench.cpp
+\author 	DigiPen
+\par    	email: digipen\@digipen.edu
+\date   	February 01, 20xx
+\brief
+Microbenchmark for MoveBoxGrid. Agents of scale 0.5 to 2 jump and fall
+around a 512x256 map of one cell thick floors, at step lengths of 1/60 s
+up to 1/4 s. Each step is resolved once with the hot spot test and
+SnapToCell the game used before, and once with the swept box. Reports the
+cost per agent per step and how many agents ended a step inside a
+collision cell, i.e. went into or through a wall. Build it together with
+GridSweep.cpp, SimKernels.cpp, TileMap.cpp and LevelArena.cpp, no Alpha
+Engine needed:
+
+	GridSweepBench [agents] [steps]
+
+Prints one line per step length and variant: dt, variant, ns per agent
+per step, agents found in a wall.
+
+Copyright (C) 20xx DigiPen Institute of Technology.
+Reproduction or disclosure of this file or its contents without the
+prior written consent of DigiPen Institute of Technology is prohibited.
+ */
+/******************************************************************************/
+
+#include "../PlatformTypes.h"
+#include "../GridSweep.h"
+#include "../SimKernels.h"
+#include "../TileMap.h"
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+const int			MAP_WIDTH	= 512;
+const int			MAP_HEIGHT	= 256;
+const float			FLOOR_GAP	= 8.0f;		//Rows between floors
+
+struct Agent
+{
+	SimVec2			pos, vel;
+	float			scale;
+};
+
+/******************************************************************************/
+/*!
+	The hot spot test and snap PlatformWorld uses by default
+*/
+/******************************************************************************/
+static unsigned int HotSpotCollision(const CollisionGrid& grid, Agent& a)
+{
+	float x = a.pos.x, y = a.pos.y, s = a.scale;
+	unsigned int flag = 0;
+	if (CollisionGridCell(grid, (int)(x + s / 4.0f), (int)(y + s / 2.0f)) ||
+		CollisionGridCell(grid, (int)(x - s / 4.0f), (int)(y + s / 2.0f)))
+		flag |= COLLISION_TOP;
+	if (CollisionGridCell(grid, (int)(x + s / 4.0f), (int)(y - s / 2.0f)) ||
+		CollisionGridCell(grid, (int)(x - s / 4.0f), (int)(y - s / 2.0f)))
+		flag |= COLLISION_BOTTOM;
+	if (CollisionGridCell(grid, (int)(x - s / 2.0f), (int)(y + s / 4.0f)) ||
+		CollisionGridCell(grid, (int)(x - s / 2.0f), (int)(y - s / 4.0f)))
+		flag |= COLLISION_LEFT;
+	if (CollisionGridCell(grid, (int)(x + s / 2.0f), (int)(y + s / 4.0f)) ||
+		CollisionGridCell(grid, (int)(x + s / 2.0f), (int)(y - s / 4.0f)))
+		flag |= COLLISION_RIGHT;
+
+	if (flag & (COLLISION_LEFT | COLLISION_RIGHT)) {
+		a.pos.x = (float)((int)a.pos.x) + 0.5f;
+		a.vel.x = 0.0f;
+	}
+	if (flag & (COLLISION_TOP | COLLISION_BOTTOM)) {
+		a.pos.y = (float)((int)a.pos.y) + 0.5f;
+		a.vel.y = 0.0f;
+	}
+	return flag;
+}
+
+/******************************************************************************/
+/*!
+	True if the agent's box is more than the sweep's skin into a collision
+	cell
+*/
+/******************************************************************************/
+static bool InWall(const CollisionGrid& grid, const Agent& a)
+{
+	float half = BOUNDING_RECT_SIZE * a.scale - GRID_SWEEP_SKIN;
+	for (int y = (int)floorf(a.pos.y - half); y < (int)ceilf(a.pos.y + half); ++y)
+		for (int x = (int)floorf(a.pos.x - half); x < (int)ceilf(a.pos.x + half); ++x)
+			if (CollisionGridCell(grid, x, y))
+				return true;
+	return false;
+}
+
+/******************************************************************************/
+/*!
+	Places the agents clear of the walls between two floors, running left
+	or right, on their way up
+*/
+/******************************************************************************/
+static void Spawn(std::vector<Agent>& agents)
+{
+	for (Agent& a : agents)
+	{
+		int floor = 1 + rand() % (int)(MAP_HEIGHT / FLOOR_GAP - 2);
+		a.scale	= 0.5f + (rand() % 4) * 0.5f;
+		int x	= 32 * (rand() % (MAP_WIDTH / 32)) + 4 + rand() % 24;
+		a.pos	= { (float)x, floor * FLOOR_GAP + 1.0f + a.scale };
+		a.vel	= { rand() % 2 ? MOVE_VELOCITY_ENEMY : -MOVE_VELOCITY_ENEMY, JUMP_VELOCITY };
+	}
+}
+
+/******************************************************************************/
+/*!
+
+*/
+/******************************************************************************/
+int main(int argc, char** argv)
+{
+	const float			STEPS[]	= { 1.0f / 60.0f, 1.0f / 30.0f, 1.0f / 15.0f, 1.0f / 8.0f, 1.0f / 4.0f };
+	const unsigned int	count	= argc > 1 ? (unsigned int)atoi(argv[1]) : 20000;
+	const unsigned int	steps	= argc > 2 ? (unsigned int)atoi(argv[2]) : 200;
+
+	//floors every FLOOR_GAP rows with a hole now and then, and walls
+	TileMap map;
+	map.Create(MAP_WIDTH, MAP_HEIGHT, true);
+	srand(11);
+	for (int y = 0; y < MAP_HEIGHT; ++y)
+		for (int x = 0; x < MAP_WIDTH; ++x) {
+			bool solid = (y % (int)FLOOR_GAP == 0 && rand() % 16 != 0) || (x % 32 == 0 && y % (int)FLOOR_GAP < 3);
+			map.SetCell(x, y, solid ? TYPE_OBJECT_COLLISION : TYPE_OBJECT_EMPTY);
+		}
+	const CollisionGrid& grid = map.GetCollisionGrid();
+
+	printf("dt\tvariant\tns/agent\tin wall\n");
+	for (float dt : STEPS)
+		for (int swept = 0; swept < 2; ++swept)
+		{
+			std::vector<Agent> agents(count);
+			srand(5);
+			Spawn(agents);
+
+			unsigned int inWall = 0;
+			double ns = 0.0;
+			for (unsigned int step = 0; step < steps; ++step)
+			{
+				auto start = std::chrono::steady_clock::now();
+				for (Agent& a : agents)
+				{
+					SimVec2 from = a.pos;
+					a.vel.y += GRAVITY * dt;
+					a.pos.x += a.vel.x * dt;
+					a.pos.y += a.vel.y * dt;
+					unsigned int flag;
+					if (swept) {
+						float half = BOUNDING_RECT_SIZE * a.scale;
+						flag = MoveBoxGrid(grid, SimVec2{ half, half }, from, &a.pos, &a.vel);
+					}
+					else
+						flag = HotSpotCollision(grid, a);
+
+					//turn at walls, jump off floors
+					if (flag & (COLLISION_LEFT | COLLISION_RIGHT))
+						a.vel.x = flag & COLLISION_LEFT ? MOVE_VELOCITY_ENEMY : -MOVE_VELOCITY_ENEMY;
+					if (flag & COLLISION_BOTTOM)
+						a.vel.y = JUMP_VELOCITY;
+				}
+				ns += std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+
+				for (const Agent& a : agents)
+					inWall += InWall(grid, a);
+			}
+			printf("%.4f\t%s\t%.1f\t%u\n", dt, swept ? "swept" : "hot_spots", ns / ((double)count * steps), inWall);
+		}
+	return 0;
+}
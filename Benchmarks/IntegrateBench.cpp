@@ -0,0 +1,160 @@
+/******************************************************************************/
+/*!
+\file		IntegrateBench.cpp
+\author 	DigiPen
+\par    	email: digipen\@digipen.edu
+\date   	February 01, 20xx
+\brief
+Microbenchmark for IntegrateAndBound. Compares the per instance loop the
+game used before (array of GameObjInst structs, AEVec2 style operators)
+against the structure of arrays kernel at every SIMD level this CPU
+supports, for 100, 2k and 100k entities. Build it together with
+SimKernels.cpp, no Alpha Engine needed:
+
+	IntegrateBench [ticks]
+
+Prints one line per case: entities, variant, ns per entity per tick.
+
+Copyright (C) 20xx DigiPen Institute of Technology.
+Reproduction or disclosure of this file or its contents without the
+prior written consent of DigiPen Institute of Technology is prohibited.
+ */
+/******************************************************************************/
+
+#include "../PlatformTypes.h"
+#include "../SimKernels.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+/******************************************************************************/
+/*!
+	The instance layout and loop the game used before the tables
+*/
+/******************************************************************************/
+struct LegacyInst
+{
+	void*			pObject;
+	unsigned int	flag;
+	float			scale;
+	SimVec2			posCurr;
+	SimVec2			velCurr;
+	float			dirCurr;
+	SimMtx33		transform;
+	SimAABB			boundingBox;
+	int				gridCollisionFlag;
+	void*			pUserData;
+	int				state;
+	int				innerState;
+	double			counter;
+	void*			_sprite;
+};
+
+static void LegacyIntegrate(std::vector<LegacyInst>& list, float _dt)
+{
+	SimVec2 BOUNDING_RECT_SIZE = { 0.5f,0.5f };
+	for (size_t i = 0; i < list.size(); ++i)
+	{
+		LegacyInst* pInst = &list[i];
+		if (0 == (pInst->flag & FLAG_ACTIVE))
+			continue;
+		pInst->velCurr.y += GRAVITY * _dt;
+	}
+	for (size_t i = 0; i < list.size(); ++i)
+	{
+		LegacyInst* pInst = &list[i];
+		if (0 == (pInst->flag & FLAG_ACTIVE))
+			continue;
+		pInst->posCurr += pInst->velCurr * _dt;
+		pInst->boundingBox.min = pInst->posCurr + -BOUNDING_RECT_SIZE * pInst->scale;
+		pInst->boundingBox.max = pInst->posCurr + BOUNDING_RECT_SIZE * pInst->scale;
+	}
+}
+
+/******************************************************************************/
+/*!
+
+*/
+/******************************************************************************/
+struct Columns
+{
+	std::vector<float>	posX, posY, posPrevX, posPrevY, velX, velY, scale, minX, minY, maxX, maxY;
+
+	explicit Columns(unsigned int n) :
+		posX(n), posY(n), posPrevX(n), posPrevY(n), velX(n), velY(n), scale(n, 1.0f),
+		minX(n), minY(n), maxX(n), maxY(n)
+	{
+	}
+
+	IntegrateBatch Batch(void)
+	{
+		return { posX.data(), posY.data(), posPrevX.data(), posPrevY.data(), velX.data(), velY.data(),
+				 scale.data(), minX.data(), minY.data(), maxX.data(), maxY.data(), (unsigned int)posX.size() };
+	}
+};
+
+static float sSink = 0.0f;
+
+/******************************************************************************/
+/*!
+
+*/
+/******************************************************************************/
+int main(int argc, char** argv)
+{
+	const unsigned int	SIZES[]		= { 100, 2000, 100000 };
+	const unsigned int	ticks		= argc > 1 ? (unsigned int)atoi(argv[1]) : 2000;
+	const float			dt			= 1.0f / 60.0f;
+	const SIMD_LEVEL	best		= SimKernelsDetectLevel();
+
+	printf("entities\tvariant\tns_per_entity_tick\n");
+	for (unsigned int n : SIZES)
+	{
+		// scale the tick count down so every case takes about as long
+		unsigned int runs = ticks * 2000 / n;
+		if (runs < 10)
+			runs = 10;
+
+		std::vector<LegacyInst> legacy(n);
+		for (unsigned int i = 0; i < n; ++i) {
+			legacy[i] = LegacyInst{};
+			legacy[i].flag		= FLAG_ACTIVE | FLAG_VISIBLE;
+			legacy[i].scale		= 1.0f;
+			legacy[i].posCurr	= { (float)(i % 512), (float)(i / 512) };
+			legacy[i].velCurr	= { (float)(i % 7) - 3.0f, 0.0f };
+		}
+
+		auto start = std::chrono::steady_clock::now();
+		for (unsigned int r = 0; r < runs; ++r)
+			LegacyIntegrate(legacy, dt);
+		auto stop = std::chrono::steady_clock::now();
+		sSink += legacy[n / 2].boundingBox.max.y;
+		double ns = std::chrono::duration<double, std::nano>(stop - start).count();
+		printf("%u\tlegacy_aos\t%.3f\n", n, ns / ((double)runs * n));
+
+		for (int level = SIMD_LEVEL_SCALAR; level <= best; ++level)
+		{
+			Columns c(n);
+			for (unsigned int i = 0; i < n; ++i) {
+				c.posX[i] = (float)(i % 512);
+				c.posY[i] = (float)(i / 512);
+				c.velX[i] = (float)(i % 7) - 3.0f;
+			}
+
+			SimKernelsSetLevel((SIMD_LEVEL)level);
+			IntegrateBatch batch = c.Batch();
+
+			start = std::chrono::steady_clock::now();
+			for (unsigned int r = 0; r < runs; ++r)
+				IntegrateAndBound(batch, dt, GRAVITY, true, 0.5f);
+			stop = std::chrono::steady_clock::now();
+			sSink += c.maxY[n / 2];
+			ns = std::chrono::duration<double, std::nano>(stop - start).count();
+			printf("%u\tsoa_%s\t%.3f\n", n, SimKernelsLevelName((SIMD_LEVEL)level), ns / ((double)runs * n));
+		}
+	}
+
+	// keeps the optimizer from dropping the loops
+	return sSink == 12345.0f ? 1 : 0;
+}
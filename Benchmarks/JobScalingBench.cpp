@@ -0,0 +1,103 @@
+/******************************************************************************/
+/*!
+\file		JobScalingBench.cpp
+\author 	DigiPen
+\par    	email: digipen\@digipen.edu
+\date   	February 01, 20xx
+\brief
+Scaling of PlatformWorld::Step with the worker count. Runs the same
+scripted input on a level for 0, 1, 3, 7, ... workers up to one per core
+(or the count given), times the steps and takes the world's HashState
+after the run: the hash must not depend on the worker count. Build it together with
+every engine free .cpp of the game:
+
+	JobScalingBench level [steps] [maxWorkers]
+
+Prints one line per worker count: workers, ms per step, speedup, hash.
+
+Copyright (C) 20xx DigiPen Institute of Technology.
+Reproduction or disclosure of this file or its contents without the
+prior written consent of DigiPen Institute of Technology is prohibited.
+ */
+/******************************************************************************/
+
+#include "../PlatformWorld.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <thread>
+
+/******************************************************************************/
+/*!
+	Runs right, jumping every second, and turns back every 20 seconds. Every
+	run starts from the snapshot the first Init took, so the handle
+	generations HashState covers are the same for every worker count.
+*/
+/******************************************************************************/
+static double Run(PlatformWorld& world, unsigned int steps, unsigned long long *pHash)
+{
+	world.Restart();
+	auto start = std::chrono::steady_clock::now();
+	for (unsigned int s = 0; s < steps; ++s)
+	{
+		InputFrame input{};
+		input.moveRight	= (s / 1200) % 2 == 0;
+		input.moveLeft	= !input.moveRight;
+		input.jump		= s % 60 < 10;
+		if (world.Step(FIXED_TIMESTEP, input) == STEP_RESULT_RESTART)
+			world.Restart();
+	}
+	double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+	*pHash = world.HashState();
+	return ms / steps;
+}
+
+/******************************************************************************/
+/*!
+
+*/
+/******************************************************************************/
+int main(int argc, char** argv)
+{
+	if (argc < 2) {
+		printf("usage: JobScalingBench level [steps] [maxWorkers]\n");
+		return 1;
+	}
+	unsigned int steps = argc > 2 ? (unsigned int)atoi(argv[2]) : 3000;
+	unsigned int cores = std::thread::hardware_concurrency();
+	unsigned int maxWorkers = argc > 3 ? (unsigned int)atoi(argv[3]) : (cores > 1 ? cores - 1 : 0);
+
+	PlatformWorld world;
+	if (!world.ImportMapDataFromFile(argv[1])) {
+		printf("can't load %s\n", argv[1]);
+		return 1;
+	}
+
+	unsigned long long reference = 0;
+	double baseline = 0.0;
+	bool mismatch = false;
+	printf("workers\tms_per_step\tspeedup\thash\n");
+	for (unsigned int workers = 0; ; workers = workers * 2 + 1)
+	{
+		if (workers > maxWorkers)
+			workers = maxWorkers;
+		world.SetWorkerCount(workers);
+
+		unsigned long long hash;
+		double ms = Run(world, steps, &hash);
+		if (workers == 0) {
+			reference = hash;
+			baseline = ms;
+		}
+		mismatch = mismatch || hash != reference;
+		printf("%u\t%.4f\t%.2f\t%016llx%s\n", workers, ms, baseline / ms, hash,
+			   hash != reference ? "\tMISMATCH" : "");
+		if (workers == maxWorkers)
+			break;
+	}
+
+	world.SetWorkerCount(0);
+	world.FreeMapData();
+	return mismatch;
+}
@@ -0,0 +1,134 @@
+/******************************************************************************/
+/*!
+\file		LevelArenaBench.cpp
+\author 	DigiPen
+\par    	email: digipen\@digipen.edu
+\date   	February 01, 20xx
+\brief
+Load/unload cycles through the level arena. Generates text levels (see
+LevelGenerator.h) from 256x256 to 2048x2048 cells and runs each one
+through a number of cycles: ImportMapDataFromFile, Init, a second of
+steps, Free and FreeMapData. The levels run from smallest to largest and
+then smallest again, so the last pass shows the small levels reusing the
+blocks the large one left. Build it together with every engine free .cpp
+of the game:
+
+	LevelArenaBench [cycles] [dir]
+
+Prints one line per level and pass: size, mean ms of the load, Init and
+unload, arena bytes in use and reserved, blocks the arena took from the
+heap during the pass, scratch peak, and the peak resident bytes of the
+pass where the OS lets it be reset.
+
+Copyright (C) 20xx DigiPen Institute of Technology.
+Reproduction or disclosure of this file or its contents without the
+prior written consent of DigiPen Institute of Technology is prohibited.
+ */
+/******************************************************************************/
+
+#include "../PlatformWorld.h"
+#include "../LevelGenerator.h"
+#include "../ProcessMemory.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+
+const unsigned int	STEPS_PER_CYCLE	= 60;
+
+static const int	sSizes[] = { 256, 1024, 2048, 256 };
+
+/******************************************************************************/
+/*!
+
+*/
+/******************************************************************************/
+static double MsSince(std::chrono::steady_clock::time_point start)
+{
+	return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+/******************************************************************************/
+/*!
+	In the exported format ImportMapDataFromFile reads
+*/
+/******************************************************************************/
+static bool WriteTextLevel(const char *FileName, const LevelGenResult& level, int width, int height)
+{
+	FILE *file = fopen(FileName, "w");
+	if (!file)
+		return false;
+	fprintf(file, "Width %d\nHeight %d\n", width, height);
+	for (int y = 0; y < height; ++y)
+	{
+		for (int x = 0; x < width; ++x)
+			fprintf(file, "%d ", level.types[(size_t)y * width + x]);
+		fputc('\n', file);
+	}
+	return fclose(file) == 0;
+}
+
+/******************************************************************************/
+/*!
+
+*/
+/******************************************************************************/
+int main(int argc, char** argv)
+{
+	unsigned int cycles = argc > 1 ? (unsigned int)atoi(argv[1]) : 10;
+	if (cycles == 0)
+		cycles = 1;
+	std::string dir = argc > 2 ? argv[2] : ".";
+
+	PlatformWorld world;
+	printf("size\tload_ms\tinit_ms\tunload_ms\tarena_bytes\treserved_bytes\theap_blocks\tscratch_peak\tpeak_resident\n");
+	for (int size : sSizes)
+	{
+		LevelGenParams params{ size, size, 0.5f, (unsigned int)size * 4, (unsigned int)size * 4, 1 };
+		LevelGenResult level;
+		std::string name = dir + "/LevelArenaBench_" + std::to_string(size) + ".txt";
+		if (!GenerateLevel(params, &level) || !WriteTextLevel(name.c_str(), level, size, size)) {
+			printf("can't write %s\n", name.c_str());
+			return 1;
+		}
+		level.types = std::vector<unsigned char>();
+
+		bool levelPeak = ResetPeakResidentBytes();
+		unsigned int heapBefore = world.GetLevelMemoryStats().arenaHeapAllocations;
+		double loadMs = 0.0, initMs = 0.0, unloadMs = 0.0;
+		LevelMemoryStats memory{};
+		for (unsigned int c = 0; c < cycles; ++c)
+		{
+			auto start = std::chrono::steady_clock::now();
+			if (!world.ImportMapDataFromFile(name.c_str())) {
+				printf("can't load %s\n", name.c_str());
+				return 1;
+			}
+			loadMs += MsSince(start);
+
+			start = std::chrono::steady_clock::now();
+			world.Init();
+			initMs += MsSince(start);
+
+			for (unsigned int s = 0; s < STEPS_PER_CYCLE; ++s)
+			{
+				InputFrame input{ false, true, s % 30 == 0 };
+				if (world.Step(FIXED_TIMESTEP, input) == STEP_RESULT_RESTART)
+					world.Restart();
+			}
+			memory = world.GetLevelMemoryStats();
+
+			start = std::chrono::steady_clock::now();
+			world.Free();
+			world.FreeMapData();
+			unloadMs += MsSince(start);
+		}
+		remove(name.c_str());
+
+		printf("%d\t%.3f\t%.3f\t%.3f\t%zu\t%zu\t%u\t%zu\t%zu%s\n", size,
+			   loadMs / cycles, initMs / cycles, unloadMs / cycles,
+			   memory.arenaBytes, memory.arenaReservedBytes, memory.arenaHeapAllocations - heapBefore,
+			   memory.scratchPeakBytes, GetPeakResidentBytes(), levelPeak ? "" : " (whole run)");
+	}
+	return 0;
+}
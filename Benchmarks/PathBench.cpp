@@ -0,0 +1,172 @@
+/******************************************************************************/
+/*!
+\file		PathBench.cpp
+\author 	DigiPen
+\par    	email: digipen\@digipen.edu
+\date   	February 01, 20xx
+\brief
+Microbenchmark for NavGraph and PathService on generated maps of 512x128,
+2048x512 and 4096x1024 cells: floors with holes every 4 rows, the odd
+block on them, so most of the map can reach most of it. For each map it
+times the full graph build, an incremental rebuild after a one cell edit,
+hierarchical queries between any two cells and between cells at most
+NEAR_RANGE apart (an enemy chasing the hero), plain A* over every node
+(checking both find the same paths, and how much longer the far ones
+that took a corridor came out), and a batch of requests answered by the
+PathService on all the workers.
+Build it together with NavGraph.cpp, PathService.cpp, TileMap.cpp,
+LevelArena.cpp, SimKernels.cpp and JobSystem.cpp, no Alpha Engine needed:
+
+	PathBench [queries] [workers]
+
+Prints one line per map and variant: map, variant, ms or us per query.
+
+Copyright (C) 20xx DigiPen Institute of Technology.
+Reproduction or disclosure of this file or its contents without the
+prior written consent of DigiPen Institute of Technology is prohibited.
+ */
+/******************************************************************************/
+
+#include "../NavGraph.h"
+#include "../PathService.h"
+#include "../TileMap.h"
+#include "../JobSystem.h"
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <thread>
+#include <vector>
+
+const int		NEAR_RANGE		= 128;	//Cells, both ways, between the ends of a near query
+
+struct QueryCells
+{
+	int				fromX, fromY;
+	int				toX, toY;
+};
+
+static double MsSince(std::chrono::steady_clock::time_point start)
+{
+	return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+/******************************************************************************/
+/*!
+
+*/
+/******************************************************************************/
+int main(int argc, char** argv)
+{
+	const int			SIZES[][2]	= { { 512, 128 }, { 2048, 512 }, { 4096, 1024 } };
+	const unsigned int	queries		= argc > 1 ? (unsigned int)atoi(argv[1]) : 1000;
+	unsigned int		workers		= std::thread::hardware_concurrency();
+	workers = argc > 2 ? (unsigned int)atoi(argv[2]) : (workers > 1 ? workers - 1 : 0);
+
+	JobSystem jobs;
+	jobs.Start(workers);
+	srand(7);
+	printf("map\tvariant\ttime\n");
+	for (const int* size : SIZES)
+	{
+		int width = size[0], height = size[1];
+		TileMap map;
+		map.Create(width, height, false);
+		for (int y = 0; y < height; ++y)
+			for (int x = 0; x < width; ++x) {
+				bool solid = y == 0 || (y % 4 == 0 && rand() % 6 != 0) || (y % 4 == 1 && rand() % 20 == 0);
+				map.SetCell(x, y, solid ? TYPE_OBJECT_COLLISION : TYPE_OBJECT_EMPTY);
+			}
+
+		NavGraph graph;
+		auto start = std::chrono::steady_clock::now();
+		graph.Update(map, jobs);
+		const NavStats& stats = graph.GetStats();
+		printf("%dx%d\tbuild\t%.3f ms\t(%u nodes, %u links, %u entrances)\n", width, height, MsSince(start),
+			   stats.nodes, stats.links, stats.entrances);
+
+		int editX = width / 2, editY = height / 2;
+		map.SetCell(editX, editY, TYPE_OBJECT_COLLISION);
+		graph.InvalidateCells(editX, editY, editX, editY);
+		start = std::chrono::steady_clock::now();
+		graph.Update(map, jobs);
+		printf("%dx%d\tedit_one_cell\t%.3f ms\t(%u of %u clusters)\n", width, height, MsSince(start),
+			   stats.clustersRebuilt, stats.clusters);
+
+		// ends on a floor row, anywhere on the map
+		std::vector<QueryCells> cells(queries);
+		for (QueryCells& q : cells)
+			q = { rand() % width, 1 + 4 * (rand() % (height / 4)), rand() % width, 1 + 4 * (rand() % (height / 4)) };
+
+		std::vector<QueryCells> nearCells(queries);
+		for (QueryCells& q : nearCells)
+		{
+			int x = rand() % width, y = rand() % (height / 4);
+			int toX = x + rand() % (2 * NEAR_RANGE + 1) - NEAR_RANGE;
+			int toY = y + rand() % (NEAR_RANGE / 2 + 1) - NEAR_RANGE / 4;
+			toX = toX < 0 ? 0 : (toX >= width ? width - 1 : toX);
+			toY = toY < 0 ? 0 : (toY >= height / 4 ? height / 4 - 1 : toY);
+			q = { x, 1 + 4 * y, toX, 1 + 4 * toY };
+		}
+
+		NavScratch scratch;
+		std::vector<NavWaypoint> path;
+		std::vector<float> costs(queries);
+		unsigned int found = 0;
+		start = std::chrono::steady_clock::now();
+		for (unsigned int i = 0; i < queries; ++i)
+			found += graph.FindPath(nearCells[i].fromX, nearCells[i].fromY, nearCells[i].toX, nearCells[i].toY,
+									scratch, &path, &costs[i]);
+		printf("%dx%d\thierarchical_near\t%.3f us\t(%u found)\n", width, height,
+			   MsSince(start) * 1000.0 / queries, found);
+
+		found = 0;
+		start = std::chrono::steady_clock::now();
+		for (unsigned int i = 0; i < queries; ++i)
+			found += graph.FindPath(cells[i].fromX, cells[i].fromY, cells[i].toX, cells[i].toY, scratch,
+									&path, &costs[i]);
+		printf("%dx%d\thierarchical_any\t%.3f us\t(%u found)\n", width, height,
+			   MsSince(start) * 1000.0 / queries, found);
+
+		// the flat search is slow on the big maps, a few queries are enough.
+		// A corridor can make a path longer, never shorter.
+		unsigned int flatQueries = queries < 100 ? queries : 100, mismatches = 0, longer = 0;
+		double extra = 0.0, extraMax = 0.0;
+		start = std::chrono::steady_clock::now();
+		for (unsigned int i = 0; i < flatQueries; ++i)
+		{
+			float cost = 0.0f;
+			bool flatFound = graph.FindPathFlat(cells[i].fromX, cells[i].fromY, cells[i].toX, cells[i].toY,
+												scratch, &path, &cost);
+			bool hierarchical = graph.FindPath(cells[i].fromX, cells[i].fromY, cells[i].toX, cells[i].toY,
+											   scratch, &path, &costs[i]);
+			mismatches += flatFound != hierarchical || (flatFound && costs[i] < cost - 1e-3f * cost);
+			if (flatFound && hierarchical && costs[i] > cost + 1e-3f * cost) {
+				double ratio = (costs[i] - cost) / cost;
+				++longer;
+				extra += ratio;
+				extraMax = ratio > extraMax ? ratio : extraMax;
+			}
+		}
+		printf("%dx%d\tflat\t%.3f us\t(%u of %u longer, +%.1f%% mean, +%.1f%% max)%s\n", width, height,
+			   MsSince(start) * 1000.0 / flatQueries, longer, flatQueries, longer ? 100.0 * extra / longer : 0.0,
+			   100.0 * extraMax, mismatches ? "\tMISMATCH" : "");
+
+		PathService service;
+		std::vector<PathTicket> tickets(queries);
+		// builds the graph
+		service.Request(cells[0].fromX, cells[0].fromY, cells[0].toX, cells[0].toY);
+		service.Update(map, jobs);
+		for (unsigned int i = 0; i < queries; ++i)
+			tickets[i] = service.Request(cells[i].fromX, cells[i].fromY, cells[i].toX, cells[i].toY);
+		start = std::chrono::steady_clock::now();
+		service.Update(map, jobs);
+		double ms = MsSince(start);
+		unsigned int answered = 0;
+		for (PathTicket ticket : tickets)
+			answered += service.GetPath(ticket, nullptr) == PATH_STATUS_FOUND;
+		printf("%dx%d\tservice_%u_workers\t%.3f us\t(%u found)\n", width, height, workers,
+			   ms * 1000.0 / queries, answered);
+	}
+	return 0;
+}
@@ -0,0 +1,95 @@
+/******************************************************************************/
+/*!
+\file		ProfilerBench.cpp
+\author 	DigiPen
+\par    	email: digipen\@digipen.edu
+\date   	February 01, 20xx
+\brief
+Overhead of the frame profiler, and what it reports on a level. Times an
+empty PROFILE_ZONE and a counter add, then runs the level with one
+frame per step under the profiler and prints its report. The trace goes
+to the file given. Build it together with every engine free .cpp of the
+game, once as is and once with -DSS_PROFILE=0 to compare the step time
+with the profiler compiled out:
+
+	ProfilerBench level [steps] [trace.json]
+
+Copyright (C) 20xx DigiPen Institute of Technology.
+Reproduction or disclosure of this file or its contents without the
+prior written consent of DigiPen Institute of Technology is prohibited.
+ */
+/******************************************************************************/
+
+#include "../PlatformWorld.h"
+#include "../Profiler.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+
+const unsigned int	OVERHEAD_ZONES	= 1000000;
+
+/******************************************************************************/
+/*!
+
+*/
+/******************************************************************************/
+int main(int argc, char** argv)
+{
+	if (argc < 2) {
+		printf("usage: ProfilerBench level [steps] [trace.json]\n");
+		return 1;
+	}
+	unsigned int steps = argc > 2 ? (unsigned int)atoi(argv[2]) : 3000;
+	const char *traceName = argc > 3 ? argv[3] : nullptr;
+
+	PlatformWorld world;
+	if (!world.ImportMapDataFromFile(argv[1])) {
+		printf("can't load %s\n", argv[1]);
+		return 1;
+	}
+
+#if SS_PROFILE
+	//a frame of nothing but zones, so the trace ring wraps a few times
+	PROFILE_FRAME_BEGIN();
+	auto start = std::chrono::steady_clock::now();
+	for (unsigned int z = 0; z < OVERHEAD_ZONES; ++z)
+	{
+		PROFILE_ZONE("empty");
+		PROFILE_COUNTER_ADD("zones", 1);
+	}
+	double zoneNs = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+	PROFILE_FRAME_END();
+	Profiler::Instance().Reset();
+	printf("ns per zone and counter add\t%.1f\n", zoneNs / OVERHEAD_ZONES);
+#else
+	printf("profiler compiled out\n");
+#endif
+
+	world.Init();
+	auto run = std::chrono::steady_clock::now();
+	for (unsigned int s = 0; s < steps; ++s)
+	{
+		PROFILE_FRAME_BEGIN();
+		InputFrame input{};
+		input.moveRight	= (s / 1200) % 2 == 0;
+		input.moveLeft	= !input.moveRight;
+		input.jump		= s % 60 < 10;
+		if (world.Step(FIXED_TIMESTEP, input) == STEP_RESULT_RESTART)
+			world.Restart();
+		PROFILE_FRAME_END();
+	}
+	double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - run).count();
+	printf("ms per step\t%.4f\n", ms / steps);
+
+#if SS_PROFILE
+	Profiler::Instance().Report(stdout);
+	if (traceName && !Profiler::Instance().WriteChromeTrace(traceName))
+		printf("can't write %s\n", traceName);
+#else
+	(void)traceName;
+#endif
+
+	world.Free();
+	world.FreeMapData();
+	return 0;
+}
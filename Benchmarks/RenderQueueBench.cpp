@@ -0,0 +1,153 @@
+/******************************************************************************/
+/*!
+\file		RenderQueueBench.cpp
+\author 	DigiPen
+\par    	email: digipen\@digipen.edu
+\date   	February 01, 20xx
+\brief
+Microbenchmark for RenderQueue. Instances of 3 meshes on 3 layers, the
+game's two squares and 12 triangle coin, are submitted in shuffled order,
+the way the tables hand them out, for 100, 2k, 20k and 100k instances.
+Compares the draw loop the game used before (one concat, one transform
+and one draw call per instance) with the queue's sort and vertex baking,
+and checks the baked vertices against std::stable_sort and the shapes put
+through each matrix. Only the CPU side is timed, a draw call costs
+nothing here. Build it together with RenderQueue.cpp, no Alpha Engine
+needed:
+
+	RenderQueueBench [frames]
+
+Prints one line per case: instances, variant, ns per instance, draw
+calls.
+
+Copyright (C) 20xx DigiPen Institute of Technology.
+Reproduction or disclosure of this file or its contents without the
+prior written consent of DigiPen Institute of Technology is prohibited.
+ */
+/******************************************************************************/
+
+#include "../PlatformTypes.h"
+#include "../RenderQueue.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cmath>
+#include <cstdlib>
+#include <vector>
+
+struct Instance
+{
+	unsigned int	layer;
+	unsigned int	mesh;
+	SimMtx33		transform;
+};
+
+static volatile float	sSink;
+
+/******************************************************************************/
+/*!
+
+*/
+/******************************************************************************/
+int main(int argc, char** argv)
+{
+	const unsigned int	SIZES[]		= { 100, 2000, 20000, 100000 };
+	const unsigned int	frames		= argc > 1 ? (unsigned int)atoi(argv[1]) : 1000;
+
+	SimMtx33 camera, scale, trans;
+	SimMtx33Trans(&trans, -30.0f, -20.0f);
+	SimMtx33Scale(&scale, 50.0f, 50.0f);
+	SimMtx33Concat(&camera, &scale, &trans);
+
+	std::vector<TileVertex> shapes[TYPE_OBJECT_COIN + 1];
+	for (unsigned int mesh = TYPE_OBJECT_HERO; mesh <= TYPE_OBJECT_ENEMY1; ++mesh)
+		shapes[mesh] = { { -0.5f, -0.5f, mesh }, { 0.5f, -0.5f, mesh }, { -0.5f, 0.5f, mesh },
+						 { -0.5f, 0.5f, mesh }, { 0.5f, -0.5f, mesh }, { 0.5f, 0.5f, mesh } };
+	for (int i = 0; i < 12; ++i)
+	{
+		float a0 = i * 2 * 3.14159265f / 12, a1 = (i + 1) * 2 * 3.14159265f / 12;
+		shapes[TYPE_OBJECT_COIN].push_back({ 0.0f, 0.0f, TYPE_OBJECT_COIN });
+		shapes[TYPE_OBJECT_COIN].push_back({ cosf(a0) * 0.5f, sinf(a0) * 0.5f, TYPE_OBJECT_COIN });
+		shapes[TYPE_OBJECT_COIN].push_back({ cosf(a1) * 0.5f, sinf(a1) * 0.5f, TYPE_OBJECT_COIN });
+	}
+
+	srand(7);
+	printf("instances\tvariant\tns_per_instance\tdraw_calls\n");
+	for (unsigned int n : SIZES)
+	{
+		unsigned int runs = frames * 2000 / n;
+		if (runs < 10)
+			runs = 10;
+
+		std::vector<Instance> instances(n);
+		for (unsigned int i = 0; i < n; ++i) {
+			instances[i].mesh	= TYPE_OBJECT_HERO + rand() % 3;
+			instances[i].layer	= instances[i].mesh == TYPE_OBJECT_HERO ? 2 : instances[i].mesh == TYPE_OBJECT_ENEMY1 ? 1 : 0;
+			SimMtx33Trans(&trans, (float)rand() / RAND_MAX * 60.0f, (float)rand() / RAND_MAX * 40.0f);
+			SimMtx33Scale(&scale, 1.0f, 0.5f + (float)rand() / RAND_MAX);
+			SimMtx33Concat(&instances[i].transform, &trans, &scale);
+		}
+
+		// before: concat per instance, in table order, each its own draw call
+		auto start = std::chrono::steady_clock::now();
+		for (unsigned int r = 0; r < runs; ++r)
+		{
+			for (const Instance& inst : instances)
+			{
+				SimMtx33 final;
+				SimMtx33Concat(&final, &camera, &inst.transform);
+				sSink = final.m[0][2];
+			}
+		}
+		auto stop = std::chrono::steady_clock::now();
+		double ns = std::chrono::duration<double, std::nano>(stop - start).count();
+		printf("%u\tper_instance\t%.3f\t%u\n", n, ns / ((double)runs * n), n);
+
+		RenderQueue queue;
+		for (unsigned int mesh = TYPE_OBJECT_HERO; mesh <= TYPE_OBJECT_COIN; ++mesh)
+			queue.SetShape(mesh, shapes[mesh].data(), (unsigned int)shapes[mesh].size());
+		start = std::chrono::steady_clock::now();
+		for (unsigned int r = 0; r < runs; ++r)
+		{
+			queue.Clear();
+			for (const Instance& inst : instances)
+				queue.Submit(inst.layer, RENDER_TEXTURE_NONE, inst.mesh, inst.transform);
+			queue.Build();
+			sSink = queue.GetVertices()[n / 2].x;
+		}
+		stop = std::chrono::steady_clock::now();
+		ns = std::chrono::duration<double, std::nano>(stop - start).count();
+
+		// the reference order: by layer then mesh, submission order within
+		std::vector<unsigned int> order(n);
+		for (unsigned int i = 0; i < n; ++i)
+			order[i] = i;
+		std::stable_sort(order.begin(), order.end(), [&](unsigned int a, unsigned int b) {
+			const Instance& ia = instances[a];
+			const Instance& ib = instances[b];
+			return ia.layer != ib.layer ? ia.layer < ib.layer : ia.mesh < ib.mesh;
+		});
+
+		unsigned int mismatches = 0, k = 0;
+		for (const RenderBatch& batch : queue.GetBatches())
+		{
+			const TileVertex *pOut = queue.GetVertices() + batch.vertexBegin;
+			for (unsigned int i = 0; i < batch.count; ++i, ++k)
+			{
+				const Instance& inst = instances[order[k]];
+				mismatches += batch.mesh != inst.mesh;
+				for (const TileVertex& v : shapes[inst.mesh])
+				{
+					SimVec2 expected = SimMtx33MultPoint(&inst.transform, { v.x, v.y });
+					mismatches += expected.x != pOut->x || expected.y != pOut->y || v.color != pOut->color;
+					++pOut;
+				}
+			}
+			mismatches += pOut != queue.GetVertices() + batch.vertexBegin + batch.vertexCount;
+		}
+		mismatches += k != n;
+		printf("%u\tqueue\t%.3f\t%u%s\n", n, ns / ((double)runs * n), (unsigned int)queue.GetBatches().size(),
+			   mismatches ? "\tMISMATCH" : "");
+	}
+	return 0;
+}
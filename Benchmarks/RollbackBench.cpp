@@ -0,0 +1,172 @@
+/******************************************************************************/
+/*!
+\file		RollbackBench.cpp
+\author 	DigiPen
+\par    	email: digipen\@digipen.edu
+\date   	February 01, 20xx
+\brief
+Cost of world snapshots and of rollback. Times SaveSnapshot,
+RestoreSnapshot, and Restart against the Free and Init the game used to
+restart with. Then runs two RollbackSession peers over a LoopbackLink at
+a few latencies, each with its own scripted input, and checks that both
+end on the state of a world stepped with the real merged inputs. Build it
+together with every engine free .cpp of the game:
+
+	RollbackBench level [ticks]
+
+Prints the snapshot size and timings, then one line per latency: ticks of
+latency, us per tick per peer, rollbacks, ticks resimulated, longest
+rollback, and whether both peers match the reference.
+
+Copyright (C) 20xx DigiPen Institute of Technology.
+Reproduction or disclosure of this file or its contents without the
+prior written consent of DigiPen Institute of Technology is prohibited.
+ */
+/******************************************************************************/
+
+#include "../PlatformWorld.h"
+#include "../RollbackSession.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+
+const unsigned int	REPEATS		= 200;
+
+/******************************************************************************/
+/*!
+	Player 0 runs right and left, player 1 jumps now and then, both change
+	their input often enough to be mispredicted
+*/
+/******************************************************************************/
+static InputFrame ScriptedInput(unsigned int player, unsigned int tick)
+{
+	InputFrame input{ false, false, false };
+	if (player == 0) {
+		input.moveRight	= (tick / 300) % 2 == 0;
+		input.moveLeft	= !input.moveRight && tick % 7 != 0;
+	}
+	else
+		input.jump		= (tick * 2654435761u) % 97 < 20;
+	return input;
+}
+
+/******************************************************************************/
+/*!
+	us per call of "f"
+*/
+/******************************************************************************/
+template <typename F>
+static double Time(unsigned int repeats, F f)
+{
+	auto start = std::chrono::steady_clock::now();
+	for (unsigned int r = 0; r < repeats; ++r)
+		f();
+	return std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count() / repeats;
+}
+
+/******************************************************************************/
+/*!
+
+*/
+/******************************************************************************/
+int main(int argc, char** argv)
+{
+	if (argc < 2) {
+		printf("usage: RollbackBench level [ticks]\n");
+		return 1;
+	}
+	unsigned int ticks = argc > 2 ? (unsigned int)atoi(argv[2]) : 3000;
+
+	//the timings, the reference run and the two peers: every world goes
+	//through the same Init and Free so their handles' generations agree
+	PlatformWorld timed, worlds[3];
+	if (!timed.ImportMapDataFromFile(argv[1])) {
+		printf("can't load %s\n", argv[1]);
+		return 1;
+	}
+	for (PlatformWorld& world : worlds)
+		if (!world.ImportMapDataFromFile(argv[1])) {
+			printf("can't load %s\n", argv[1]);
+			return 1;
+		}
+
+	//Snapshots of a level some way into play
+	PlatformWorld& world = timed;
+	world.Init();
+	for (unsigned int tick = 0; tick < 600; ++tick)
+		if (world.Step(FIXED_TIMESTEP, ScriptedInput(0, tick)) == STEP_RESULT_RESTART)
+			world.Restart();
+
+	WorldSnapshot snapshot;
+	double saveUs = Time(REPEATS, [&]() { world.SaveSnapshot(&snapshot); });
+	double restoreUs = Time(REPEATS, [&]() { world.RestoreSnapshot(snapshot); });
+	double restartUs = Time(REPEATS, [&]() { world.Restart(); });
+	double reloadUs = Time(REPEATS, [&]() { world.Free(); world.Init(); });
+	world.Free();
+	world.FreeMapData();
+
+	printf("snapshot\t%zu bytes\n", snapshot.data.size());
+	printf("save\t%.2f us\nrestore\t%.2f us\n", saveUs, restoreUs);
+	printf("restart\t%.2f us\nfree_init\t%.2f us\n", restartUs, reloadUs);
+
+	printf("latency\tus_per_tick\trollbacks\tresimulated\tlongest\tresult\n");
+	bool mismatch = false;
+	for (unsigned int latency : { 0u, 1u, 3u, 6u, 12u })
+	{
+		//the reference: every input known when its tick runs
+		PlatformWorld& reference = worlds[0];
+		reference.Init();
+		for (unsigned int tick = 0; tick < ticks; ++tick)
+		{
+			InputFrame a = ScriptedInput(0, tick), b = ScriptedInput(1, tick);
+			InputFrame merged{ a.moveLeft || b.moveLeft, a.moveRight || b.moveRight, a.jump || b.jump };
+			if (reference.Step(FIXED_TIMESTEP, merged) == STEP_RESULT_RESTART)
+				reference.Restart();
+		}
+
+		RollbackSession peers[2];
+		LoopbackLink link;
+		link.Open(latency);
+		for (unsigned int p = 0; p < 2; ++p) {
+			worlds[p + 1].Init();
+			peers[p].Start(&worlds[p + 1], p, FIXED_TIMESTEP);
+		}
+
+		auto start = std::chrono::steady_clock::now();
+		for (unsigned int tick = 0; tick < ticks; ++tick)
+			for (unsigned int p = 0; p < 2; ++p)
+			{
+				RollbackInput message;
+				while (link.Receive(p, tick, &message))
+					peers[p].AddRemoteInput(message);
+
+				InputFrame local = ScriptedInput(p, tick);
+				link.Send(1 - p, RollbackInput{ tick, p, local }, tick);
+				peers[p].Tick(local);
+			}
+		//what is still on the way, then catch up with it
+		for (unsigned int p = 0; p < 2; ++p)
+		{
+			RollbackInput message;
+			while (link.Receive(p, ticks + latency, &message))
+				peers[p].AddRemoteInput(message);
+			peers[p].Synchronize();
+		}
+		double us = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+
+		uint64_t expected = reference.HashState();
+		bool match = worlds[1].HashState() == expected && worlds[2].HashState() == expected;
+		mismatch |= !match;
+
+		const RollbackStats& stats = peers[0].GetStats();
+		printf("%u\t%.2f\t%u\t%u\t%u\t%s\n", latency, us / (2.0 * ticks), stats.rollbacks,
+			   stats.ticksResimulated, stats.longestRollback, match ? "match" : "MISMATCH");
+
+		for (PlatformWorld& w : worlds)
+			w.Free();
+	}
+
+	for (PlatformWorld& w : worlds)
+		w.FreeMapData();
+	return mismatch ? 1 : 0;
+}
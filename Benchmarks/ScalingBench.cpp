@@ -0,0 +1,321 @@
+/******************************************************************************/
+/*!
+\file		ScalingBench.cpp
+\author 	DigiPen
+\par    	email: digipen\@digipen.edu
+\date   	February 01, 20xx
+\brief
+Headless scaling suite. Generates synthetic levels (see LevelGenerator.h)
+from the tutorial size up to 10000x10000 cells with 100k enemies, writes
+each as a binary level, loads it, and steps it with scripted input for a
+number of ticks. Build it together with every engine free .cpp of the
+game:
+
+	ScalingBench [--preset name|all] [--ticks N] [--workers N] [--seed N]
+				 [--tag text] [--dir path] [--out file]
+	ScalingBench --width W --height H [--density D] [--enemies N] [--coins N] ...
+
+Presets: tutorial, small, medium, large, huge. "all" runs them in that
+order. Without --preset or --width every preset but huge runs.
+
+Every workload prints one JSON object per line, to stdout and appended to
+--out if given, so runs of different commits can be diffed or plotted:
+the workload, what was placed and what the pools took, the generate,
+write, load and Init times, ns per entity per tick of the step and of
+every profiler zone in it (mean over all ticks, p50/p99 over the last
+PROFILE_HISTORY), the bytes, reallocations and rows past the soft cap of
+the entity tables, and the resident and peak resident bytes after the
+run. The peak is reset before every workload where the OS allows it (see
+ProcessMemory.h); "peak_is_workload" says whether it was.
+"--tag" is copied into every line, e.g. the commit hash.
+
+Copyright (C) 20xx DigiPen Institute of Technology.
+Reproduction or disclosure of this file or its contents without the
+prior written consent of DigiPen Institute of Technology is prohibited.
+ */
+/******************************************************************************/
+
+#include "../PlatformWorld.h"
+#include "../LevelFile.h"
+#include "../LevelGenerator.h"
+#include "../ProcessMemory.h"
+#include "../Profiler.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+
+struct Workload
+{
+	const char		*name;
+	LevelGenParams	level;
+	unsigned int	ticks;
+};
+
+static const Workload sPresets[] =
+{
+	{ "tutorial",	{ 60,		40,		0.6f,	12,		30,		1 },	3000 },
+	{ "small",		{ 256,		256,	0.5f,	1000,	2000,	1 },	2000 },
+	{ "medium",		{ 1024,		1024,	0.5f,	10000,	10000,	1 },	500 },
+	{ "large",		{ 4096,		4096,	0.5f,	50000,	50000,	1 },	200 },
+	{ "huge",		{ 10000,	10000,	0.5f,	100000,	100000,	1 },	100 },
+};
+const unsigned int	PRESET_NUM		= sizeof(sPresets) / sizeof(sPresets[0]);
+
+//The zones of PlatformWorld::Step, see Profiler.h
+static const char *sPhases[] = { "step", "streaming", "paths", "entities", "object collision", "commands" };
+const unsigned int	PHASE_NUM		= sizeof(sPhases) / sizeof(sPhases[0]);
+
+struct Options
+{
+	unsigned int	ticks;			// 0 for the workload's own
+	unsigned int	workers;
+	std::string		tag;
+	std::string		dir;
+	const char		*outName;
+};
+
+/******************************************************************************/
+/*!
+
+*/
+/******************************************************************************/
+static double MsSince(std::chrono::steady_clock::time_point start)
+{
+	return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+/******************************************************************************/
+/*!
+	"text" as the inside of a JSON string
+*/
+/******************************************************************************/
+static std::string JsonEscape(const std::string& text)
+{
+	std::string escaped;
+	for (char c : text)
+	{
+		if (c == '"' || c == '\\')
+			escaped += '\\';
+		if ((unsigned char)c >= 0x20)
+			escaped += c;
+	}
+	return escaped;
+}
+
+/******************************************************************************/
+/*!
+	Runs right for 10 s then left, jumping every second
+*/
+/******************************************************************************/
+static InputFrame ScriptedInput(unsigned int tick)
+{
+	InputFrame input{};
+	input.moveRight	= (tick / 600) % 2 == 0;
+	input.moveLeft	= !input.moveRight;
+	input.jump		= tick % 60 < 10;
+	return input;
+}
+
+/******************************************************************************/
+/*!
+	One JSON line, false if the level couldn't be generated or loaded
+*/
+/******************************************************************************/
+static bool Run(const Workload& workload, const Options& options, std::string *pLine)
+{
+	char buffer[512];
+	unsigned int ticks = options.ticks ? options.ticks : workload.ticks;
+	bool peakReset = ResetPeakResidentBytes();
+	std::string levelName = options.dir + "/ScalingBench_" + workload.name + ".level";
+
+	auto start = std::chrono::steady_clock::now();
+	LevelGenResult level;
+	if (!GenerateLevel(workload.level, &level))
+		return false;
+	double generateMs = MsSince(start);
+
+	start = std::chrono::steady_clock::now();
+	bool written = WriteLevelFile(levelName.c_str(), level.types.data(), workload.level.width, workload.level.height);
+	double writeMs = MsSince(start);
+	level.types = std::vector<unsigned char>();
+	if (!written) {
+		fprintf(stderr, "can't write %s\n", levelName.c_str());
+		return false;
+	}
+
+	PlatformWorld world;
+	start = std::chrono::steady_clock::now();
+	int loaded = world.ImportMapDataFromFile(levelName.c_str());
+	double loadMs = MsSince(start);
+	if (!loaded) {
+		remove(levelName.c_str());
+		fprintf(stderr, "can't load %s\n", levelName.c_str());
+		return false;
+	}
+	world.SetWorkerCount(options.workers);
+
+	start = std::chrono::steady_clock::now();
+	world.Init();
+	double initMs = MsSince(start);
+	unsigned int enemies = world.GetTable(TYPE_OBJECT_ENEMY1).count;
+	unsigned int coins = world.GetTable(TYPE_OBJECT_COIN).count;
+
+	//the step timed here, its phases by the profiler, both per live entity
+	double stepNs = 0.0, entityTicks = 0.0;
+	double phaseMs[PHASE_NUM] = {};
+	for (unsigned int tick = 0; tick < ticks; ++tick)
+	{
+		entityTicks += world.GetLiveCount();
+
+		PROFILE_FRAME_BEGIN();
+		auto stepStart = std::chrono::steady_clock::now();
+		if (world.Step(FIXED_TIMESTEP, ScriptedInput(tick)) == STEP_RESULT_RESTART)
+			world.Restart();
+		stepNs += MsSince(stepStart) * 1000000.0;
+		PROFILE_FRAME_END();
+
+#if SS_PROFILE
+		for (unsigned int p = 0; p < PHASE_NUM; ++p)
+		{
+			double ms;
+			if (Profiler::Instance().GetZoneLast(sPhases[p], &ms))
+				phaseMs[p] += ms;
+		}
+#endif
+	}
+	if (entityTicks == 0.0)
+		entityTicks = 1.0;
+
+	snprintf(buffer, sizeof(buffer),
+			 "{\"tag\":\"%s\",\"workload\":\"%s\",\"width\":%d,\"height\":%d,\"density\":%.3f,\"seed\":%u,"
+			 "\"ticks\":%u,\"workers\":%u,\"enemies_requested\":%u,\"enemies_placed\":%u,\"enemies_spawned\":%u,"
+			 "\"coins_requested\":%u,\"coins_placed\":%u,\"coins_spawned\":%u,",
+			 options.tag.c_str(), workload.name, workload.level.width, workload.level.height,
+			 workload.level.platformDensity, workload.level.seed, ticks, options.workers,
+			 workload.level.enemyCount, level.enemyCount, enemies,
+			 workload.level.coinCount, level.coinCount, coins);
+	*pLine = buffer;
+	snprintf(buffer, sizeof(buffer),
+			 "\"generate_ms\":%.3f,\"write_ms\":%.3f,\"load_ms\":%.3f,\"init_ms\":%.3f,"
+			 "\"step_ms\":%.4f,\"step_ns_per_entity_tick\":%.3f,\"phases\":{",
+			 generateMs, writeMs, loadMs, initMs, stepNs / 1000000.0 / (ticks ? ticks : 1), stepNs / entityTicks);
+	*pLine += buffer;
+
+	const char *separator = "";
+#if SS_PROFILE
+	for (unsigned int p = 0; p < PHASE_NUM; ++p)
+	{
+		ProfileStats stats;
+		if (!Profiler::Instance().GetZoneStats(sPhases[p], &stats))
+			continue;
+		snprintf(buffer, sizeof(buffer), "%s\"%s\":{\"ns_per_entity_tick\":%.3f,\"p50_ms\":%.4f,\"p99_ms\":%.4f}",
+				 separator, sPhases[p], phaseMs[p] * 1000000.0 / entityTicks, stats.p50, stats.p99);
+		*pLine += buffer;
+		separator = ",";
+	}
+	Profiler::Instance().Reset();
+#else
+	(void)phaseMs;
+	(void)separator;
+#endif
+
+	unsigned int grows = 0, overSoftCap = 0;
+	for (unsigned int type = TYPE_OBJECT_HERO; type < ENTITY_TABLE_NUM; ++type)
+	{
+		grows += world.GetTable(type).GetStats().growCount;
+		overSoftCap += world.GetTable(type).GetStats().overSoftCap;
+	}
+	snprintf(buffer, sizeof(buffer), "},\"entity_bytes\":%zu,\"entity_grows\":%u,\"entity_over_soft_cap\":%u",
+			 world.GetEntityMemoryBytes(), grows, overSoftCap);
+	*pLine += buffer;
+
+	world.Free();
+	world.FreeMapData();
+	remove(levelName.c_str());
+
+	//the kernel's high water mark can trail the resident size a little
+	size_t resident = GetResidentBytes(), peak = GetPeakResidentBytes();
+	snprintf(buffer, sizeof(buffer), ",\"resident_bytes\":%zu,\"peak_resident_bytes\":%zu,\"peak_is_workload\":%s}",
+			 resident, peak > resident ? peak : resident, peakReset ? "true" : "false");
+	*pLine += buffer;
+	return true;
+}
+
+/******************************************************************************/
+/*!
+
+*/
+/******************************************************************************/
+int main(int argc, char** argv)
+{
+	Options options{ 0, 0, "", ".", nullptr };
+	Workload custom{ "custom", { 0, 0, 0.5f, 1000, 1000, 1 }, 1000 };
+	const char *preset = nullptr;
+	uint32_t seed = 1;
+
+	for (int i = 1; i < argc; ++i)
+	{
+		const char *arg = argv[i], *value = i + 1 < argc ? argv[i + 1] : nullptr;
+		if (!value) {
+			fprintf(stderr, "%s needs a value\n", arg);
+			return 2;
+		}
+		++i;
+		if (strcmp(arg, "--preset") == 0)			preset = value;
+		else if (strcmp(arg, "--ticks") == 0)		options.ticks = (unsigned int)atoi(value);
+		else if (strcmp(arg, "--workers") == 0)		options.workers = (unsigned int)atoi(value);
+		else if (strcmp(arg, "--seed") == 0)		seed = (uint32_t)strtoul(value, nullptr, 10);
+		else if (strcmp(arg, "--tag") == 0)			options.tag = JsonEscape(value);
+		else if (strcmp(arg, "--dir") == 0)			options.dir = value;
+		else if (strcmp(arg, "--out") == 0)			options.outName = value;
+		else if (strcmp(arg, "--width") == 0)		custom.level.width = atoi(value);
+		else if (strcmp(arg, "--height") == 0)		custom.level.height = atoi(value);
+		else if (strcmp(arg, "--density") == 0)		custom.level.platformDensity = (float)atof(value);
+		else if (strcmp(arg, "--enemies") == 0)		custom.level.enemyCount = (unsigned int)atoi(value);
+		else if (strcmp(arg, "--coins") == 0)		custom.level.coinCount = (unsigned int)atoi(value);
+		else {
+			fprintf(stderr, "unknown option %s\n", arg);
+			return 2;
+		}
+	}
+
+	std::vector<Workload> workloads;
+	if (custom.level.width > 0 || custom.level.height > 0)
+		workloads.push_back(custom);
+	bool defaults = workloads.empty() && !preset;
+	for (unsigned int k = 0; k < PRESET_NUM; ++k)
+		if (preset ? (strcmp(preset, "all") == 0 || strcmp(preset, sPresets[k].name) == 0)
+				   : (defaults && strcmp(sPresets[k].name, "huge") != 0))
+			workloads.push_back(sPresets[k]);
+	if (workloads.empty()) {
+		fprintf(stderr, "no preset named %s\n", preset);
+		return 2;
+	}
+
+	FILE *out = options.outName ? fopen(options.outName, "a") : nullptr;
+	if (options.outName && !out) {
+		fprintf(stderr, "can't open %s\n", options.outName);
+		return 2;
+	}
+
+	int result = 0;
+	for (Workload& workload : workloads)
+	{
+		workload.level.seed = seed;
+		std::string line;
+		if (!Run(workload, options, &line)) {
+			result = 1;
+			continue;
+		}
+		printf("%s\n", line.c_str());
+		fflush(stdout);
+		if (out)
+			fprintf(out, "%s\n", line.c_str());
+	}
+
+	if (out)
+		fclose(out);
+	return result;
+}
@@ -0,0 +1,201 @@
+/******************************************************************************/
+/*!
+\file		TileBatchBench.cpp
+\author 	DigiPen
+\par    	email: digipen\@digipen.edu
+\date   	February 01, 20xx
+\brief
+Headless check of the tile map batching. Loads a level the way the game
+does, draws it through a TileBatchCache whose backend only counts, and
+compares with the one draw call per cell the game used to make. Also
+checks that the quads built cover every cell in memory exactly once with
+its color, and times the first (building) and later (cached) frames.
+Then culls to an 800x600 window with level two's camera (50 pixels per
+cell, centered on the hero) and prints what was kept.
+Build it together with every engine free .cpp of the game:
+
+	TileBatchBench level [--stream] [frames]
+
+Copyright (C) 20xx DigiPen Institute of Technology.
+Reproduction or disclosure of this file or its contents without the
+prior written consent of DigiPen Institute of Technology is prohibited.
+ */
+/******************************************************************************/
+
+#include "../PlatformWorld.h"
+#include "../TileBatch.h"
+#include "../ViewCulling.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+/******************************************************************************/
+/*!
+	Keeps the vertices instead of uploading them, and counts
+*/
+/******************************************************************************/
+class CountingBackend : public TileMeshBackend
+{
+public:
+	CountingBackend() : Live{ 0 }, Draws{ 0 } {}
+
+	void* CreateMesh(const TileVertex *vertices, unsigned int count) override
+	{
+		++Live;
+		return new std::vector<TileVertex>(vertices, vertices + count);
+	}
+
+	void FreeMesh(void *mesh) override
+	{
+		--Live;
+		delete (std::vector<TileVertex> *)mesh;
+	}
+
+	void DrawMesh(void *mesh) override
+	{
+		++Draws;
+		Drawn.push_back((const std::vector<TileVertex> *)mesh);
+	}
+
+	int									Live;
+	unsigned int						Draws;
+	std::vector<const std::vector<TileVertex> *>	Drawn;
+};
+
+/******************************************************************************/
+/*!
+	Every cell in [x0, x1) x [y0, y1) must be covered by exactly one quad,
+	of its color. Returns the number of bad cells.
+*/
+/******************************************************************************/
+static unsigned int CheckCoverage(const PlatformWorld& world, const CountingBackend& backend,
+								  int x0, int y0, int x1, int y1)
+{
+	int width = x1 - x0, height = y1 - y0;
+	std::vector<int> hits((size_t)width * height, 0);
+	std::vector<unsigned int> colors((size_t)width * height, 0);
+	unsigned int bad = 0;
+
+	for (const std::vector<TileVertex> *pMesh : backend.Drawn)
+		for (size_t v = 0; v < pMesh->size(); v += 6)
+		{
+			// the second triangle's last vertex is the max corner
+			const TileVertex& lo = (*pMesh)[v];
+			const TileVertex& hi = (*pMesh)[v + 5];
+			for (int y = (int)lo.y; y < (int)hi.y; ++y)
+				for (int x = (int)lo.x; x < (int)hi.x; ++x)
+				{
+					if (x < x0 || x >= x1 || y < y0 || y >= y1) {
+						++bad;
+						continue;
+					}
+					size_t cell = (size_t)(y - y0) * width + (x - x0);
+					++hits[cell];
+					colors[cell] = lo.color;
+				}
+		}
+
+	for (int y = y0; y < y1; ++y)
+		for (int x = x0; x < x1; ++x)
+		{
+			size_t cell = (size_t)(y - y0) * width + (x - x0);
+			unsigned int expected = world.GetCellValue(x, y) == TYPE_OBJECT_COLLISION ? TILE_COLOR_COLLISION : TILE_COLOR_EMPTY;
+			if (hits[cell] != 1 || colors[cell] != expected)
+				++bad;
+		}
+	return bad;
+}
+
+/******************************************************************************/
+/*!
+
+*/
+/******************************************************************************/
+int main(int argc, char** argv)
+{
+	if (argc < 2) {
+		printf("usage: TileBatchBench level [--stream] [frames]\n");
+		return 1;
+	}
+	bool stream = argc > 2 && strcmp(argv[2], "--stream") == 0;
+	int frames = argc > (stream ? 3 : 2) ? atoi(argv[stream ? 3 : 2]) : 1000;
+	frames = frames < 2 ? 2 : frames;
+
+	PlatformWorld world;
+	if (!(stream ? world.StreamMapFromFile(argv[1]) : world.ImportMapDataFromFile(argv[1]))) {
+		printf("can't load %s\n", argv[1]);
+		return 1;
+	}
+	world.Init();
+
+	CountingBackend backend;
+	TileBatchCache cache;
+	cache.SetBackend(&backend);
+
+	int x0, y0, x1, y1;
+	world.GetResidentBounds(&x0, &y0, &x1, &y1);
+	int chunkX0 = ChunkOfCell(x0), chunkY0 = ChunkOfCell(y0);
+	int chunkX1 = ChunkOfCell(x1 - 1) + 1, chunkY1 = ChunkOfCell(y1 - 1) + 1;
+
+	auto start = std::chrono::steady_clock::now();
+	cache.Draw(world, chunkX0, chunkY0, chunkX1, chunkY1);
+	double firstNs = (double)std::chrono::duration_cast<std::chrono::nanoseconds>(
+		std::chrono::steady_clock::now() - start).count();
+	TileBatchStats first = cache.GetStats();
+	unsigned int bad = CheckCoverage(world, backend, x0, y0, x1, y1);
+
+	start = std::chrono::steady_clock::now();
+	for (int f = 1; f < frames; ++f)
+	{
+		backend.Drawn.clear();
+		cache.Draw(world, chunkX0, chunkY0, chunkX1, chunkY1);
+	}
+	double cachedNs = (double)std::chrono::duration_cast<std::chrono::nanoseconds>(
+		std::chrono::steady_clock::now() - start).count() / (frames - 1);
+	TileBatchStats cached = cache.GetStats();
+
+	printf("cells\t%d x %d\n", x1 - x0, y1 - y0);
+	printf("draw_calls_per_cell\t%d\n", (x1 - x0) * (y1 - y0));
+	printf("draw_calls_batched\t%u\n", cached.drawCalls);
+	printf("quads\t%u\n", cached.quadsDrawn);
+	printf("chunks_built\tfirst %u later %u\n", first.chunksBuilt, cached.chunksBuilt);
+	printf("frame_ns\tfirst %.0f cached %.0f\n", firstNs, cachedNs);
+	printf("coverage_errors\t%u\n", bad);
+
+	// level two's camera
+	SimVec2 hero;
+	if (world.GetInterpolatedPosition(world.GetHeroHandle(), &hero)) {
+		SimMtx33 scale, trans, mapTransform;
+		SimMtx33Trans(&trans, -hero.x, -hero.y);
+		SimMtx33Scale(&scale, 50.0f, 50.0f);
+		SimMtx33Concat(&mapTransform, &scale, &trans);
+
+		ViewCuller culler;
+		culler.Begin(mapTransform, -400.0f, -300.0f, 400.0f, 300.0f);
+		int vx0, vy0, vx1, vy1;
+		culler.GetCellRange(x0, y0, x1, y1, &vx0, &vy0, &vx1, &vy1);
+		if (vx0 < vx1 && vy0 < vy1)
+			cache.Draw(world, ChunkOfCell(vx0), ChunkOfCell(vy0), ChunkOfCell(vx1 - 1) + 1, ChunkOfCell(vy1 - 1) + 1);
+		for (unsigned int type = TYPE_OBJECT_HERO; type < ENTITY_TABLE_NUM; ++type)
+		{
+			const EntityTable& table = world.GetTable(type);
+			for (unsigned int k = 0; k < table.count; ++k)
+				culler.IsVisible({ { table.minX[k], table.minY[k] }, { table.maxX[k], table.maxY[k] } });
+		}
+
+		const ViewCullStats& stats = culler.GetStats();
+		printf("view_cells\t%u of %u\n", stats.cellsInView, stats.cellsInBounds);
+		printf("view_draw_calls\t%u\n", cache.GetStats().drawCalls);
+		printf("view_instances\t%u of %u (%u culled)\n", stats.instancesTested - stats.instancesCulled,
+			   stats.instancesTested, stats.instancesCulled);
+	}
+
+	cache.Clear();
+	world.Free();
+	world.FreeMapData();
+	if (backend.Live != 0)
+		printf("leaked_meshes\t%d\n", backend.Live);
+	return bad != 0 || backend.Live != 0;
+}
@@ -0,0 +1,522 @@
+/******************************************************************************/
+/*!
+\file		ChunkStreamer.cpp
+\author 	DigiPen
+\par    	email: digipen\@digipen.edu
+\date   	February 01, 20xx
+\brief
+Streaming of large levels. See ChunkStreamer.h.
+
+Copyright (C) 20xx DigiPen Institute of Technology.
+Reproduction or disclosure of this file or its contents without the
+prior written consent of DigiPen Institute of Technology is prohibited.
+ */
+/******************************************************************************/
+
+#include "ChunkStreamer.h"
+#include "PlatformTypes.h"
+#include <cstdlib>
+#include <cstring>
+#include <string>
+
+/******************************************************************************/
+/*!
+
+*/
+/******************************************************************************/
+TextChunkSource::TextChunkSource() :
+	FileSize{ 0 }, Width{ 0 }, Height{ 0 }, ChunksX{ 0 }, RowsIndexed{ 0 }, IndexEnd{ 0 },
+	IndexHeader{}
+{
+}
+
+/******************************************************************************/
+/*!
+	Only reads the header, and the side index's
+*/
+/******************************************************************************/
+bool TextChunkSource::Open(const char *FileName)
+{
+	if (!OpenText(FileName))
+		return false;
+
+	// a missing or stale index only means the rows get indexed as they come
+	std::string indexName = std::string(FileName) + TEXT_INDEX_EXTENSION;
+	OpenIndex(indexName.c_str());
+	return true;
+}
+
+/******************************************************************************/
+/*!
+
+*/
+/******************************************************************************/
+bool TextChunkSource::OpenText(const char *FileName)
+{
+	std::string s;
+
+	File.open(FileName, std::ios::in | std::ios::binary);
+	if (!File)
+		return false;
+
+	File.seekg(0, std::ios::end);
+	FileSize = (std::streamoff)File.tellg();
+	File.seekg(0);
+
+	File >> s >> Width >> s >> Height;
+	if (!File || Width <= 0 || Height <= 0)
+		return false;
+
+	ChunksX		= (Width + CHUNK_SIZE - 1) / CHUNK_SIZE;
+	RowsIndexed	= 0;
+	IndexEnd	= (std::streamoff)File.tellg();
+	CellOffsets.clear();
+	return true;
+}
+
+/******************************************************************************/
+/*!
+	Keeps the index open only if it was written for this very level: same
+	size, same dimensions, every offset there
+*/
+/******************************************************************************/
+bool TextChunkSource::OpenIndex(const char *FileName)
+{
+	Index.open(FileName, std::ios::in | std::ios::binary);
+	if (!Index)
+		return false;
+
+	Index.read((char*)&IndexHeader, sizeof(IndexHeader));
+	Index.seekg(0, std::ios::end);
+	std::streamoff expected = (std::streamoff)sizeof(IndexHeader) +
+							  (std::streamoff)Height * ChunksX * (std::streamoff)sizeof(int64_t);
+
+	if (!Index || memcmp(IndexHeader.magic, TEXT_INDEX_MAGIC, sizeof(TEXT_INDEX_MAGIC)) != 0 ||
+		IndexHeader.version != TEXT_INDEX_VERSION || IndexHeader.textSize != (uint64_t)FileSize ||
+		IndexHeader.width != Width || IndexHeader.height != Height ||
+		(std::streamoff)Index.tellg() != expected) {
+		Index.close();
+		return false;
+	}
+	return true;
+}
+
+/******************************************************************************/
+/*!
+	Indexes every row, then writes the header and the offsets
+*/
+/******************************************************************************/
+bool TextChunkSource::WriteIndex(const char *FileName)
+{
+	TextChunkSource source;
+	TextIndexHeader header{};
+
+	if (!source.OpenText(FileName) || !source.IndexRowsTo(source.Height - 1))
+		return false;
+
+	memcpy(header.magic, TEXT_INDEX_MAGIC, sizeof(TEXT_INDEX_MAGIC));
+	header.version	= TEXT_INDEX_VERSION;
+	header.textSize	= (uint64_t)source.FileSize;
+	header.width	= source.Width;
+	header.height	= source.Height;
+	int x, y;
+	bool hasHero	= source.FindHeroSpawn(&x, &y);
+	header.heroX	= hasHero ? x : -1;
+	header.heroY	= hasHero ? y : -1;
+
+	std::vector<int64_t> offsets(source.CellOffsets.begin(), source.CellOffsets.end());
+	std::string indexName = std::string(FileName) + TEXT_INDEX_EXTENSION;
+	std::ofstream out(indexName.c_str(), std::ios::out | std::ios::binary | std::ios::trunc);
+	out.write((const char*)&header, sizeof(header));
+	out.write((const char*)offsets.data(), (std::streamsize)(offsets.size() * sizeof(int64_t)));
+	return (bool)out;
+}
+
+/******************************************************************************/
+/*!
+	Skips a row's Width values from the last row known, once per row, and
+	keeps where each chunk column starts on the way
+*/
+/******************************************************************************/
+bool TextChunkSource::IndexRowsTo(int Y)
+{
+	int j;
+
+	while (RowsIndexed <= Y)
+	{
+		File.clear();
+		File.seekg(IndexEnd);
+		for (int x = 0; x < Width; ++x) {
+			if (x % CHUNK_SIZE == 0)
+				CellOffsets.push_back((std::streamoff)File.tellg());
+			File >> j;
+		}
+		if (!File) {
+			CellOffsets.resize((size_t)RowsIndexed * ChunksX);
+			return false;
+		}
+		IndexEnd = (std::streamoff)File.tellg();
+		++RowsIndexed;
+	}
+	return true;
+}
+
+/******************************************************************************/
+/*!
+	One read of the side index, or the rows indexed down to Y
+*/
+/******************************************************************************/
+bool TextChunkSource::GetCellOffset(int chunkX, int Y, std::streamoff *pOffset)
+{
+	if (Index.is_open()) {
+		int64_t offset;
+		Index.clear();
+		Index.seekg((std::streamoff)sizeof(IndexHeader) +
+					((std::streamoff)Y * ChunksX + chunkX) * (std::streamoff)sizeof(int64_t));
+		Index.read((char*)&offset, sizeof(offset));
+		*pOffset = (std::streamoff)offset;
+		return (bool)Index;
+	}
+
+	if (!IndexRowsTo(Y))
+		return false;
+	*pOffset = CellOffsets[(size_t)Y * ChunksX + chunkX];
+	return true;
+}
+
+/******************************************************************************/
+/*!
+	From the side index, or by walking the rows from the top until one holds
+	the hero
+*/
+/******************************************************************************/
+bool TextChunkSource::FindHeroSpawn(int *pX, int *pY)
+{
+	std::streamoff offset;
+	int j;
+
+	if (Index.is_open()) {
+		*pX = IndexHeader.heroX;
+		*pY = IndexHeader.heroY;
+		return IndexHeader.heroX >= 0;
+	}
+
+	for (int y = 0; y < Height; ++y)
+	{
+		if (!GetCellOffset(0, y, &offset))
+			return false;
+
+		File.clear();
+		File.seekg(offset);
+		for (int x = 0; x < Width; ++x) {
+			File >> j;
+			if (!File)
+				return false;
+			if (j == TYPE_OBJECT_HERO) {
+				*pX = x;
+				*pY = y;
+				return true;
+			}
+		}
+	}
+	return false;
+}
+
+/******************************************************************************/
+/*!
+	Seeks straight to the chunk's first column on every row it spans. Cell
+	types are checked like ImportMapDataFromFile does.
+*/
+/******************************************************************************/
+bool TextChunkSource::LoadChunk(int chunkX, int chunkY, unsigned char *types)
+{
+	std::streamoff offset;
+	int j;
+	int x0 = chunkX * CHUNK_SIZE, y0 = chunkY * CHUNK_SIZE;
+	int x1 = x0 + CHUNK_SIZE < Width ? x0 + CHUNK_SIZE : Width;
+	int y1 = y0 + CHUNK_SIZE < Height ? y0 + CHUNK_SIZE : Height;
+
+	if (x0 < 0 || y0 < 0 || x0 >= x1 || y0 >= y1)
+		return true;
+
+	for (int y = y0; y < y1; ++y)
+	{
+		if (!GetCellOffset(chunkX, y, &offset))
+			return false;
+
+		File.clear();
+		File.seekg(offset);
+		for (int x = x0; x < x1; ++x) {
+			File >> j;
+			if (!File || j < TYPE_OBJECT_EMPTY || j > TYPE_OBJECT_COIN)
+				return false;
+			types[(y - y0) * CHUNK_SIZE + (x - x0)] = (unsigned char)j;
+		}
+	}
+	return true;
+}
+
+//What chunks outside the level read as
+static const unsigned char	sEmptyChunk[CHUNK_CELLS] = {};
+
+/******************************************************************************/
+/*!
+
+*/
+/******************************************************************************/
+ChunkStreamer::ChunkStreamer() :
+	Source{ nullptr }, LevelWidth{ 0 }, LevelHeight{ 0 }, FailedCount{ 0 },
+	Quit{ false }, SpawnKnown{ false }, HasHeroSpawn{ false }, HeroSpawnX{ 0 }, HeroSpawnY{ 0 }
+{
+}
+
+/******************************************************************************/
+/*!
+
+*/
+/******************************************************************************/
+ChunkStreamer::~ChunkStreamer()
+{
+	Close();
+}
+
+/******************************************************************************/
+/*!
+	The hero is looked up by the thread, so the source is never used by two
+	threads at once and the parsing a level without a side index takes is
+	only waited for by GetHeroSpawn
+*/
+/******************************************************************************/
+void ChunkStreamer::Open(ChunkSource *pSource)
+{
+	Close();
+
+	Source		= pSource;
+	LevelWidth	= pSource->GetWidth();
+	LevelHeight	= pSource->GetHeight();
+	FailedCount	= 0;
+
+	Quit		= false;
+	SpawnKnown	= false;
+	Worker		= std::thread(&ChunkStreamer::WorkerMain, this);
+}
+
+/******************************************************************************/
+/*!
+
+*/
+/******************************************************************************/
+void ChunkStreamer::Close(void)
+{
+	if (!Source)
+		return;
+
+	{
+		std::lock_guard<std::mutex> guard(Lock);
+		Quit = true;
+		Queue.clear();
+	}
+	WorkAvailable.notify_one();
+	Worker.join();
+
+	for (LoadedChunk& chunk : Done)
+		delete[] chunk.types;
+	Done.clear();
+	for (auto& entry : Cache)
+		delete[] entry.second;
+	Cache.clear();
+	Pending.clear();
+
+	delete Source;
+	Source		= nullptr;
+	LevelWidth	= 0;
+	LevelHeight	= 0;
+	SpawnKnown	= false;
+	HasHeroSpawn = false;
+}
+
+/******************************************************************************/
+/*!
+
+*/
+/******************************************************************************/
+bool ChunkStreamer::GetHeroSpawn(int *pX, int *pY)
+{
+	if (!Source)
+		return false;
+
+	std::unique_lock<std::mutex> guard(Lock);
+	WorkDone.wait(guard, [this] { return SpawnKnown; });
+	if (!HasHeroSpawn)
+		return false;
+
+	*pX = HeroSpawnX;
+	*pY = HeroSpawnY;
+	return true;
+}
+
+/******************************************************************************/
+/*!
+	Nearest chunks first, so the ones needed soonest are loaded first
+*/
+/******************************************************************************/
+void ChunkStreamer::Request(int chunkX, int chunkY, int radius)
+{
+	bool queued = false;
+
+	Collect();
+
+	std::lock_guard<std::mutex> guard(Lock);
+	for (int ring = 0; ring <= radius; ++ring)
+		for (int y = chunkY - ring; y <= chunkY + ring; ++y)
+			for (int x = chunkX - ring; x <= chunkX + ring; ++x)
+			{
+				// only the outline of this ring
+				if (y != chunkY - ring && y != chunkY + ring && x != chunkX - ring && x != chunkX + ring)
+					continue;
+
+				long long key = ChunkKey(x, y);
+				if (!IsInLevel(x, y) || Cache.count(key) || Pending.count(key))
+					continue;
+				Pending.insert(key);
+				Queue.push_back(key);
+				queued = true;
+			}
+
+	if (queued)
+		WorkAvailable.notify_one();
+}
+
+/******************************************************************************/
+/*!
+
+*/
+/******************************************************************************/
+const unsigned char* ChunkStreamer::GetChunk(int chunkX, int chunkY, bool wait)
+{
+	long long key = ChunkKey(chunkX, chunkY);
+
+	if (!IsInLevel(chunkX, chunkY))
+		return sEmptyChunk;
+
+	Collect();
+	auto it = Cache.find(key);
+	if (it != Cache.end())
+		return it->second;
+	if (!wait)
+		return nullptr;
+
+	std::unique_lock<std::mutex> guard(Lock);
+	if (!Pending.count(key)) {
+		Pending.insert(key);
+		Queue.push_front(key);
+		WorkAvailable.notify_one();
+	}
+	else {
+		// needed now, move it to the front of the queue if it hasn't started
+		for (auto q = Queue.begin(); q != Queue.end(); ++q)
+			if (*q == key) {
+				Queue.erase(q);
+				Queue.push_front(key);
+				break;
+			}
+	}
+
+	for (;;)
+	{
+		CollectLocked();
+		it = Cache.find(key);
+		if (it != Cache.end())
+			return it->second;
+		WorkDone.wait(guard);
+	}
+}
+
+/******************************************************************************/
+/*!
+
+*/
+/******************************************************************************/
+void ChunkStreamer::Evict(int chunkX, int chunkY, int radius)
+{
+	for (auto it = Cache.begin(); it != Cache.end(); )
+	{
+		int x = (int)(unsigned int)(it->first & 0xFFFFFFFF);
+		int y = (int)(it->first >> 32);
+		if (abs(x - chunkX) > radius || abs(y - chunkY) > radius) {
+			delete[] it->second;
+			it = Cache.erase(it);
+		}
+		else {
+			++it;
+		}
+	}
+}
+
+/******************************************************************************/
+/*!
+
+*/
+/******************************************************************************/
+void ChunkStreamer::CollectLocked(void)
+{
+	for (LoadedChunk& chunk : Done) {
+		Pending.erase(chunk.key);
+		Cache[chunk.key] = chunk.types;
+		FailedCount += chunk.failed;
+	}
+	Done.clear();
+}
+
+/******************************************************************************/
+/*!
+
+*/
+/******************************************************************************/
+void ChunkStreamer::Collect(void)
+{
+	std::lock_guard<std::mutex> guard(Lock);
+	CollectLocked();
+}
+
+/******************************************************************************/
+/*!
+	Loading thread: looks up the hero, then takes chunks off the queue one
+	at a time. The source is read outside the lock so the game never waits
+	on a load it didn't ask to wait for. A chunk that fails comes back
+	empty, flagged.
+*/
+/******************************************************************************/
+void ChunkStreamer::WorkerMain(void)
+{
+	int x = 0, y = 0;
+	bool hasHero = Source->FindHeroSpawn(&x, &y);
+
+	std::unique_lock<std::mutex> guard(Lock);
+	HasHeroSpawn	= hasHero;
+	HeroSpawnX		= x;
+	HeroSpawnY		= y;
+	SpawnKnown		= true;
+	WorkDone.notify_all();
+
+	for (;;)
+	{
+		WorkAvailable.wait(guard, [this] { return Quit || !Queue.empty(); });
+		if (Quit)
+			return;
+
+		long long key = Queue.front();
+		Queue.pop_front();
+		guard.unlock();
+
+		unsigned char *types = new unsigned char[CHUNK_CELLS];
+		memset(types, TYPE_OBJECT_EMPTY, CHUNK_CELLS);
+		bool failed = !Source->LoadChunk((int)(unsigned int)(key & 0xFFFFFFFF), (int)(key >> 32), types);
+		if (failed)
+			memset(types, TYPE_OBJECT_EMPTY, CHUNK_CELLS);
+
+		guard.lock();
+		Done.push_back({ key, types, failed });
+		WorkDone.notify_all();
+	}
+}
@@ -0,0 +1,212 @@
+/******************************************************************************/
+/*!
+\file		ChunkStreamer.h
+\author 	DigiPen
+\par    	email: digipen\@digipen.edu
+\date   	February 01, 20xx
+\brief
+Streaming of large levels. The level is cut into CHUNK_SIZE x CHUNK_SIZE
+chunks of cell types; a ChunkSource reads single chunks from wherever the
+level is stored, and the ChunkStreamer loads them on a background thread
+and caches the ones around the part of the level in use. Only the cache
+and the source's own index are ever in memory, whatever the level size.
+
+Copyright (C) 20xx DigiPen Institute of Technology.
+Reproduction or disclosure of this file or its contents without the
+prior written consent of DigiPen Institute of Technology is prohibited.
+ */
+/******************************************************************************/
+
+#ifndef CHUNK_STREAMER_H
+#define CHUNK_STREAMER_H
+
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <fstream>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+/******************************************************************************/
+/*!
+	Defines
+*/
+/******************************************************************************/
+const int			CHUNK_SIZE				= 32;	//Cells per chunk side
+const int			CHUNK_CELLS				= CHUNK_SIZE * CHUNK_SIZE;
+
+//Side index of a text level, the level's file name with this appended
+const char			TEXT_INDEX_EXTENSION[]	= ".idx";
+const char			TEXT_INDEX_MAGIC[4]		= { 'S', 'S', 'T', 'X' };
+const uint32_t		TEXT_INDEX_VERSION		= 1;
+
+/******************************************************************************/
+/*!
+	Struct/Class Definitions
+*/
+/******************************************************************************/
+
+//Header of a text level's side index, written by TextChunkSource::WriteIndex.
+//It is followed by the file offset (int64_t) of every CHUNK_SIZE-th cell of
+//every row, row major, the same offsets the rows are indexed with.
+struct TextIndexHeader
+{
+	char			magic[4];			// TEXT_INDEX_MAGIC
+	uint32_t		version;			// TEXT_INDEX_VERSION
+	uint64_t		textSize;			// bytes in the text level, any other size means it changed
+	int32_t			width;				// cells
+	int32_t			height;
+	int32_t			heroX;				// hero spawn cell, -1 if the level has none
+	int32_t			heroY;
+};
+
+//Where a streamed level comes from. Only ever called by one thread at a time.
+class ChunkSource
+{
+public:
+	virtual ~ChunkSource() {}
+
+	//Level size in cells
+	virtual int			GetWidth(void) const = 0;
+	virtual int			GetHeight(void) const = 0;
+	//Cell of the (first) TYPE_OBJECT_HERO, false if the level has none
+	virtual bool		FindHeroSpawn(int *pX, int *pY) = 0;
+	//Fills "types" with the CHUNK_CELLS cell types of chunk (chunkX, chunkY),
+	//row major. Cells outside the level are left as they are (empty). False
+	//if the chunk can't be read.
+	virtual bool		LoadChunk(int chunkX, int chunkY, unsigned char *types) = 0;
+};
+
+//The exported "Width W Height H" text levels. Where every chunk column of a
+//row starts is indexed, so a chunk only costs parsing its own cells. With a
+//side index (WriteIndex) next to the level, the offsets and the hero spawn
+//are read from it and opening costs the same whatever the level size.
+//Without one, rows are indexed the first time they are reached, and finding
+//the hero parses every row down to it. A chunk holding a type outside
+//TYPE_OBJECT_EMPTY..TYPE_OBJECT_COIN fails to load.
+class TextChunkSource : public ChunkSource
+{
+public:
+	TextChunkSource();
+
+	//Reads the header, and the side index's if there is a current one
+	bool				Open(const char *FileName);
+	//Parses the whole level and writes its side index
+	static bool			WriteIndex(const char *FileName);
+
+	int					GetWidth(void) const override		{ return Width; }
+	int					GetHeight(void) const override		{ return Height; }
+	bool				FindHeroSpawn(int *pX, int *pY) override;
+	bool				LoadChunk(int chunkX, int chunkY, unsigned char *types) override;
+
+private:
+	bool				OpenText(const char *FileName);
+	bool				OpenIndex(const char *FileName);
+	//Makes sure the chunk column starts of row Y are known
+	bool				IndexRowsTo(int Y);
+	//Where the cell (chunkX * CHUNK_SIZE, Y) starts in the text
+	bool				GetCellOffset(int chunkX, int Y, std::streamoff *pOffset);
+
+	std::ifstream		File;
+	std::streamoff		FileSize;
+	int					Width;
+	int					Height;
+	int					ChunksX;
+	int					RowsIndexed;
+	std::streamoff		IndexEnd;		// file offset of the first row not indexed yet
+	std::vector<std::streamoff>	CellOffsets;	// file offset of every CHUNK_SIZE-th cell of the rows indexed
+
+	std::ifstream		Index;			// side index, open if it matched the level
+	TextIndexHeader		IndexHeader;
+};
+
+class ChunkStreamer
+{
+public:
+	ChunkStreamer();
+	~ChunkStreamer();
+
+	//Takes ownership of "pSource" and starts the loading thread
+	void				Open(ChunkSource *pSource);
+	void				Close(void);
+	bool				IsOpen(void) const					{ return Source != nullptr; }
+
+	int					GetLevelWidth(void) const			{ return LevelWidth; }
+	int					GetLevelHeight(void) const			{ return LevelHeight; }
+	//Looked up once by the loading thread, before any chunk. Waits for it.
+	bool				GetHeroSpawn(int *pX, int *pY);
+	//Chunks the source failed to load. They are cached as empty so they
+	//aren't asked for again, but the level is broken.
+	unsigned int		GetFailedCount(void) const			{ return FailedCount; }
+
+	//Queues every chunk within "radius" chunks of (chunkX, chunkY) that is
+	//neither cached nor already queued
+	void				Request(int chunkX, int chunkY, int radius);
+	//Cell types of a chunk, nullptr if it isn't loaded yet. With "wait" the
+	//chunk is queued if needed and the call blocks until it is loaded.
+	//Chunks outside the level are always there and empty.
+	const unsigned char*	GetChunk(int chunkX, int chunkY, bool wait);
+	//Frees the cached chunks farther than "radius" chunks from (chunkX, chunkY)
+	void				Evict(int chunkX, int chunkY, int radius);
+	unsigned int		GetCachedCount(void) const			{ return (unsigned int)Cache.size(); }
+
+private:
+	ChunkStreamer(const ChunkStreamer&) = delete;
+	ChunkStreamer& operator=(const ChunkStreamer&) = delete;
+
+	struct LoadedChunk
+	{
+		long long		key;
+		unsigned char	*types;
+		bool			failed;
+	};
+
+	void				WorkerMain(void);
+	bool				IsInLevel(int chunkX, int chunkY) const
+	{
+		return chunkX >= 0 && chunkY >= 0 &&
+			   chunkX * CHUNK_SIZE < LevelWidth && chunkY * CHUNK_SIZE < LevelHeight;
+	}
+	//Moves the finished loads into the cache, Lock must be held
+	void				CollectLocked(void);
+	void				Collect(void);
+
+	ChunkSource			*Source;
+	int					LevelWidth;
+	int					LevelHeight;
+
+	// main thread only
+	std::unordered_map<long long, unsigned char*>	Cache;
+	std::unordered_set<long long>	Pending;		// queued or loading
+	unsigned int		FailedCount;
+
+	// shared with the loading thread, under Lock
+	std::thread			Worker;
+	std::mutex			Lock;
+	std::condition_variable	WorkAvailable;
+	std::condition_variable	WorkDone;
+	std::deque<long long>	Queue;
+	std::vector<LoadedChunk>	Done;
+	bool				Quit;
+	bool				SpawnKnown;
+	bool				HasHeroSpawn;
+	int					HeroSpawnX;
+	int					HeroSpawnY;
+};
+
+//Chunk a level cell is in, rounding down for negative cells
+inline int ChunkOfCell(int cell)
+{
+	return cell >= 0 ? cell / CHUNK_SIZE : (cell - CHUNK_SIZE + 1) / CHUNK_SIZE;
+}
+
+//Key of a chunk in hash maps
+inline long long ChunkKey(int chunkX, int chunkY)
+{
+	return (long long)(((unsigned long long)(unsigned int)chunkY << 32) | (unsigned int)chunkX);
+}
+
+#endif // CHUNK_STREAMER_H
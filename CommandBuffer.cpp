@@ -0,0 +1,102 @@
+/******************************************************************************/
+/*!
+\file		CommandBuffer.cpp
+\author 	DigiPen
+\par    	email: digipen\@digipen.edu
+\date   	February 01, 20xx
+\brief
+Deferred structural changes. See CommandBuffer.h.
+
+Copyright (C) 20xx DigiPen Institute of Technology.
+Reproduction or disclosure of this file or its contents without the
+prior written consent of DigiPen Institute of Technology is prohibited.
+ */
+/******************************************************************************/
+
+#include "CommandBuffer.h"
+#include <algorithm>
+
+/******************************************************************************/
+/*!
+
+*/
+/******************************************************************************/
+WorldCommand& CommandBuffer::Record(unsigned long long key, WORLD_COMMAND command)
+{
+	WorldCommand record{};
+	record.key		= key;
+	record.command	= command;
+	record.target	= INVALID_HANDLE;
+	record.state	= STATE_NONE;
+	Commands.push_back(record);
+	return Commands.back();
+}
+
+/******************************************************************************/
+/*!
+
+*/
+/******************************************************************************/
+void CommandBuffer::Spawn(unsigned long long key, unsigned int objType, float scale,
+						  const SimVec2& pos, const SimVec2& vel, float dir, enum STATE state)
+{
+	WorldCommand& record = Record(key, WORLD_COMMAND_SPAWN);
+	record.objType	= objType;
+	record.scale	= scale;
+	record.pos		= pos;
+	record.vel		= vel;
+	record.dir		= dir;
+	record.state	= state;
+}
+
+/******************************************************************************/
+/*!
+
+*/
+/******************************************************************************/
+void CommandBuffer::Destroy(unsigned long long key, GameObjHandle target)
+{
+	Record(key, WORLD_COMMAND_DESTROY).target = target;
+}
+
+/******************************************************************************/
+/*!
+
+*/
+/******************************************************************************/
+void CommandBuffer::Damage(unsigned long long key, GameObjHandle target, int amount)
+{
+	WorldCommand& record = Record(key, WORLD_COMMAND_DAMAGE);
+	record.target	= target;
+	record.amount	= amount;
+}
+
+/******************************************************************************/
+/*!
+
+*/
+/******************************************************************************/
+void CommandBuffer::Teleport(unsigned long long key, GameObjHandle target, const SimVec2& pos)
+{
+	WorldCommand& record = Record(key, WORLD_COMMAND_TELEPORT);
+	record.target	= target;
+	record.pos		= pos;
+}
+
+/******************************************************************************/
+/*!
+	Each buffer is in recording order, not key order, so the whole lot is
+	sorted; there are only ever a handful of commands per step
+*/
+/******************************************************************************/
+void MergeCommandBuffers(const CommandBuffer *buffers, unsigned int count,
+						 std::vector<WorldCommand> *pOut)
+{
+	pOut->clear();
+	for (unsigned int b = 0; b < count; ++b)
+		pOut->insert(pOut->end(), buffers[b].GetCommands().begin(), buffers[b].GetCommands().end());
+
+	std::stable_sort(pOut->begin(), pOut->end(), [](const WorldCommand& a, const WorldCommand& b) {
+		return a.key < b.key;
+	});
+}
@@ -0,0 +1,81 @@
+/******************************************************************************/
+/*!
+\file		CommandBuffer.h
+\author 	DigiPen
+\par    	email: digipen\@digipen.edu
+\date   	February 01, 20xx
+\brief
+Deferred structural changes. While a step's parallel phases run, nothing
+is spawned, destroyed, damaged or moved in place: each thread records
+commands in its own buffer instead. At the sync point the buffers are
+merged, sorted by the key every command was recorded with, and the world
+applies them in that order, so the outcome depends neither on the
+thread count nor on which thread saw what.
+
+Copyright (C) 20xx DigiPen Institute of Technology.
+Reproduction or disclosure of this file or its contents without the
+prior written consent of DigiPen Institute of Technology is prohibited.
+ */
+/******************************************************************************/
+
+#ifndef COMMAND_BUFFER_H
+#define COMMAND_BUFFER_H
+
+#include "PlatformTypes.h"
+#include "EntityTable.h"
+#include <vector>
+
+/******************************************************************************/
+/*!
+	Struct/Class Definitions
+*/
+/******************************************************************************/
+enum WORLD_COMMAND
+{
+	WORLD_COMMAND_SPAWN,
+	WORLD_COMMAND_DESTROY,
+	WORLD_COMMAND_DAMAGE,
+	WORLD_COMMAND_TELEPORT
+};
+
+struct WorldCommand
+{
+	unsigned long long	key;		// sort key, unique within a step
+	WORLD_COMMAND		command;
+	GameObjHandle		target;		// DESTROY, DAMAGE, TELEPORT
+	unsigned int		objType;	// SPAWN
+	float				scale;		// SPAWN
+	float				dir;		// SPAWN
+	enum STATE			state;		// SPAWN
+	SimVec2				pos;		// SPAWN, TELEPORT
+	SimVec2				vel;		// SPAWN
+	int					amount;		// DAMAGE
+};
+
+class CommandBuffer
+{
+public:
+	//"key" decides the order commands are applied in. Keys are expected to
+	//be unique within a step (a row, a pair index...): commands with the
+	//same key are applied in an unspecified order.
+	void				Spawn(unsigned long long key, unsigned int objType, float scale,
+							  const SimVec2& pos, const SimVec2& vel, float dir, enum STATE state);
+	void				Destroy(unsigned long long key, GameObjHandle target);
+	void				Damage(unsigned long long key, GameObjHandle target, int amount);
+	void				Teleport(unsigned long long key, GameObjHandle target, const SimVec2& pos);
+
+	void				Clear(void)		{ Commands.clear(); }
+	bool				IsEmpty(void) const	{ return Commands.empty(); }
+	const std::vector<WorldCommand>&	GetCommands(void) const	{ return Commands; }
+
+private:
+	WorldCommand&		Record(unsigned long long key, WORLD_COMMAND command);
+
+	std::vector<WorldCommand>	Commands;
+};
+
+//The commands of "count" buffers in key order, in "pOut"
+void					MergeCommandBuffers(const CommandBuffer *buffers, unsigned int count,
+											std::vector<WorldCommand> *pOut);
+
+#endif // COMMAND_BUFFER_H
@@ -0,0 +1,207 @@
+/******************************************************************************/
+/*!
+\file		EnemyAI.cpp
+\author 	DigiPen
+\par    	email: digipen\@digipen.edu
+\date   	February 01, 20xx
+\brief
+Table driven enemy state machine. See EnemyAI.h.
+
+Copyright (C) 20xx DigiPen Institute of Technology.
+Reproduction or disclosure of this file or its contents without the
+prior written consent of DigiPen Institute of Technology is prohibited.
+ */
+/******************************************************************************/
+
+#include "EnemyAI.h"
+
+//Rows bucketed at a time
+static const unsigned int	AI_BATCH_SIZE = 256;
+
+/******************************************************************************/
+/*!
+	What going left and going right don't share. DIR is the sign of the
+	walking velocity.
+*/
+/******************************************************************************/
+template <int DIR>
+struct PatrolDirection;
+
+template <>
+struct PatrolDirection<-1>
+{
+	static STATE		State(void)			{ return STATE_GOING_LEFT; }
+	static STATE		Opposite(void)		{ return STATE_GOING_RIGHT; }
+	static unsigned int	Wall(void)			{ return COLLISION_LEFT; }
+
+	//In the half of the cell next to the ledge
+	static bool			NearEdge(float fraction)	{ return fraction <= 0.5f; }
+};
+
+template <>
+struct PatrolDirection<1>
+{
+	static STATE		State(void)			{ return STATE_GOING_RIGHT; }
+	static STATE		Opposite(void)		{ return STATE_GOING_LEFT; }
+	static unsigned int	Wall(void)			{ return COLLISION_RIGHT; }
+
+	static bool			NearEdge(float fraction)	{ return fraction >= 0.5f; }
+};
+
+/******************************************************************************/
+/*!
+	Patrol: walk one way until a wall or a ledge, idle, turn around
+*/
+/******************************************************************************/
+template <int DIR>
+struct Patrol
+{
+	typedef PatrolDirection<DIR> Direction;
+
+	static void Enter(EntityTable& t, const EnemyAIContext&, const unsigned int *rows, unsigned int count, float)
+	{
+		for (unsigned int k = 0; k < count; ++k)
+		{
+			unsigned int i = rows[k];
+			t.velX[i]		= DIR * MOVE_VELOCITY_ENEMY;
+			t.innerState[i]	= INNER_STATE_ON_UPDATE;
+		}
+	}
+
+	//The ledge cell is always read, which is cheaper than branching on
+	//whether the enemy is close enough for it to matter. Seeing the hero
+	//wins over stopping.
+	static void Walk(EntityTable& t, const EnemyAIContext& ctx, const unsigned int *rows, unsigned int count, float)
+	{
+		for (unsigned int k = 0; k < count; ++k)
+		{
+			unsigned int i = rows[k];
+			int cellX = (int)t.posX[i];
+			bool ledge = Direction::NearEdge(t.posX[i] - cellX) &
+						 !CollisionGridCell(*ctx.grid, cellX + DIR, (int)t.posY[i] - 1);
+			bool stop = ((t.gridCollisionFlag[i] & Direction::Wall()) != 0) | ledge;
+			bool chase = IsInChaseRange(ctx, t.posX[i], t.posY[i]);
+
+			t.state[i]		= chase ? STATE_CHASE : Direction::State();
+			t.counter[i]	= stop ? ENEMY_IDLE_TIME : t.counter[i];
+			t.innerState[i]	= chase ? INNER_STATE_ON_ENTER : stop ? INNER_STATE_ON_EXIT : INNER_STATE_ON_UPDATE;
+			t.velX[i]		= stop ? 0.0f : t.velX[i];
+		}
+	}
+
+	static void Idle(EntityTable& t, const EnemyAIContext&, const unsigned int *rows, unsigned int count, float dt)
+	{
+		for (unsigned int k = 0; k < count; ++k)
+		{
+			unsigned int i = rows[k];
+			t.counter[i] -= dt;
+			bool turn = t.counter[i] < 0.0;
+
+			t.state[i]		= turn ? Direction::Opposite() : Direction::State();
+			t.innerState[i]	= turn ? INNER_STATE_ON_ENTER : INNER_STATE_ON_EXIT;
+		}
+	}
+};
+
+/******************************************************************************/
+/*!
+	Chase: walk to the waypoint the planner left in targetX, then plan
+	again. So does a chaser stuck against a wall, once its replan time is
+	out.
+*/
+/******************************************************************************/
+static void ChaseFollow(EntityTable& t, const EnemyAIContext&, const unsigned int *rows, unsigned int count, float dt)
+{
+	for (unsigned int k = 0; k < count; ++k)
+	{
+		unsigned int i = rows[k];
+		float dx = t.targetX[i] - t.posX[i];
+		bool arrived = fabsf(dx) <= ENEMY_CHASE_VELOCITY * dt;
+		t.counter[i] -= dt;
+		bool replan = arrived | (t.counter[i] < 0.0);
+
+		t.velX[i]		= arrived ? 0.0f : dx < 0.0f ? -ENEMY_CHASE_VELOCITY : ENEMY_CHASE_VELOCITY;
+		t.innerState[i]	= replan ? INNER_STATE_ON_ENTER : INNER_STATE_ON_UPDATE;
+	}
+}
+
+/******************************************************************************/
+/*!
+	Behaviour table
+*/
+/******************************************************************************/
+const EnemyBehaviour ENEMY_BEHAVIOUR_TABLE[] =
+{
+	//state				innerState				update
+	{ STATE_GOING_LEFT,		INNER_STATE_ON_ENTER,	&Patrol<-1>::Enter },
+	{ STATE_GOING_LEFT,		INNER_STATE_ON_UPDATE,	&Patrol<-1>::Walk },
+	{ STATE_GOING_LEFT,		INNER_STATE_ON_EXIT,	&Patrol<-1>::Idle },
+	{ STATE_GOING_RIGHT,	INNER_STATE_ON_ENTER,	&Patrol<1>::Enter },
+	{ STATE_GOING_RIGHT,	INNER_STATE_ON_UPDATE,	&Patrol<1>::Walk },
+	{ STATE_GOING_RIGHT,	INNER_STATE_ON_EXIT,	&Patrol<1>::Idle },
+	{ STATE_CHASE,			INNER_STATE_ON_UPDATE,	&ChaseFollow },
+};
+
+const unsigned int ENEMY_BEHAVIOUR_NUM = sizeof(ENEMY_BEHAVIOUR_TABLE) / sizeof(ENEMY_BEHAVIOUR_TABLE[0]);
+
+/******************************************************************************/
+/*!
+	(state, inner state) -> update, nullptr where there's nothing to do
+*/
+/******************************************************************************/
+struct BehaviourLookup
+{
+	EnemyBatchUpdate	update[AI_STATE_NUM][AI_INNER_STATE_NUM];
+
+	BehaviourLookup() : update{}
+	{
+		for (unsigned int b = 0; b < ENEMY_BEHAVIOUR_NUM; ++b)
+			update[ENEMY_BEHAVIOUR_TABLE[b].state][ENEMY_BEHAVIOUR_TABLE[b].innerState] = ENEMY_BEHAVIOUR_TABLE[b].update;
+	}
+};
+
+/******************************************************************************/
+/*!
+	Every row only touches its own columns, so the buckets can run in any
+	order. Rows in a state the table doesn't know (STATE_NONE) are left
+	alone, like the switch did.
+*/
+/******************************************************************************/
+void UpdateEnemyAI(EntityTable& t, const EnemyAIContext& ctx,
+				   unsigned int begin, unsigned int end, float dt)
+{
+	const unsigned int buckets = AI_STATE_NUM * AI_INNER_STATE_NUM;
+	static const BehaviourLookup sLookup;
+
+	unsigned int bucketOf[AI_BATCH_SIZE];
+	unsigned int rows[AI_BATCH_SIZE];
+
+	for (unsigned int first = begin; first < end; first += AI_BATCH_SIZE)
+	{
+		unsigned int last = end - first < AI_BATCH_SIZE ? end : first + AI_BATCH_SIZE;
+		unsigned int start[buckets + 1] = { 0 };
+
+		for (unsigned int i = first; i < last; ++i)
+		{
+			unsigned int state = (unsigned int)t.state[i] < AI_STATE_NUM ? (unsigned int)t.state[i] : (unsigned int)STATE_NONE;
+			unsigned int inner = (unsigned int)t.innerState[i] < AI_INNER_STATE_NUM ? (unsigned int)t.innerState[i] : 0;
+			bucketOf[i - first] = state * AI_INNER_STATE_NUM + inner;
+			++start[bucketOf[i - first] + 1];
+		}
+		for (unsigned int b = 0; b < buckets; ++b)
+			start[b + 1] += start[b];
+
+		unsigned int next[buckets];
+		for (unsigned int b = 0; b < buckets; ++b)
+			next[b] = start[b];
+		for (unsigned int i = first; i < last; ++i)
+			rows[next[bucketOf[i - first]]++] = i;
+
+		for (unsigned int b = 0; b < buckets; ++b)
+		{
+			EnemyBatchUpdate update = sLookup.update[b / AI_INNER_STATE_NUM][b % AI_INNER_STATE_NUM];
+			if (update && start[b + 1] > start[b])
+				update(t, ctx, rows + start[b], start[b + 1] - start[b], dt);
+		}
+	}
+}
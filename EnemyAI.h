@@ -0,0 +1,87 @@
+/******************************************************************************/
+/*!
+\file		EnemyAI.h
+\author 	DigiPen
+\par    	email: digipen\@digipen.edu
+\date   	February 01, 20xx
+\brief
+Table driven enemy state machine. Every (STATE, INNER_STATE) pair has an
+entry in ENEMY_BEHAVIOUR_TABLE: a batch update that runs on all the
+enemies currently in that state. A range of rows is first bucketed by
+state with a counting sort, then each bucket goes through its entry in
+one tight loop with no per row branching on the state.
+
+The patrol states are one template specialized by direction at compile
+time (going left and going right only differ by signs). A new behaviour
+is a new STATE, its batch updates and their rows in the table; the core
+loop in UpdateEnemyAI doesn't change.
+
+STATE_CHASE is entered by a walking enemy that gets near the hero. Its
+enter step is not in the table: PlatformWorld plans it on the main
+thread with a path query (PathService isn't thread safe) and leaves the
+next waypoint in targetX. The update then walks there and goes back to
+the enter step on arrival, or after ENEMY_CHASE_REPLAN_TIME.
+
+Copyright (C) 20xx DigiPen Institute of Technology.
+Reproduction or disclosure of this file or its contents without the
+prior written consent of DigiPen Institute of Technology is prohibited.
+ */
+/******************************************************************************/
+
+#ifndef ENEMY_AI_H
+#define ENEMY_AI_H
+
+#include "PlatformTypes.h"
+#include "EntityTable.h"
+#include "SimKernels.h"
+#include <cmath>
+
+/******************************************************************************/
+/*!
+	Defines
+*/
+/******************************************************************************/
+const unsigned int	AI_STATE_NUM			= STATE_CHASE + 1;
+const unsigned int	AI_INNER_STATE_NUM		= INNER_STATE_ON_EXIT + 1;
+
+/******************************************************************************/
+/*!
+	Struct/Class Definitions
+*/
+/******************************************************************************/
+//What the state machine reads besides the enemies' own rows
+struct EnemyAIContext
+{
+	const CollisionGrid*	grid;
+	bool					hasTarget;		// the hero is alive
+	float					targetX, targetY;	// where it was at the start of the step
+};
+
+//Updates the enemies at "rows" (all in the same state) of table "t"
+typedef void		(*EnemyBatchUpdate)(EntityTable& t, const EnemyAIContext& ctx,
+										const unsigned int *rows, unsigned int count, float dt);
+
+struct EnemyBehaviour
+{
+	enum STATE			state;
+	enum INNER_STATE	innerState;
+	EnemyBatchUpdate	update;
+};
+
+//One entry per (state, inner state) that does something
+extern const EnemyBehaviour	ENEMY_BEHAVIOUR_TABLE[];
+extern const unsigned int	ENEMY_BEHAVIOUR_NUM;
+
+//Runs the state machine on rows [begin, end) of "t". Same results, bit for
+//bit, as PlatformWorld::EnemyStateMachine on each row.
+void				UpdateEnemyAI(EntityTable& t, const EnemyAIContext& ctx,
+								  unsigned int begin, unsigned int end, float dt);
+
+//True if an enemy at (x, y) is close enough to "ctx"'s target to chase it
+inline bool			IsInChaseRange(const EnemyAIContext& ctx, float x, float y)
+{
+	return ctx.hasTarget & (fabsf(ctx.targetX - x) <= ENEMY_CHASE_RANGE_X) &
+		   (fabsf(ctx.targetY - y) <= ENEMY_CHASE_RANGE_Y);
+}
+
+#endif // ENEMY_AI_H
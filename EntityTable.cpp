@@ -0,0 +1,519 @@
+/******************************************************************************/
+/*!
+\file		EntityTable.cpp
+\author 	DigiPen
+\par    	email: digipen\@digipen.edu
+\date   	February 01, 20xx
+\brief
+Structure of arrays storage for game object instances. See EntityTable.h.
+
+Copyright (C) 20xx DigiPen Institute of Technology.
+Reproduction or disclosure of this file or its contents without the
+prior written consent of DigiPen Institute of Technology is prohibited.
+ */
+/******************************************************************************/
+
+#include "EntityTable.h"
+#include <cstring>
+
+/******************************************************************************/
+/*!
+
+*/
+/******************************************************************************/
+EntityTable::EntityTable() :
+	type{ 0 }, count{ 0 }, capacity{ 0 },
+	posX{ nullptr }, posY{ nullptr }, posPrevX{ nullptr }, posPrevY{ nullptr },
+	velX{ nullptr }, velY{ nullptr }, scale{ nullptr }, dirCurr{ nullptr },
+	minX{ nullptr }, minY{ nullptr }, maxX{ nullptr }, maxY{ nullptr },
+	gridCollisionFlag{ nullptr }, flag{ nullptr },
+	state{ nullptr }, innerState{ nullptr }, counter{ nullptr }, targetX{ nullptr },
+	transform{ nullptr },
+	softCap{ GAME_OBJ_INST_NUM_MAX }, stats{ 0, 0, 0 }
+{
+}
+
+/******************************************************************************/
+/*!
+
+*/
+/******************************************************************************/
+EntityTable::~EntityTable()
+{
+	Destroy();
+}
+
+/******************************************************************************/
+/*!
+
+*/
+/******************************************************************************/
+void EntityTable::Create(unsigned int objType, unsigned int initialCount)
+{
+	Destroy();
+
+	type				= objType;
+	capacity			= initialCount;
+	count				= 0;
+	stats				= EntityTableStats{ 0, 0, 0 };
+
+	posX				= new float[initialCount];
+	posY				= new float[initialCount];
+	posPrevX			= new float[initialCount];
+	posPrevY			= new float[initialCount];
+	velX				= new float[initialCount];
+	velY				= new float[initialCount];
+	scale				= new float[initialCount];
+	dirCurr				= new float[initialCount];
+	minX				= new float[initialCount];
+	minY				= new float[initialCount];
+	maxX				= new float[initialCount];
+	maxY				= new float[initialCount];
+	gridCollisionFlag	= new int[initialCount];
+	flag				= new unsigned int[initialCount];
+	state				= new enum STATE[initialCount];
+	innerState			= new enum INNER_STATE[initialCount];
+	counter				= new double[initialCount];
+	targetX				= new float[initialCount];
+	transform			= new SimMtx33[initialCount];
+
+	pool.Create(initialCount);
+}
+
+/******************************************************************************/
+/*!
+
+*/
+/******************************************************************************/
+void EntityTable::Destroy(void)
+{
+	delete[] posX;				posX = nullptr;
+	delete[] posY;				posY = nullptr;
+	delete[] posPrevX;			posPrevX = nullptr;
+	delete[] posPrevY;			posPrevY = nullptr;
+	delete[] velX;				velX = nullptr;
+	delete[] velY;				velY = nullptr;
+	delete[] scale;				scale = nullptr;
+	delete[] dirCurr;			dirCurr = nullptr;
+	delete[] minX;				minX = nullptr;
+	delete[] minY;				minY = nullptr;
+	delete[] maxX;				maxX = nullptr;
+	delete[] maxY;				maxY = nullptr;
+	delete[] gridCollisionFlag;	gridCollisionFlag = nullptr;
+	delete[] flag;				flag = nullptr;
+	delete[] state;				state = nullptr;
+	delete[] innerState;		innerState = nullptr;
+	delete[] counter;			counter = nullptr;
+	delete[] targetX;			targetX = nullptr;
+	delete[] transform;			transform = nullptr;
+
+	pool.Destroy();
+	count		= 0;
+	capacity	= 0;
+}
+
+/******************************************************************************/
+/*!
+	Only the live rows are copied
+*/
+/******************************************************************************/
+void EntityTable::CopyFrom(const EntityTable& rhs)
+{
+	if (capacity != rhs.capacity)
+		Create(rhs.type, rhs.capacity);
+
+	type	= rhs.type;
+	count	= rhs.count;
+	softCap	= rhs.softCap;
+	stats	= rhs.stats;
+
+	unsigned int n = rhs.count;
+	memcpy(posX,				rhs.posX,				n * sizeof(*posX));
+	memcpy(posY,				rhs.posY,				n * sizeof(*posY));
+	memcpy(posPrevX,			rhs.posPrevX,			n * sizeof(*posPrevX));
+	memcpy(posPrevY,			rhs.posPrevY,			n * sizeof(*posPrevY));
+	memcpy(velX,				rhs.velX,				n * sizeof(*velX));
+	memcpy(velY,				rhs.velY,				n * sizeof(*velY));
+	memcpy(scale,				rhs.scale,				n * sizeof(*scale));
+	memcpy(dirCurr,				rhs.dirCurr,			n * sizeof(*dirCurr));
+	memcpy(minX,				rhs.minX,				n * sizeof(*minX));
+	memcpy(minY,				rhs.minY,				n * sizeof(*minY));
+	memcpy(maxX,				rhs.maxX,				n * sizeof(*maxX));
+	memcpy(maxY,				rhs.maxY,				n * sizeof(*maxY));
+	memcpy(gridCollisionFlag,	rhs.gridCollisionFlag,	n * sizeof(*gridCollisionFlag));
+	memcpy(flag,				rhs.flag,				n * sizeof(*flag));
+	memcpy(state,				rhs.state,				n * sizeof(*state));
+	memcpy(innerState,			rhs.innerState,			n * sizeof(*innerState));
+	memcpy(counter,				rhs.counter,			n * sizeof(*counter));
+	memcpy(targetX,				rhs.targetX,			n * sizeof(*targetX));
+	memcpy(transform,			rhs.transform,			n * sizeof(*transform));
+
+	pool.CopyFrom(rhs.pool);
+}
+
+/******************************************************************************/
+/*!
+
+*/
+/******************************************************************************/
+bool EntityTable::IsIdentical(const EntityTable& rhs) const
+{
+	if (type != rhs.type || count != rhs.count)
+		return false;
+
+	unsigned int n = count;
+	return 0 == memcmp(posX,				rhs.posX,				n * sizeof(*posX))
+		&& 0 == memcmp(posY,				rhs.posY,				n * sizeof(*posY))
+		&& 0 == memcmp(posPrevX,			rhs.posPrevX,			n * sizeof(*posPrevX))
+		&& 0 == memcmp(posPrevY,			rhs.posPrevY,			n * sizeof(*posPrevY))
+		&& 0 == memcmp(velX,				rhs.velX,				n * sizeof(*velX))
+		&& 0 == memcmp(velY,				rhs.velY,				n * sizeof(*velY))
+		&& 0 == memcmp(scale,				rhs.scale,				n * sizeof(*scale))
+		&& 0 == memcmp(dirCurr,				rhs.dirCurr,			n * sizeof(*dirCurr))
+		&& 0 == memcmp(minX,				rhs.minX,				n * sizeof(*minX))
+		&& 0 == memcmp(minY,				rhs.minY,				n * sizeof(*minY))
+		&& 0 == memcmp(maxX,				rhs.maxX,				n * sizeof(*maxX))
+		&& 0 == memcmp(maxY,				rhs.maxY,				n * sizeof(*maxY))
+		&& 0 == memcmp(gridCollisionFlag,	rhs.gridCollisionFlag,	n * sizeof(*gridCollisionFlag))
+		&& 0 == memcmp(flag,				rhs.flag,				n * sizeof(*flag))
+		&& 0 == memcmp(state,				rhs.state,				n * sizeof(*state))
+		&& 0 == memcmp(innerState,			rhs.innerState,			n * sizeof(*innerState))
+		&& 0 == memcmp(counter,				rhs.counter,			n * sizeof(*counter))
+		&& 0 == memcmp(targetX,				rhs.targetX,			n * sizeof(*targetX))
+		&& 0 == memcmp(transform,			rhs.transform,			n * sizeof(*transform))
+		&& pool.IsIdentical(rhs.pool);
+}
+
+/******************************************************************************/
+/*!
+	The rows' columns one after the other, then the handle of every row
+	(which covers the pool as far as the simulation can tell). Columns are
+	hashed 64 bits at a time on four lanes, so the multiplies of one lane
+	don't wait on the others, and the lanes are folded at the end.
+*/
+/******************************************************************************/
+static const uint64_t	HASH_MULTIPLIER = 0x9E3779B97F4A7C15ull;
+
+static uint64_t HashMix(uint64_t hash, uint64_t word)
+{
+	hash = (hash ^ word) * HASH_MULTIPLIER;
+	return hash ^ (hash >> 32);
+}
+
+static uint64_t HashBytes(const void *data, size_t size, uint64_t hash)
+{
+	const unsigned char *bytes = (const unsigned char *)data;
+	uint64_t lane[4] = { hash, hash + HASH_MULTIPLIER, hash - HASH_MULTIPLIER, ~hash };
+	uint64_t word[4];
+	size_t i = 0;
+
+	for (; i + sizeof(word) <= size; i += sizeof(word))
+	{
+		memcpy(word, bytes + i, sizeof(word));
+		lane[0] = HashMix(lane[0], word[0]);
+		lane[1] = HashMix(lane[1], word[1]);
+		lane[2] = HashMix(lane[2], word[2]);
+		lane[3] = HashMix(lane[3], word[3]);
+	}
+	for (; i + sizeof(uint64_t) <= size; i += sizeof(uint64_t))
+	{
+		memcpy(word, bytes + i, sizeof(uint64_t));
+		lane[0] = HashMix(lane[0], word[0]);
+	}
+	if (i < size) {
+		word[0] = 0;
+		memcpy(word, bytes + i, size - i);
+		lane[1] = HashMix(lane[1], word[0]);
+	}
+
+	hash = HashMix(lane[0], lane[1]);
+	hash = HashMix(hash, lane[2]);
+	hash = HashMix(hash, lane[3]);
+	return HashMix(hash, size);
+}
+
+uint64_t EntityTable::Hash(uint64_t hash) const
+{
+	unsigned int n = count;
+	hash = HashBytes(&type,				sizeof(type),						hash);
+	hash = HashBytes(&count,			sizeof(count),						hash);
+	hash = HashBytes(posX,				n * sizeof(*posX),					hash);
+	hash = HashBytes(posY,				n * sizeof(*posY),					hash);
+	hash = HashBytes(posPrevX,			n * sizeof(*posPrevX),				hash);
+	hash = HashBytes(posPrevY,			n * sizeof(*posPrevY),				hash);
+	hash = HashBytes(velX,				n * sizeof(*velX),					hash);
+	hash = HashBytes(velY,				n * sizeof(*velY),					hash);
+	hash = HashBytes(scale,				n * sizeof(*scale),					hash);
+	hash = HashBytes(dirCurr,			n * sizeof(*dirCurr),				hash);
+	hash = HashBytes(minX,				n * sizeof(*minX),					hash);
+	hash = HashBytes(minY,				n * sizeof(*minY),					hash);
+	hash = HashBytes(maxX,				n * sizeof(*maxX),					hash);
+	hash = HashBytes(maxY,				n * sizeof(*maxY),					hash);
+	hash = HashBytes(gridCollisionFlag,	n * sizeof(*gridCollisionFlag),		hash);
+	hash = HashBytes(flag,				n * sizeof(*flag),					hash);
+	hash = HashBytes(state,				n * sizeof(*state),					hash);
+	hash = HashBytes(innerState,		n * sizeof(*innerState),			hash);
+	hash = HashBytes(counter,			n * sizeof(*counter),				hash);
+	hash = HashBytes(targetX,			n * sizeof(*targetX),				hash);
+	hash = HashBytes(transform,			n * sizeof(*transform),				hash);
+	for (unsigned int row = 0; row < n; ++row)
+	{
+		GameObjHandle handle = GetHandle(row);
+		hash = HashMix(hash, (uint64_t)handle.generation << 32 | handle.index);
+	}
+	return hash;
+}
+
+/******************************************************************************/
+/*!
+	The header, then each column's live rows, then the pool
+*/
+/******************************************************************************/
+void EntityTable::SaveState(SnapshotWriter& out) const
+{
+	unsigned int n = count;
+	out.Write(type);
+	out.Write(count);
+	out.Write(pool.GetTouched());
+	out.Write(posX,					n * sizeof(*posX));
+	out.Write(posY,					n * sizeof(*posY));
+	out.Write(posPrevX,				n * sizeof(*posPrevX));
+	out.Write(posPrevY,				n * sizeof(*posPrevY));
+	out.Write(velX,					n * sizeof(*velX));
+	out.Write(velY,					n * sizeof(*velY));
+	out.Write(scale,				n * sizeof(*scale));
+	out.Write(dirCurr,				n * sizeof(*dirCurr));
+	out.Write(minX,					n * sizeof(*minX));
+	out.Write(minY,					n * sizeof(*minY));
+	out.Write(maxX,					n * sizeof(*maxX));
+	out.Write(maxY,					n * sizeof(*maxY));
+	out.Write(gridCollisionFlag,	n * sizeof(*gridCollisionFlag));
+	out.Write(flag,					n * sizeof(*flag));
+	out.Write(state,				n * sizeof(*state));
+	out.Write(innerState,			n * sizeof(*innerState));
+	out.Write(counter,				n * sizeof(*counter));
+	out.Write(targetX,				n * sizeof(*targetX));
+	out.Write(transform,			n * sizeof(*transform));
+	pool.SaveState(out);
+}
+
+/******************************************************************************/
+/*!
+	The table may have grown or been smaller when saved, it only needs room
+	for every pool slot the save had touched
+*/
+/******************************************************************************/
+bool EntityTable::RestoreState(SnapshotReader& in)
+{
+	unsigned int savedType, n, touched;
+	if (!in.Read(&savedType) || !in.Read(&n) || !in.Read(&touched) ||
+		savedType != type || n > touched)
+		return false;
+	Reserve(touched);
+
+	count = n;
+	return in.Read(posX,				n * sizeof(*posX))
+		&& in.Read(posY,				n * sizeof(*posY))
+		&& in.Read(posPrevX,			n * sizeof(*posPrevX))
+		&& in.Read(posPrevY,			n * sizeof(*posPrevY))
+		&& in.Read(velX,				n * sizeof(*velX))
+		&& in.Read(velY,				n * sizeof(*velY))
+		&& in.Read(scale,				n * sizeof(*scale))
+		&& in.Read(dirCurr,				n * sizeof(*dirCurr))
+		&& in.Read(minX,				n * sizeof(*minX))
+		&& in.Read(minY,				n * sizeof(*minY))
+		&& in.Read(maxX,				n * sizeof(*maxX))
+		&& in.Read(maxY,				n * sizeof(*maxY))
+		&& in.Read(gridCollisionFlag,	n * sizeof(*gridCollisionFlag))
+		&& in.Read(flag,				n * sizeof(*flag))
+		&& in.Read(state,				n * sizeof(*state))
+		&& in.Read(innerState,			n * sizeof(*innerState))
+		&& in.Read(counter,				n * sizeof(*counter))
+		&& in.Read(targetX,				n * sizeof(*targetX))
+		&& in.Read(transform,			n * sizeof(*transform))
+		&& pool.RestoreState(in) && pool.GetLiveCount() == n;
+}
+
+/******************************************************************************/
+/*!
+
+*/
+/******************************************************************************/
+GameObjHandle EntityTable::Add(float scl, const SimVec2& pos, const SimVec2& vel,
+							   float dir, enum STATE startState)
+{
+	if (count == capacity)
+		Reserve(capacity < ENTITY_TABLE_MIN_GROWTH ? ENTITY_TABLE_MIN_GROWTH : capacity * 2);
+	if (count >= softCap)
+		++stats.overSoftCap;
+
+	unsigned int index = pool.Allocate();
+	if (index == POOL_INVALID_INDEX)
+		return INVALID_HANDLE;
+
+	unsigned int row		= count++;
+	if (count > stats.peakCount)
+		stats.peakCount		= count;
+	posX[row]				= pos.x;
+	posY[row]				= pos.y;
+	posPrevX[row]			= pos.x;
+	posPrevY[row]			= pos.y;
+	velX[row]				= vel.x;
+	velY[row]				= vel.y;
+	scale[row]				= scl;
+	dirCurr[row]			= dir;
+	minX[row]				= pos.x - BOUNDING_RECT_SIZE * scl;
+	minY[row]				= pos.y - BOUNDING_RECT_SIZE * scl;
+	maxX[row]				= pos.x + BOUNDING_RECT_SIZE * scl;
+	maxY[row]				= pos.y + BOUNDING_RECT_SIZE * scl;
+	gridCollisionFlag[row]	= 0;
+	flag[row]				= FLAG_ACTIVE | FLAG_VISIBLE;
+	state[row]				= startState;
+	innerState[row]			= INNER_STATE_ON_ENTER;
+	counter[row]			= 0;
+	targetX[row]			= 0;
+	SimMtx33Trans(transform + row, pos.x, pos.y);
+
+	return { type, index, pool.GetGeneration(index) };
+}
+
+/******************************************************************************/
+/*!
+	Every column is moved to a new array of "rows" entries, live rows only
+*/
+/******************************************************************************/
+template <typename T>
+static void GrowColumn(T*& column, unsigned int count, unsigned int rows)
+{
+	T *grown = new T[rows];
+	if (count)
+		memcpy(grown, column, count * sizeof(T));
+	delete[] column;
+	column = grown;
+}
+
+void EntityTable::Reserve(unsigned int rows)
+{
+	if (rows <= capacity)
+		return;
+
+	unsigned int n = count;
+	GrowColumn(posX,				n, rows);
+	GrowColumn(posY,				n, rows);
+	GrowColumn(posPrevX,			n, rows);
+	GrowColumn(posPrevY,			n, rows);
+	GrowColumn(velX,				n, rows);
+	GrowColumn(velY,				n, rows);
+	GrowColumn(scale,				n, rows);
+	GrowColumn(dirCurr,				n, rows);
+	GrowColumn(minX,				n, rows);
+	GrowColumn(minY,				n, rows);
+	GrowColumn(maxX,				n, rows);
+	GrowColumn(maxY,				n, rows);
+	GrowColumn(gridCollisionFlag,	n, rows);
+	GrowColumn(flag,				n, rows);
+	GrowColumn(state,				n, rows);
+	GrowColumn(innerState,			n, rows);
+	GrowColumn(counter,				n, rows);
+	GrowColumn(targetX,				n, rows);
+	GrowColumn(transform,			n, rows);
+
+	pool.Reserve(rows);
+	capacity = rows;
+	++stats.growCount;
+}
+
+/******************************************************************************/
+/*!
+	A row of every column, and the pool's free list, dense list, dense
+	index and generation of a slot
+*/
+/******************************************************************************/
+size_t EntityTable::GetMemoryBytes(void) const
+{
+	const size_t rowBytes = 13 * sizeof(float) + sizeof(int) + sizeof(unsigned int) +
+							sizeof(enum STATE) + sizeof(enum INNER_STATE) + sizeof(double) +
+							sizeof(SimMtx33) + 4 * sizeof(unsigned int);
+	return (size_t)capacity * rowBytes;
+}
+
+/******************************************************************************/
+/*!
+
+*/
+/******************************************************************************/
+void EntityTable::Remove(unsigned int row)
+{
+	if (row >= count)
+		return;
+
+	unsigned int last = count - 1;
+	if (row != last)
+		MoveRow(last, row);
+
+	// the pool does the same swap on its dense list so rows stay in step
+	pool.Release(pool.GetLive()[row]);
+	--count;
+}
+
+/******************************************************************************/
+/*!
+
+*/
+/******************************************************************************/
+void EntityTable::Clear(void)
+{
+	pool.Clear();
+	count = 0;
+}
+
+/******************************************************************************/
+/*!
+
+*/
+/******************************************************************************/
+unsigned int EntityTable::GetRow(GameObjHandle handle) const
+{
+	if (handle.type != type || !pool.IsValid(handle.index, handle.generation))
+		return POOL_INVALID_INDEX;
+	return pool.GetDenseIndex(handle.index);
+}
+
+/******************************************************************************/
+/*!
+
+*/
+/******************************************************************************/
+GameObjHandle EntityTable::GetHandle(unsigned int row) const
+{
+	unsigned int index = pool.GetLive()[row];
+	return { type, index, pool.GetGeneration(index) };
+}
+
+/******************************************************************************/
+/*!
+
+*/
+/******************************************************************************/
+void EntityTable::MoveRow(unsigned int from, unsigned int to)
+{
+	posX[to]				= posX[from];
+	posY[to]				= posY[from];
+	posPrevX[to]			= posPrevX[from];
+	posPrevY[to]			= posPrevY[from];
+	velX[to]				= velX[from];
+	velY[to]				= velY[from];
+	scale[to]				= scale[from];
+	dirCurr[to]				= dirCurr[from];
+	minX[to]				= minX[from];
+	minY[to]				= minY[from];
+	maxX[to]				= maxX[from];
+	maxY[to]				= maxY[from];
+	gridCollisionFlag[to]	= gridCollisionFlag[from];
+	flag[to]				= flag[from];
+	state[to]				= state[from];
+	innerState[to]			= innerState[from];
+	counter[to]				= counter[from];
+	targetX[to]				= targetX[from];
+	transform[to]			= transform[from];
+}
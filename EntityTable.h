@@ -0,0 +1,131 @@
+/******************************************************************************/
+/*!
+\file		EntityTable.h
+\author 	DigiPen
+\par    	email: digipen\@digipen.edu
+\date   	February 01, 20xx
+\brief
+Structure of arrays storage for every game object instance of one type.
+Each component lives in its own contiguous array and live rows are always
+packed at the front (swap and pop on removal), so a pass that only needs
+positions and velocities walks nothing but positions and velocities.
+Rows move when other rows are removed; hold a GameObjHandle, not a row.
+
+A table grows when a row is added to a full one, doubling its columns and
+pool, so its memory follows the most rows it ever held rather than a
+worst case. Columns are reallocated when that happens, which only Add and
+Reserve do: no pass may keep a column pointer across either. Past the
+soft cap rows are still added, and counted in the stats.
+
+Copyright (C) 20xx DigiPen Institute of Technology.
+Reproduction or disclosure of this file or its contents without the
+prior written consent of DigiPen Institute of Technology is prohibited.
+ */
+/******************************************************************************/
+
+#ifndef ENTITY_TABLE_H
+#define ENTITY_TABLE_H
+
+#include "PlatformTypes.h"
+#include "InstancePool.h"
+#include <cstdint>
+
+/******************************************************************************/
+/*!
+	Struct/Class Definitions
+*/
+/******************************************************************************/
+struct GameObjHandle
+{
+	unsigned int	type;		// table the instance lives in (TYPE_OBJECT)
+	unsigned int	index;		// slot in the table's pool
+	unsigned int	generation;	// generation of the slot when the handle was made
+};
+
+const GameObjHandle	INVALID_HANDLE			= { 0, POOL_INVALID_INDEX, 0 };
+
+const unsigned int	ENTITY_TABLE_MIN_GROWTH	= 64;	//Rows a table grows to at least
+
+struct EntityTableStats
+{
+	unsigned int	peakCount;		// most live rows at once
+	unsigned int	growCount;		// times the columns were reallocated
+	unsigned int	overSoftCap;	// rows added with the table at or past its soft cap
+};
+
+class EntityTable
+{
+public:
+	EntityTable();
+	~EntityTable();
+
+	//Starts with room for "initialCount" rows
+	void				Create(unsigned int objType, unsigned int initialCount);
+	void				Destroy(void);
+	void				CopyFrom(const EntityTable& rhs);
+	//Bit for bit comparison of every live row and of the handle pool
+	bool				IsIdentical(const EntityTable& rhs) const;
+	//Hash of the same data, 64 bits at a time, continuing from "hash"
+	uint64_t			Hash(uint64_t hash) const;
+	//Live rows and pool into a snapshot, see WorldSnapshot.h. Restore grows
+	//the table if it has to and fails on a table of another type.
+	void				SaveState(SnapshotWriter& out) const;
+	bool				RestoreState(SnapshotReader& in);
+
+	//Room for "rows" rows without growing again, e.g. a level's spawn count
+	void				Reserve(unsigned int rows);
+	void				SetSoftCap(unsigned int rows)		{ softCap = rows; }
+	unsigned int		GetSoftCap(void) const				{ return softCap; }
+	const EntityTableStats&	GetStats(void) const			{ return stats; }
+	//Columns and pool, as allocated
+	size_t				GetMemoryBytes(void) const;
+
+	//Appends a row, growing the table if it is full
+	GameObjHandle		Add(float scl, const SimVec2& pos, const SimVec2& vel,
+							float dir, enum STATE startState);
+	//Swap and pop, the last row moves into "row"
+	void				Remove(unsigned int row);
+	void				Clear(void);
+
+	//POOL_INVALID_INDEX if the handle's instance is gone
+	unsigned int		GetRow(GameObjHandle handle) const;
+	GameObjHandle		GetHandle(unsigned int row) const;
+
+	unsigned int		type;		// object type of every row (TYPE_OBJECT)
+	unsigned int		count;		// live rows, packed at the front
+	unsigned int		capacity;
+
+	//Transform
+	float				*posX, *posY;			// object current position
+	float				*posPrevX, *posPrevY;	// position before the last step (render interpolation)
+	float				*velX, *velY;			// object current velocity
+	float				*scale;
+	float				*dirCurr;				// object current direction
+
+	//Bounds and collision
+	float				*minX, *minY;			// bounding box that encapsulates the object
+	float				*maxX, *maxY;
+	int					*gridCollisionFlag;
+	unsigned int		*flag;					// bit flag or-ed together
+
+	//State machine
+	enum STATE			*state;
+	enum INNER_STATE	*innerState;
+	double				*counter;				// general purpose counter (enemy idle and replan time)
+	float				*targetX;				// x a chasing enemy walks to
+
+	//Output
+	SimMtx33			*transform;				// object matrix in map space (MapTransform not included)
+
+private:
+	EntityTable(const EntityTable&) = delete;
+	EntityTable& operator=(const EntityTable&) = delete;
+
+	void				MoveRow(unsigned int from, unsigned int to);
+
+	InstancePool		pool;					// handles -> rows, pool dense order == row order
+	unsigned int		softCap;
+	EntityTableStats	stats;
+};
+
+#endif // ENTITY_TABLE_H
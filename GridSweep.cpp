@@ -0,0 +1,164 @@
+/******************************************************************************/
+/*!
+\file		GridSweep.cpp
+\author 	DigiPen
+\par    	email: digipen\@digipen.edu
+\date   	February 01, 20xx
+\brief
+Swept box against the collision map. See GridSweep.h.
+
+Copyright (C) 20xx DigiPen Institute of Technology.
+Reproduction or disclosure of this file or its contents without the
+prior written consent of DigiPen Institute of Technology is prohibited.
+ */
+/******************************************************************************/
+
+#include "GridSweep.h"
+#include <cmath>
+
+/******************************************************************************/
+/*!
+	Cells [*pFirst, *pEnd) the extent [lo, hi] covers on one axis, while
+	the box moves by "step" on that axis. The edge it leads with covers a
+	cell as soon as it is past the cell's line, any other edge only when it
+	is more than GRID_SWEEP_SKIN past it.
+*/
+/******************************************************************************/
+static void CoveredCells(float lo, float hi, int step, int* pFirst, int* pEnd)
+{
+	*pFirst	= (int)floorf(step < 0 ? lo : lo + GRID_SWEEP_SKIN);
+	*pEnd	= (int)ceilf(step > 0 ? hi : hi - GRID_SWEEP_SKIN);
+}
+
+/******************************************************************************/
+/*!
+	First collision cell in [first, end) of column "line", or of row "line"
+	if "row"
+*/
+/******************************************************************************/
+static bool FindBlocked(const CollisionGrid& grid, int line, bool row, int first, int end, int* pCell)
+{
+	for (int c = first; c < end; ++c)
+		if (row ? CollisionGridCell(grid, c, line) : CollisionGridCell(grid, line, c)) {
+			*pCell = c;
+			return true;
+		}
+	return false;
+}
+
+/******************************************************************************/
+/*!
+	Walks the cell lines the leading edges cross in the order the motion
+	reaches them. Crossing a column line only brings in that column's cells
+	beside the box at that moment (likewise for rows), so each cell is
+	tested once, when the box enters it. A box reaching a corner diagonally
+	enters the corner cell through neither side, so it is tested when the
+	other leading edge is within GRID_SWEEP_SKIN of its line, and counts as
+	a hit on that edge's face.
+*/
+/******************************************************************************/
+bool SweepBoxGrid(const CollisionGrid& grid, const SimAABB& box, const SimVec2& motion, GridSweepHit* pHit)
+{
+	const int stepX = (motion.x > 0.0f) - (motion.x < 0.0f);
+	const int stepY = (motion.y > 0.0f) - (motion.y < 0.0f);
+	if (!stepX && !stepY)
+		return false;
+
+	//next line each leading edge crosses, the first one it isn't already on
+	const float edgeX = stepX > 0 ? box.max.x : box.min.x;
+	const float edgeY = stepY > 0 ? box.max.y : box.min.y;
+	int lineX = stepX > 0 ? (int)ceilf(edgeX - GRID_SWEEP_SKIN) : (int)floorf(edgeX + GRID_SWEEP_SKIN);
+	int lineY = stepY > 0 ? (int)ceilf(edgeY - GRID_SWEEP_SKIN) : (int)floorf(edgeY + GRID_SWEEP_SKIN);
+
+	for (;;)
+	{
+		float nextX = stepX ? ((float)lineX - edgeX) / motion.x : 2.0f;
+		float nextY = stepY ? ((float)lineY - edgeY) / motion.y : 2.0f;
+		nextX = nextX < 0.0f ? 0.0f : nextX;
+		nextY = nextY < 0.0f ? 0.0f : nextY;
+
+		//rows first on a tie, so a box that lands and moves on in the same
+		//step stands on the floor before it walks along it
+		const bool crossX = nextX < nextY;
+		const float t = crossX ? nextX : nextY;
+		if (t > 1.0f)
+			return false;
+
+		//the cells entered, and the corner cell if the other edge is about
+		//to enter the next row or column too
+		const int column = stepX > 0 ? lineX : lineX - 1;
+		const int row = stepY > 0 ? lineY : lineY - 1;
+		const float x = edgeX + motion.x * t, y = edgeY + motion.y * t;
+		int first, end, cell;
+		if (crossX) {
+			CoveredCells(box.min.y + motion.y * t, box.max.y + motion.y * t, stepY, &first, &end);
+			if (FindBlocked(grid, column, false, first, end, &cell)) {
+				*pHit = { t, -stepX, 0, column, cell };
+				return true;
+			}
+			if (stepY && fabsf((float)lineY - y) <= GRID_SWEEP_SKIN && CollisionGridCell(grid, column, row)) {
+				*pHit = { t, 0, -stepY, column, row };
+				return true;
+			}
+			lineX += stepX;
+		}
+		else {
+			CoveredCells(box.min.x + motion.x * t, box.max.x + motion.x * t, stepX, &first, &end);
+			if (FindBlocked(grid, row, true, first, end, &cell)) {
+				*pHit = { t, 0, -stepY, cell, row };
+				return true;
+			}
+			if (stepX && fabsf((float)lineX - x) <= GRID_SWEEP_SKIN && CollisionGridCell(grid, column, row)) {
+				*pHit = { t, 0, -stepY, column, row };
+				return true;
+			}
+			lineY += stepY;
+		}
+	}
+}
+
+/******************************************************************************/
+/*!
+	Each hit puts the box against the face it hit, exactly, and drops the
+	motion into that face; the rest of the motion is swept again from
+	there.
+*/
+/******************************************************************************/
+unsigned int MoveBoxGrid(const CollisionGrid& grid, const SimVec2& half, const SimVec2& from,
+						 SimVec2* pPos, SimVec2* pVel)
+{
+	SimVec2 pos = from;
+	SimVec2 motion{ pPos->x - from.x, pPos->y - from.y };
+	unsigned int flags = 0;
+
+	for (int i = 0; i < GRID_SWEEP_ITERATIONS && (motion.x != 0.0f || motion.y != 0.0f); ++i)
+	{
+		SimAABB box{ { pos.x - half.x, pos.y - half.y }, { pos.x + half.x, pos.y + half.y } };
+		GridSweepHit hit;
+		if (!SweepBoxGrid(grid, box, motion, &hit)) {
+			pos.x += motion.x;
+			pos.y += motion.y;
+			break;
+		}
+
+		if (hit.normalX) {
+			pos.x = hit.normalX < 0 ? (float)hit.cellX - half.x : (float)(hit.cellX + 1) + half.x;
+			pos.y += motion.y * hit.time;
+			motion.x = 0.0f;
+			motion.y *= 1.0f - hit.time;
+			pVel->x = 0.0f;
+			flags |= hit.normalX < 0 ? COLLISION_RIGHT : COLLISION_LEFT;
+		}
+		else {
+			pos.x += motion.x * hit.time;
+			pos.y = hit.normalY < 0 ? (float)hit.cellY - half.y : (float)(hit.cellY + 1) + half.y;
+			motion.x *= 1.0f - hit.time;
+			motion.y = 0.0f;
+			pVel->y = 0.0f;
+			flags |= hit.normalY < 0 ? COLLISION_TOP : COLLISION_BOTTOM;
+		}
+	}
+
+	*pPos = pos;
+	return flags;
+}
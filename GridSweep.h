@@ -0,0 +1,75 @@
+/******************************************************************************/
+/*!
+\file		GridSweep.h
+\author 	DigiPen
+\par    	email: digipen\@digipen.edu
+\date   	February 01, 20xx
+\brief
+Continuous collision of axis aligned boxes against the binary collision
+map. Instead of sampling hot spots where a box ends up, the box is swept
+along its motion: the leading edges are stepped across the cell lines in
+the order the motion reaches them (a DDA in tile space), and the first
+collision cell they run into gives the time of impact and the contact
+normal. A box of any size is stopped at the cell's face however far it
+moves in a step, so nothing tunnels through a one cell wall.
+
+Copyright (C) 20xx DigiPen Institute of Technology.
+Reproduction or disclosure of this file or its contents without the
+prior written consent of DigiPen Institute of Technology is prohibited.
+ */
+/******************************************************************************/
+
+#ifndef GRID_SWEEP_H
+#define GRID_SWEEP_H
+
+#include "PlatformTypes.h"
+#include "SimKernels.h"
+
+/******************************************************************************/
+/*!
+	Defines
+*/
+/******************************************************************************/
+//A box edge this close to a cell line is on it: a box left touching a wall
+//is still blocked by it, and one touching a cell side on isn't
+const float			GRID_SWEEP_SKIN			= 1.0f / 256.0f;
+//Hits resolved per move, enough to slide along a wall into a floor
+const int			GRID_SWEEP_ITERATIONS	= 3;
+
+/******************************************************************************/
+/*!
+	Struct/Class Definitions
+*/
+/******************************************************************************/
+
+//Where a swept box first runs into a collision cell
+struct GridSweepHit
+{
+	float			time;			// fraction of the motion done at the impact, [0, 1]
+	int				normalX;		// contact normal, out of the cell: -1, 0 or 1
+	int				normalY;
+	int				cellX, cellY;	// level cell hit
+};
+
+/******************************************************************************/
+/*!
+	First collision cell "box" runs into while it moves by "motion". Cells
+	the box already overlaps don't count, so a box stuck in a wall can
+	leave it. Returns false if the whole motion is free.
+*/
+/******************************************************************************/
+bool				SweepBoxGrid(const CollisionGrid& grid, const SimAABB& box, const SimVec2& motion,
+								 GridSweepHit* pHit);
+
+/******************************************************************************/
+/*!
+	Moves a box of half size "half" from "from" to *pPos, stopping at
+	whatever it hits and sliding the rest of the motion along it. *pPos
+	gets where the box ends up and the components of *pVel into a contact
+	are zeroed. Returns the COLLISION_ flags of the sides that touched.
+*/
+/******************************************************************************/
+unsigned int		MoveBoxGrid(const CollisionGrid& grid, const SimVec2& half, const SimVec2& from,
+								SimVec2* pPos, SimVec2* pVel);
+
+#endif // GRID_SWEEP_H
@@ -0,0 +1,273 @@
+/******************************************************************************/
+/*!
+\file		InputLog.cpp
+\author 	DigiPen
+\par    	email: digipen\@digipen.edu
+\date   	February 01, 20xx
+\brief
+Recorded input sessions. See InputLog.h.
+
+Copyright (C) 20xx DigiPen Institute of Technology.
+Reproduction or disclosure of this file or its contents without the
+prior written consent of DigiPen Institute of Technology is prohibited.
+ */
+/******************************************************************************/
+
+#include "InputLog.h"
+#include "PlatformWorld.h"
+#include "LevelFile.h"
+#include <cstdio>
+#include <cstring>
+
+/******************************************************************************/
+/*!
+	Payload writing and reading
+*/
+/******************************************************************************/
+static void PutBytes(std::vector<unsigned char>& out, const void *data, size_t size)
+{
+	const unsigned char *bytes = (const unsigned char *)data;
+	out.insert(out.end(), bytes, bytes + size);
+}
+
+static void PutVarint(std::vector<unsigned char>& out, uint32_t value)
+{
+	for (; value >= 0x80; value >>= 7)
+		out.push_back((unsigned char)(value | 0x80));
+	out.push_back((unsigned char)value);
+}
+
+struct PayloadCursor
+{
+	const unsigned char	*p;
+	const unsigned char	*end;
+
+	bool Bytes(void *data, size_t size)
+	{
+		if ((size_t)(end - p) < size)
+			return false;
+		memcpy(data, p, size);
+		p += size;
+		return true;
+	}
+
+	bool Varint(uint32_t *pValue)
+	{
+		uint32_t value = 0;
+		for (int shift = 0; shift < 35 && p < end; shift += 7)
+		{
+			unsigned char byte = *p++;
+			value |= (uint32_t)(byte & 0x7F) << shift;
+			if (!(byte & 0x80)) {
+				*pValue = value;
+				return true;
+			}
+		}
+		return false;
+	}
+};
+
+/******************************************************************************/
+/*!
+
+*/
+/******************************************************************************/
+InputLog::InputLog() :
+	Flags{ 0 }, Step{ 0.0f }, HashInterval{ 1 }
+{
+}
+
+/******************************************************************************/
+/*!
+
+*/
+/******************************************************************************/
+void InputLog::Begin(const char *levelName, float step, uint32_t flags, uint32_t hashInterval)
+{
+	Clear();
+	LevelName = levelName ? levelName : "";
+	Step = step;
+	Flags = flags;
+	HashInterval = hashInterval ? hashInterval : 1;
+}
+
+/******************************************************************************/
+/*!
+
+*/
+/******************************************************************************/
+void InputLog::Clear(void)
+{
+	LevelName.clear();
+	Flags = 0;
+	Step = 0.0f;
+	HashInterval = 1;
+	Buttons.clear();
+	Dts.clear();
+	Hashes.clear();
+}
+
+/******************************************************************************/
+/*!
+
+*/
+/******************************************************************************/
+void InputLog::Append(const InputFrame& input, float dt, uint64_t hash)
+{
+	unsigned char buttons = 0;
+	buttons |= input.moveLeft	? INPUT_LOG_BUTTON_LEFT		: 0;
+	buttons |= input.moveRight	? INPUT_LOG_BUTTON_RIGHT	: 0;
+	buttons |= input.jump		? INPUT_LOG_BUTTON_JUMP		: 0;
+
+	if (WantsHash())
+		Hashes.push_back(hash);
+	Buttons.push_back(buttons);
+	Dts.push_back(dt);
+}
+
+/******************************************************************************/
+/*!
+
+*/
+/******************************************************************************/
+void InputLog::GetTick(unsigned int tick, InputFrame* pInput, float* pDt) const
+{
+	unsigned char buttons = Buttons[tick];
+	pInput->moveLeft	= (buttons & INPUT_LOG_BUTTON_LEFT) != 0;
+	pInput->moveRight	= (buttons & INPUT_LOG_BUTTON_RIGHT) != 0;
+	pInput->jump		= (buttons & INPUT_LOG_BUTTON_JUMP) != 0;
+	*pDt = Dts[tick];
+}
+
+/******************************************************************************/
+/*!
+	A run is a stretch of ticks with the same buttons and dt. The dt is
+	compared bit for bit, whatever was stepped is what gets replayed.
+*/
+/******************************************************************************/
+bool InputLog::Save(const char *FileName) const
+{
+	std::vector<unsigned char> payload;
+	InputLogHeader header;
+	memset(&header, 0, sizeof(header));
+
+	PutBytes(payload, LevelName.data(), LevelName.size());
+	for (size_t begin = 0, end; begin < Buttons.size(); begin = end)
+	{
+		for (end = begin + 1; end < Buttons.size() && Buttons[end] == Buttons[begin] &&
+			 memcmp(&Dts[end], &Dts[begin], sizeof(float)) == 0; ++end);
+
+		bool ownDt = memcmp(&Dts[begin], &Step, sizeof(float)) != 0;
+		payload.push_back(Buttons[begin] | (ownDt ? INPUT_LOG_BUTTON_DT : 0));
+		PutVarint(payload, (uint32_t)(end - begin));
+		if (ownDt)
+			PutBytes(payload, &Dts[begin], sizeof(float));
+		++header.runCount;
+	}
+	if (Flags & INPUT_LOG_FLAG_HASHES)
+		PutBytes(payload, Hashes.data(), Hashes.size() * sizeof(uint64_t));
+
+	memcpy(header.magic, INPUT_LOG_MAGIC, sizeof(header.magic));
+	header.version			= INPUT_LOG_VERSION;
+	header.headerSize		= sizeof(InputLogHeader);
+	header.flags			= Flags;
+	header.tickCount		= (uint32_t)Buttons.size();
+	header.step				= Step;
+	header.levelNameSize	= (uint32_t)LevelName.size();
+	header.hashInterval		= HashInterval;
+	header.payloadSize		= payload.size();
+	header.payloadChecksum	= LevelChecksum(payload.data(), payload.size());
+
+	FILE *file = fopen(FileName, "wb");
+	if (!file)
+		return false;
+	bool written = fwrite(&header, sizeof(header), 1, file) == 1 &&
+				   fwrite(payload.data(), 1, payload.size(), file) == payload.size();
+	return fclose(file) == 0 && written;
+}
+
+/******************************************************************************/
+/*!
+
+*/
+/******************************************************************************/
+bool InputLog::Load(const char *FileName, const char **pError)
+{
+	const char *pFail = nullptr;
+	InputLogHeader header;
+	std::vector<unsigned char> payload;
+
+	Clear();
+
+	FILE *file = fopen(FileName, "rb");
+	if (!file)
+		pFail = "can't open the file";
+	else if (fread(&header, sizeof(header), 1, file) != 1 ||
+			 memcmp(header.magic, INPUT_LOG_MAGIC, sizeof(header.magic)) != 0)
+		pFail = "not an input log";
+	else if (header.version != INPUT_LOG_VERSION || header.headerSize != sizeof(InputLogHeader))
+		pFail = "unsupported version";
+	else if (header.hashInterval == 0)
+		pFail = "bad hash interval";
+	else {
+		// check the size against the file before allocating for it
+		long start = ftell(file), end = -1;
+		if (start >= 0 && fseek(file, 0, SEEK_END) == 0)
+			end = ftell(file);
+		if (end < start || header.payloadSize > (uint64_t)(end - start) || fseek(file, start, SEEK_SET) != 0)
+			pFail = "truncated file";
+		else {
+			payload.resize((size_t)header.payloadSize);
+			if (fread(payload.data(), 1, payload.size(), file) != payload.size())
+				pFail = "truncated file";
+			else if (LevelChecksum(payload.data(), payload.size()) != header.payloadChecksum)
+				pFail = "checksum mismatch";
+		}
+	}
+	if (file)
+		fclose(file);
+	// the hashes have to be in the payload, before anything is sized by the count
+	size_t hashCount = pFail ? 0 : ((size_t)header.tickCount + header.hashInterval - 1) / header.hashInterval;
+	if (!pFail && (header.flags & INPUT_LOG_FLAG_HASHES) && hashCount > payload.size() / sizeof(uint64_t))
+		pFail = "bad tick count";
+
+	PayloadCursor cursor{ payload.data(), payload.data() + payload.size() };
+	if (!pFail && header.levelNameSize > payload.size())
+		pFail = "bad level name";
+	if (!pFail) {
+		LevelName.assign((const char *)cursor.p, header.levelNameSize);
+		cursor.p += header.levelNameSize;
+		Flags = header.flags;
+		Step = header.step;
+		HashInterval = header.hashInterval;
+	}
+
+	for (uint32_t run = 0; !pFail && run < header.runCount; ++run)
+	{
+		unsigned char buttons;
+		uint32_t count;
+		float dt = Step;
+		if (!cursor.Bytes(&buttons, 1) || !cursor.Varint(&count) ||
+			((buttons & INPUT_LOG_BUTTON_DT) && !cursor.Bytes(&dt, sizeof(dt))) ||
+			count > header.tickCount - Buttons.size())
+			pFail = "bad input run";
+		else {
+			Buttons.insert(Buttons.end(), count, (unsigned char)(buttons & ~INPUT_LOG_BUTTON_DT));
+			Dts.insert(Dts.end(), count, dt);
+		}
+	}
+	if (!pFail && Buttons.size() != header.tickCount)
+		pFail = "bad tick count";
+
+	if (!pFail && (Flags & INPUT_LOG_FLAG_HASHES)) {
+		Hashes.resize(hashCount);
+		if (!cursor.Bytes(Hashes.data(), Hashes.size() * sizeof(uint64_t)))
+			pFail = "bad state hashes";
+	}
+
+	if (pFail)
+		Clear();
+	if (pError)
+		*pError = pFail;
+	return pFail == nullptr;
+}
@@ -0,0 +1,129 @@
+/******************************************************************************/
+/*!
+\file		InputLog.h
+\author 	DigiPen
+\par    	email: digipen\@digipen.edu
+\date   	February 01, 20xx
+\brief
+Recorded session: the InputFrame and dt of every simulation tick, and
+optionally the PlatformWorld::HashState after every hashInterval-th one
+(ticks 0, hashInterval, 2 * hashInterval...). A world given a log with
+SetInputRecorder appends to it on every Step, and only hashes its state
+on the ticks the log keeps; PlatformWorld::Replay feeds a log back as
+fast as the simulation runs and reports the first hashed tick whose state
+differs from the recording. Tools/InputReplay.cpp replays a
+saved log headless.
+
+On disk ticks are run length coded, a long session of held keys at a
+fixed step takes a few bytes per change of input. All values are little
+endian.
+
+	InputLogHeader
+	level name			levelNameSize bytes, no terminator
+	input runs			runCount of: buttons byte, LEB128 tick count,
+						float dt if buttons has INPUT_LOG_BUTTON_DT
+	state hashes		ceil(tickCount / hashInterval) uint64_t, if
+						INPUT_LOG_FLAG_HASHES
+
+Copyright (C) 20xx DigiPen Institute of Technology.
+Reproduction or disclosure of this file or its contents without the
+prior written consent of DigiPen Institute of Technology is prohibited.
+ */
+/******************************************************************************/
+
+#ifndef INPUT_LOG_H
+#define INPUT_LOG_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+struct InputFrame;
+
+/******************************************************************************/
+/*!
+	Defines
+*/
+/******************************************************************************/
+const char			INPUT_LOG_MAGIC[4]			= { 'S', 'S', 'I', 'L' };
+const uint32_t		INPUT_LOG_VERSION			= 2;
+const uint32_t		INPUT_LOG_HASH_INTERVAL		= 60;	//Ticks per hash the game keeps, a second at the fixed step
+
+//InputLogHeader::flags
+const uint32_t		INPUT_LOG_FLAG_HASHES		= 0x00000001;	//A state hash per hashInterval ticks follows the runs
+const uint32_t		INPUT_LOG_FLAG_STREAMED		= 0x00000002;	//The level was streamed
+const uint32_t		INPUT_LOG_FLAG_SWEPT		= 0x00000004;	//Swept grid collision
+
+//Buttons byte of a run
+const unsigned char	INPUT_LOG_BUTTON_LEFT		= 0x01;
+const unsigned char	INPUT_LOG_BUTTON_RIGHT		= 0x02;
+const unsigned char	INPUT_LOG_BUTTON_JUMP		= 0x04;
+const unsigned char	INPUT_LOG_BUTTON_DT			= 0x80;		//The run's dt isn't the header's step
+
+const unsigned int	INPUT_LOG_NO_TICK			= 0xFFFFFFFF;
+
+/******************************************************************************/
+/*!
+	Struct/Class Definitions
+*/
+/******************************************************************************/
+struct InputLogHeader
+{
+	char			magic[4];			// INPUT_LOG_MAGIC
+	uint32_t		version;			// INPUT_LOG_VERSION
+	uint32_t		headerSize;			// sizeof(InputLogHeader)
+	uint32_t		flags;				// INPUT_LOG_FLAG_
+	uint32_t		tickCount;
+	uint32_t		runCount;
+	float			step;				// dt of every run without INPUT_LOG_BUTTON_DT
+	uint32_t		levelNameSize;
+	uint32_t		hashInterval;		// ticks per state hash, 1 or more
+	uint32_t		reserved;			// 0
+	uint64_t		payloadSize;		// bytes after the header
+	uint64_t		payloadChecksum;	// FNV-1a of every byte after the header
+};
+
+class InputLog
+{
+public:
+	InputLog();
+
+	//Starts an empty log of a session on "levelName" (the file the world
+	//loaded), at a fixed "step" or 0 for variable steps. With
+	//INPUT_LOG_FLAG_HASHES one tick in "hashInterval" keeps its hash.
+	void				Begin(const char *levelName, float step, uint32_t flags, uint32_t hashInterval = 1);
+	void				Clear(void);
+
+	//True if the next Append keeps its hash, the caller only hashes then
+	bool				WantsHash(void) const		{ return HasHash((unsigned int)Buttons.size()); }
+	void				Append(const InputFrame& input, float dt, uint64_t hash);
+
+	bool				Save(const char *FileName) const;
+	//False for a missing, truncated or corrupt file, the log is left empty
+	bool				Load(const char *FileName, const char **pError = nullptr);
+
+	unsigned int		GetTickCount(void) const	{ return (unsigned int)Buttons.size(); }
+	void				GetTick(unsigned int tick, InputFrame* pInput, float* pDt) const;
+	bool				HasHashes(void) const		{ return (Flags & INPUT_LOG_FLAG_HASHES) != 0; }
+	bool				HasHash(unsigned int tick) const	{ return HasHashes() && tick % HashInterval == 0; }
+	//Only for a tick HasHash is true for
+	uint64_t			GetHash(unsigned int tick) const	{ return Hashes[tick / HashInterval]; }
+	uint32_t			GetHashInterval(void) const	{ return HashInterval; }
+
+	const std::string&	GetLevelName(void) const	{ return LevelName; }
+	uint32_t			GetFlags(void) const		{ return Flags; }
+	float				GetStep(void) const			{ return Step; }
+
+private:
+	std::string			LevelName;
+	uint32_t			Flags;
+	float				Step;
+	uint32_t			HashInterval;
+
+	//one entry per tick, run length coded only on disk
+	std::vector<unsigned char>	Buttons;
+	std::vector<float>	Dts;
+	std::vector<uint64_t>	Hashes;
+};
+
+#endif // INPUT_LOG_H
@@ -0,0 +1,285 @@
+/******************************************************************************/
+/*!
+\file		InstancePool.cpp
+\author 	DigiPen
+\par    	email: digipen\@digipen.edu
+\date   	February 01, 20xx
+\brief
+Slot allocator for game object instances. See InstancePool.h.
+
+Copyright (C) 20xx DigiPen Institute of Technology.
+Reproduction or disclosure of this file or its contents without the
+prior written consent of DigiPen Institute of Technology is prohibited.
+ */
+/******************************************************************************/
+
+#include "InstancePool.h"
+#include <cstring>
+
+/******************************************************************************/
+/*!
+
+*/
+/******************************************************************************/
+InstancePool::InstancePool() :
+	Capacity{ 0 },
+	FreeList{ nullptr }, FreeCount{ 0 },
+	Dense{ nullptr }, DenseIndex{ nullptr }, DenseCount{ 0 },
+	Generation{ nullptr }, Touched{ 0 }
+{
+}
+
+/******************************************************************************/
+/*!
+
+*/
+/******************************************************************************/
+InstancePool::~InstancePool()
+{
+	Destroy();
+}
+
+/******************************************************************************/
+/*!
+
+*/
+/******************************************************************************/
+void InstancePool::Create(unsigned int capacity)
+{
+	Destroy();
+
+	Capacity	= capacity;
+	FreeList	= new unsigned int[capacity];
+	Dense		= new unsigned int[capacity];
+	DenseIndex	= new unsigned int[capacity];
+	Generation	= new unsigned int[capacity];
+
+	// pushed backwards so the first allocations come out as 0, 1, 2...
+	for (unsigned int i = 0; i < capacity; ++i) {
+		FreeList[i]		= capacity - 1 - i;
+		DenseIndex[i]	= POOL_INVALID_INDEX;
+		Generation[i]	= 0;
+	}
+	FreeCount	= capacity;
+	DenseCount	= 0;
+	Touched		= 0;
+}
+
+/******************************************************************************/
+/*!
+
+*/
+/******************************************************************************/
+void InstancePool::Destroy(void)
+{
+	delete[] FreeList;
+	delete[] Dense;
+	delete[] DenseIndex;
+	delete[] Generation;
+
+	FreeList	= nullptr;
+	Dense		= nullptr;
+	DenseIndex	= nullptr;
+	Generation	= nullptr;
+	Capacity	= 0;
+	FreeCount	= 0;
+	DenseCount	= 0;
+	Touched		= 0;
+}
+
+/******************************************************************************/
+/*!
+
+*/
+/******************************************************************************/
+void InstancePool::CopyFrom(const InstancePool& rhs)
+{
+	if (Capacity != rhs.Capacity)
+		Create(rhs.Capacity);
+
+	memcpy(FreeList,	rhs.FreeList,	Capacity * sizeof(unsigned int));
+	memcpy(Dense,		rhs.Dense,		Capacity * sizeof(unsigned int));
+	memcpy(DenseIndex,	rhs.DenseIndex,	Capacity * sizeof(unsigned int));
+	memcpy(Generation,	rhs.Generation,	Capacity * sizeof(unsigned int));
+	FreeCount	= rhs.FreeCount;
+	DenseCount	= rhs.DenseCount;
+	Touched		= rhs.Touched;
+}
+
+/******************************************************************************/
+/*!
+	Same live slots in the same order with the same generations
+*/
+/******************************************************************************/
+bool InstancePool::IsIdentical(const InstancePool& rhs) const
+{
+	if (Capacity != rhs.Capacity || DenseCount != rhs.DenseCount || FreeCount != rhs.FreeCount)
+		return false;
+
+	return 0 == memcmp(Dense, rhs.Dense, DenseCount * sizeof(unsigned int))
+		&& 0 == memcmp(FreeList, rhs.FreeList, FreeCount * sizeof(unsigned int))
+		&& 0 == memcmp(Generation, rhs.Generation, Capacity * sizeof(unsigned int));
+}
+
+/******************************************************************************/
+/*!
+	The free stack below Capacity - Touched and every slot from Touched on
+	are as Create left them, the rest is saved
+*/
+/******************************************************************************/
+void InstancePool::SaveState(SnapshotWriter& out) const
+{
+	unsigned int untouched = Capacity - Touched;
+	out.Write(Touched);
+	out.Write(FreeCount - untouched);
+	out.Write(DenseCount);
+	out.Write(FreeList + untouched, (FreeCount - untouched) * sizeof(unsigned int));
+	out.Write(Dense, DenseCount * sizeof(unsigned int));
+	out.Write(Generation, Touched * sizeof(unsigned int));
+}
+
+/******************************************************************************/
+/*!
+	Slots touched since the save go back to how Create left them, then the
+	saved part is copied in and DenseIndex rebuilt from Dense. The pool may
+	have grown since the save, the slots past what was saved are untouched
+	either way.
+*/
+/******************************************************************************/
+bool InstancePool::RestoreState(SnapshotReader& in)
+{
+	unsigned int touched, touchedFree, denseCount;
+	if (!in.Read(&touched) || !in.Read(&touchedFree) || !in.Read(&denseCount) ||
+		touched > Capacity || touchedFree + denseCount != touched)
+		return false;
+
+	unsigned int i, reach = touched > Touched ? touched : Touched;
+	for (i = touched; i < Touched; ++i) {
+		FreeList[Capacity - 1 - i] = i;
+		Generation[i] = 0;
+	}
+	for (i = 0; i < reach; ++i)
+		DenseIndex[i] = POOL_INVALID_INDEX;
+
+	unsigned int untouched = Capacity - touched;
+	if (!in.Read(FreeList + untouched, touchedFree * sizeof(unsigned int)) ||
+		!in.Read(Dense, denseCount * sizeof(unsigned int)) ||
+		!in.Read(Generation, touched * sizeof(unsigned int)))
+		return false;
+
+	for (i = 0; i < denseCount; ++i) {
+		if (Dense[i] >= touched)
+			return false;
+		DenseIndex[Dense[i]] = i;
+	}
+	FreeCount	= untouched + touchedFree;
+	DenseCount	= denseCount;
+	Touched		= touched;
+	return true;
+}
+
+/******************************************************************************/
+/*!
+	The new slots go at the bottom of the free stack, highest first, which
+	is where Create would have put them
+*/
+/******************************************************************************/
+void InstancePool::Reserve(unsigned int capacity)
+{
+	if (capacity <= Capacity)
+		return;
+
+	unsigned int *freeList		= new unsigned int[capacity];
+	unsigned int *dense			= new unsigned int[capacity];
+	unsigned int *denseIndex	= new unsigned int[capacity];
+	unsigned int *generation	= new unsigned int[capacity];
+
+	unsigned int i, added = capacity - Capacity;
+	for (i = 0; i < added; ++i)
+		freeList[i] = capacity - 1 - i;
+	if (FreeCount)
+		memcpy(freeList + added, FreeList, FreeCount * sizeof(unsigned int));
+	if (DenseCount)
+		memcpy(dense, Dense, DenseCount * sizeof(unsigned int));
+	if (Capacity) {
+		memcpy(denseIndex, DenseIndex, Capacity * sizeof(unsigned int));
+		memcpy(generation, Generation, Capacity * sizeof(unsigned int));
+	}
+	for (i = Capacity; i < capacity; ++i) {
+		denseIndex[i]	= POOL_INVALID_INDEX;
+		generation[i]	= 0;
+	}
+
+	delete[] FreeList;
+	delete[] Dense;
+	delete[] DenseIndex;
+	delete[] Generation;
+	FreeList	= freeList;
+	Dense		= dense;
+	DenseIndex	= denseIndex;
+	Generation	= generation;
+	FreeCount	+= added;
+	Capacity	= capacity;
+}
+
+/******************************************************************************/
+/*!
+
+*/
+/******************************************************************************/
+unsigned int InstancePool::Allocate(void)
+{
+	if (FreeCount == 0)
+		return POOL_INVALID_INDEX;
+
+	unsigned int index = FreeList[--FreeCount];
+	DenseIndex[index] = DenseCount;
+	Dense[DenseCount++] = index;
+	if (Capacity - FreeCount > Touched)
+		Touched = Capacity - FreeCount;
+	return index;
+}
+
+/******************************************************************************/
+/*!
+	Swap and pop: the last live slot takes the released slot's place in the
+	dense array
+*/
+/******************************************************************************/
+void InstancePool::Release(unsigned int index)
+{
+	if (index >= Capacity || DenseIndex[index] == POOL_INVALID_INDEX)
+		return;
+
+	unsigned int pos	= DenseIndex[index];
+	unsigned int last	= Dense[--DenseCount];
+	Dense[pos]			= last;
+	DenseIndex[last]	= pos;
+
+	DenseIndex[index]	= POOL_INVALID_INDEX;
+	++Generation[index];
+	FreeList[FreeCount++] = index;
+}
+
+/******************************************************************************/
+/*!
+
+*/
+/******************************************************************************/
+void InstancePool::Clear(void)
+{
+	while (DenseCount)
+		Release(Dense[DenseCount - 1]);
+}
+
+/******************************************************************************/
+/*!
+
+*/
+/******************************************************************************/
+bool InstancePool::IsValid(unsigned int index, unsigned int generation) const
+{
+	return index < Capacity
+		&& DenseIndex[index] != POOL_INVALID_INDEX
+		&& Generation[index] == generation;
+}
@@ -0,0 +1,96 @@
+/******************************************************************************/
+/*!
+\file		InstancePool.h
+\author 	DigiPen
+\par    	email: digipen\@digipen.edu
+\date   	February 01, 20xx
+\brief
+Slot allocator for game object instances. Free slots are kept on a stack so
+allocation is O(1), live slots are kept packed in a dense array (swap and
+pop on release) so systems only iterate what is alive, and every slot has a
+generation counter so a handle to a destroyed instance can be detected.
+
+Slots come off the stack in order 0, 1, 2... and anything past the highest
+slot ever allocated is still as Create left it, so a snapshot of the pool
+only needs the slots up to there. Reserve adds slots under the free stack,
+so they keep that order and come out after every slot already free.
+
+Copyright (C) 20xx DigiPen Institute of Technology.
+Reproduction or disclosure of this file or its contents without the
+prior written consent of DigiPen Institute of Technology is prohibited.
+ */
+/******************************************************************************/
+
+#ifndef INSTANCE_POOL_H
+#define INSTANCE_POOL_H
+
+#include "WorldSnapshot.h"
+
+/******************************************************************************/
+/*!
+	Defines
+*/
+/******************************************************************************/
+const unsigned int	POOL_INVALID_INDEX		= 0xFFFFFFFF;
+
+/******************************************************************************/
+/*!
+	Struct/Class Definitions
+*/
+/******************************************************************************/
+class InstancePool
+{
+public:
+	InstancePool();
+	~InstancePool();
+
+	void				Create(unsigned int capacity);
+	void				Destroy(void);
+	void				CopyFrom(const InstancePool& rhs);
+	bool				IsIdentical(const InstancePool& rhs) const;
+	//O(slots ever allocated). Restore fails if the pool has fewer slots
+	//than were ever allocated when saving or the data is malformed, and
+	//leaves the pool unusable if so.
+	void				SaveState(SnapshotWriter& out) const;
+	bool				RestoreState(SnapshotReader& in);
+
+	//Grows to "capacity" slots, never shrinks
+	void				Reserve(unsigned int capacity);
+
+	//Returns POOL_INVALID_INDEX when the pool is full
+	unsigned int		Allocate(void);
+	void				Release(unsigned int index);
+	//Releases every live slot, O(live)
+	void				Clear(void);
+
+	bool				IsAlive(unsigned int index) const	{ return DenseIndex[index] != POOL_INVALID_INDEX; }
+	//False if the slot was released after "generation" was read
+	bool				IsValid(unsigned int index, unsigned int generation) const;
+	unsigned int		GetGeneration(unsigned int index) const	{ return Generation[index]; }
+
+	//Live slots, packed. Order changes when a slot is released.
+	const unsigned int*	GetLive(void) const					{ return Dense; }
+	//Position of a live slot in GetLive()
+	unsigned int		GetDenseIndex(unsigned int index) const	{ return DenseIndex[index]; }
+	unsigned int		GetLiveCount(void) const			{ return DenseCount; }
+	unsigned int		GetCapacity(void) const				{ return Capacity; }
+	unsigned int		GetTouched(void) const				{ return Touched; }
+
+private:
+	InstancePool(const InstancePool&) = delete;
+	InstancePool& operator=(const InstancePool&) = delete;
+
+	unsigned int		Capacity;
+
+	unsigned int		*FreeList;		// stack of free slots
+	unsigned int		FreeCount;
+
+	unsigned int		*Dense;			// live slots, packed
+	unsigned int		*DenseIndex;	// slot -> position in Dense, POOL_INVALID_INDEX if free
+	unsigned int		DenseCount;
+
+	unsigned int		*Generation;	// bumped every time a slot is released
+	unsigned int		Touched;		// slots [0, Touched) have been allocated at some point
+};
+
+#endif // INSTANCE_POOL_H
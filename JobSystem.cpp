@@ -0,0 +1,188 @@
+/******************************************************************************/
+/*!
+\file		JobSystem.cpp
+\author 	DigiPen
+\par    	email: digipen\@digipen.edu
+\date   	February 01, 20xx
+\brief
+Work stealing job scheduler. See JobSystem.h.
+
+Copyright (C) 20xx DigiPen Institute of Technology.
+Reproduction or disclosure of this file or its contents without the
+prior written consent of DigiPen Institute of Technology is prohibited.
+ */
+/******************************************************************************/
+
+#include "JobSystem.h"
+
+// the scheduler a worker thread belongs to, and its queue
+static thread_local const JobSystem	*tOwner = nullptr;
+static thread_local unsigned int	tQueue = 0;
+
+/******************************************************************************/
+/*!
+
+*/
+/******************************************************************************/
+JobSystem::JobSystem() :
+	Queued{ 0 }, Stopping{ false }
+{
+	Queues.emplace_back(new JobQueue);
+}
+
+/******************************************************************************/
+/*!
+
+*/
+/******************************************************************************/
+JobSystem::~JobSystem()
+{
+	Stop();
+}
+
+/******************************************************************************/
+/*!
+
+*/
+/******************************************************************************/
+void JobSystem::Start(unsigned int workerCount)
+{
+	Stop();
+
+	Stopping = false;
+	for (unsigned int w = 0; w < workerCount; ++w)
+		Queues.emplace_back(new JobQueue);
+	for (unsigned int w = 0; w < workerCount; ++w)
+		Workers.emplace_back(&JobSystem::WorkerMain, this, w + 1);
+}
+
+/******************************************************************************/
+/*!
+	Only called between ParallelFors, so the queues are empty
+*/
+/******************************************************************************/
+void JobSystem::Stop(void)
+{
+	{
+		std::lock_guard<std::mutex> guard(SleepLock);
+		Stopping = true;
+	}
+	WorkAvailable.notify_all();
+
+	for (std::thread& worker : Workers)
+		worker.join();
+	Workers.clear();
+	Queues.resize(1);
+}
+
+/******************************************************************************/
+/*!
+
+*/
+/******************************************************************************/
+unsigned int JobSystem::GetThreadIndex(void) const
+{
+	return tOwner == this ? tQueue : 0;
+}
+
+/******************************************************************************/
+/*!
+	The caller runs the first range itself, the rest go on its own queue
+	(last range at the front, where thieves take from) and it keeps popping
+	or stealing until every range of this call has finished
+*/
+/******************************************************************************/
+void JobSystem::Dispatch(JobFunction run, const void *context, unsigned int count, unsigned int grain)
+{
+	grain = grain ? grain : 1;
+	if (count <= grain || Workers.empty()) {
+		for (unsigned int begin = 0; begin < count; begin += grain)
+			run(context, begin, count - begin < grain ? count : begin + grain);
+		return;
+	}
+
+	unsigned int ranges = (count + grain - 1) / grain;
+	std::atomic<unsigned int> pending{ ranges - 1 };
+	unsigned int self = GetThreadIndex();
+
+	{
+		JobQueue& queue = *Queues[self];
+		std::lock_guard<std::mutex> guard(queue.lock);
+		for (unsigned int r = ranges; r-- > 1; )
+		{
+			unsigned int begin = r * grain;
+			queue.jobs.push_back({ run, context, begin, count - begin < grain ? count : begin + grain, &pending });
+		}
+	}
+	Queued.fetch_add(ranges - 1);
+	{
+		std::lock_guard<std::mutex> guard(SleepLock);
+	}
+	WorkAvailable.notify_all();
+
+	run(context, 0, grain);
+	while (pending.load(std::memory_order_acquire) != 0)
+	{
+		if (!RunOne(self))
+			std::this_thread::yield();
+	}
+}
+
+/******************************************************************************/
+/*!
+	Newest job of our own queue first, then the oldest of someone else's
+*/
+/******************************************************************************/
+bool JobSystem::RunOne(unsigned int self)
+{
+	Job job;
+	bool found = false;
+	unsigned int queues = (unsigned int)Queues.size();
+
+	for (unsigned int k = 0; k < queues && !found; ++k)
+	{
+		JobQueue& queue = *Queues[(self + k) % queues];
+		std::lock_guard<std::mutex> guard(queue.lock);
+		if (queue.jobs.empty())
+			continue;
+
+		if (k == 0) {
+			job = queue.jobs.back();
+			queue.jobs.pop_back();
+		}
+		else {
+			job = queue.jobs.front();
+			queue.jobs.pop_front();
+		}
+		found = true;
+	}
+	if (!found)
+		return false;
+
+	Queued.fetch_sub(1);
+	job.run(job.context, job.begin, job.end);
+	job.pPending->fetch_sub(1, std::memory_order_release);
+	return true;
+}
+
+/******************************************************************************/
+/*!
+
+*/
+/******************************************************************************/
+void JobSystem::WorkerMain(unsigned int self)
+{
+	tOwner = this;
+	tQueue = self;
+
+	for (;;)
+	{
+		if (RunOne(self))
+			continue;
+
+		std::unique_lock<std::mutex> guard(SleepLock);
+		WorkAvailable.wait(guard, [this] { return Stopping || Queued.load() != 0; });
+		if (Stopping && Queued.load() == 0)
+			break;
+	}
+}
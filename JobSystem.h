@@ -0,0 +1,140 @@
+/******************************************************************************/
+/*!
+\file		JobSystem.h
+\author 	DigiPen
+\par    	email: digipen\@digipen.edu
+\date   	February 01, 20xx
+\brief
+Work stealing job scheduler. Every worker thread has its own deque of
+jobs: it pushes and pops at the back, idle threads steal from the front
+of the others'. The thread that calls ParallelFor queues the sub ranges
+and works on them too until they are all done, so a scheduler with no
+workers just runs everything in place.
+
+ParallelReduce folds the per range results in range order, whatever
+order the ranges ran in, so a reduction gives the same answer at any
+worker count.
+
+Copyright (C) 20xx DigiPen Institute of Technology.
+Reproduction or disclosure of this file or its contents without the
+prior written consent of DigiPen Institute of Technology is prohibited.
+ */
+/******************************************************************************/
+
+#ifndef JOB_SYSTEM_H
+#define JOB_SYSTEM_H
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/******************************************************************************/
+/*!
+	Struct/Class Definitions
+*/
+/******************************************************************************/
+class JobSystem
+{
+public:
+	JobSystem();
+	~JobSystem();
+
+	//Starts "workerCount" threads besides the callers' (0 runs everything
+	//on the calling thread). Restarts the scheduler if it was running.
+	void				Start(unsigned int workerCount);
+	void				Stop(void);
+	unsigned int		GetWorkerCount(void) const	{ return (unsigned int)Workers.size(); }
+	//1 + w on worker w, 0 on any other thread: an index for per thread data
+	//sized GetWorkerCount() + 1
+	unsigned int		GetThreadIndex(void) const;
+
+	//Calls func(begin, end) on consecutive sub ranges of [0, count) of
+	//"grain" items (the last one shorter) and returns when all are done
+	template <typename FUNC>
+	void				ParallelFor(unsigned int count, unsigned int grain, const FUNC& func);
+
+	//Same split as ParallelFor; map(begin, end) gives a T per range and the
+	//results are folded as combine(combine(identity, r0), r1)... in range
+	//order on the calling thread
+	template <typename T, typename MAP, typename COMBINE>
+	T					ParallelReduce(unsigned int count, unsigned int grain, T identity,
+									   const MAP& map, const COMBINE& combine);
+
+private:
+	JobSystem(const JobSystem&) = delete;
+	JobSystem& operator=(const JobSystem&) = delete;
+
+	typedef void		(*JobFunction)(const void *context, unsigned int begin, unsigned int end);
+
+	struct Job
+	{
+		JobFunction					run;
+		const void					*context;
+		unsigned int				begin, end;
+		std::atomic<unsigned int>	*pPending;		// jobs of the ParallelFor left
+	};
+
+	struct JobQueue
+	{
+		std::mutex					lock;
+		std::deque<Job>				jobs;
+	};
+
+	void				Dispatch(JobFunction run, const void *context, unsigned int count, unsigned int grain);
+	bool				RunOne(unsigned int self);
+	void				WorkerMain(unsigned int self);
+
+	//[0] is shared by the threads that aren't workers, [1 + w] is worker w's
+	std::vector<std::unique_ptr<JobQueue>>	Queues;
+	std::vector<std::thread>	Workers;
+	std::atomic<unsigned int>	Queued;				// jobs in all the queues
+	std::mutex					SleepLock;
+	std::condition_variable		WorkAvailable;
+	bool						Stopping;
+};
+
+/******************************************************************************/
+/*!
+
+*/
+/******************************************************************************/
+template <typename FUNC>
+void JobSystem::ParallelFor(unsigned int count, unsigned int grain, const FUNC& func)
+{
+	Dispatch([](const void *context, unsigned int begin, unsigned int end) {
+				 (*(const FUNC *)context)(begin, end);
+			 }, &func, count, grain);
+}
+
+/******************************************************************************/
+/*!
+
+*/
+/******************************************************************************/
+template <typename T, typename MAP, typename COMBINE>
+T JobSystem::ParallelReduce(unsigned int count, unsigned int grain, T identity,
+							const MAP& map, const COMBINE& combine)
+{
+	grain = grain ? grain : 1;
+	unsigned int ranges = (count + grain - 1) / grain;
+	std::vector<T> partial(ranges, identity);
+
+	ParallelFor(ranges, 1, [&](unsigned int first, unsigned int last) {
+		for (unsigned int r = first; r < last; ++r)
+		{
+			unsigned int begin = r * grain;
+			partial[r] = map(begin, count - begin < grain ? count : begin + grain);
+		}
+	});
+
+	T result = identity;
+	for (unsigned int r = 0; r < ranges; ++r)
+		result = combine(result, partial[r]);
+	return result;
+}
+
+#endif // JOB_SYSTEM_H
@@ -0,0 +1,141 @@
+/******************************************************************************/
+/*!
+\file		LevelArena.cpp
+\author 	DigiPen
+\par    	email: digipen\@digipen.edu
+\date   	February 01, 20xx
+\brief
+Level and frame lifetime bump allocator. See LevelArena.h.
+
+Copyright (C) 20xx DigiPen Institute of Technology.
+Reproduction or disclosure of this file or its contents without the
+prior written consent of DigiPen Institute of Technology is prohibited.
+ */
+/******************************************************************************/
+
+#include "LevelArena.h"
+#include <cstdint>
+
+static size_t AlignUp(size_t value, size_t alignment)
+{
+	return (value + alignment - 1) & ~(alignment - 1);
+}
+
+/******************************************************************************/
+/*!
+	No block until the first allocation
+*/
+/******************************************************************************/
+LevelArena::LevelArena(size_t blockSize) :
+	Current{ 0 }, Offset{ 0 }, BlockSize{ blockSize },
+	Used{ 0 }, Peak{ 0 }, Reserved{ 0 }, HeapAllocations{ 0 }
+{
+}
+
+/******************************************************************************/
+/*!
+
+*/
+/******************************************************************************/
+LevelArena::~LevelArena()
+{
+	Release();
+}
+
+/******************************************************************************/
+/*!
+	Bumps within the current block, and moves on to the next one when it
+	doesn't fit
+*/
+/******************************************************************************/
+void* LevelArena::Allocate(size_t bytes, size_t alignment)
+{
+	if (alignment < LEVEL_ARENA_ALIGNMENT)
+		alignment = LEVEL_ARENA_ALIGNMENT;
+
+	if (Blocks.empty() || AlignUp((uintptr_t)Blocks[Current].memory + Offset, alignment) + bytes >
+						  (uintptr_t)Blocks[Current].memory + Blocks[Current].size)
+		NextBlock(bytes, alignment);
+
+	const Block& block = Blocks[Current];
+	size_t start = (size_t)(AlignUp((uintptr_t)block.memory + Offset, alignment) - (uintptr_t)block.memory);
+	Used	+= start + bytes - Offset;
+	Offset	= start + bytes;
+	if (Used > Peak)
+		Peak = Used;
+	return block.memory + start;
+}
+
+/******************************************************************************/
+/*!
+	Takes the first kept block after the current one that is big enough,
+	or a new one from the heap, and makes it the current one. Blocks are
+	only reordered past the current one, where no marker points.
+*/
+/******************************************************************************/
+void LevelArena::NextBlock(size_t bytes, size_t alignment)
+{
+	size_t needed = bytes + alignment - 1;
+	unsigned int next = Blocks.empty() ? 0 : Current + 1;
+
+	unsigned int fit = next;
+	while (fit < Blocks.size() && Blocks[fit].size < needed)
+		++fit;
+
+	if (fit == Blocks.size()) {
+		Block block;
+		block.size		= needed > BlockSize ? needed : BlockSize;
+		block.memory	= new unsigned char[block.size];
+		Blocks.push_back(block);
+		Reserved += block.size;
+		++HeapAllocations;
+	}
+
+	Block block = Blocks[fit];
+	Blocks[fit] = Blocks[next];
+	Blocks[next] = block;
+
+	Current	= next;
+	Offset	= 0;
+}
+
+/******************************************************************************/
+/*!
+
+*/
+/******************************************************************************/
+void LevelArena::Rewind(const ArenaMarker& marker)
+{
+	if (Blocks.empty())
+		return;
+	Current	= marker.block;
+	Offset	= marker.offset;
+	Used	= marker.used;
+}
+
+/******************************************************************************/
+/*!
+
+*/
+/******************************************************************************/
+void LevelArena::Reset(void)
+{
+	Current	= 0;
+	Offset	= 0;
+	Used	= 0;
+	Peak	= 0;
+}
+
+/******************************************************************************/
+/*!
+
+*/
+/******************************************************************************/
+void LevelArena::Release(void)
+{
+	for (Block& block : Blocks)
+		delete[] block.memory;
+	Blocks.clear();
+	Reserved = 0;
+	Reset();
+}
@@ -0,0 +1,125 @@
+/******************************************************************************/
+/*!
+\file		LevelArena.h
+\author 	DigiPen
+\par    	email: digipen\@digipen.edu
+\date   	February 01, 20xx
+\brief
+Monotonic bump allocator for data that lives exactly as long as a level
+(or a frame). Allocation moves a pointer through a chain of blocks and
+nothing is freed one by one: Reset drops everything at once and keeps the
+blocks for the next level, so load/unload cycles stop going to the heap
+once the largest level has been seen. Only trivially destructible data
+goes in, no destructor is ever run.
+
+A marker taken with GetMarker and handed back to Rewind frees everything
+allocated since, which makes any arena usable as scratch; ArenaScratch
+does that for a scope. Not thread safe, one arena per thread.
+
+Copyright (C) 20xx DigiPen Institute of Technology.
+Reproduction or disclosure of this file or its contents without the
+prior written consent of DigiPen Institute of Technology is prohibited.
+ */
+/******************************************************************************/
+
+#ifndef LEVEL_ARENA_H
+#define LEVEL_ARENA_H
+
+#include <cstddef>
+#include <type_traits>
+#include <vector>
+
+/******************************************************************************/
+/*!
+	Defines
+*/
+/******************************************************************************/
+const size_t		LEVEL_ARENA_BLOCK_SIZE	= 1 << 20;	//Default block, bigger requests get a block of their own
+const size_t		LEVEL_ARENA_ALIGNMENT	= 16;		//Least alignment of an allocation
+
+/******************************************************************************/
+/*!
+	Struct/Class Definitions
+*/
+/******************************************************************************/
+
+//Where the arena was, see LevelArena::Rewind
+struct ArenaMarker
+{
+	unsigned int	block;
+	size_t			offset;		// in the block
+	size_t			used;		// LevelArena::GetUsedBytes at the time
+};
+
+class LevelArena
+{
+public:
+	explicit LevelArena(size_t blockSize = LEVEL_ARENA_BLOCK_SIZE);
+	~LevelArena();
+
+	//Never fails short of the heap itself. "alignment" is a power of two.
+	void*				Allocate(size_t bytes, size_t alignment = LEVEL_ARENA_ALIGNMENT);
+	//Uninitialized
+	template <typename T>
+	T*					AllocateArray(size_t count)
+	{
+		static_assert(std::is_trivially_destructible<T>::value, "the arena never runs destructors");
+		return static_cast<T*>(Allocate(count * sizeof(T), alignof(T)));
+	}
+
+	ArenaMarker			GetMarker(void) const				{ return ArenaMarker{ Current, Offset, Used }; }
+	//Frees everything allocated after "marker" was taken
+	void				Rewind(const ArenaMarker& marker);
+	//Frees everything, O(1). The blocks stay for what comes next.
+	void				Reset(void);
+	//Frees everything and gives the blocks back to the heap
+	void				Release(void);
+
+	//Handed out, alignment padding included
+	size_t				GetUsedBytes(void) const			{ return Used; }
+	//Most bytes used at once since the last Reset or Release
+	size_t				GetPeakBytes(void) const			{ return Peak; }
+	//Blocks held, used or not
+	size_t				GetReservedBytes(void) const		{ return Reserved; }
+	unsigned int		GetBlockCount(void) const			{ return (unsigned int)Blocks.size(); }
+	//Blocks ever taken from the heap, constant over cycles that fit
+	unsigned int		GetHeapAllocations(void) const		{ return HeapAllocations; }
+
+private:
+	LevelArena(const LevelArena&) = delete;
+	LevelArena& operator=(const LevelArena&) = delete;
+
+	struct Block
+	{
+		unsigned char	*memory;
+		size_t			size;
+	};
+
+	void				NextBlock(size_t bytes, size_t alignment);
+
+	std::vector<Block>	Blocks;				// [0, Current] in use, the rest kept for later
+	unsigned int		Current;
+	size_t				Offset;				// into Blocks[Current]
+	size_t				BlockSize;
+	size_t				Used;
+	size_t				Peak;
+	size_t				Reserved;
+	unsigned int		HeapAllocations;
+};
+
+//Everything allocated from the arena during the scope is freed at its end
+class ArenaScratch
+{
+public:
+	explicit ArenaScratch(LevelArena& arena) : Arena(arena), Marker(arena.GetMarker())	{}
+	~ArenaScratch()												{ Arena.Rewind(Marker); }
+
+	ArenaScratch(const ArenaScratch&) = delete;
+	ArenaScratch& operator=(const ArenaScratch&) = delete;
+
+private:
+	LevelArena&			Arena;
+	ArenaMarker			Marker;
+};
+
+#endif // LEVEL_ARENA_H
@@ -0,0 +1,262 @@
+/******************************************************************************/
+/*!
+\file		LevelFile.cpp
+\author 	DigiPen
+\par    	email: digipen\@digipen.edu
+\date   	February 01, 20xx
+\brief
+Binary level format. See LevelFile.h.
+
+Copyright (C) 20xx DigiPen Institute of Technology.
+Reproduction or disclosure of this file or its contents without the
+prior written consent of DigiPen Institute of Technology is prohibited.
+ */
+/******************************************************************************/
+
+#include "LevelFile.h"
+#include "PlatformTypes.h"
+#include "TileMap.h"
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+static_assert(sizeof(LevelFileHeader) == 80, "LevelFileHeader is part of the file format");
+static_assert(sizeof(LevelSpawn) == 12, "LevelSpawn is part of the file format");
+
+/******************************************************************************/
+/*!
+
+*/
+/******************************************************************************/
+static uint64_t AlignUp(uint64_t value)
+{
+	return (value + TILE_MAP_ALIGNMENT - 1) & ~(uint64_t)(TILE_MAP_ALIGNMENT - 1);
+}
+
+/******************************************************************************/
+/*!
+	FNV-1a, 64 bit
+*/
+/******************************************************************************/
+uint64_t LevelChecksum(const void *data, size_t size, uint64_t hash)
+{
+	const unsigned char *bytes = (const unsigned char*)data;
+	for (size_t i = 0; i < size; ++i) {
+		hash ^= bytes[i];
+		hash *= 1099511628211ull;
+	}
+	return hash;
+}
+
+/******************************************************************************/
+/*!
+
+*/
+/******************************************************************************/
+static uint64_t HeaderChecksum(const LevelFileHeader& header)
+{
+	LevelFileHeader copy = header;
+	copy.headerChecksum = 0;
+	return LevelChecksum(&copy, sizeof(copy));
+}
+
+/******************************************************************************/
+/*!
+	Sections are checked against the file size with 64 bit math, a corrupt
+	header can't make any later access read outside the mapping
+*/
+/******************************************************************************/
+bool LevelFile::Open(const char *FileName, bool verifyPayload, const char **pError)
+{
+	const char *error = nullptr;
+
+	Close();
+	if (!File.Open(FileName)) {
+		error = "can't open file";
+	}
+	else if (File.GetSize() < sizeof(LevelFileHeader)) {
+		error = "file too small";
+	}
+	else {
+		const LevelFileHeader *h = (const LevelFileHeader*)File.GetData();
+		uint64_t collisionSize	= h->width > 0 && h->height > 0 ? TileMapCollisionLayerSize(h->width, h->height) : 0;
+		uint64_t typeSize		= (uint64_t)(uint32_t)h->width * (uint32_t)h->height;
+		uint64_t spawnSize		= (uint64_t)h->spawnCount * sizeof(LevelSpawn);
+
+		if (memcmp(h->magic, LEVEL_FILE_MAGIC, sizeof(h->magic)) != 0)
+			error = "not a level file";
+		else if (h->version != LEVEL_FILE_VERSION || h->headerSize != sizeof(LevelFileHeader))
+			error = "unsupported version";
+		else if (HeaderChecksum(*h) != h->headerChecksum)
+			error = "header checksum mismatch";
+		else if (h->fileSize != File.GetSize())
+			error = "truncated file";
+		else if (h->width <= 0 || h->height <= 0 || h->width > 0x7FFFFFF || h->height > 0x7FFFFFF)
+			error = "bad map size";
+		else if (h->collisionOffset % TILE_MAP_ALIGNMENT || h->typeOffset % TILE_MAP_ALIGNMENT ||
+				 h->spawnOffset % TILE_MAP_ALIGNMENT)
+			error = "misaligned section";
+		else if (h->collisionOffset < sizeof(LevelFileHeader) ||
+				 h->collisionOffset + collisionSize > h->typeOffset ||
+				 h->typeOffset + typeSize > h->spawnOffset ||
+				 h->spawnOffset + spawnSize > h->fileSize)
+			error = "bad section offsets";
+		else if (h->heroX >= h->width || h->heroY >= h->height)
+			error = "bad hero spawn";
+		else if (verifyPayload &&
+				 LevelChecksum(File.GetData() + sizeof(LevelFileHeader), File.GetSize() - sizeof(LevelFileHeader)) != h->payloadChecksum)
+			error = "payload checksum mismatch";
+		else
+			Header = h;
+	}
+
+	if (error) {
+		File.Close();
+		if (pError)
+			*pError = error;
+		return false;
+	}
+	return true;
+}
+
+/******************************************************************************/
+/*!
+
+*/
+/******************************************************************************/
+const unsigned int* LevelFile::GetCollisionLayer(void) const
+{
+	return (const unsigned int*)(File.GetData() + Header->collisionOffset);
+}
+
+const unsigned char* LevelFile::GetTypeLayer(void) const
+{
+	return File.GetData() + Header->typeOffset;
+}
+
+const LevelSpawn* LevelFile::GetSpawns(void) const
+{
+	return (const LevelSpawn*)(File.GetData() + Header->spawnOffset);
+}
+
+/******************************************************************************/
+/*!
+
+*/
+/******************************************************************************/
+bool BinaryChunkSource::FindHeroSpawn(int *pX, int *pY)
+{
+	const LevelFileHeader& header = Level.GetHeader();
+	if (header.heroX < 0 || header.heroY < 0)
+		return false;
+
+	*pX = header.heroX;
+	*pY = header.heroY;
+	return true;
+}
+
+/******************************************************************************/
+/*!
+	One row copy per chunk row, nothing is parsed
+*/
+/******************************************************************************/
+bool BinaryChunkSource::LoadChunk(int chunkX, int chunkY, unsigned char *types)
+{
+	const LevelFileHeader& header = Level.GetHeader();
+	int x0 = chunkX * CHUNK_SIZE, y0 = chunkY * CHUNK_SIZE;
+	int x1 = x0 + CHUNK_SIZE < header.width ? x0 + CHUNK_SIZE : header.width;
+	int y1 = y0 + CHUNK_SIZE < header.height ? y0 + CHUNK_SIZE : header.height;
+
+	if (x0 < 0 || y0 < 0 || x0 >= x1 || y0 >= y1)
+		return true;
+
+	const unsigned char *layer = Level.GetTypeLayer();
+	for (int y = y0; y < y1; ++y)
+		memcpy(types + (y - y0) * CHUNK_SIZE, layer + (size_t)y * header.width + x0, x1 - x0);
+	return true;
+}
+
+/******************************************************************************/
+/*!
+
+*/
+/******************************************************************************/
+bool IsLevelFile(const char *FileName)
+{
+	char magic[4];
+	FILE *file = fopen(FileName, "rb");
+	if (!file)
+		return false;
+
+	bool isLevel = fread(magic, 1, sizeof(magic), file) == sizeof(magic) &&
+				   memcmp(magic, LEVEL_FILE_MAGIC, sizeof(magic)) == 0;
+	fclose(file);
+	return isLevel;
+}
+
+/******************************************************************************/
+/*!
+	The layers are built with a TileMap so they match what Attach expects.
+	Spawns are listed column by column, the order Init used to find them in.
+*/
+/******************************************************************************/
+bool WriteLevelFile(const char *FileName, const unsigned char *types, int width, int height)
+{
+	TileMap map;
+	std::vector<LevelSpawn> spawns;
+	LevelFileHeader header;
+
+	map.Create(width, height, false);
+	for (int y = 0; y < height; ++y)
+		for (int x = 0; x < width; ++x)
+			map.SetCell(x, y, types[(size_t)y * width + x]);
+
+	memset(&header, 0, sizeof(header));
+	header.heroX = -1;
+	header.heroY = -1;
+	for (int x = 0; x < width; ++x)
+		for (int y = 0; y < height; ++y)
+		{
+			unsigned char type = types[(size_t)y * width + x];
+			if (type != TYPE_OBJECT_HERO && type != TYPE_OBJECT_ENEMY1 && type != TYPE_OBJECT_COIN)
+				continue;
+			spawns.push_back({ x, y, type });
+			// Init kept the last hero it found
+			if (type == TYPE_OBJECT_HERO) {
+				header.heroX = x;
+				header.heroY = y;
+			}
+		}
+
+	memcpy(header.magic, LEVEL_FILE_MAGIC, sizeof(header.magic));
+	header.version			= LEVEL_FILE_VERSION;
+	header.headerSize		= sizeof(LevelFileHeader);
+	header.width			= width;
+	header.height			= height;
+	header.spawnCount		= (uint32_t)spawns.size();
+	header.collisionOffset	= AlignUp(sizeof(LevelFileHeader));
+	header.typeOffset		= AlignUp(header.collisionOffset + map.GetCollisionLayerSize());
+	header.spawnOffset		= AlignUp(header.typeOffset + map.GetTypeLayerSize());
+	header.fileSize			= header.spawnOffset + spawns.size() * sizeof(LevelSpawn);
+
+	// everything after the header, padding included, as it will be on disk
+	std::vector<unsigned char> payload((size_t)(header.fileSize - sizeof(LevelFileHeader)), 0);
+	unsigned char *payloadStart = payload.data();
+	memcpy(payloadStart + (header.collisionOffset - sizeof(LevelFileHeader)),
+		   map.GetCollisionLayer(), map.GetCollisionLayerSize());
+	memcpy(payloadStart + (header.typeOffset - sizeof(LevelFileHeader)),
+		   map.GetTypeLayer(), map.GetTypeLayerSize());
+	if (!spawns.empty())
+		memcpy(payloadStart + (header.spawnOffset - sizeof(LevelFileHeader)),
+			   spawns.data(), spawns.size() * sizeof(LevelSpawn));
+
+	header.payloadChecksum	= LevelChecksum(payload.data(), payload.size());
+	header.headerChecksum	= HeaderChecksum(header);
+
+	FILE *file = fopen(FileName, "wb");
+	if (!file)
+		return false;
+	bool written = fwrite(&header, sizeof(header), 1, file) == 1 &&
+				   fwrite(payload.data(), 1, payload.size(), file) == payload.size();
+	return fclose(file) == 0 && written;
+}
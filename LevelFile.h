@@ -0,0 +1,119 @@
+/******************************************************************************/
+/*!
+\file		LevelFile.h
+\author 	DigiPen
+\par    	email: digipen\@digipen.edu
+\date   	February 01, 20xx
+\brief
+Binary level format. The file is meant to be memory mapped and used in
+place: a fixed header, the collision layer and the type layer laid out
+exactly as a TileMap holds them, and a spawn table of every hero, enemy and
+coin in the order GameStatePlatformInit creates them. All values are little
+endian, every section starts on a TILE_MAP_ALIGNMENT boundary.
+
+	LevelFileHeader
+	collision layer		TileMapCollisionLayerSize(width, height) bytes
+	type layer			width * height bytes, row major
+	spawn table			spawnCount LevelSpawn
+
+Tools/LevelConvert.cpp converts the exported text levels.
+
+Copyright (C) 20xx DigiPen Institute of Technology.
+Reproduction or disclosure of this file or its contents without the
+prior written consent of DigiPen Institute of Technology is prohibited.
+ */
+/******************************************************************************/
+
+#ifndef LEVEL_FILE_H
+#define LEVEL_FILE_H
+
+#include "ChunkStreamer.h"
+#include "MappedFile.h"
+#include <cstdint>
+
+/******************************************************************************/
+/*!
+	Defines
+*/
+/******************************************************************************/
+const char			LEVEL_FILE_MAGIC[4]		= { 'S', 'S', 'L', 'V' };
+const uint32_t		LEVEL_FILE_VERSION		= 1;
+
+/******************************************************************************/
+/*!
+	Struct/Class Definitions
+*/
+/******************************************************************************/
+struct LevelFileHeader
+{
+	char			magic[4];			// LEVEL_FILE_MAGIC
+	uint32_t		version;			// LEVEL_FILE_VERSION
+	uint32_t		headerSize;			// sizeof(LevelFileHeader)
+	int32_t			width;				// cells
+	int32_t			height;
+	int32_t			heroX;				// hero spawn cell, -1 if the level has none
+	int32_t			heroY;
+	uint32_t		spawnCount;
+	uint64_t		collisionOffset;	// from the start of the file
+	uint64_t		typeOffset;
+	uint64_t		spawnOffset;
+	uint64_t		fileSize;
+	uint64_t		payloadChecksum;	// FNV-1a of every byte after the header
+	uint64_t		headerChecksum;		// FNV-1a of the header with this field 0
+};
+
+struct LevelSpawn
+{
+	int32_t			x;					// cell
+	int32_t			y;
+	uint32_t		type;				// TYPE_OBJECT_HERO, _ENEMY1 or _COIN
+};
+
+/******************************************************************************/
+/*!
+	A level file mapped in memory. Open checks the header and that every
+	section lies inside the file; the payload checksum reads the whole file
+	so it is only verified when asked for.
+*/
+/******************************************************************************/
+class LevelFile
+{
+public:
+	bool				Open(const char *FileName, bool verifyPayload, const char **pError = nullptr);
+	void				Close(void)					{ File.Close(); Header = nullptr; }
+	bool				IsOpen(void) const			{ return Header != nullptr; }
+
+	const LevelFileHeader&	GetHeader(void) const	{ return *Header; }
+	const unsigned int*	GetCollisionLayer(void) const;
+	const unsigned char*	GetTypeLayer(void) const;
+	const LevelSpawn*	GetSpawns(void) const;
+
+private:
+	MappedFile			File;
+	const LevelFileHeader	*Header = nullptr;
+};
+
+//Streams a level file; chunks are copied straight out of the mapped type layer
+class BinaryChunkSource : public ChunkSource
+{
+public:
+	bool				Open(const char *FileName)	{ return Level.Open(FileName, false); }
+
+	int					GetWidth(void) const override		{ return Level.GetHeader().width; }
+	int					GetHeight(void) const override		{ return Level.GetHeader().height; }
+	bool				FindHeroSpawn(int *pX, int *pY) override;
+	bool				LoadChunk(int chunkX, int chunkY, unsigned char *types) override;
+
+private:
+	LevelFile			Level;
+};
+
+//Checks the first bytes of a file for LEVEL_FILE_MAGIC
+bool					IsLevelFile(const char *FileName);
+
+//Writes "types" (width * height cells, row major) as a level file
+bool					WriteLevelFile(const char *FileName, const unsigned char *types, int width, int height);
+
+uint64_t				LevelChecksum(const void *data, size_t size, uint64_t hash = 14695981039346656037ull);
+
+#endif // LEVEL_FILE_H
@@ -0,0 +1,123 @@
+/******************************************************************************/
+/*!
+\file		LevelGenerator.cpp
+\author 	DigiPen
+\par    	email: digipen\@digipen.edu
+\date   	February 01, 20xx
+\brief
+Synthetic levels. See LevelGenerator.h.
+
+Copyright (C) 20xx DigiPen Institute of Technology.
+Reproduction or disclosure of this file or its contents without the
+prior written consent of DigiPen Institute of Technology is prohibited.
+ */
+/******************************************************************************/
+
+#include "LevelGenerator.h"
+#include "PlatformTypes.h"
+
+/******************************************************************************/
+/*!
+	xorshift32, the level must not depend on the standard library's rand
+*/
+/******************************************************************************/
+struct LevelRandom
+{
+	uint32_t		state;
+
+	uint32_t Next(void)
+	{
+		state ^= state << 13;
+		state ^= state >> 17;
+		state ^= state << 5;
+		return state;
+	}
+
+	//[0, range)
+	uint32_t Below(uint32_t range)
+	{
+		return (uint32_t)(((uint64_t)Next() * range) >> 32);
+	}
+};
+
+/******************************************************************************/
+/*!
+	Each object goes on the first free spot at or after a random entry of
+	"stands", wrapping around. Placing stops early once every spot is taken.
+*/
+/******************************************************************************/
+static unsigned int PlaceObjects(std::vector<unsigned char>& types, const std::vector<size_t>& stands,
+								 unsigned int count, unsigned char type, LevelRandom& random)
+{
+	unsigned int placed;
+	for (placed = 0; placed < count && !stands.empty(); ++placed)
+	{
+		size_t k = random.Below((uint32_t)stands.size()), tries;
+		for (tries = 0; tries < stands.size() && types[stands[k]] != TYPE_OBJECT_EMPTY; ++tries)
+			if (++k == stands.size())
+				k = 0;
+		if (tries == stands.size())
+			break;
+		types[stands[k]] = type;
+	}
+	return placed;
+}
+
+/******************************************************************************/
+/*!
+
+*/
+/******************************************************************************/
+bool GenerateLevel(const LevelGenParams& params, LevelGenResult* pResult)
+{
+	int width = params.width, height = params.height;
+	if (width < 4 || height < 4)
+		return false;
+
+	std::vector<unsigned char>& types = pResult->types;
+	types.assign((size_t)width * height, (unsigned char)TYPE_OBJECT_EMPTY);
+	LevelRandom random{ params.seed ? params.seed : 1 };
+
+	//walls, floor and ceiling
+	for (int x = 0; x < width; ++x) {
+		types[x] = TYPE_OBJECT_COLLISION;
+		types[(size_t)(height - 1) * width + x] = TYPE_OBJECT_COLLISION;
+	}
+	for (int y = 0; y < height; ++y) {
+		types[(size_t)y * width] = TYPE_OBJECT_COLLISION;
+		types[(size_t)y * width + width - 1] = TYPE_OBJECT_COLLISION;
+	}
+
+	//platform rows: a run of solid cells then a gap, the gap averaging what
+	//makes runs cover "platformDensity" of the row
+	float density = params.platformDensity > 1.0f ? 1.0f : params.platformDensity;
+	for (int y = LEVEL_GEN_ROW_GAP; y < height - 2 && density > 0.0f; y += LEVEL_GEN_ROW_GAP)
+	{
+		for (int x = 1; x < width - 1; )
+		{
+			int run = LEVEL_GEN_MIN_RUN + (int)random.Below(LEVEL_GEN_MAX_RUN - LEVEL_GEN_MIN_RUN + 1);
+			float meanGap = (float)run * (1.0f - density) / density;
+			int gap = (int)(meanGap * 2.0f * (float)random.Below(1024) / 1024.0f);
+			for (int end = x + run; x < end && x < width - 1; ++x)
+				types[(size_t)y * width + x] = TYPE_OBJECT_COLLISION;
+			x += gap;
+		}
+	}
+
+	types[(size_t)1 * width + 1] = TYPE_OBJECT_HERO;
+
+	//every empty cell right above a solid one, the hero's row left out so
+	//nothing spawns on top of it
+	std::vector<size_t> stands;
+	for (int y = 1; y < height - 1; ++y)
+		for (int x = 1; x < width - 1; ++x)
+		{
+			size_t cell = (size_t)y * width + x;
+			if (types[cell] == TYPE_OBJECT_EMPTY && types[cell - width] == TYPE_OBJECT_COLLISION && !(y == 1 && x < 4))
+				stands.push_back(cell);
+		}
+
+	pResult->enemyCount	= PlaceObjects(types, stands, params.enemyCount, TYPE_OBJECT_ENEMY1, random);
+	pResult->coinCount	= PlaceObjects(types, stands, params.coinCount, TYPE_OBJECT_COIN, random);
+	return true;
+}
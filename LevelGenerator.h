@@ -0,0 +1,61 @@
+/******************************************************************************/
+/*!
+\file		LevelGenerator.h
+\author 	DigiPen
+\par    	email: digipen\@digipen.edu
+\date   	February 01, 20xx
+\brief
+Synthetic levels for benchmarks. The level is walled in, with a floor at
+the bottom and platform rows every LEVEL_GEN_ROW_GAP rows above it. Each
+platform row is broken into runs of solid cells that cover about
+"platformDensity" of the row. The hero stands at the bottom left. Enemies
+and coins stand on random solid cells, one object per cell. The same
+parameters and seed always give the same level.
+
+Copyright (C) 20xx DigiPen Institute of Technology.
+Reproduction or disclosure of this file or its contents without the
+prior written consent of DigiPen Institute of Technology is prohibited.
+ */
+/******************************************************************************/
+
+#ifndef LEVEL_GENERATOR_H
+#define LEVEL_GENERATOR_H
+
+#include <cstdint>
+#include <vector>
+
+/******************************************************************************/
+/*!
+	Defines
+*/
+/******************************************************************************/
+const int			LEVEL_GEN_ROW_GAP		= 6;		//Rows from one platform row to the next
+const int			LEVEL_GEN_MIN_RUN		= 4;		//Cells in a platform run
+const int			LEVEL_GEN_MAX_RUN		= 24;
+
+/******************************************************************************/
+/*!
+	Struct/Class Definitions
+*/
+/******************************************************************************/
+struct LevelGenParams
+{
+	int				width;				// cells, at least 4
+	int				height;
+	float			platformDensity;	// 0 to 1, of every platform row
+	unsigned int	enemyCount;
+	unsigned int	coinCount;
+	uint32_t		seed;
+};
+
+struct LevelGenResult
+{
+	std::vector<unsigned char>	types;	// width * height TYPE_OBJECT, row major
+	unsigned int	enemyCount;			// placed, fewer than asked if the platforms are full
+	unsigned int	coinCount;
+};
+
+//False for a level too small to hold the hero
+bool					GenerateLevel(const LevelGenParams& params, LevelGenResult* pResult);
+
+#endif // LEVEL_GENERATOR_H
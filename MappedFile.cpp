@@ -0,0 +1,130 @@
+/******************************************************************************/
+/*!
+\file		MappedFile.cpp
+\author 	DigiPen
+\par    	email: digipen\@digipen.edu
+\date   	February 01, 20xx
+\brief
+Read only memory mapping of a whole file. See MappedFile.h.
+
+Copyright (C) 20xx DigiPen Institute of Technology.
+Reproduction or disclosure of this file or its contents without the
+prior written consent of DigiPen Institute of Technology is prohibited.
+ */
+/******************************************************************************/
+
+#include "MappedFile.h"
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+/******************************************************************************/
+/*!
+
+*/
+/******************************************************************************/
+MappedFile::MappedFile() :
+	Data{ nullptr }, Size{ 0 }
+#ifdef _WIN32
+	, FileHandle{ INVALID_HANDLE_VALUE }, MappingHandle{ nullptr }
+#endif
+{
+}
+
+/******************************************************************************/
+/*!
+
+*/
+/******************************************************************************/
+MappedFile::~MappedFile()
+{
+	Close();
+}
+
+/******************************************************************************/
+/*!
+	Empty files can't be mapped and are reported as a failure
+*/
+/******************************************************************************/
+bool MappedFile::Open(const char *FileName)
+{
+	Close();
+
+#ifdef _WIN32
+	FileHandle = CreateFileA(FileName, GENERIC_READ, FILE_SHARE_READ, nullptr,
+							 OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+	if (FileHandle == INVALID_HANDLE_VALUE)
+		return false;
+
+	LARGE_INTEGER size;
+	if (!GetFileSizeEx(FileHandle, &size) || size.QuadPart == 0) {
+		Close();
+		return false;
+	}
+
+	MappingHandle = CreateFileMappingA(FileHandle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+	if (!MappingHandle) {
+		Close();
+		return false;
+	}
+
+	Data = (const unsigned char*)MapViewOfFile(MappingHandle, FILE_MAP_READ, 0, 0, 0);
+	if (!Data) {
+		Close();
+		return false;
+	}
+	Size = (size_t)size.QuadPart;
+#else
+	int fd = open(FileName, O_RDONLY);
+	if (fd < 0)
+		return false;
+
+	struct stat info;
+	if (fstat(fd, &info) != 0 || info.st_size == 0) {
+		close(fd);
+		return false;
+	}
+
+	// the mapping keeps the file referenced, the descriptor isn't needed
+	void *data = mmap(nullptr, (size_t)info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+	close(fd);
+	if (data == MAP_FAILED)
+		return false;
+
+	Data = (const unsigned char*)data;
+	Size = (size_t)info.st_size;
+#endif
+	return true;
+}
+
+/******************************************************************************/
+/*!
+
+*/
+/******************************************************************************/
+void MappedFile::Close(void)
+{
+#ifdef _WIN32
+	if (Data)
+		UnmapViewOfFile(Data);
+	if (MappingHandle)
+		CloseHandle(MappingHandle);
+	if (FileHandle != INVALID_HANDLE_VALUE)
+		CloseHandle(FileHandle);
+	MappingHandle	= nullptr;
+	FileHandle		= INVALID_HANDLE_VALUE;
+#else
+	if (Data)
+		munmap((void*)Data, Size);
+#endif
+	Data = nullptr;
+	Size = 0;
+}
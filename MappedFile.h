@@ -0,0 +1,52 @@
+/******************************************************************************/
+/*!
+\file		MappedFile.h
+\author 	DigiPen
+\par    	email: digipen\@digipen.edu
+\date   	February 01, 20xx
+\brief
+Read only memory mapping of a whole file. Pages are read in by the OS the
+first time they are touched, so opening costs the same whatever the size.
+
+Copyright (C) 20xx DigiPen Institute of Technology.
+Reproduction or disclosure of this file or its contents without the
+prior written consent of DigiPen Institute of Technology is prohibited.
+ */
+/******************************************************************************/
+
+#ifndef MAPPED_FILE_H
+#define MAPPED_FILE_H
+
+#include <cstddef>
+
+/******************************************************************************/
+/*!
+	Struct/Class Definitions
+*/
+/******************************************************************************/
+class MappedFile
+{
+public:
+	MappedFile();
+	~MappedFile();
+
+	bool				Open(const char *FileName);
+	void				Close(void);
+
+	bool				IsOpen(void) const		{ return Data != nullptr; }
+	const unsigned char*	GetData(void) const	{ return Data; }
+	size_t				GetSize(void) const		{ return Size; }
+
+private:
+	MappedFile(const MappedFile&) = delete;
+	MappedFile& operator=(const MappedFile&) = delete;
+
+	const unsigned char	*Data;
+	size_t				Size;
+#ifdef _WIN32
+	void				*FileHandle;
+	void				*MappingHandle;
+#endif
+};
+
+#endif // MAPPED_FILE_H
@@ -0,0 +1,1094 @@
+/******************************************************************************/
+/*!
+\file		NavGraph.cpp
+\author 	DigiPen
+\par    	email: digipen\@digipen.edu
+\date   	February 01, 20xx
+\brief
+Navigation graph and hierarchical A*. See NavGraph.h.
+
+Copyright (C) 20xx DigiPen Institute of Technology.
+Reproduction or disclosure of this file or its contents without the
+prior written consent of DigiPen Institute of Technology is prohibited.
+ */
+/******************************************************************************/
+
+#include "NavGraph.h"
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+
+//Clusters per job while building
+static const unsigned int	NAV_BUILD_GRAIN = 8;
+static const float			NAV_COST_INF = 1e30f;
+//Where a cluster is when the clusters are searched
+static const unsigned int	NAV_CLUSTER_CENTER = (NAV_CLUSTER_SIZE / 2) * NAV_CLUSTER_SIZE + NAV_CLUSTER_SIZE / 2;
+
+//Min heap order. A* passes the heuristic as the tie: among equal estimates
+//the entry closest to the goal goes first, which cuts the nodes expanded
+//on the many equal cost routes of a tile map.
+static bool HeapAfter(const NavHeapItem& lhs, const NavHeapItem& rhs)
+{
+	if (lhs.key != rhs.key)
+		return lhs.key > rhs.key;
+	if (lhs.tie != rhs.tie)
+		return lhs.tie > rhs.tie;
+	return lhs.value > rhs.value;
+}
+
+static void HeapPush(std::vector<NavHeapItem>& heap, float key, unsigned int value, float tie = 0.0f)
+{
+	heap.push_back({ key, tie, value });
+	std::push_heap(heap.begin(), heap.end(), HeapAfter);
+}
+
+static NavHeapItem HeapPop(std::vector<NavHeapItem>& heap)
+{
+	std::pop_heap(heap.begin(), heap.end(), HeapAfter);
+	NavHeapItem top = heap.back();
+	heap.pop_back();
+	return top;
+}
+
+//Lists a cluster for the next Update, once
+static void MarkDirty(bool& flag, unsigned int cluster, std::vector<unsigned int>& list)
+{
+	if (!flag) {
+		flag = true;
+		list.push_back(cluster);
+	}
+}
+
+/******************************************************************************/
+/*!
+
+*/
+/******************************************************************************/
+NavGraph::NavGraph() :
+	Grid{ nullptr }, Width{ 0 }, Height{ 0 }, OriginX{ 0 }, OriginY{ 0 },
+	ClustersX{ 0 }, ClustersY{ 0 }, AbstractEdgeCount{ 0 }, ResetPending{ true }, CellsDirty{ false }, Stats{}
+{
+}
+
+/******************************************************************************/
+/*!
+
+*/
+/******************************************************************************/
+NavGraph::~NavGraph()
+{
+}
+
+/******************************************************************************/
+/*!
+
+*/
+/******************************************************************************/
+void NavGraph::Clear(void)
+{
+	Grid = nullptr;
+	Width = Height = ClustersX = ClustersY = 0;
+	Clusters.clear();
+	AbstractNodes.clear();
+	AbstractEdges.clear();
+	AbstractEdgeCount = 0;
+	LinksDirty.clear();
+	AbstractDirty.clear();
+	FlattenDirty.clear();
+	ResetPending = true;
+	CellsDirty = false;
+	Stats = NavStats{};
+}
+
+/******************************************************************************/
+/*!
+	Walks and jumps reach at most NAV_JUMP_ACROSS + 1 columns and
+	NAV_JUMP_UP + 1 rows from a node, a cell the walkability of the one
+	above depends on included. A fall runs down a single column, so it only
+	crosses the change from a node next to the changed columns, and from
+	no higher than the open cells above the change go. Call it once the
+	cells changed.
+*/
+/******************************************************************************/
+void NavGraph::InvalidateCells(int X0, int Y0, int X1, int Y1)
+{
+	if (Clusters.empty() || ResetPending)
+		return;
+
+	X0 -= OriginX;
+	X1 -= OriginX;
+	Y0 -= OriginY;
+	Y1 -= OriginY;
+	if (X1 < 0 || X0 >= Width || Y1 < 0 || Y0 >= Height)
+		return;
+
+	// the highest row a fall through the changed columns starts on
+	int fallTop = Y1;
+	for (int x = X0 > 0 ? X0 : 0; x <= X1 && x < Width; ++x)
+	{
+		int y = Y1 + 1;
+		while (y < Height && !IsSolid(x, y))
+			++y;
+		fallTop = y - 1 > fallTop ? y - 1 : fallTop;
+	}
+
+	InvalidateClusters(X0 - NAV_JUMP_ACROSS - 1, Y0 - NAV_JUMP_UP - 2, X1 + NAV_JUMP_ACROSS + 1, Y1 + NAV_JUMP_UP + 2);
+	InvalidateClusters(X0 - 1, Y0 - 1, X1 + 1, fallTop);
+	CellsDirty = true;
+}
+
+/******************************************************************************/
+/*!
+	Lists every cluster over graph cells [x0, x1] x [y0, y1]
+*/
+/******************************************************************************/
+void NavGraph::InvalidateClusters(int x0, int y0, int x1, int y1)
+{
+	x0 = x0 < 0 ? 0 : x0;
+	y0 = y0 < 0 ? 0 : y0;
+	x1 = x1 >= Width ? Width - 1 : x1;
+	y1 = y1 >= Height ? Height - 1 : y1;
+
+	for (int cy = y0 / NAV_CLUSTER_SIZE; cy <= y1 / NAV_CLUSTER_SIZE; ++cy)
+		for (int cx = x0 / NAV_CLUSTER_SIZE; cx <= x1 / NAV_CLUSTER_SIZE; ++cx)
+			MarkDirty(Clusters[cy * ClustersX + cx].linksDirty, cy * ClustersX + cx, LinksDirty);
+}
+
+/******************************************************************************/
+/*!
+
+*/
+/******************************************************************************/
+bool NavGraph::NeedsUpdate(void) const
+{
+	return ResetPending || CellsDirty;
+}
+
+/******************************************************************************/
+/*!
+	Links are built in parallel, each cluster only writes its own. Hooking
+	up the entries of the clusters they lead into is serial and cheap, then
+	the entrance to entrance searches run in parallel again. Only the
+	clusters listed since the last Update are touched, whatever the map
+	size.
+*/
+/******************************************************************************/
+void NavGraph::Update(const TileMap& map, JobSystem& jobs)
+{
+	if (ResetPending)
+		Layout(map);
+	Grid = &map.GetCollisionGrid();
+
+	Stats.clustersRebuilt = (unsigned int)LinksDirty.size();
+	for (unsigned int c : LinksDirty) {
+		Stats.nodes -= Clusters[c].nodeCount;
+		Stats.links -= (unsigned int)Clusters[c].links.size();
+	}
+	jobs.ParallelFor((unsigned int)LinksDirty.size(), NAV_BUILD_GRAIN, [&](unsigned int begin, unsigned int end) {
+		for (unsigned int k = begin; k < end; ++k)
+			BuildLinks(LinksDirty[k]);
+	});
+	for (unsigned int c : LinksDirty) {
+		Stats.nodes += Clusters[c].nodeCount;
+		Stats.links += (unsigned int)Clusters[c].links.size();
+		LinkClusters(c);
+	}
+	LinksDirty.clear();
+
+	BuildScratch.resize(jobs.GetWorkerCount() + 1);
+	jobs.ParallelFor((unsigned int)AbstractDirty.size(), NAV_BUILD_GRAIN, [&](unsigned int begin, unsigned int end) {
+		NavScratch& scratch = BuildScratch[jobs.GetThreadIndex()];
+		for (unsigned int k = begin; k < end; ++k)
+			BuildAbstract(AbstractDirty[k], scratch);
+	});
+
+	// the rebuilt clusters and whatever links into them
+	for (unsigned int c : AbstractDirty) {
+		MarkDirty(Clusters[c].flattenDirty, c, FlattenDirty);
+		for (const NavEntry& e : Clusters[c].entries)
+			MarkDirty(Clusters[e.fromCluster].flattenDirty, e.fromCluster, FlattenDirty);
+	}
+	jobs.ParallelFor((unsigned int)FlattenDirty.size(), NAV_BUILD_GRAIN, [&](unsigned int begin, unsigned int end) {
+		for (unsigned int k = begin; k < end; ++k)
+			ResolveCrossLinks(FlattenDirty[k]);
+	});
+
+	// numbered in cluster order, whatever order they were listed in
+	std::sort(AbstractDirty.begin(), AbstractDirty.end());
+	for (unsigned int c : AbstractDirty)
+		PlaceEntrances(c);
+	for (unsigned int c : FlattenDirty) {
+		FlattenCluster(c);
+		Clusters[c].flattenDirty = false;
+	}
+	AbstractDirty.clear();
+	FlattenDirty.clear();
+
+	if (AbstractNodes.size() - Stats.entrances > Stats.entrances ||
+		AbstractEdges.size() - AbstractEdgeCount > AbstractEdgeCount)
+		CompactAbstract();
+
+	Stats.clusters = (unsigned int)Clusters.size();
+	CellsDirty = false;
+}
+
+/******************************************************************************/
+/*!
+	Numbers a rebuilt cluster's entrances in the whole graph: in the slots
+	it had when they fit, in new ones at the end when they don't. Every
+	cluster linking into it is flattened again after, the entrances it had
+	are no longer referenced.
+*/
+/******************************************************************************/
+void NavGraph::PlaceEntrances(unsigned int cluster)
+{
+	NavCluster& k = Clusters[cluster];
+	unsigned int n = (unsigned int)k.entrances.size();
+
+	if (n > k.abstractCapacity) {
+		for (unsigned int i = 0; i < k.abstractCapacity; ++i)
+			AbstractNodes[k.abstractBase + i] = { NAV_NODE_NONE, 0, 0 };
+		k.abstractBase		= (unsigned int)AbstractNodes.size();
+		k.abstractCapacity	= n;
+		AbstractNodes.resize(AbstractNodes.size() + n);
+	}
+	for (unsigned int i = 0; i < k.abstractCapacity; ++i)
+		AbstractNodes[k.abstractBase + i] = { i < n ? cluster << 8 | k.entrances[i] : NAV_NODE_NONE, 0, 0 };
+
+	Stats.entrances += n - k.abstractCount;
+	k.abstractCount = n;
+}
+
+/******************************************************************************/
+/*!
+	Copies a cluster's resolved edges out, so a search only walks two
+	arrays. The edges go where the cluster's were when they fit.
+*/
+/******************************************************************************/
+void NavGraph::FlattenCluster(unsigned int cluster)
+{
+	NavCluster& k = Clusters[cluster];
+	unsigned int count = 0;
+	for (const NavAbstractLink& link : k.abstractLinks)
+		count += link.entrance != NAV_ENTRANCE_NONE;
+
+	if (count > k.edgeCapacity) {
+		k.edgeBase		= (unsigned int)AbstractEdges.size();
+		k.edgeCapacity	= count;
+		AbstractEdges.resize(AbstractEdges.size() + count);
+	}
+	AbstractEdgeCount += count - k.edgeCount;
+	k.edgeCount = count;
+
+	unsigned int e = k.edgeBase;
+	for (unsigned int i = 0; i < k.abstractCount; ++i)
+	{
+		NavAbstractNode& a = AbstractNodes[k.abstractBase + i];
+		a.edgeStart = e;
+		for (unsigned int l = k.abstractStart[i]; l < k.abstractStart[i + 1]; ++l)
+		{
+			const NavAbstractLink& link = k.abstractLinks[l];
+			if (link.entrance != NAV_ENTRANCE_NONE)
+				AbstractEdges[e++] = { Clusters[link.cluster].abstractBase + link.entrance, link.cost };
+		}
+		a.edgeEnd = e;
+	}
+}
+
+/******************************************************************************/
+/*!
+	Numbers every entrance and edge afresh, in cluster order, once more
+	slots are unused than used
+*/
+/******************************************************************************/
+void NavGraph::CompactAbstract(void)
+{
+	AbstractNodes.clear();
+	AbstractEdges.clear();
+	AbstractEdgeCount = 0;
+	Stats.entrances = 0;
+	for (NavCluster& k : Clusters) {
+		k.abstractBase = k.abstractCount = k.abstractCapacity = 0;
+		k.edgeBase = k.edgeCount = k.edgeCapacity = 0;
+	}
+
+	for (unsigned int c = 0; c < Clusters.size(); ++c)
+		PlaceEntrances(c);
+	for (unsigned int c = 0; c < Clusters.size(); ++c)
+		FlattenCluster(c);
+}
+
+/******************************************************************************/
+/*!
+
+*/
+/******************************************************************************/
+void NavGraph::Layout(const TileMap& map)
+{
+	Grid		= &map.GetCollisionGrid();
+	Width		= map.GetWidth();
+	Height		= map.GetHeight();
+	OriginX		= map.GetOriginX();
+	OriginY		= map.GetOriginY();
+	ClustersX	= (Width + NAV_CLUSTER_SIZE - 1) / NAV_CLUSTER_SIZE;
+	ClustersY	= (Height + NAV_CLUSTER_SIZE - 1) / NAV_CLUSTER_SIZE;
+
+	Clusters.clear();
+	Clusters.resize((size_t)ClustersX * ClustersY);
+	AbstractNodes.clear();
+	AbstractEdges.clear();
+	AbstractEdgeCount = 0;
+	LinksDirty.clear();
+	AbstractDirty.clear();
+	FlattenDirty.clear();
+	Stats = NavStats{};
+	for (unsigned int c = 0; c < Clusters.size(); ++c) {
+		NavCluster& k = Clusters[c];
+		memset(k.walkable, 0, sizeof(k.walkable));
+		memset(k.linkStart, 0, sizeof(k.linkStart));
+		k.nodeCount			= 0;
+		k.abstractBase		= 0;
+		k.abstractCount		= 0;
+		k.abstractCapacity	= 0;
+		k.edgeBase			= 0;
+		k.edgeCount			= 0;
+		k.edgeCapacity		= 0;
+		k.linksDirty		= false;
+		k.abstractDirty		= false;
+		k.flattenDirty		= false;
+		MarkDirty(k.linksDirty, c, LinksDirty);
+	}
+	ResetPending = false;
+}
+
+/******************************************************************************/
+/*!
+	Walk to a standable neighbour; otherwise, if the neighbour is open,
+	fall down its column to the first cell with ground. Then every jump
+	target in reach whose arc (straight up, across, straight down, one row
+	above the higher end) is clear.
+*/
+/******************************************************************************/
+void NavGraph::BuildLinks(unsigned int cluster)
+{
+	NavCluster& k = Clusters[cluster];
+	int x0 = (int)(cluster % ClustersX) * NAV_CLUSTER_SIZE;
+	int y0 = (int)(cluster / ClustersX) * NAV_CLUSTER_SIZE;
+
+	memset(k.walkable, 0, sizeof(k.walkable));
+	k.links.clear();
+	k.nodeCount = 0;
+
+	for (int cell = 0; cell < NAV_CLUSTER_CELLS; ++cell)
+	{
+		k.linkStart[cell] = (unsigned int)k.links.size();
+		int x = x0 + cell % NAV_CLUSTER_SIZE, y = y0 + cell / NAV_CLUSTER_SIZE;
+		if (!IsWalkable(x, y))
+			continue;
+		k.walkable[cell >> 5] |= 1u << (cell & 31);
+		++k.nodeCount;
+
+		for (int dx = -1; dx <= 1; dx += 2)
+		{
+			int nx = x + dx;
+			if (nx < 0 || nx >= Width || IsSolid(nx, y))
+				continue;
+			if (IsWalkable(nx, y)) {
+				k.links.push_back({ NodeOf(nx, y), 1.0f, NAV_LINK_WALK });
+				continue;
+			}
+			// every cell passed is open, the first one with ground is the landing
+			for (int ny = y - 1; ny >= 0; --ny)
+				if (IsWalkable(nx, ny)) {
+					k.links.push_back({ NodeOf(nx, ny), 1.0f + NAV_FALL_COST * (y - ny), NAV_LINK_FALL });
+					break;
+				}
+		}
+
+		for (int dy = -NAV_JUMP_UP; dy <= NAV_JUMP_UP; ++dy)
+			for (int dx = -NAV_JUMP_ACROSS; dx <= NAV_JUMP_ACROSS; ++dx)
+			{
+				// next door is a walk or a fall
+				if (dx == 0 || ((dx == 1 || dx == -1) && dy <= 0))
+					continue;
+				int tx = x + dx, ty = y + dy;
+				if (!IsWalkable(tx, ty) || !IsJumpClear(x, y, tx, ty))
+					continue;
+				k.links.push_back({ NodeOf(tx, ty), (float)(abs(dx) + abs(dy)) + NAV_JUMP_PENALTY, NAV_LINK_JUMP });
+			}
+	}
+	k.linkStart[NAV_CLUSTER_CELLS] = (unsigned int)k.links.size();
+}
+
+/******************************************************************************/
+/*!
+	Replaces the entries "cluster" had made in other clusters with the ones
+	its new links make, one per cell reached. Only the clusters whose cells
+	reached from it changed get their entrances rebuilt.
+*/
+/******************************************************************************/
+void NavGraph::LinkClusters(unsigned int cluster)
+{
+	NavCluster& k = Clusters[cluster];
+	std::vector<unsigned int> before, after;		// nodes reached in other clusters, sorted
+
+	for (unsigned int t : k.targets)
+	{
+		std::vector<NavEntry>& entries = Clusters[t].entries;
+		for (const NavEntry& e : entries)
+			if (e.fromCluster == cluster)
+				before.push_back(t << 8 | e.cell);
+		entries.erase(std::remove_if(entries.begin(), entries.end(),
+									 [cluster](const NavEntry& e) { return e.fromCluster == cluster; }),
+					  entries.end());
+	}
+	std::sort(before.begin(), before.end());
+
+	for (const NavLink& link : k.links)
+		if (link.to >> 8 != cluster)
+			after.push_back(link.to);
+	std::sort(after.begin(), after.end());
+	after.erase(std::unique(after.begin(), after.end()), after.end());
+
+	k.targets.clear();
+	for (unsigned int node : after)
+	{
+		unsigned int t = node >> 8;
+		Clusters[t].entries.push_back({ cluster, (unsigned char)(node & 0xFF) });
+		if (k.targets.empty() || k.targets.back() != t)
+			k.targets.push_back(t);
+	}
+
+	// both lists are grouped by cluster, compared one cluster at a time
+	for (size_t i = 0, j = 0; i < before.size() || j < after.size(); )
+	{
+		unsigned int t = i < before.size() ? before[i] >> 8 : after[j] >> 8;
+		if (j < after.size() && after[j] >> 8 < t)
+			t = after[j] >> 8;
+		size_t i1 = i, j1 = j;
+		while (i1 < before.size() && before[i1] >> 8 == t)
+			++i1;
+		while (j1 < after.size() && after[j1] >> 8 == t)
+			++j1;
+		if (!std::equal(before.begin() + i, before.begin() + i1, after.begin() + j, after.begin() + j1))
+			MarkDirty(Clusters[t].abstractDirty, t, AbstractDirty);
+		i = i1;
+		j = j1;
+	}
+
+	k.linksDirty = false;
+	MarkDirty(k.abstractDirty, cluster, AbstractDirty);
+}
+
+/******************************************************************************/
+/*!
+	Entrances and one shortest path tree per entrance
+*/
+/******************************************************************************/
+void NavGraph::BuildAbstract(unsigned int cluster, NavScratch& scratch)
+{
+	NavCluster& k = Clusters[cluster];
+
+	k.entrances.clear();
+	for (int cell = 0; cell < NAV_CLUSTER_CELLS; ++cell)
+		for (unsigned int l = k.linkStart[cell]; l < k.linkStart[cell + 1]; ++l)
+			if (k.links[l].to >> 8 != cluster) {
+				k.entrances.push_back((unsigned char)cell);
+				break;
+			}
+	for (const NavEntry& e : k.entries)
+		k.entrances.push_back(e.cell);
+	std::sort(k.entrances.begin(), k.entrances.end());
+	k.entrances.erase(std::unique(k.entrances.begin(), k.entrances.end()), k.entrances.end());
+
+	unsigned int n = (unsigned int)k.entrances.size();
+	std::vector<float>& cost = scratch.entranceCost;
+	cost.resize((size_t)n * n);
+	k.entranceTree.resize((size_t)n * NAV_CLUSTER_CELLS);
+	for (unsigned int i = 0; i < n; ++i)
+	{
+		SearchCluster(cluster, k.entrances[i], false, scratch, scratch.dist, &k.entranceTree[(size_t)i * NAV_CLUSTER_CELLS]);
+		for (unsigned int j = 0; j < n; ++j)
+			cost[(size_t)i * n + j] = scratch.dist[k.entrances[j]];
+	}
+
+	// i -> j is dropped when some i -> m -> j costs no more: both legs are
+	// cheaper than i -> j (every link costs 1 or more) so they, or what
+	// replaces them, stay. Costs are multiples of a half, the sums are exact.
+	k.abstractStart.resize(n + 1);
+	k.abstractLinks.clear();
+	for (unsigned int i = 0; i < n; ++i)
+	{
+		k.abstractStart[i] = (unsigned int)k.abstractLinks.size();
+		const float *from = &cost[(size_t)i * n];
+		for (unsigned int j = 0; j < n; ++j)
+		{
+			if (j == i || from[j] >= NAV_COST_INF)
+				continue;
+			bool through = false;
+			for (unsigned int m = 0; m < n && !through; ++m)
+				through = m != i && m != j && from[m] + cost[(size_t)m * n + j] <= from[j];
+			if (!through)
+				k.abstractLinks.push_back({ cluster, from[j], (unsigned short)j, k.entrances[j] });
+		}
+
+		unsigned int cell = k.entrances[i];
+		for (unsigned int l = k.linkStart[cell]; l < k.linkStart[cell + 1]; ++l)
+			if (k.links[l].to >> 8 != cluster)
+				k.abstractLinks.push_back({ k.links[l].to >> 8, k.links[l].cost, NAV_ENTRANCE_NONE,
+											(unsigned char)(k.links[l].to & 0xFF) });
+	}
+	k.abstractStart[n] = (unsigned int)k.abstractLinks.size();
+	k.abstractDirty = false;
+}
+
+/******************************************************************************/
+/*!
+	Entrance indices of the clusters the links out of "cluster" reach, to be
+	redone whenever those clusters get new entrances
+*/
+/******************************************************************************/
+void NavGraph::ResolveCrossLinks(unsigned int cluster)
+{
+	for (NavAbstractLink& link : Clusters[cluster].abstractLinks)
+	{
+		if (link.cluster == cluster)
+			continue;
+		const std::vector<unsigned char>& entrances = Clusters[link.cluster].entrances;
+		auto it = std::lower_bound(entrances.begin(), entrances.end(), link.cell);
+		link.entrance = it != entrances.end() && *it == link.cell ? (unsigned short)(it - entrances.begin())
+																   : NAV_ENTRANCE_NONE;
+	}
+}
+
+/******************************************************************************/
+/*!
+	Unreached cells keep NAV_COST_INF and are their own parent
+*/
+/******************************************************************************/
+void NavGraph::SearchCluster(unsigned int cluster, unsigned int cell, bool reverse, NavScratch& scratch,
+							 float* dist, unsigned char* parent) const
+{
+	const NavCluster& k = Clusters[cluster];
+
+	for (int c = 0; c < NAV_CLUSTER_CELLS; ++c) {
+		dist[c] = NAV_COST_INF;
+		parent[c] = (unsigned char)c;
+	}
+
+	// links of the cluster turned around, grouped by the cell they reach
+	if (reverse) {
+		scratch.reverseStart.assign(NAV_CLUSTER_CELLS + 1, 0);
+		for (const NavLink& link : k.links)
+			if (link.to >> 8 == cluster)
+				++scratch.reverseStart[(link.to & 0xFF) + 1];
+		for (int c = 0; c < NAV_CLUSTER_CELLS; ++c)
+			scratch.reverseStart[c + 1] += scratch.reverseStart[c];
+		scratch.reverseFrom.resize(scratch.reverseStart[NAV_CLUSTER_CELLS]);
+		scratch.reverseCost.resize(scratch.reverseStart[NAV_CLUSTER_CELLS]);
+
+		unsigned int next[NAV_CLUSTER_CELLS];
+		memcpy(next, scratch.reverseStart.data(), sizeof(next));
+		for (int c = 0; c < NAV_CLUSTER_CELLS; ++c)
+			for (unsigned int l = k.linkStart[c]; l < k.linkStart[c + 1]; ++l)
+				if (k.links[l].to >> 8 == cluster) {
+					unsigned int slot = next[k.links[l].to & 0xFF]++;
+					scratch.reverseFrom[slot] = (unsigned char)c;
+					scratch.reverseCost[slot] = k.links[l].cost;
+				}
+	}
+
+	std::vector<NavHeapItem>& heap = scratch.heap;
+	heap.clear();
+	dist[cell] = 0.0f;
+	HeapPush(heap, 0.0f, cell);
+	while (!heap.empty())
+	{
+		NavHeapItem top = HeapPop(heap);
+		unsigned int u = top.value;
+		if (top.key > dist[u])
+			continue;
+
+		if (reverse) {
+			for (unsigned int r = scratch.reverseStart[u]; r < scratch.reverseStart[u + 1]; ++r)
+			{
+				unsigned int v = scratch.reverseFrom[r];
+				float d = top.key + scratch.reverseCost[r];
+				if (d < dist[v]) {
+					dist[v] = d;
+					parent[v] = (unsigned char)u;
+					HeapPush(heap, d, v);
+				}
+			}
+		}
+		else {
+			for (unsigned int l = k.linkStart[u]; l < k.linkStart[u + 1]; ++l)
+			{
+				const NavLink& link = k.links[l];
+				if (link.to >> 8 != cluster)
+					continue;
+				unsigned int v = link.to & 0xFF;
+				float d = top.key + link.cost;
+				if (d < dist[v]) {
+					dist[v] = d;
+					parent[v] = (unsigned char)u;
+					HeapPush(heap, d, v);
+				}
+			}
+		}
+	}
+}
+
+/******************************************************************************/
+/*!
+	The cheapest link between two nodes, the one every search takes
+*/
+/******************************************************************************/
+const NavLink* NavGraph::FindLink(unsigned int from, unsigned int to) const
+{
+	const NavCluster& k = Clusters[from >> 8];
+	const NavLink* pBest = nullptr;
+	for (unsigned int l = k.linkStart[from & 0xFF]; l < k.linkStart[(from & 0xFF) + 1]; ++l)
+		if (k.links[l].to == to && (!pBest || k.links[l].cost < pBest->cost))
+			pBest = &k.links[l];
+	return pBest;
+}
+
+/******************************************************************************/
+/*!
+	The node at or at most NAV_SNAP_DEPTH rows below a level cell
+*/
+/******************************************************************************/
+bool NavGraph::SnapToNode(int X, int Y, unsigned int* pNode) const
+{
+	int x = X - OriginX, y = Y - OriginY;
+	for (int depth = 0; depth <= NAV_SNAP_DEPTH; ++depth, --y)
+		if (IsNode(x, y)) {
+			*pNode = NodeOf(x, y);
+			return true;
+		}
+	return false;
+}
+
+/******************************************************************************/
+/*!
+
+*/
+/******************************************************************************/
+void NavGraph::PushNode(unsigned int node, std::vector<NavWaypoint>* pPath) const
+{
+	int x, y;
+	CellOf(node, &x, &y);
+	pPath->push_back({ x + OriginX, y + OriginY, NAV_LINK_START });
+}
+
+/******************************************************************************/
+/*!
+	Fills in how each waypoint is reached from the one before
+*/
+/******************************************************************************/
+void NavGraph::FinishPath(std::vector<NavWaypoint>* pPath) const
+{
+	std::vector<NavWaypoint>& path = *pPath;
+	for (size_t i = 1; i < path.size(); ++i)
+	{
+		const NavLink* pLink = FindLink(NodeOf(path[i - 1].x - OriginX, path[i - 1].y - OriginY),
+										NodeOf(path[i].x - OriginX, path[i].y - OriginY));
+		path[i].link = pLink ? pLink->type : NAV_LINK_WALK;
+	}
+}
+
+/******************************************************************************/
+/*!
+	A lower bound from what each link costs at least: a column crossed
+	costs 1; a row climbed costs 1 and needs a jump every NAV_JUMP_UP rows;
+	a row dropped costs NAV_FALL_COST. No link lowers the bound by more than
+	its cost, so A* never needs to reopen a node.
+*/
+/******************************************************************************/
+float NavGraph::Heuristic(unsigned int node, unsigned int goal) const
+{
+	int x, y, gx, gy;
+	CellOf(node, &x, &y);
+	CellOf(goal, &gx, &gy);
+	float across = (float)abs(gx - x);
+	if (gy > y)
+		return across + (float)(gy - y) + (float)((gy - y + NAV_JUMP_UP - 1) / NAV_JUMP_UP) * NAV_JUMP_PENALTY;
+	return across + (float)(y - gy) * NAV_FALL_COST;
+}
+
+/******************************************************************************/
+/*!
+	Invalidates the previous search's state without touching it
+*/
+/******************************************************************************/
+void NavGraph::BeginSearch(NavScratch& scratch, unsigned int size) const
+{
+	if (scratch.state.size() < size) {
+		scratch.cost.resize(size);
+		scratch.from.resize(size);
+		scratch.state.resize(size, 0);
+	}
+	if (++scratch.stamp >= 0x80000000u) {
+		std::fill(scratch.state.begin(), scratch.state.end(), 0u);
+		scratch.stamp = 1;
+	}
+	scratch.heap.clear();
+}
+
+/******************************************************************************/
+/*!
+	A* over the clusters, from the start's to the goal's along the clusters
+	each one's links lead into, a hop costing the heuristic between their
+	centers. The clusters of the route and the ones NAV_CORRIDOR_RADIUS
+	around them are marked with the search's stamp, returned in "pCorridor"; 0 when the ends
+	are too close to bother. False when the goal's cluster can't be reached,
+	and then neither can the goal.
+*/
+/******************************************************************************/
+bool NavGraph::FindCorridor(unsigned int start, unsigned int goal, NavScratch& scratch, unsigned int* pCorridor) const
+{
+	unsigned int from = start >> 8, to = goal >> 8;
+	int fromX = (int)(from % ClustersX), fromY = (int)(from / ClustersX);
+	int toX = (int)(to % ClustersX), toY = (int)(to / ClustersX);
+	*pCorridor = 0;
+	if (abs(toX - fromX) < NAV_CORRIDOR_MIN && abs(toY - fromY) < NAV_CORRIDOR_MIN)
+		return true;
+
+	BeginSearch(scratch, (unsigned int)Clusters.size());
+	const unsigned int open = scratch.stamp << 1, closed = open | 1;
+	const unsigned int goalCenter = to << 8 | NAV_CLUSTER_CENTER;
+	scratch.state[from] = open;
+	scratch.cost[from] = 0.0f;
+	scratch.from[from] = NAV_NODE_NONE;
+	HeapPush(scratch.heap, Heuristic(from << 8 | NAV_CLUSTER_CENTER, goalCenter), from);
+
+	bool found = false;
+	while (!scratch.heap.empty())
+	{
+		unsigned int u = HeapPop(scratch.heap).value;
+		if (scratch.state[u] == closed)
+			continue;
+		scratch.state[u] = closed;
+		if (u == to) {
+			found = true;
+			break;
+		}
+
+		for (unsigned int t : Clusters[u].targets)
+		{
+			float cost = scratch.cost[u] + Heuristic(u << 8 | NAV_CLUSTER_CENTER, t << 8 | NAV_CLUSTER_CENTER);
+			if (scratch.state[t] >> 1 != scratch.stamp) {
+				scratch.state[t] = open;
+				scratch.cost[t] = NAV_COST_INF;
+			}
+			if (scratch.state[t] == open && cost < scratch.cost[t]) {
+				scratch.cost[t] = cost;
+				scratch.from[t] = u;
+				float estimate = Heuristic(t << 8 | NAV_CLUSTER_CENTER, goalCenter);
+				HeapPush(scratch.heap, cost + estimate, t, estimate);
+			}
+		}
+	}
+	if (!found)
+		return false;
+
+	if (scratch.corridor.size() < Clusters.size())
+		scratch.corridor.resize(Clusters.size(), 0);
+	for (unsigned int c = to; c != NAV_NODE_NONE; c = scratch.from[c])
+	{
+		int cx = (int)(c % ClustersX), cy = (int)(c / ClustersX);
+		for (int y = cy - NAV_CORRIDOR_RADIUS; y <= cy + NAV_CORRIDOR_RADIUS; ++y)
+			for (int x = cx - NAV_CORRIDOR_RADIUS; x <= cx + NAV_CORRIDOR_RADIUS; ++x)
+				if (x >= 0 && x < ClustersX && y >= 0 && y < ClustersY)
+					scratch.corridor[y * ClustersX + x] = scratch.stamp;
+	}
+	*pCorridor = scratch.stamp;
+	return true;
+}
+
+/******************************************************************************/
+/*!
+	Searches the entrances, seeded with the cost from the start to every
+	entrance of its cluster, leaving out the clusters outside "corridor"
+	unless it is 0. Reaching an entrance of the goal's cluster offers its
+	cost to the goal; the search stops once nothing in the open list can
+	beat the best offer (or the direct path when both ends share a
+	cluster). "scratch.from" then holds the chain of entrances.
+*/
+/******************************************************************************/
+void NavGraph::SearchEntrances(unsigned int start, unsigned int goal, unsigned int corridor, NavScratch& scratch,
+							   float* pBest, unsigned int* pBestEntrance) const
+{
+	unsigned int startCluster = start >> 8, goalCluster = goal >> 8;
+	float best = startCluster == goalCluster ? scratch.startDist[goal & 0xFF] : NAV_COST_INF;
+	unsigned int bestEntrance = NAV_NODE_NONE;
+
+	BeginSearch(scratch, (unsigned int)AbstractNodes.size());
+	const unsigned int open = scratch.stamp << 1, closed = open | 1;
+	auto relax = [&](unsigned int a, float cost, unsigned int from) {
+		unsigned int node = AbstractNodes[a].node;
+		if (corridor && scratch.corridor[node >> 8] != corridor)
+			return;
+		if (scratch.state[a] >> 1 != scratch.stamp) {
+			scratch.state[a] = open;
+			scratch.cost[a] = NAV_COST_INF;
+		}
+		if (scratch.state[a] == open && cost < scratch.cost[a]) {
+			scratch.cost[a] = cost;
+			scratch.from[a] = from;
+			float estimate = Heuristic(node, goal);
+			HeapPush(scratch.heap, cost + estimate, a, estimate);
+		}
+	};
+
+	const NavCluster& first = Clusters[startCluster];
+	for (size_t i = 0; i < first.entrances.size(); ++i)
+		if (scratch.startDist[first.entrances[i]] < NAV_COST_INF)
+			relax(first.abstractBase + (unsigned int)i, scratch.startDist[first.entrances[i]], NAV_NODE_NONE);
+
+	while (!scratch.heap.empty())
+	{
+		NavHeapItem top = HeapPop(scratch.heap);
+		unsigned int a = top.value;
+		if (top.key >= best)
+			break;
+		if (scratch.state[a] == closed)
+			continue;
+		scratch.state[a] = closed;
+
+		const NavAbstractNode& entrance = AbstractNodes[a];
+		float cost = scratch.cost[a];
+		if (entrance.node >> 8 == goalCluster && cost + scratch.goalDist[entrance.node & 0xFF] < best) {
+			best = cost + scratch.goalDist[entrance.node & 0xFF];
+			bestEntrance = a;
+		}
+
+		for (unsigned int e = entrance.edgeStart; e < entrance.edgeEnd; ++e)
+			relax(AbstractEdges[e].to, cost + AbstractEdges[e].cost, a);
+	}
+
+	*pBest = best;
+	*pBestEntrance = bestEntrance;
+}
+
+/******************************************************************************/
+/*!
+	Far apart ends search the entrances in a corridor first, and all of
+	them when it holds no path. The path is then expanded: start to first
+	entrance, each hop through a cluster along the cached tree, cross links
+	as they are, last entrance to goal.
+*/
+/******************************************************************************/
+bool NavGraph::FindPath(int fromX, int fromY, int toX, int toY, NavScratch& scratch,
+						std::vector<NavWaypoint>* pPath, float* pCost) const
+{
+	unsigned int start, goal, corridor;
+	pPath->clear();
+	if (ResetPending || !SnapToNode(fromX, fromY, &start) || !SnapToNode(toX, toY, &goal))
+		return false;
+
+	unsigned int startCluster = start >> 8, goalCluster = goal >> 8;
+	unsigned int goalCell = goal & 0xFF;
+	SearchCluster(startCluster, start & 0xFF, false, scratch, scratch.startDist, scratch.startParent);
+	SearchCluster(goalCluster, goalCell, true, scratch, scratch.goalDist, scratch.goalNext);
+	if (!FindCorridor(start, goal, scratch, &corridor))
+		return false;
+
+	float best;
+	unsigned int bestEntrance;
+	SearchEntrances(start, goal, corridor, scratch, &best, &bestEntrance);
+	if (best >= NAV_COST_INF && corridor)
+		SearchEntrances(start, goal, 0, scratch, &best, &bestEntrance);
+	if (best >= NAV_COST_INF)
+		return false;
+
+	std::vector<NavWaypoint>& path = *pPath;
+	if (bestEntrance == NAV_NODE_NONE) {
+		for (unsigned int c = goalCell; c != (start & 0xFF); c = scratch.startParent[c])
+			PushNode(startCluster << 8 | c, pPath);
+		PushNode(start, pPath);
+		std::reverse(path.begin(), path.end());
+	}
+	else {
+		std::vector<unsigned int>& chain = scratch.chain;
+		chain.clear();
+		for (unsigned int a = bestEntrance; a != NAV_NODE_NONE; a = scratch.from[a])
+			chain.push_back(a);
+		std::reverse(chain.begin(), chain.end());
+
+		// start to the first entrance
+		for (unsigned int c = AbstractNodes[chain[0]].node & 0xFF; c != (start & 0xFF); c = scratch.startParent[c])
+			PushNode(startCluster << 8 | c, pPath);
+		PushNode(start, pPath);
+		std::reverse(path.begin(), path.end());
+
+		for (size_t h = 1; h < chain.size(); ++h)
+		{
+			unsigned int node = AbstractNodes[chain[h]].node, prev = AbstractNodes[chain[h - 1]].node;
+			unsigned int cluster = node >> 8;
+			if (prev >> 8 != cluster) {
+				PushNode(node, pPath);
+				continue;
+			}
+			const NavCluster& k = Clusters[cluster];
+			const unsigned char* tree = &k.entranceTree[(size_t)(chain[h - 1] - k.abstractBase) * NAV_CLUSTER_CELLS];
+			size_t mark = path.size();
+			for (unsigned int c = node & 0xFF; c != (prev & 0xFF); c = tree[c])
+				PushNode(cluster << 8 | c, pPath);
+			std::reverse(path.begin() + mark, path.end());
+		}
+
+		// last entrance to the goal
+		for (unsigned int c = AbstractNodes[bestEntrance].node & 0xFF; c != goalCell; )
+		{
+			c = scratch.goalNext[c];
+			PushNode(goalCluster << 8 | c, pPath);
+		}
+	}
+
+	FinishPath(pPath);
+	if (pCost)
+		*pCost = best;
+	return true;
+}
+
+/******************************************************************************/
+/*!
+
+*/
+/******************************************************************************/
+bool NavGraph::FindPathFlat(int fromX, int fromY, int toX, int toY, NavScratch& scratch,
+							std::vector<NavWaypoint>* pPath, float* pCost) const
+{
+	unsigned int start, goal;
+	pPath->clear();
+	if (ResetPending || !SnapToNode(fromX, fromY, &start) || !SnapToNode(toX, toY, &goal))
+		return false;
+
+	BeginSearch(scratch, (unsigned int)Clusters.size() * NAV_CLUSTER_CELLS);
+	const unsigned int open = scratch.stamp << 1, closed = open | 1;
+	scratch.state[start] = open;
+	scratch.cost[start] = 0.0f;
+	scratch.from[start] = NAV_NODE_NONE;
+	HeapPush(scratch.heap, Heuristic(start, goal), start);
+
+	bool found = false;
+	while (!scratch.heap.empty())
+	{
+		unsigned int u = HeapPop(scratch.heap).value;
+		if (scratch.state[u] == closed)
+			continue;
+		scratch.state[u] = closed;
+		if (u == goal) {
+			found = true;
+			break;
+		}
+
+		const NavCluster& k = Clusters[u >> 8];
+		for (unsigned int l = k.linkStart[u & 0xFF]; l < k.linkStart[(u & 0xFF) + 1]; ++l)
+		{
+			unsigned int v = k.links[l].to;
+			float cost = scratch.cost[u] + k.links[l].cost;
+			if (scratch.state[v] >> 1 != scratch.stamp) {
+				scratch.state[v] = open;
+				scratch.cost[v] = NAV_COST_INF;
+			}
+			if (scratch.state[v] == open && cost < scratch.cost[v]) {
+				scratch.cost[v] = cost;
+				scratch.from[v] = u;
+				float estimate = Heuristic(v, goal);
+				HeapPush(scratch.heap, cost + estimate, v, estimate);
+			}
+		}
+	}
+	if (!found)
+		return false;
+
+	for (unsigned int u = goal; u != NAV_NODE_NONE; u = scratch.from[u])
+		PushNode(u, pPath);
+	std::reverse(pPath->begin(), pPath->end());
+	FinishPath(pPath);
+	if (pCost)
+		*pCost = scratch.cost[goal];
+	return true;
+}
+
+/******************************************************************************/
+/*!
+
+*/
+/******************************************************************************/
+bool NavGraph::IsSolid(int x, int y) const
+{
+	return CollisionGridCell(*Grid, x + OriginX, y + OriginY) != 0;
+}
+
+/******************************************************************************/
+/*!
+	Open, with ground under it
+*/
+/******************************************************************************/
+bool NavGraph::IsWalkable(int x, int y) const
+{
+	return x >= 0 && x < Width && y >= 0 && y < Height && !IsSolid(x, y) && IsSolid(x, y - 1);
+}
+
+/******************************************************************************/
+/*!
+	Straight up from (x, y) to one row above the higher end, across, and
+	down to (toX, toY)
+*/
+/******************************************************************************/
+bool NavGraph::IsJumpClear(int x, int y, int toX, int toY) const
+{
+	int top = (y > toY ? y : toY) + 1;
+	if (top >= Height)
+		return false;
+	for (int row = y + 1; row <= top; ++row)
+		if (IsSolid(x, row))
+			return false;
+	for (int col = x < toX ? x : toX; col <= (x < toX ? toX : x); ++col)
+		if (IsSolid(col, top))
+			return false;
+	for (int row = toY + 1; row < top; ++row)
+		if (IsSolid(toX, row))
+			return false;
+	return true;
+}
+
+/******************************************************************************/
+/*!
+
+*/
+/******************************************************************************/
+bool NavGraph::IsNode(int x, int y) const
+{
+	if (x < 0 || x >= Width || y < 0 || y >= Height || Clusters.empty())
+		return false;
+	unsigned int node = NodeOf(x, y);
+	return (Clusters[node >> 8].walkable[(node & 0xFF) >> 5] >> (node & 31)) & 1;
+}
+
+/******************************************************************************/
+/*!
+
+*/
+/******************************************************************************/
+unsigned int NavGraph::NodeOf(int x, int y) const
+{
+	unsigned int cluster = (unsigned int)((y / NAV_CLUSTER_SIZE) * ClustersX + x / NAV_CLUSTER_SIZE);
+	return cluster << 8 | (unsigned int)((y % NAV_CLUSTER_SIZE) * NAV_CLUSTER_SIZE + x % NAV_CLUSTER_SIZE);
+}
+
+/******************************************************************************/
+/*!
+
+*/
+/******************************************************************************/
+void NavGraph::CellOf(unsigned int node, int* pX, int* pY) const
+{
+	unsigned int cluster = node >> 8, cell = node & 0xFF;
+	*pX = (int)(cluster % ClustersX) * NAV_CLUSTER_SIZE + (int)(cell % NAV_CLUSTER_SIZE);
+	*pY = (int)(cluster / ClustersX) * NAV_CLUSTER_SIZE + (int)(cell / NAV_CLUSTER_SIZE);
+}
@@ -0,0 +1,294 @@
+/******************************************************************************/
+/*!
+\file		NavGraph.h
+\author 	DigiPen
+\par    	email: digipen\@digipen.edu
+\date   	February 01, 20xx
+\brief
+Navigation graph of the binary collision map, for agents that walk and
+jump like the hero. A node is a cell an agent can stand in (empty, solid
+below); links are walks to the next cell, falls off a ledge to wherever
+the agent lands, and short jumps whose bounding arc is clear.
+
+The map is cut into NAV_CLUSTER_SIZE square clusters. Every node with a
+link into or out of another cluster is an entrance, and each cluster
+keeps the cost and the path between every pair of its entrances. A query
+searches the small graph of entrances (hierarchical A*) and expands the
+result with the cached intra cluster paths. Since entrance to entrance
+costs are exact, the paths are as short as a search of the full graph.
+
+That holds for ends less than NAV_CORRIDOR_MIN clusters apart. Farther
+ones first search the clusters themselves, linked where any node of one
+links into the other, for a corridor of clusters toward the goal; the
+entrances are then only searched inside it, widened by
+NAV_CORRIDOR_RADIUS clusters, and everywhere when that finds nothing.
+Such a path is a little longer than the shortest one when the shortest
+leaves the corridor.
+
+A changed cell only rebuilds the clusters whose links can depend on it,
+and only their part of the entrance graph is rewritten.
+
+Copyright (C) 20xx DigiPen Institute of Technology.
+Reproduction or disclosure of this file or its contents without the
+prior written consent of DigiPen Institute of Technology is prohibited.
+ */
+/******************************************************************************/
+
+#ifndef NAV_GRAPH_H
+#define NAV_GRAPH_H
+
+#include "TileMap.h"
+#include "JobSystem.h"
+#include <vector>
+
+/******************************************************************************/
+/*!
+	Defines
+*/
+/******************************************************************************/
+const int			NAV_CLUSTER_SIZE		= 16;	//Cells per cluster side, a cluster's cells are numbered in a byte
+const int			NAV_CLUSTER_CELLS		= NAV_CLUSTER_SIZE * NAV_CLUSTER_SIZE;
+
+//Planned jumps stay well inside what JUMP_VELOCITY allows, so any agent
+//can make them
+const int			NAV_JUMP_UP				= 4;	//Rows a jump may climb or drop
+const int			NAV_JUMP_ACROSS			= 4;	//Columns a jump may cross
+const float			NAV_JUMP_PENALTY		= 2.0f;	//Added to a jump's length
+const float			NAV_FALL_COST			= 0.5f;	//Per row dropped, on top of the step off the ledge
+const int			NAV_SNAP_DEPTH			= 4;	//Rows searched below a query point for ground
+const int			NAV_CORRIDOR_MIN		= 4;	//Clusters apart, either way, before a query takes a corridor
+const int			NAV_CORRIDOR_RADIUS		= 2;	//Clusters the corridor is widened by on every side
+
+const unsigned int	NAV_NODE_NONE			= 0xFFFFFFFF;
+const unsigned short	NAV_ENTRANCE_NONE	= 0xFFFF;
+
+/******************************************************************************/
+/*!
+	Struct/Class Definitions
+*/
+/******************************************************************************/
+enum NAV_LINK
+{
+	NAV_LINK_START,				//First waypoint of a path
+	NAV_LINK_WALK,
+	NAV_LINK_JUMP,
+	NAV_LINK_FALL
+};
+
+//A level cell of a path and how it is reached from the previous one
+struct NavWaypoint
+{
+	int				x, y;
+	NAV_LINK		link;
+};
+
+struct NavLink
+{
+	unsigned int	to;			// node, cluster << 8 | cell
+	float			cost;
+	NAV_LINK		type;
+};
+
+//An edge of the entrance graph
+struct NavAbstractLink
+{
+	unsigned int	cluster;	// of the entrance reached
+	float			cost;
+	unsigned short	entrance;	// index in the cluster's entrances, NAV_ENTRANCE_NONE until resolved
+	unsigned char	cell;
+};
+
+struct NavAbstractEdge
+{
+	unsigned int	to;			// entrance in the whole graph
+	float			cost;
+};
+
+//An entrance in the whole graph, its edges are AbstractEdges[edgeStart, edgeEnd)
+struct NavAbstractNode
+{
+	unsigned int	node;		// NAV_NODE_NONE for a slot no entrance uses
+	unsigned int	edgeStart;
+	unsigned int	edgeEnd;
+};
+
+//A link from another cluster into one of this cluster's cells
+struct NavEntry
+{
+	unsigned int	fromCluster;
+	unsigned char	cell;
+};
+
+struct NavCluster
+{
+	//Nodes: cell = y * NAV_CLUSTER_SIZE + x in the cluster, links of cell c
+	//are links[linkStart[c], linkStart[c + 1])
+	unsigned int				walkable[NAV_CLUSTER_CELLS / 32];	// bit per cell that is a node
+	unsigned int				linkStart[NAV_CLUSTER_CELLS + 1];
+	std::vector<NavLink>		links;
+	unsigned int				nodeCount;
+
+	std::vector<unsigned int>	targets;		// clusters the links lead into
+	std::vector<NavEntry>		entries;
+
+	//Abstract level: entrances (sorted cells) and, for each entrance, the
+	//parent of every cell in its shortest path tree inside the cluster. The
+	//edges of entrance i are abstractLinks[abstractStart[i], ...): first the
+	//other entrances, without the ones reached through a third at no extra
+	//cost, then its links out of the cluster
+	std::vector<unsigned char>	entrances;
+	std::vector<unsigned char>	entranceTree;
+	std::vector<unsigned int>	abstractStart;
+	std::vector<NavAbstractLink>	abstractLinks;
+
+	//Where the cluster sits in the whole graph: entrances[i] is entrance
+	//abstractBase + i, and its edges are in the cluster's edgeCapacity
+	//slots from edgeBase. The slots are kept while what is rebuilt fits.
+	unsigned int				abstractBase;
+	unsigned int				abstractCount;		// entrances placed
+	unsigned int				abstractCapacity;
+	unsigned int				edgeBase;
+	unsigned int				edgeCount;
+	unsigned int				edgeCapacity;
+
+	bool						linksDirty;
+	bool						abstractDirty;
+	bool						flattenDirty;
+};
+
+//Open list entry, ordered by key then tie
+struct NavHeapItem
+{
+	float			key;
+	float			tie;
+	unsigned int	value;
+};
+
+//Working memory of one query, one per thread
+struct NavScratch
+{
+	float						dist[NAV_CLUSTER_CELLS];
+	unsigned char				parent[NAV_CLUSTER_CELLS];
+	float						startDist[NAV_CLUSTER_CELLS];
+	unsigned char				startParent[NAV_CLUSTER_CELLS];
+	float						goalDist[NAV_CLUSTER_CELLS];
+	unsigned char				goalNext[NAV_CLUSTER_CELLS];
+
+	std::vector<NavHeapItem>	heap;
+	std::vector<unsigned int>	reverseStart;
+	std::vector<unsigned char>	reverseFrom;
+	std::vector<float>			reverseCost;
+	std::vector<float>			entranceCost;	// n * n, while building a cluster
+
+	//Graph wide search state, valid where state[i] >> 1 == stamp
+	std::vector<float>			cost;
+	std::vector<unsigned int>	from;
+	std::vector<unsigned int>	state;			// stamp << 1 | closed
+	unsigned int				stamp;
+	std::vector<unsigned int>	chain;
+	std::vector<unsigned int>	corridor;		// per cluster, the stamp of the search it was picked by
+
+	NavScratch() : stamp{ 0 } {}
+};
+
+struct NavStats
+{
+	unsigned int	clusters;
+	unsigned int	nodes;
+	unsigned int	links;
+	unsigned int	entrances;
+	unsigned int	clustersRebuilt;	// by the last Update
+};
+
+class NavGraph
+{
+public:
+	NavGraph();
+	~NavGraph();
+
+	void				Clear(void);
+	//Everything is rebuilt by the next Update, for a new map or a map whose
+	//cells all changed (a streaming window that moved)
+	void				Reset(void)					{ ResetPending = true; }
+	//Level cells [X0, X1] x [Y0, Y1] changed, call it after changing them
+	void				InvalidateCells(int X0, int Y0, int X1, int Y1);
+	bool				NeedsUpdate(void) const;
+	//Rebuilds whatever was invalidated, on the job system's threads
+	void				Update(const TileMap& map, JobSystem& jobs);
+
+	//Shortest path between the ground under two level cells, false if there
+	//is none. Any number of threads may query at once, each with its own
+	//scratch, as long as no Update runs.
+	bool				FindPath(int fromX, int fromY, int toX, int toY, NavScratch& scratch,
+								 std::vector<NavWaypoint>* pPath, float* pCost) const;
+	//Reference: plain A* over every node
+	bool				FindPathFlat(int fromX, int fromY, int toX, int toY, NavScratch& scratch,
+									 std::vector<NavWaypoint>* pPath, float* pCost) const;
+
+	const NavStats&		GetStats(void) const		{ return Stats; }
+
+private:
+	NavGraph(const NavGraph&) = delete;
+	NavGraph& operator=(const NavGraph&) = delete;
+
+	void				Layout(const TileMap& map);
+	void				InvalidateClusters(int x0, int y0, int x1, int y1);
+	void				BuildLinks(unsigned int cluster);
+	void				LinkClusters(unsigned int cluster);
+	void				BuildAbstract(unsigned int cluster, NavScratch& scratch);
+	void				ResolveCrossLinks(unsigned int cluster);
+	void				PlaceEntrances(unsigned int cluster);
+	void				FlattenCluster(unsigned int cluster);
+	void				CompactAbstract(void);
+
+	//Dijkstra inside one cluster, along the links or against them. Forward,
+	//"parent" is each cell's predecessor; reverse, its next cell toward "cell"
+	void				SearchCluster(unsigned int cluster, unsigned int cell, bool reverse, NavScratch& scratch,
+									  float* dist, unsigned char* parent) const;
+	bool				FindCorridor(unsigned int start, unsigned int goal, NavScratch& scratch, unsigned int* pCorridor) const;
+	void				SearchEntrances(unsigned int start, unsigned int goal, unsigned int corridor,
+										NavScratch& scratch, float* pBest, unsigned int* pBestEntrance) const;
+	const NavLink*		FindLink(unsigned int from, unsigned int to) const;
+	bool				SnapToNode(int X, int Y, unsigned int* pNode) const;
+	void				PushNode(unsigned int node, std::vector<NavWaypoint>* pPath) const;
+	void				FinishPath(std::vector<NavWaypoint>* pPath) const;
+	float				Heuristic(unsigned int node, unsigned int goal) const;
+	void				BeginSearch(NavScratch& scratch, unsigned int size) const;
+
+	//Map cells, only while building or invalidating
+	bool				IsSolid(int x, int y) const;
+	bool				IsWalkable(int x, int y) const;
+	bool				IsJumpClear(int x, int y, int toX, int toY) const;
+
+	//Graph cells, (0, 0) is the map's
+	bool				IsNode(int x, int y) const;
+	unsigned int		NodeOf(int x, int y) const;
+	void				CellOf(unsigned int node, int* pX, int* pY) const;
+
+	const CollisionGrid	*Grid;
+	int					Width, Height;		// cells
+	int					OriginX, OriginY;	// level cell of the map's (0, 0)
+	int					ClustersX, ClustersY;
+
+	std::vector<NavCluster>		Clusters;
+
+	//The entrance graph flattened for the searches from the clusters' lists.
+	//Update only rewrites the clusters it touched, in their own slots or in
+	//new ones at the end; the ones left behind are unused until enough of
+	//them pile up for CompactAbstract to number everything afresh.
+	std::vector<NavAbstractNode>	AbstractNodes;
+	std::vector<NavAbstractEdge>	AbstractEdges;
+	unsigned int				AbstractEdgeCount;	// in use, Stats.entrances counts the nodes
+
+	//Clusters waiting for the next Update, each listed when its flag is set
+	std::vector<unsigned int>	LinksDirty;
+	std::vector<unsigned int>	AbstractDirty;
+	std::vector<unsigned int>	FlattenDirty;
+
+	std::vector<NavScratch>		BuildScratch;		// one per job system thread
+	bool				ResetPending;
+	bool				CellsDirty;
+	NavStats			Stats;
+};
+
+#endif // NAV_GRAPH_H
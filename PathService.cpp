@@ -0,0 +1,128 @@
+/******************************************************************************/
+/*!
+\file		PathService.cpp
+\author 	DigiPen
+\par    	email: digipen\@digipen.edu
+\date   	February 01, 20xx
+\brief
+Batched path queries. See PathService.h.
+
+Copyright (C) 20xx DigiPen Institute of Technology.
+Reproduction or disclosure of this file or its contents without the
+prior written consent of DigiPen Institute of Technology is prohibited.
+ */
+/******************************************************************************/
+
+#include "PathService.h"
+
+/******************************************************************************/
+/*!
+
+*/
+/******************************************************************************/
+PathService::PathService() :
+	PendingBase{ 0 }, ResultBase{ 0 }
+{
+}
+
+/******************************************************************************/
+/*!
+
+*/
+/******************************************************************************/
+PathService::~PathService()
+{
+}
+
+/******************************************************************************/
+/*!
+	Tickets keep counting so an old one can't pass for a new one
+*/
+/******************************************************************************/
+void PathService::Clear(void)
+{
+	Graph.Clear();
+	PendingBase += (PathTicket)Pending.size();
+	Pending.clear();
+	Results.clear();
+	Found.clear();
+	ResultBase = PendingBase;
+}
+
+/******************************************************************************/
+/*!
+
+*/
+/******************************************************************************/
+PathTicket PathService::Request(int fromX, int fromY, int toX, int toY)
+{
+	Pending.push_back({ fromX, fromY, toX, toY });
+	return PendingBase + (PathTicket)Pending.size() - 1;
+}
+
+/******************************************************************************/
+/*!
+	Unsigned differences so the checks hold when the tickets wrap around
+*/
+/******************************************************************************/
+PATH_STATUS PathService::GetPath(PathTicket ticket, const NavPath** ppPath) const
+{
+	if (ticket - PendingBase < (PathTicket)Pending.size())
+		return PATH_STATUS_PENDING;
+
+	PathTicket result = ticket - ResultBase;
+	if (result >= (PathTicket)Results.size())
+		return PATH_STATUS_EXPIRED;
+	if (!Found[result])
+		return PATH_STATUS_NOT_FOUND;
+	if (ppPath)
+		*ppPath = &Results[result];
+	return PATH_STATUS_FOUND;
+}
+
+/******************************************************************************/
+/*!
+
+*/
+/******************************************************************************/
+void PathService::Prepare(const TileMap& map, JobSystem& jobs)
+{
+	if (Graph.NeedsUpdate())
+		Graph.Update(map, jobs);
+}
+
+/******************************************************************************/
+/*!
+	The last batch's answers are dropped even when nothing is pending, they
+	only last one Update
+*/
+/******************************************************************************/
+void PathService::Update(const TileMap& map, JobSystem& jobs)
+{
+	unsigned int count = (unsigned int)Pending.size();
+	ResultBase = PendingBase;
+	PendingBase += count;
+	if (count == 0) {
+		Results.clear();
+		Found.clear();
+		return;
+	}
+
+	Prepare(map, jobs);
+
+	// keeps the waypoint buffers of the last batch
+	Results.resize(count);
+	Found.assign(count, 0);
+	Scratch.resize(jobs.GetWorkerCount() + 1);
+
+	jobs.ParallelFor(count, PATH_REQUEST_GRAIN, [&](unsigned int begin, unsigned int end) {
+		NavScratch& scratch = Scratch[jobs.GetThreadIndex()];
+		for (unsigned int r = begin; r < end; ++r)
+		{
+			const PathRequest& q = Pending[r];
+			Found[r] = Graph.FindPath(q.fromX, q.fromY, q.toX, q.toY, scratch,
+									  &Results[r].waypoints, &Results[r].cost);
+		}
+	});
+	Pending.clear();
+}
@@ -0,0 +1,101 @@
+/******************************************************************************/
+/*!
+\file		PathService.h
+\author 	DigiPen
+\par    	email: digipen\@digipen.edu
+\date   	February 01, 20xx
+\brief
+Batched path queries over a NavGraph. Requests are queued as they come
+and answered together by the next Update, spread over the job system's
+threads, so a path asked for during a step is ready for the next one.
+Answering at a fixed point of the step keeps the results the same at any
+worker count.
+
+The graph is only built, or brought up to date with the map, when there
+are requests to answer, unless Prepare asks for it.
+
+Copyright (C) 20xx DigiPen Institute of Technology.
+Reproduction or disclosure of this file or its contents without the
+prior written consent of DigiPen Institute of Technology is prohibited.
+ */
+/******************************************************************************/
+
+#ifndef PATH_SERVICE_H
+#define PATH_SERVICE_H
+
+#include "NavGraph.h"
+#include <vector>
+
+/******************************************************************************/
+/*!
+	Defines
+*/
+/******************************************************************************/
+const unsigned int	PATH_REQUEST_GRAIN		= 4;	//Requests per job
+
+/******************************************************************************/
+/*!
+	Struct/Class Definitions
+*/
+/******************************************************************************/
+typedef unsigned int	PathTicket;
+
+enum PATH_STATUS
+{
+	PATH_STATUS_PENDING,		//Answered by the next Update
+	PATH_STATUS_FOUND,
+	PATH_STATUS_NOT_FOUND,
+	PATH_STATUS_EXPIRED			//Answered before the last Update, ask again
+};
+
+struct NavPath
+{
+	std::vector<NavWaypoint>	waypoints;		// level cells, from start to goal
+	float						cost;
+};
+
+class PathService
+{
+public:
+	PathService();
+	~PathService();
+
+	//See NavGraph::Reset/InvalidateCells
+	void				Reset(void)					{ Graph.Reset(); }
+	void				InvalidateCells(int X0, int Y0, int X1, int Y1)	{ Graph.InvalidateCells(X0, Y0, X1, Y1); }
+	//Drops the graph and every request
+	void				Clear(void);
+
+	//From the ground under level cell (fromX, fromY) to the ground under
+	//(toX, toY). Not thread safe, call it outside the parallel stages.
+	PathTicket			Request(int fromX, int fromY, int toX, int toY);
+	//"ppPath" is set when found, and valid until the next Update
+	PATH_STATUS			GetPath(PathTicket ticket, const NavPath** ppPath) const;
+
+	//Updates the graph to "map" and answers every pending request
+	void				Update(const TileMap& map, JobSystem& jobs);
+	//Updates the graph to "map" now, requests or not
+	void				Prepare(const TileMap& map, JobSystem& jobs);
+
+	const NavGraph&		GetGraph(void) const		{ return Graph; }
+
+private:
+	PathService(const PathService&) = delete;
+	PathService& operator=(const PathService&) = delete;
+
+	struct PathRequest
+	{
+		int				fromX, fromY;
+		int				toX, toY;
+	};
+
+	NavGraph					Graph;
+	std::vector<PathRequest>	Pending;		// tickets [PendingBase, PendingBase + size)
+	PathTicket					PendingBase;
+	std::vector<NavPath>		Results;		// tickets [ResultBase, PendingBase)
+	std::vector<unsigned char>	Found;			// per result, written by the jobs
+	PathTicket					ResultBase;
+	std::vector<NavScratch>		Scratch;		// one per job system thread
+};
+
+#endif // PATH_SERVICE_H
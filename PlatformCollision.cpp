@@ -0,0 +1,85 @@
+/******************************************************************************/
+/*!
+\file		PlatformCollision.cpp
+\author 	DigiPen
+\par    	email: digipen\@digipen.edu
+\date   	February 01, 20xx
+\brief
+
+Copyright (C) 20xx DigiPen Institute of Technology.
+Reproduction or disclosure of this file or its contents without the
+prior written consent of DigiPen Institute of Technology is prohibited.
+ */
+/******************************************************************************/
+
+#include "PlatformCollision.h"
+
+#include <algorithm>
+
+/******************************************************************************/
+/*!
+
+*/
+/******************************************************************************/
+bool CollisionIntersection_RectRect(const SimAABB & aabb1, const SimVec2 & vel1, 
+									const SimAABB & aabb2, const SimVec2 & vel2,
+									float dt)
+{
+	// static check
+	if (!(aabb1.max.x < aabb2.min.x || aabb1.min.x > aabb2.max.x ||
+		  aabb1.max.y < aabb2.min.y || aabb1.min.y > aabb2.max.y)) {
+		return true;
+	}
+
+	// relative velocity of the second box, the first one is treated as static
+	SimVec2 vb{ vel2.x - vel1.x, vel2.y - vel1.y };
+	float tFirst{ 0.0f }, tLast{ dt };
+
+	// x axis
+	if (vb.x < 0.0f) {
+		if (aabb1.min.x > aabb2.max.x)
+			return false;
+		if (aabb1.max.x < aabb2.min.x)
+			tFirst = std::max((aabb1.max.x - aabb2.min.x) / vb.x, tFirst);
+		if (aabb1.min.x < aabb2.max.x)
+			tLast = std::min((aabb1.min.x - aabb2.max.x) / vb.x, tLast);
+	}
+	else if (vb.x > 0.0f) {
+		if (aabb1.max.x < aabb2.min.x)
+			return false;
+		if (aabb1.min.x > aabb2.max.x)
+			tFirst = std::max((aabb1.min.x - aabb2.max.x) / vb.x, tFirst);
+		if (aabb1.max.x > aabb2.min.x)
+			tLast = std::min((aabb1.max.x - aabb2.min.x) / vb.x, tLast);
+	}
+	else if (aabb1.max.x < aabb2.min.x || aabb1.min.x > aabb2.max.x) {
+		return false;
+	}
+	if (tFirst > tLast)
+		return false;
+
+	// y axis
+	if (vb.y < 0.0f) {
+		if (aabb1.min.y > aabb2.max.y)
+			return false;
+		if (aabb1.max.y < aabb2.min.y)
+			tFirst = std::max((aabb1.max.y - aabb2.min.y) / vb.y, tFirst);
+		if (aabb1.min.y < aabb2.max.y)
+			tLast = std::min((aabb1.min.y - aabb2.max.y) / vb.y, tLast);
+	}
+	else if (vb.y > 0.0f) {
+		if (aabb1.max.y < aabb2.min.y)
+			return false;
+		if (aabb1.min.y > aabb2.max.y)
+			tFirst = std::max((aabb1.min.y - aabb2.max.y) / vb.y, tFirst);
+		if (aabb1.max.y > aabb2.min.y)
+			tLast = std::min((aabb1.max.y - aabb2.min.y) / vb.y, tLast);
+	}
+	else if (aabb1.max.y < aabb2.min.y || aabb1.min.y > aabb2.max.y) {
+		return false;
+	}
+	if (tFirst > tLast)
+		return false;
+
+	return true;
+}
@@ -0,0 +1,33 @@
+/******************************************************************************/
+/*!
+\file		PlatformCollision.h
+\author 	DigiPen
+\par    	email: digipen\@digipen.edu
+\date   	February 01, 20xx
+\brief
+Engine independent copy of the rectangle/rectangle collision test so the
+platformer simulation can run without Collision.h and the global g_dt.
+
+Copyright (C) 20xx DigiPen Institute of Technology.
+Reproduction or disclosure of this file or its contents without the
+prior written consent of DigiPen Institute of Technology is prohibited.
+ */
+/******************************************************************************/
+
+#ifndef PLATFORM_COLLISION_H
+#define PLATFORM_COLLISION_H
+
+#include "PlatformTypes.h"
+
+/******************************************************************************/
+/*!
+	Static overlap test first, then a dynamic test of the relative velocity
+	over "dt". Same algorithm as CollisionIntersection_RectRect in
+	Collision.cpp, but the frame time is passed in instead of read from g_dt.
+*/
+/******************************************************************************/
+bool CollisionIntersection_RectRect(const SimAABB & aabb1, const SimVec2 & vel1, 
+									const SimAABB & aabb2, const SimVec2 & vel2,
+									float dt);
+
+#endif // PLATFORM_COLLISION_H
@@ -0,0 +1,193 @@
+/******************************************************************************/
+/*!
+\file		PlatformTypes.h
+\author 	DigiPen
+\par    	email: digipen\@digipen.edu
+\date   	February 01, 20xx
+\brief
+Engine independent types and gameplay constants shared by the headless
+platformer simulation (PlatformWorld) and the Alpha Engine front end.
+Nothing in here may include an Alpha Engine header.
+
+Copyright (C) 20xx DigiPen Institute of Technology.
+Reproduction or disclosure of this file or its contents without the
+prior written consent of DigiPen Institute of Technology is prohibited.
+ */
+/******************************************************************************/
+
+#ifndef PLATFORM_TYPES_H
+#define PLATFORM_TYPES_H
+
+#include <cmath>
+
+/******************************************************************************/
+/*!
+	Defines
+*/
+/******************************************************************************/
+const unsigned int	GAME_OBJ_NUM_MAX		= 32;	//The total number of different objects (Shapes)
+const unsigned int	GAME_OBJ_INST_NUM_MAX	= 2048;	//Default soft cap on the instances of one type, see EntityTable.h
+
+//Gameplay related variables and values
+const float			GRAVITY					= -2.0f;
+const float			JUMP_VELOCITY			= 11.0f;
+const float			MOVE_VELOCITY_HERO		= 4.0f;
+const float			MOVE_VELOCITY_ENEMY		= 7.5f;
+const double		ENEMY_IDLE_TIME			= 2.0;
+const float			ENEMY_CHASE_VELOCITY	= 3.0f;	//Slower than the hero, who can still get away
+const float			ENEMY_CHASE_RANGE_X		= 6.0f;	//Cells from the hero, across and up or down, at which
+const float			ENEMY_CHASE_RANGE_Y		= 2.0f;	//a walking enemy starts chasing it
+const float			ENEMY_CHASE_LOSE_RANGE	= 12.0f;	//Cells either way at which a chaser gives up
+const double		ENEMY_CHASE_REPLAN_TIME	= 0.5;	//Seconds a chaser follows a waypoint before planning again
+const int			HERO_LIVES				= 3;
+const float			BOUNDING_RECT_SIZE		= 0.5f;	//Half the size of an instance's bounding box at scale 1
+
+//Fixed timestep simulation
+const float			FIXED_TIMESTEP			= 1.0f / 60.0f;	//Length of one simulation tick
+const unsigned int	FIXED_SUBSTEPS_MAX		= 5;			//Ticks allowed per rendered frame before time is dropped
+
+//Flags
+const unsigned int	FLAG_ACTIVE				= 0x00000001;
+const unsigned int	FLAG_VISIBLE			= 0x00000002;
+const unsigned int	FLAG_NON_COLLIDABLE		= 0x00000004;
+
+//Collision flags
+const unsigned int	COLLISION_LEFT			= 0x00000001;	//0001
+const unsigned int	COLLISION_RIGHT			= 0x00000002;	//0010
+const unsigned int	COLLISION_TOP			= 0x00000004;	//0100
+const unsigned int	COLLISION_BOTTOM		= 0x00000008;	//1000
+
+
+enum TYPE_OBJECT
+{
+	TYPE_OBJECT_EMPTY,			//0
+	TYPE_OBJECT_COLLISION,		//1
+	TYPE_OBJECT_HERO,			//2
+	TYPE_OBJECT_ENEMY1,			//3
+	TYPE_OBJECT_COIN			//4
+};
+
+//State machine states
+enum STATE
+{
+	STATE_NONE,
+	STATE_GOING_LEFT,
+	STATE_GOING_RIGHT,
+	STATE_CHASE
+};
+
+//State machine inner states
+enum INNER_STATE
+{
+	INNER_STATE_ON_ENTER,
+	INNER_STATE_ON_UPDATE,
+	INNER_STATE_ON_EXIT
+};
+
+/******************************************************************************/
+/*!
+	Math types
+	Same memory layout as AEVec2 / AEMtx33 so the front end can copy them
+	straight into Alpha Engine calls.
+*/
+/******************************************************************************/
+struct SimVec2
+{
+	float			x, y;
+};
+
+struct SimAABB
+{
+	SimVec2			min;
+	SimVec2			max;
+};
+
+struct SimMtx33
+{
+	float			m[3][3];
+};
+
+inline SimVec2& operator+=(SimVec2& lhs, const SimVec2& rhs) {
+	lhs.x += rhs.x;
+	lhs.y += rhs.y;
+	return lhs;
+}
+
+inline SimVec2 operator+(const SimVec2& lhs, const SimVec2& rhs) {
+	return { lhs.x + rhs.x,lhs.y + rhs.y };
+}
+
+inline SimVec2 operator*(const SimVec2& lhs, const float& rhs) {
+	return { lhs.x * rhs,lhs.y * rhs };
+}
+
+inline SimVec2 operator-(const SimVec2& vec) {
+	return { -vec.x,-vec.y };
+}
+
+/******************************************************************************/
+/*!
+	Matrix helpers, same conventions as AEMtx33Scale/Rot/Trans/Concat
+*/
+/******************************************************************************/
+inline void SimMtx33Scale(SimMtx33* pResult, float x, float y)
+{
+	*pResult = { { { x, 0.0f, 0.0f }, { 0.0f, y, 0.0f }, { 0.0f, 0.0f, 1.0f } } };
+}
+
+inline void SimMtx33Rot(SimMtx33* pResult, float angle)
+{
+	float c = cosf(angle), s = sinf(angle);
+	*pResult = { { { c, -s, 0.0f }, { s, c, 0.0f }, { 0.0f, 0.0f, 1.0f } } };
+}
+
+inline void SimMtx33Trans(SimMtx33* pResult, float x, float y)
+{
+	*pResult = { { { 1.0f, 0.0f, x }, { 0.0f, 1.0f, y }, { 0.0f, 0.0f, 1.0f } } };
+}
+
+inline void SimMtx33Concat(SimMtx33* pResult, const SimMtx33* pMtx0, const SimMtx33* pMtx1)
+{
+	SimMtx33 result;
+	for (int i = 0; i < 3; ++i)
+		for (int j = 0; j < 3; ++j)
+			result.m[i][j] = pMtx0->m[i][0] * pMtx1->m[0][j]
+						   + pMtx0->m[i][1] * pMtx1->m[1][j]
+						   + pMtx0->m[i][2] * pMtx1->m[2][j];
+	*pResult = result;
+}
+
+//Returns false, and leaves "pResult" alone, if "pMtx" can't be inverted
+inline bool SimMtx33Inverse(SimMtx33* pResult, const SimMtx33* pMtx)
+{
+	const float (&m)[3][3] = pMtx->m;
+	float c00 = m[1][1] * m[2][2] - m[1][2] * m[2][1];
+	float c01 = m[1][2] * m[2][0] - m[1][0] * m[2][2];
+	float c02 = m[1][0] * m[2][1] - m[1][1] * m[2][0];
+	float det = m[0][0] * c00 + m[0][1] * c01 + m[0][2] * c02;
+	if (det == 0.0f)
+		return false;
+
+	float inv = 1.0f / det;
+	SimMtx33 result = { { {
+		c00 * inv,
+		(m[0][2] * m[2][1] - m[0][1] * m[2][2]) * inv,
+		(m[0][1] * m[1][2] - m[0][2] * m[1][1]) * inv }, {
+		c01 * inv,
+		(m[0][0] * m[2][2] - m[0][2] * m[2][0]) * inv,
+		(m[0][2] * m[1][0] - m[0][0] * m[1][2]) * inv }, {
+		c02 * inv,
+		(m[0][1] * m[2][0] - m[0][0] * m[2][1]) * inv,
+		(m[0][0] * m[1][1] - m[0][1] * m[1][0]) * inv } } };
+	*pResult = result;
+	return true;
+}
+
+//pMtx * (v, 1)
+inline SimVec2 SimMtx33MultPoint(const SimMtx33* pMtx, const SimVec2& v)
+{
+	return { pMtx->m[0][0] * v.x + pMtx->m[0][1] * v.y + pMtx->m[0][2],
+			 pMtx->m[1][0] * v.x + pMtx->m[1][1] * v.y + pMtx->m[1][2] };
+}
+
+#endif // PLATFORM_TYPES_H
@@ -0,0 +1,1809 @@
+/******************************************************************************/
+/*!
+\file		PlatformWorld.cpp
+\author 	DigiPen
+\par    	email: digipen\@digipen.edu
+\date   	February 01, 20xx
+\brief
+Headless platformer simulation. See PlatformWorld.h.
+
+Copyright (C) 20xx DigiPen Institute of Technology.
+Reproduction or disclosure of this file or its contents without the
+prior written consent of DigiPen Institute of Technology is prohibited.
+ */
+/******************************************************************************/
+
+#include "PlatformWorld.h"
+#include "PlatformCollision.h"
+#include "SimPipeline.h"
+#include "SimKernels.h"
+#include "EnemyAI.h"
+#include "GridSweep.h"
+#include "SpatialHash.h"
+#include "Profiler.h"
+#include <algorithm>
+#include <cassert>
+#include <cstdlib>
+#include <string>
+#include <fstream>
+
+/******************************************************************************/
+/*!
+
+*/
+/******************************************************************************/
+PlatformWorld::PlatformWorld() :
+	HeroLives{ 0 }, Hero_Initial_X{ 0 }, Hero_Initial_Y{ 0 }, TotalCoins{ 0 },
+	MapRevision{ 0 }, BuildPathsOnLoad{ true }, LoadSerial{ 0 },
+	WindowChunkX{ 0 }, WindowChunkY{ 0 }, WindowValid{ false },
+	hHero( INVALID_HANDLE ), HasChaseTarget{ false }, ChaseTarget{ 0.0f, 0.0f },
+	FixedStep{ FIXED_TIMESTEP }, MaxSubsteps{ FIXED_SUBSTEPS_MAX },
+	Accumulator{ 0.0f }, InterpolationAlpha{ 1.0f }, LastSubstepCount{ 0 },
+	SweptCollision{ false },
+	FrameScratch{ FRAME_SCRATCH_BLOCK_SIZE },
+	Broad{ new SpatialHash },
+	Recorder{ nullptr },
+	PipelineVerify{ false }, PipelineMismatches{ 0 }
+{
+	Commands.resize(1);
+	BroadMoves.resize(1);
+	for (unsigned int type = 0; type < ENTITY_TABLE_NUM; ++type)
+		sGameObjTables[type].type = type;
+
+	sGameObjTables[TYPE_OBJECT_HERO].Create(TYPE_OBJECT_HERO, ENTITY_TABLE_MIN_GROWTH);
+	sGameObjTables[TYPE_OBJECT_ENEMY1].Create(TYPE_OBJECT_ENEMY1, ENTITY_TABLE_MIN_GROWTH);
+	sGameObjTables[TYPE_OBJECT_COIN].Create(TYPE_OBJECT_COIN, ENTITY_TABLE_MIN_GROWTH);
+}
+
+/******************************************************************************/
+/*!
+
+*/
+/******************************************************************************/
+PlatformWorld::~PlatformWorld()
+{
+	FreeMapData();
+}
+
+/******************************************************************************/
+/*!
+
+*/
+/******************************************************************************/
+int PlatformWorld::ImportMapDataFromFile(const char *FileName)
+{
+	std::string line, s;
+	int j, width, height;
+
+	FreeMapData();
+
+	// binary level: check it and use it where it is
+	if (IsLevelFile(FileName)) {
+		if (!Level.Open(FileName, true))
+			return 0;
+		const LevelFileHeader& header = Level.GetHeader();
+		Map.Attach(Level.GetCollisionLayer(), Level.GetTypeLayer(), header.width, header.height);
+		return 1;
+	}
+
+	// open file
+	std::fstream file(FileName, std::ios::in);
+	if (file) {
+		file >> s >> width >> s >> height;
+		if (!file || width <= 0 || height <= 0)
+			return 0;
+		// allocate space, outside the map has always been empty so the
+		// border is too
+		Map.Create(width, height, false, &Arena);
+		// add data in
+		for (int y = 0; y < height; ++y) {
+			for (int x = 0; x < width; ++x) {
+				file >> j;
+				// a missing cell or one of no known type, as LevelConvert
+				if (!file || j < TYPE_OBJECT_EMPTY || j > TYPE_OBJECT_COIN) {
+					FreeMapData();
+					return 0;
+				}
+				Map.SetCell(x, y, (unsigned char)j);
+			}
+		}
+		return 1;
+	}
+	return 0;
+}
+
+/******************************************************************************/
+/*!
+	Whatever the level put in the arena goes with one Reset
+*/
+/******************************************************************************/
+void PlatformWorld::FreeMapData(void)
+{
+	Streamer.Close();
+	ChunkRecords.clear();
+	WindowValid = false;
+	Map.Destroy();
+	Level.Close();
+	Paths.Clear();
+	++MapRevision;
+	EditedCells.clear();
+	InitSnapshot.data.clear();
+	++LoadSerial;
+	Arena.Reset();
+	FrameScratch.Reset();
+}
+
+/******************************************************************************/
+/*!
+
+*/
+/******************************************************************************/
+LevelMemoryStats PlatformWorld::GetLevelMemoryStats(void) const
+{
+	LevelMemoryStats stats;
+	stats.arenaBytes			= Arena.GetUsedBytes();
+	stats.arenaPeakBytes		= Arena.GetPeakBytes();
+	stats.arenaReservedBytes	= Arena.GetReservedBytes();
+	stats.arenaHeapAllocations	= Arena.GetHeapAllocations();
+	stats.scratchPeakBytes		= FrameScratch.GetPeakBytes();
+	stats.entityBytes			= GetEntityMemoryBytes();
+	stats.mapBytes				= Map.GetByteSize();
+	return stats;
+}
+
+/******************************************************************************/
+/*!
+	Only the cells around the change get new navigation links
+*/
+/******************************************************************************/
+bool PlatformWorld::SetCell(int X, int Y, unsigned char type)
+{
+	if (!Map.IsLoaded() || Level.IsOpen() || IsStreamed())
+		return false;
+	if (X < 0 || X >= Map.GetWidth() || Y < 0 || Y >= Map.GetHeight())
+		return false;
+	// the same types ImportMapDataFromFile accepts
+	if (type > TYPE_OBJECT_COIN)
+		return false;
+
+	EditedCells.emplace((unsigned int)(Y * Map.GetWidth() + X), Map.GetType(X, Y));
+	Map.SetCell(X, Y, type);
+	Paths.InvalidateCells(X, Y, X, Y);
+	++MapRevision;
+	return true;
+}
+
+/******************************************************************************/
+/*!
+	Creates the hero, the enemies and the coins according to their initial
+	positions in the map
+*/
+/******************************************************************************/
+void PlatformWorld::Init(void)
+{
+	hHero = INVALID_HANDLE;
+	TotalCoins = 0;
+
+	//Setting the inital number of hero lives
+	HeroLives = HERO_LIVES;
+
+	Accumulator = 0.0f;
+	InterpolationAlpha = 1.0f;
+
+	//Streamed: only the hero is known up front, everything else is created
+	//with its chunk
+	if (IsStreamed()) {
+		int x, y;
+		ChunkRecords.clear();
+		WindowValid = false;
+		if (Streamer.GetHeroSpawn(&x, &y)) {
+			SimVec2 pos{ (float)x + 0.5f, (float)y + 0.5f };
+			hHero = gameObjInstCreate(TYPE_OBJECT_HERO, 1.0f, &pos, nullptr, 0.0f, STATE::STATE_NONE);
+			Hero_Initial_X = x;
+			Hero_Initial_Y = y;
+		}
+		UpdateStreaming();
+		if (BuildPathsOnLoad)
+			Paths.Prepare(Map, Jobs);
+		return;
+	}
+
+	if (BuildPathsOnLoad)
+		Paths.Prepare(Map, Jobs);
+
+	//Binary level: the spawns were extracted by the converter, in the
+	//order the scan below finds them
+	unsigned int spawnCount[ENTITY_TABLE_NUM] = {};
+	if (Level.IsOpen()) {
+		const LevelSpawn* spawns = Level.GetSpawns();
+		for (uint32_t k = 0; k < Level.GetHeader().spawnCount; ++k)
+			if (spawns[k].type < ENTITY_TABLE_NUM)
+				++spawnCount[spawns[k].type];
+		ReserveSpawns(spawnCount);
+
+		for (uint32_t k = 0; k < Level.GetHeader().spawnCount; ++k)
+		{
+			const LevelSpawn& spawn = spawns[k];
+			SimVec2 pos{ (float)spawn.x + 0.5f, (float)spawn.y + 0.5f };
+			if (spawn.type == TYPE_OBJECT_HERO) {
+				hHero = gameObjInstCreate(spawn.type, 1.0f, &pos, nullptr, 0.0f, STATE::STATE_NONE);
+				Hero_Initial_X = spawn.x;
+				Hero_Initial_Y = spawn.y;
+			}
+			else if (spawn.type == TYPE_OBJECT_ENEMY1) {
+				gameObjInstCreate(spawn.type, 1.0f, &pos, nullptr, 0.0f, STATE::STATE_GOING_RIGHT);
+			}
+			else {
+				gameObjInstCreate(spawn.type, 1.0f, &pos, nullptr, 0.0f, STATE::STATE_NONE);
+			}
+		}
+		SaveSnapshot(&InitSnapshot);
+		return;
+	}
+
+	for (int j = 0; j < Map.GetHeight(); ++j)
+		for (int i = 0; i < Map.GetWidth(); ++i)
+			if (Map.GetType(i, j) < ENTITY_TABLE_NUM)
+				++spawnCount[Map.GetType(i, j)];
+	ReserveSpawns(spawnCount);
+
+	for (int i = 0; i < Map.GetWidth(); ++i) {
+		for (int j = 0; j < Map.GetHeight(); ++j)
+		{
+			unsigned int type = Map.GetType(i, j);
+			if (type == TYPE_OBJECT_EMPTY || type == TYPE_OBJECT_COLLISION) {
+				continue;
+			}
+			SimVec2 pos{ (float)i+0.5f,(float)j+0.5f };
+			if (type == TYPE_OBJECT_HERO) {
+				hHero = gameObjInstCreate(type, 1.0f, &pos, nullptr, 0.0f, STATE::STATE_NONE);
+				Hero_Initial_X = i;
+				Hero_Initial_Y = j;
+			}
+			else if (type == TYPE_OBJECT_ENEMY1) {
+				gameObjInstCreate(type, 1.0f, &pos, nullptr, 0.0f, STATE::STATE_GOING_RIGHT);
+			}
+			else {
+				gameObjInstCreate(type, 1.0f, &pos, nullptr, 0.0f, STATE::STATE_NONE);
+			}
+		}
+	}
+
+	//what Restart goes back to
+	SaveSnapshot(&InitSnapshot);
+}
+
+/******************************************************************************/
+/*!
+	Each table gets room for the level's instances of its type at once,
+	rather than doubling its way there
+*/
+/******************************************************************************/
+void PlatformWorld::ReserveSpawns(const unsigned int spawnCount[ENTITY_TABLE_NUM])
+{
+	for (unsigned int type = TYPE_OBJECT_HERO; type < ENTITY_TABLE_NUM; ++type)
+		sGameObjTables[type].Reserve(spawnCount[type]);
+}
+
+/******************************************************************************/
+/*!
+
+*/
+/******************************************************************************/
+void PlatformWorld::SetEntitySoftCap(unsigned int rows)
+{
+	for (unsigned int type = TYPE_OBJECT_HERO; type < ENTITY_TABLE_NUM; ++type)
+		sGameObjTables[type].SetSoftCap(rows);
+}
+
+/******************************************************************************/
+/*!
+
+*/
+/******************************************************************************/
+size_t PlatformWorld::GetEntityMemoryBytes(void) const
+{
+	size_t bytes = 0;
+	for (unsigned int type = TYPE_OBJECT_HERO; type < ENTITY_TABLE_NUM; ++type)
+		bytes += sGameObjTables[type].GetMemoryBytes();
+	return bytes;
+}
+
+/******************************************************************************/
+/*!
+	Snapshot layout: SnapshotHeader, every table's SaveState, then
+	editCount SnapshotCell in cell order
+*/
+/******************************************************************************/
+struct SnapshotHeader
+{
+	unsigned int	loadSerial;
+	int				heroLives;
+	int				totalCoins;
+	int				heroInitialX, heroInitialY;
+	GameObjHandle	hero;
+	unsigned int	editCount;
+};
+
+struct SnapshotCell
+{
+	unsigned int	cell;			// y * width + x
+	unsigned int	type;
+};
+
+bool PlatformWorld::SaveSnapshot(WorldSnapshot* pSnapshot) const
+{
+	if (IsStreamed() || !Map.IsLoaded())
+		return false;
+
+	SnapshotWriter out(&pSnapshot->data);
+	SnapshotHeader header{ LoadSerial, HeroLives, TotalCoins, Hero_Initial_X, Hero_Initial_Y, hHero,
+						   (unsigned int)EditedCells.size() };
+	out.Write(header);
+	for (unsigned int type = 0; type < ENTITY_TABLE_NUM; ++type)
+		sGameObjTables[type].SaveState(out);
+
+	int width = Map.GetWidth();
+	for (const auto& edit : EditedCells)
+	{
+		SnapshotCell cell{ edit.first, Map.GetType((int)edit.first % width, (int)edit.first / width) };
+		out.Write(cell);
+	}
+	return true;
+}
+
+/******************************************************************************/
+/*!
+	Cells edited since the snapshot go back to their loaded type, the ones
+	the snapshot has get its type
+*/
+/******************************************************************************/
+bool PlatformWorld::RestoreSnapshot(const WorldSnapshot& snapshot)
+{
+	SnapshotReader in(snapshot.data);
+	SnapshotHeader header;
+	if (IsStreamed() || !in.Read(&header) || header.loadSerial != LoadSerial ||
+		header.editCount > EditedCells.size())
+		return false;
+
+	for (unsigned int type = 0; type < ENTITY_TABLE_NUM; ++type)
+		if (!sGameObjTables[type].RestoreState(in))
+			return false;
+
+	// rows the snapshot doesn't have leave the broad phase, the others
+	// are moved by the next step if they have to
+	for (unsigned int type = TYPE_OBJECT_ENEMY1; type <= TYPE_OBJECT_COIN; ++type)
+		for (unsigned int row = sGameObjTables[type].count; row < Broad->GetTrackedIdEnd(type); ++row)
+			Broad->Untrack(SpatialKey(type, row));
+
+	HeroLives		= header.heroLives;
+	TotalCoins		= header.totalCoins;
+	Hero_Initial_X	= header.heroInitialX;
+	Hero_Initial_Y	= header.heroInitialY;
+	hHero			= header.hero;
+
+	int width = Map.GetWidth();
+	unsigned int read = 0;
+	SnapshotCell saved{ 0, 0 };
+	if (header.editCount && !in.Read(&saved))
+		return false;
+	for (const auto& edit : EditedCells)
+	{
+		unsigned char type = edit.second;
+		if (read < header.editCount && saved.cell == edit.first) {
+			if (saved.type > TYPE_OBJECT_COIN)
+				return false;
+			type = (unsigned char)saved.type;
+			if (++read < header.editCount && !in.Read(&saved))
+				return false;
+		}
+
+		int X = (int)edit.first % width, Y = (int)edit.first / width;
+		if (Map.GetType(X, Y) != type) {
+			Map.SetCell(X, Y, type);
+			Paths.InvalidateCells(X, Y, X, Y);
+			++MapRevision;
+		}
+	}
+	return read == header.editCount;
+}
+
+/******************************************************************************/
+/*!
+
+*/
+/******************************************************************************/
+void PlatformWorld::Restart(void)
+{
+	if (InitSnapshot.data.empty() || !RestoreSnapshot(InitSnapshot)) {
+		Free();
+		Init();
+		return;
+	}
+
+	Accumulator = 0.0f;
+	InterpolationAlpha = 1.0f;
+}
+
+/******************************************************************************/
+/*!
+
+*/
+/******************************************************************************/
+void PlatformWorld::Free(void)
+{
+	// kill all object in the tables, only the live ones are visited
+	for (unsigned int type = 0; type < ENTITY_TABLE_NUM; ++type)
+		sGameObjTables[type].Clear();
+	Broad->ClearTracked();
+
+	hHero = INVALID_HANDLE;
+
+	// a streamed level starts over from its chunks
+	ChunkRecords.clear();
+	WindowValid = false;
+}
+
+/******************************************************************************/
+/*!
+	Builds the drawing matrix of one row
+*/
+/******************************************************************************/
+static void BuildTransform(EntityTable& t, unsigned int i)
+{
+	SimMtx33 scale, rot, trans;
+	SimMtx33Scale(&scale, t.scale[i], t.scale[i]);
+	SimMtx33Rot(&rot, t.dirCurr[i]);
+	SimMtx33Trans(&trans, t.posX[i], t.posY[i]);
+	SimMtx33Concat(&rot, &rot, &scale);
+	SimMtx33Concat(t.transform + i, &trans, &rot);
+}
+
+//Swept boxes are grown by this for rounding in the narrow phase's time of
+//impact
+static const float			SWEPT_MARGIN = 1.0f / 64.0f;
+
+/******************************************************************************/
+/*!
+	Where an instance can be during a step of "dt": its box stretched by
+	its velocity, plus the margin. SweptCells does the same for a block.
+*/
+/******************************************************************************/
+static SimAABB SweptBox(const EntityTable& t, unsigned int i, float dt)
+{
+	const float margin = SWEPT_MARGIN;
+	float dx = t.velX[i] * dt, dy = t.velY[i] * dt;
+	return { { t.minX[i] + (dx < 0.0f ? dx : 0.0f) - margin, t.minY[i] + (dy < 0.0f ? dy : 0.0f) - margin },
+			 { t.maxX[i] + (dx > 0.0f ? dx : 0.0f) + margin, t.maxY[i] + (dy > 0.0f ? dy : 0.0f) + margin } };
+}
+
+//Rows per block of the fused pass, small enough that a block's columns
+//stay in L1 between the integration kernel and the per row stages. A
+//block is also the unit of work handed to the job system.
+static const unsigned int	ENTITY_BLOCK_SIZE = 256;
+
+//Candidate pairs per job of the object collision narrow phase
+static const unsigned int	COLLISION_PAIR_GRAIN = 256;
+
+/******************************************************************************/
+/*!
+	One simulation step: input, gravity and AI, integration, grid collision,
+	hero vs enemies/coins and the instance matrices.
+*/
+/******************************************************************************/
+STEP_RESULT PlatformWorld::Step(float dt, const InputFrame& input)
+{
+	PROFILE_ZONE("step");
+	PROFILE_COUNTER_ADD("steps", 1);
+	ArenaScratch scratch(FrameScratch);
+
+	if (IsStreamed()) {
+		PROFILE_ZONE("streaming");
+		UpdateStreaming();
+	}
+	{
+		PROFILE_ZONE("paths");
+		PlanChases();
+	}
+
+	STEP_RESULT result = PipelineVerify ? StepVerified(dt, input) : StepFused(dt, input);
+	if (Recorder)
+		Recorder->Append(input, dt, Recorder->WantsHash() ? HashState() : 0);
+	PROFILE_COUNTER_SET("live instances", GetLiveCount());
+	PROFILE_COUNTER_SET("entity bytes", GetEntityMemoryBytes());
+	return result;
+}
+
+/******************************************************************************/
+/*!
+
+*/
+/******************************************************************************/
+unsigned int PlatformWorld::Replay(const InputLog& log, unsigned int* pTicksRun)
+{
+	InputLog *pRecorder = Recorder;
+	unsigned int tick, diverged = INPUT_LOG_NO_TICK;
+	Recorder = nullptr;
+
+	for (tick = 0; tick < log.GetTickCount() && diverged == INPUT_LOG_NO_TICK; ++tick)
+	{
+		InputFrame input;
+		float dt;
+		log.GetTick(tick, &input, &dt);
+		STEP_RESULT result = Step(dt, input);
+		if (log.HasHash(tick) && HashState() != log.GetHash(tick))
+			diverged = tick;
+
+		if (result == STEP_RESULT_RESTART)
+			Restart();
+	}
+
+	Recorder = pRecorder;
+	if (pTicksRun)
+		*pTicksRun = tick;
+	return diverged;
+}
+
+/******************************************************************************/
+/*!
+
+*/
+/******************************************************************************/
+uint64_t PlatformWorld::HashState(void) const
+{
+	uint64_t hash = 14695981039346656037ull;
+	for (unsigned int type = 0; type < ENTITY_TABLE_NUM; ++type)
+		hash = sGameObjTables[type].Hash(hash);
+
+	int lives = HeroLives;
+	for (unsigned int i = 0; i < sizeof(lives); ++i)
+		hash = (hash ^ ((lives >> (8 * i)) & 0xFF)) * 1099511628211ull;
+	return hash;
+}
+
+/******************************************************************************/
+/*!
+	The per entity stages (previous position, AI, gravity, integration,
+	bounding box, grid collision, transform) run as one loop per table.
+	Object collision is cross entity and keeps its own phase; the hero's
+	matrix is rebuilt after it if it was teleported.
+*/
+/******************************************************************************/
+STEP_RESULT PlatformWorld::StepFused(float dt, const InputFrame& input)
+{
+	unsigned int hero = sGameObjTables[TYPE_OBJECT_HERO].GetRow(hHero);
+
+	ApplyInput(input, hero);
+
+	{
+		PROFILE_ZONE("entities");
+		for (unsigned int type = TYPE_OBJECT_HERO; type < ENTITY_TABLE_NUM; ++type)
+			UpdateEntities(sGameObjTables[type], dt);
+	}
+	{
+		PROFILE_ZONE("object collision");
+		ResolveObjectCollisions(dt, hero);
+	}
+
+	//the sync point, includes the transform fix-up of whatever was teleported
+	PROFILE_ZONE("commands");
+	return ApplyCommands();
+}
+
+/******************************************************************************/
+/*!
+	The original order, one sweep per stage. Kept as the reference for
+	SetPipelineVerify.
+*/
+/******************************************************************************/
+STEP_RESULT PlatformWorld::StepMultiPass(float dt, const InputFrame& input)
+{
+	unsigned int i, type;
+	EntityTable& heroes		= sGameObjTables[TYPE_OBJECT_HERO];
+	EntityTable& enemies	= sGameObjTables[TYPE_OBJECT_ENEMY1];
+	unsigned int hero		= heroes.GetRow(hHero);
+
+	//Remember where everything was for render interpolation
+	for (type = TYPE_OBJECT_HERO; type < ENTITY_TABLE_NUM; ++type)
+	{
+		EntityTable& t = sGameObjTables[type];
+		for (i = 0; i < t.count; ++i)
+		{
+			t.posPrevX[i] = t.posX[i];
+			t.posPrevY[i] = t.posY[i];
+		}
+	}
+
+	ApplyInput(input, hero);
+
+	//Update object instances behavior
+	{
+		PROFILE_ZONE("ai");
+		for (i = 0; i < enemies.count; ++i)
+			EnemyStateMachine(enemies, i, dt);
+	}
+
+	//Apply gravity, coins don't fall
+	{
+		PROFILE_ZONE("gravity");
+		for (i = 0; i < heroes.count; ++i)
+			heroes.velY[i] += GRAVITY * dt;
+		for (i = 0; i < enemies.count; ++i)
+			enemies.velY[i] += GRAVITY * dt;
+	}
+
+	//Update object instances positions and bounding boxes
+	{
+		PROFILE_ZONE("integrate");
+		for (type = TYPE_OBJECT_HERO; type < ENTITY_TABLE_NUM; ++type)
+		{
+			EntityTable& t = sGameObjTables[type];
+			for (i = 0; i < t.count; ++i)
+			{
+				t.posX[i] += t.velX[i] * dt;
+				t.posY[i] += t.velY[i] * dt;
+			}
+			for (i = 0; i < t.count; ++i)
+			{
+				float half = BOUNDING_RECT_SIZE * t.scale[i];
+				t.minX[i] = t.posX[i] - half;
+				t.minY[i] = t.posY[i] - half;
+				t.maxX[i] = t.posX[i] + half;
+				t.maxY[i] = t.posY[i] + half;
+			}
+		}
+	}
+
+	//Check for grid collision
+	{
+		PROFILE_ZONE("grid collision");
+		for (type = TYPE_OBJECT_HERO; type < ENTITY_TABLE_NUM; ++type)
+		{
+			EntityTable& t = sGameObjTables[type];
+			for (i = 0; i < t.count; ++i)
+			{
+				// skip non-visible object instances
+				if (0 == (t.flag[i] & FLAG_VISIBLE))
+					continue;
+
+				if (SweptCollision) {
+					SweepEntityGrid(t, i);
+					continue;
+				}
+
+				int gridFlag = CheckInstanceBinaryMapCollision(t.posX[i], t.posY[i], t.scale[i], t.scale[i]);
+				t.gridCollisionFlag[i] = gridFlag;
+				if (((gridFlag & COLLISION_LEFT) == COLLISION_LEFT) || ((gridFlag & COLLISION_RIGHT) == COLLISION_RIGHT)) {
+					SnapToCell(&t.posX[i]);
+					t.velX[i] = 0;
+				}
+				if (((gridFlag & COLLISION_TOP) == COLLISION_TOP) || ((gridFlag & COLLISION_BOTTOM) == COLLISION_BOTTOM)) {
+					SnapToCell(&t.posY[i]);
+					t.velY[i] = 0;
+				}
+			}
+		}
+	}
+
+	bool heroMoved = false;
+	STEP_RESULT result;
+	{
+		PROFILE_ZONE("object collision (reference)");
+		result = ResolveObjectCollisionsAll(dt, hero, &heroMoved);
+	}
+
+	//Computing the transformation matrices of the game object instances
+	{
+		PROFILE_ZONE("transform");
+		for (type = TYPE_OBJECT_HERO; type < ENTITY_TABLE_NUM; ++type)
+		{
+			EntityTable& t = sGameObjTables[type];
+			for (i = 0; i < t.count; ++i)
+				BuildTransform(t, i);
+		}
+	}
+
+	return result;
+}
+
+/******************************************************************************/
+/*!
+	Runs the reference order on a copy of the state, then the fused order for
+	real, and compares the two bit for bit
+*/
+/******************************************************************************/
+STEP_RESULT PlatformWorld::StepVerified(float dt, const InputFrame& input)
+{
+	unsigned int type;
+	int livesBefore = HeroLives;
+
+	// reference result, computed in place then swapped out
+	for (type = 0; type < ENTITY_TABLE_NUM; ++type)
+		sVerifyTables[type].CopyFrom(sGameObjTables[type]);
+
+	STEP_RESULT expected = StepMultiPass(dt, input);
+	int expectedLives = HeroLives;
+
+	for (type = 0; type < ENTITY_TABLE_NUM; ++type)
+	{
+		EntityTable tmp;
+		tmp.CopyFrom(sGameObjTables[type]);
+		sGameObjTables[type].CopyFrom(sVerifyTables[type]);
+		sVerifyTables[type].CopyFrom(tmp);
+	}
+	HeroLives = livesBefore;
+
+	STEP_RESULT result = StepFused(dt, input);
+
+	bool identical = result == expected && HeroLives == expectedLives;
+	for (type = 0; type < ENTITY_TABLE_NUM; ++type)
+		identical = identical && sGameObjTables[type].IsIdentical(sVerifyTables[type]);
+
+	if (!identical) {
+		++PipelineMismatches;
+		assert(!"fused step differs from the multi pass step");
+	}
+
+	return result;
+}
+
+/******************************************************************************/
+/*!
+
+*/
+/******************************************************************************/
+void PlatformWorld::SetPipelineVerify(bool enable)
+{
+	if (enable) {
+		const char* pError = 0;
+		if (!ValidateSimPipeline(&pError))
+			assert(!"invalid SIM_STAGES table");
+		(void)pError;
+	}
+
+	PipelineVerify = enable;
+	PipelineMismatches = 0;
+}
+
+/******************************************************************************/
+/*!
+	Stage "hero input"
+*/
+/******************************************************************************/
+void PlatformWorld::ApplyInput(const InputFrame& input, unsigned int hero)
+{
+	EntityTable& heroes = sGameObjTables[TYPE_OBJECT_HERO];
+	if (hero == POOL_INVALID_INDEX)
+		return;
+
+	if (input.moveRight) {
+		heroes.velX[hero] = MOVE_VELOCITY_HERO;
+	}
+	else if (input.moveLeft) {
+		heroes.velX[hero] = -MOVE_VELOCITY_HERO;
+	}
+	else {
+		heroes.velX[hero] = 0.0f;
+	}
+	if ((heroes.gridCollisionFlag[hero] & COLLISION_BOTTOM) == COLLISION_BOTTOM && input.jump) {
+		heroes.velY[hero] = JUMP_VELOCITY;
+	}
+}
+
+/******************************************************************************/
+/*!
+	All per entity stages for every row of one table. A row only reads its
+	own columns and the map, so rows can be processed in any order. The
+	table is walked in blocks: the state machine runs over the block, the
+	SIMD kernel does previous position, gravity, integration and bounding
+	box for the whole block, the batch query computes the block's grid
+	collision flags, then the flags are applied and the matrix built per row.
+*/
+/******************************************************************************/
+void PlatformWorld::UpdateEntities(EntityTable& t, float dt)
+{
+	//every stage only touches its own row (and reads the map), so the
+	//blocks can go to any thread in any order
+	Jobs.ParallelFor(t.count, ENTITY_BLOCK_SIZE, [&](unsigned int begin, unsigned int end) {
+		UpdateEntityBlock(t, begin, end, dt);
+	});
+
+	//the rows whose swept box changed cells, in any order: the broad phase
+	//query's result doesn't depend on it
+	PROFILE_ZONE("broad phase moves");
+	for (std::vector<unsigned int>& moves : BroadMoves)
+	{
+		PROFILE_COUNTER_ADD("broad phase moves", moves.size());
+		for (unsigned int row : moves)
+			Broad->Track(SpatialKey(t.type, row), SweptBox(t, row, dt));
+		moves.clear();
+	}
+}
+
+/******************************************************************************/
+/*!
+	Rows [begin, end) of a table, at most ENTITY_BLOCK_SIZE of them
+*/
+/******************************************************************************/
+void PlatformWorld::UpdateEntityBlock(EntityTable& t, unsigned int begin, unsigned int end, float dt)
+{
+	const bool hasAI	= t.type == TYPE_OBJECT_ENEMY1;
+	const bool falls	= t.type != TYPE_OBJECT_COIN;
+	unsigned int i;
+
+	//enemy state machine, only writes velX so it can run ahead of the kernel
+	if (hasAI) {
+		EnemyAIContext ai{ &Map.GetCollisionGrid(), HasChaseTarget, ChaseTarget.x, ChaseTarget.y };
+		UpdateEnemyAI(t, ai, begin, end, dt);
+	}
+
+	//previous position, gravity, integration, bounding box
+	IntegrateBatch batch{ t.posX + begin, t.posY + begin, t.posPrevX + begin, t.posPrevY + begin,
+						  t.velX + begin, t.velY + begin, t.scale + begin,
+						  t.minX + begin, t.minY + begin, t.maxX + begin, t.maxY + begin,
+						  end - begin };
+	IntegrateAndBound(batch, dt, GRAVITY, falls, BOUNDING_RECT_SIZE);
+
+	if (SweptCollision) {
+		for (i = begin; i < end; ++i)
+		{
+			if (t.flag[i] & FLAG_VISIBLE)
+				SweepEntityGrid(t, i);
+			BuildTransform(t, i);
+		}
+	}
+	else {
+		//grid collision hot spots for the whole block, invisible rows are
+		//queried too and their result dropped
+		int gridFlags[ENTITY_BLOCK_SIZE];
+		CheckGridCollisionBatch(Map.GetCollisionGrid(), t.posX + begin, t.posY + begin, t.scale + begin,
+								gridFlags, end - begin);
+
+		for (i = begin; i < end; ++i)
+			UpdateEntityGrid(t, i, gridFlags[i - begin]);
+	}
+
+	//the hero is the query, not in the broad phase
+	if (t.type != TYPE_OBJECT_HERO)
+		FindBroadPhaseMoves(t, begin, end, dt);
+}
+
+/******************************************************************************/
+/*!
+	Lists the rows of the block whose swept box no longer covers the cells
+	the broad phase has them in. Only reads the hash, the moves are made by
+	UpdateEntities once every block is done.
+*/
+/******************************************************************************/
+void PlatformWorld::FindBroadPhaseMoves(const EntityTable& t, unsigned int begin, unsigned int end, float dt)
+{
+	int cellX[ENTITY_BLOCK_SIZE], cellY[ENTITY_BLOCK_SIZE];
+	SweptCellBatch batch{ t.minX + begin, t.minY + begin, t.maxX + begin, t.maxY + begin,
+						  t.velX + begin, t.velY + begin, end - begin };
+	SweptCells(batch, dt, SWEPT_MARGIN, cellX, cellY);
+	Broad->FindMoved(t.type, begin, cellX, cellY, end - begin, &BroadMoves[Jobs.GetThreadIndex()]);
+}
+
+/******************************************************************************/
+/*!
+	EntityTable::Remove, with the broad phase following its swap and pop:
+	the last row takes the removed one's key
+*/
+/******************************************************************************/
+void PlatformWorld::RemoveRow(EntityTable& t, unsigned int row)
+{
+	if (row >= t.count)
+		return;
+
+	unsigned int last = t.count - 1;
+	Broad->Untrack(SpatialKey(t.type, row));
+	if (row != last)
+		Broad->Renumber(SpatialKey(t.type, last), SpatialKey(t.type, row));
+	t.Remove(row);
+}
+
+/******************************************************************************/
+/*!
+	Applies the grid collision flags of one row and builds its matrix
+*/
+/******************************************************************************/
+void PlatformWorld::UpdateEntityGrid(EntityTable& t, unsigned int i, int gridFlag) const
+{
+	//grid collision
+	if (t.flag[i] & FLAG_VISIBLE) {
+		t.gridCollisionFlag[i] = gridFlag;
+		if (((gridFlag & COLLISION_LEFT) == COLLISION_LEFT) || ((gridFlag & COLLISION_RIGHT) == COLLISION_RIGHT)) {
+			SnapToCell(&t.posX[i]);
+			t.velX[i] = 0;
+		}
+		if (((gridFlag & COLLISION_TOP) == COLLISION_TOP) || ((gridFlag & COLLISION_BOTTOM) == COLLISION_BOTTOM)) {
+			SnapToCell(&t.posY[i]);
+			t.velY[i] = 0;
+		}
+	}
+
+	//transform
+	BuildTransform(t, i);
+}
+
+/******************************************************************************/
+/*!
+	Swept grid collision of one visible row: moves it from posPrev to where
+	integration put it, stopping at the collision cells on the way, and
+	refits its bounding box
+*/
+/******************************************************************************/
+void PlatformWorld::SweepEntityGrid(EntityTable& t, unsigned int i) const
+{
+	float half = BOUNDING_RECT_SIZE * t.scale[i];
+	SimVec2 pos{ t.posX[i], t.posY[i] };
+	SimVec2 vel{ t.velX[i], t.velY[i] };
+
+	t.gridCollisionFlag[i] = (int)MoveBoxGrid(Map.GetCollisionGrid(), SimVec2{ half, half },
+											  SimVec2{ t.posPrevX[i], t.posPrevY[i] }, &pos, &vel);
+	t.posX[i] = pos.x;
+	t.posY[i] = pos.y;
+	t.velX[i] = vel.x;
+	t.velY[i] = vel.y;
+	t.minX[i] = pos.x - half;
+	t.minY[i] = pos.y - half;
+	t.maxX[i] = pos.x + half;
+	t.maxY[i] = pos.y + half;
+}
+
+/******************************************************************************/
+/*!
+	Stage "object collision": hero against enemies and coins. The broad
+	phase hash already has every enemy and coin in the cell of its swept
+	box, so only the cells around the hero's swept box are visited; the
+	rows whose swept boxes touch the hero's go to the narrow phase, on the
+	workers. It changes nothing itself: an enemy hit records damage to the
+	hero and a coin hit the coin's destruction, keyed by the contact's index. The
+	contacts are enemies then coins, each in row order, so applied in key
+	order they play out as the brute force loops of
+	ResolveObjectCollisionsAll.
+*/
+/******************************************************************************/
+void PlatformWorld::ResolveObjectCollisions(float dt, unsigned int hero)
+{
+	EntityTable& heroes		= sGameObjTables[TYPE_OBJECT_HERO];
+	EntityTable& enemies	= sGameObjTables[TYPE_OBJECT_ENEMY1];
+	EntityTable& coins		= sGameObjTables[TYPE_OBJECT_COIN];
+	if (hero == POOL_INVALID_INDEX)
+		return;
+
+	SimAABB heroSwept = SweptBox(heroes, hero, dt);
+	Broad->Query(heroSwept, &BroadFound);
+	// enemies then coins, each in row order, for the step only
+	ObjectContact* pContacts = FrameScratch.AllocateArray<ObjectContact>(BroadFound.size());
+	unsigned int contactCount = 0;
+	for (unsigned int key : BroadFound)
+	{
+		unsigned int type = SpatialKeyType(key);
+		const EntityTable& t = type == TYPE_OBJECT_ENEMY1 ? enemies : coins;
+		unsigned int row = SpatialKeyId(key);
+		SimAABB swept = SweptBox(t, row, dt);
+		if (swept.max.x < heroSwept.min.x || swept.min.x > heroSwept.max.x ||
+			swept.max.y < heroSwept.min.y || swept.min.y > heroSwept.max.y)
+			continue;
+		pContacts[contactCount++] = { type, row };
+	}
+	// the hash hands them out in no set order
+	std::sort(pContacts, pContacts + contactCount, [](const ObjectContact& a, const ObjectContact& b) {
+		return a.type != b.type ? a.type < b.type : a.row < b.row;
+	});
+
+	SimAABB heroBox{ { heroes.minX[hero], heroes.minY[hero] }, { heroes.maxX[hero], heroes.maxY[hero] } };
+	SimVec2 heroVel{ heroes.velX[hero], heroes.velY[hero] };
+	PROFILE_COUNTER_ADD("collision tests", contactCount);
+
+	Jobs.ParallelFor(contactCount, COLLISION_PAIR_GRAIN, [&](unsigned int begin, unsigned int end) {
+		CommandBuffer& commands = GetCommandBuffer();
+		for (unsigned int p = begin; p < end; ++p)
+		{
+			const ObjectContact& contact = pContacts[p];
+			const EntityTable& t = sGameObjTables[contact.type];
+			unsigned int row = contact.row;
+			SimAABB box{ { t.minX[row], t.minY[row] }, { t.maxX[row], t.maxY[row] } };
+			SimVec2 vel{ t.velX[row], t.velY[row] };
+			if (!CollisionIntersection_RectRect(box, vel, heroBox, heroVel, dt))
+				continue;
+
+			// with enemy: a life, with coin: picked up
+			if (contact.type == TYPE_OBJECT_ENEMY1)
+				commands.Damage(p, hHero, 1);
+			else
+				commands.Destroy(p, t.GetHandle(row));
+		}
+	});
+}
+
+/******************************************************************************/
+/*!
+	Stage "apply commands": every thread's commands in key order. Only the
+	hero takes damage: a life, and back to the start while any are left.
+	Destruction is collected and done last, in one pass per table from the
+	highest row down, so each swap and pop only moves a row that stays;
+	that's also the order the tables always removed picked up coins in.
+*/
+/******************************************************************************/
+STEP_RESULT PlatformWorld::ApplyCommands(void)
+{
+	STEP_RESULT result = STEP_RESULT_CONTINUE;
+	bool respawned = false;
+
+	MergeCommandBuffers(Commands.data(), (unsigned int)Commands.size(), &SortedCommands);
+	for (CommandBuffer& buffer : Commands)
+		buffer.Clear();
+
+	for (const WorldCommand& c : SortedCommands)
+	{
+		switch (c.command) {
+		case WORLD_COMMAND_SPAWN:
+			gameObjInstCreate(c.objType, c.scale, &c.pos, &c.vel, c.dir, c.state);
+			break;
+		case WORLD_COMMAND_DAMAGE:
+			if (c.target.type != TYPE_OBJECT_HERO || sGameObjTables[TYPE_OBJECT_HERO].GetRow(c.target) == POOL_INVALID_INDEX)
+				break;
+			HeroLives -= c.amount;
+			if (HeroLives <= 0) {
+				result = STEP_RESULT_RESTART;
+				break;
+			}
+			{
+				EntityTable& heroes = sGameObjTables[TYPE_OBJECT_HERO];
+				unsigned int hero = heroes.GetRow(c.target);
+				heroes.posX[hero] = Hero_Initial_X + 0.5f;
+				heroes.posY[hero] = Hero_Initial_Y + 0.5f;
+				// teleport, don't interpolate across the map
+				heroes.posPrevX[hero] = heroes.posX[hero];
+				heroes.posPrevY[hero] = heroes.posY[hero];
+				//transform fix-up
+				BuildTransform(heroes, hero);
+				respawned = true;
+			}
+			break;
+		case WORLD_COMMAND_TELEPORT:
+			if (c.target.type < ENTITY_TABLE_NUM) {
+				EntityTable& t = sGameObjTables[c.target.type];
+				unsigned int row = t.GetRow(c.target);
+				if (row == POOL_INVALID_INDEX)
+					break;
+				t.posX[row] = t.posPrevX[row] = c.pos.x;
+				t.posY[row] = t.posPrevY[row] = c.pos.y;
+				//transform fix-up
+				BuildTransform(t, row);
+			}
+			break;
+		case WORLD_COMMAND_DESTROY:
+			break;
+		}
+	}
+
+	// rows to destroy, one type at a time; a command names at most one
+	unsigned int* pDestroyed = FrameScratch.AllocateArray<unsigned int>(SortedCommands.size());
+	for (unsigned int type = 0; type < ENTITY_TABLE_NUM; ++type)
+	{
+		EntityTable& t = sGameObjTables[type];
+		unsigned int destroyedCount = 0;
+		for (const WorldCommand& c : SortedCommands)
+		{
+			if (c.command != WORLD_COMMAND_DESTROY || c.target.type != type)
+				continue;
+			unsigned int row = t.GetRow(c.target);
+			if (row != POOL_INVALID_INDEX)
+				pDestroyed[destroyedCount++] = row;
+		}
+
+		std::sort(pDestroyed, pDestroyed + destroyedCount);
+		destroyedCount = (unsigned int)(std::unique(pDestroyed, pDestroyed + destroyedCount) - pDestroyed);
+		for (unsigned int r = destroyedCount; r-- > 0; )
+			RemoveRow(t, pDestroyed[r]);
+	}
+
+	if (respawned)
+		StopChases();
+	return result;
+}
+
+/******************************************************************************/
+/*!
+
+*/
+/******************************************************************************/
+void PlatformWorld::SetWorkerCount(unsigned int count)
+{
+	Jobs.Start(count);
+	Commands.clear();
+	Commands.resize(count + 1);
+	BroadMoves.clear();
+	BroadMoves.resize(count + 1);
+}
+
+/******************************************************************************/
+/*!
+	The same stage testing the hero against every enemy and coin. Kept as
+	the reference for SetPipelineVerify.
+*/
+/******************************************************************************/
+STEP_RESULT PlatformWorld::ResolveObjectCollisionsAll(float dt, unsigned int hero, bool* pHeroMoved)
+{
+	STEP_RESULT result = STEP_RESULT_CONTINUE;
+	EntityTable& heroes		= sGameObjTables[TYPE_OBJECT_HERO];
+	EntityTable& enemies	= sGameObjTables[TYPE_OBJECT_ENEMY1];
+	EntityTable& coins		= sGameObjTables[TYPE_OBJECT_COIN];
+	unsigned int i;
+
+	if (hero == POOL_INVALID_INDEX)
+		return result;
+
+	SimAABB heroBox{ { heroes.minX[hero], heroes.minY[hero] }, { heroes.maxX[hero], heroes.maxY[hero] } };
+	SimVec2 heroVel{ heroes.velX[hero], heroes.velY[hero] };
+	bool respawned = false;
+	PROFILE_COUNTER_ADD("collision tests", enemies.count + coins.count);
+
+	// with enemy
+	for (i = 0; i < enemies.count; ++i)
+	{
+		SimAABB box{ { enemies.minX[i], enemies.minY[i] }, { enemies.maxX[i], enemies.maxY[i] } };
+		SimVec2 vel{ enemies.velX[i], enemies.velY[i] };
+		if (CollisionIntersection_RectRect(box, vel, heroBox, heroVel, dt)) {
+			--HeroLives;
+			if (HeroLives <= 0) {
+				result = STEP_RESULT_RESTART;
+			}
+			else {
+				heroes.posX[hero] = Hero_Initial_X + 0.5f;
+				heroes.posY[hero] = Hero_Initial_Y + 0.5f;
+				// teleport, don't interpolate across the map
+				heroes.posPrevX[hero] = heroes.posX[hero];
+				heroes.posPrevY[hero] = heroes.posY[hero];
+				*pHeroMoved = true;
+				respawned = true;
+			}
+		}
+	}
+	// after the loop, the later enemies are tested with the velocities
+	// they had when they hit
+	if (respawned)
+		StopChases();
+
+	// with coin, walked back to front: a picked up coin is removed,
+	// which moves the last row (already visited) into its place
+	for (i = coins.count; i-- > 0; )
+	{
+		SimAABB box{ { coins.minX[i], coins.minY[i] }, { coins.maxX[i], coins.maxY[i] } };
+		SimVec2 vel{ coins.velX[i], coins.velY[i] };
+		if (CollisionIntersection_RectRect(box, vel, heroBox, heroVel, dt)) {
+			coins.Remove(i);
+		}
+	}
+
+	return result;
+}
+
+/******************************************************************************/
+/*!
+	Fixed timestep: the frame time is added to an accumulator which is then
+	drained in FixedStep ticks. At most MaxSubsteps ticks run per frame, any
+	time left over beyond that is dropped so a slow frame can't make the next
+	one slower (spiral of death). The remainder sets the interpolation alpha.
+*/
+/******************************************************************************/
+STEP_RESULT PlatformWorld::Advance(float frameTime, const InputFrame& input)
+{
+	LastSubstepCount = 0;
+
+	if (FixedStep <= 0.0f) {
+		InterpolationAlpha = 1.0f;
+		LastSubstepCount = 1;
+		return Step(frameTime, input);
+	}
+
+	Accumulator += frameTime;
+	while (Accumulator >= FixedStep)
+	{
+		if (LastSubstepCount == MaxSubsteps) {
+			Accumulator = 0.0f;
+			break;
+		}
+		Accumulator -= FixedStep;
+		++LastSubstepCount;
+		if (Step(FixedStep, input) == STEP_RESULT_RESTART) {
+			Accumulator = 0.0f;
+			InterpolationAlpha = 1.0f;
+			return STEP_RESULT_RESTART;
+		}
+	}
+
+	InterpolationAlpha = Accumulator / FixedStep;
+	return STEP_RESULT_CONTINUE;
+}
+
+/******************************************************************************/
+/*!
+	"fixedStep" of 0 switches back to one variable step per frame
+*/
+/******************************************************************************/
+void PlatformWorld::SetFixedTimestep(float fixedStep, unsigned int maxSubsteps)
+{
+	FixedStep = fixedStep > 0.0f ? fixedStep : 0.0f;
+	MaxSubsteps = maxSubsteps ? maxSubsteps : 1;
+	Accumulator = 0.0f;
+	InterpolationAlpha = 1.0f;
+}
+
+/******************************************************************************/
+/*!
+
+*/
+/******************************************************************************/
+SimVec2 PlatformWorld::GetInterpolatedPosition(const EntityTable& table, unsigned int row) const
+{
+	float a = InterpolationAlpha;
+	return { table.posPrevX[row] + (table.posX[row] - table.posPrevX[row]) * a,
+			 table.posPrevY[row] + (table.posY[row] - table.posPrevY[row]) * a };
+}
+
+/******************************************************************************/
+/*!
+
+*/
+/******************************************************************************/
+bool PlatformWorld::GetInterpolatedPosition(GameObjHandle handle, SimVec2* pPos) const
+{
+	if (handle.type >= ENTITY_TABLE_NUM)
+		return false;
+
+	const EntityTable& table = sGameObjTables[handle.type];
+	unsigned int row = table.GetRow(handle);
+	if (row == POOL_INVALID_INDEX)
+		return false;
+
+	*pPos = GetInterpolatedPosition(table, row);
+	return true;
+}
+
+/******************************************************************************/
+/*!
+	Same stacking as when each table was drawn in turn: coins, then
+	enemies, then the hero on top
+*/
+/******************************************************************************/
+void PlatformWorld::EmitDrawRecords(RenderQueue *pQueue, ViewCuller *pCuller) const
+{
+	static const unsigned int sDrawLayer[ENTITY_TABLE_NUM] = { 0, 0, 2, 1, 0 };
+
+	for (unsigned int type = TYPE_OBJECT_HERO; type < ENTITY_TABLE_NUM; ++type)
+	{
+		const EntityTable& table = sGameObjTables[type];
+		for (unsigned int k = 0; k < table.count; ++k)
+		{
+			// skip non-visible object
+			if (0 == (table.flag[k] & FLAG_VISIBLE))
+				continue;
+
+			//The translation is swapped for the position interpolated between the last two ticks
+			SimVec2 pos = GetInterpolatedPosition(table, k);
+			float halfX = (table.maxX[k] - table.minX[k]) * 0.5f;
+			float halfY = (table.maxY[k] - table.minY[k]) * 0.5f;
+			if (!pCuller->IsVisible({ { pos.x - halfX, pos.y - halfY }, { pos.x + halfX, pos.y + halfY } }))
+				continue;
+
+			SimMtx33 transform = table.transform[k];
+			transform.m[0][2] = pos.x;
+			transform.m[1][2] = pos.y;
+			pQueue->Submit(sDrawLayer[type], RENDER_TEXTURE_NONE, type, transform);
+		}
+	}
+}
+
+/******************************************************************************/
+/*!
+
+*/
+/******************************************************************************/
+unsigned int PlatformWorld::GetLiveCount(void) const
+{
+	unsigned int total = 0;
+	for (unsigned int type = 0; type < ENTITY_TABLE_NUM; ++type)
+		total += sGameObjTables[type].count;
+	return total;
+}
+
+/******************************************************************************/
+/*!
+
+*/
+/******************************************************************************/
+GameObjHandle PlatformWorld::gameObjInstCreate(unsigned int type, float scale,
+											   const SimVec2* pPos, const SimVec2* pVel,
+											   float dir, enum STATE startState)
+{
+	SimVec2 zero{ 0.0f, 0.0f };
+
+	// only types with a table can be instanced
+	if (type >= ENTITY_TABLE_NUM || sGameObjTables[type].capacity == 0)
+		return INVALID_HANDLE;
+
+	return sGameObjTables[type].Add(scale, pPos ? *pPos : zero, pVel ? *pVel : zero, dir, startState);
+}
+
+/******************************************************************************/
+/*!
+
+*/
+/******************************************************************************/
+void PlatformWorld::gameObjInstDestroy(GameObjHandle handle)
+{
+	if (handle.type >= ENTITY_TABLE_NUM)
+		return;
+
+	// if instance is destroyed before, just return
+	EntityTable& table = sGameObjTables[handle.type];
+	unsigned int row = table.GetRow(handle);
+	if (row == POOL_INVALID_INDEX)
+		return;
+
+	RemoveRow(table, row);
+}
+
+/******************************************************************************/
+/*!
+
+*/
+/******************************************************************************/
+int PlatformWorld::CheckInstanceBinaryMapCollision(float PosX, float PosY, float scaleX, float scaleY) const
+{
+	//At the end of this function, "Flag" will be used to determine which sides
+	//of the object instance are colliding. 2 hot spots will be placed on each side.
+
+	// up
+	float ux1{ PosX + scaleX / 4.0f }, uy1{ PosY + scaleY / 2.0f },
+		ux2{ PosX - scaleX / 4.0f }, uy2{ PosY + scaleY / 2.0f };
+	// down
+	float dx1{ PosX + scaleX / 4.0f }, dy1{ PosY - scaleY / 2.0f },
+		dx2{ PosX - scaleX / 4.0f }, dy2{ PosY - scaleY / 2.0f };
+	// left
+	float lx1{ PosX - scaleX / 2.0f }, ly1{ PosY + scaleY / 4.0f },
+		lx2{ PosX - scaleX / 2.0f }, ly2{ PosY - scaleY / 4.0f };
+	// right
+	float rx1{ PosX + scaleX / 2.0f }, ry1{ PosY + scaleY / 4.0f },
+		rx2{ PosX + scaleX / 2.0f }, ry2{ PosY - scaleY / 4.0f };
+
+	int flag = 0;
+	// check if positions in occupied cell
+	// up
+	if (GetCellValue((int)ux1, (int)uy1) == TYPE_OBJECT_COLLISION || GetCellValue((int)ux2, (int)uy2) == TYPE_OBJECT_COLLISION) {
+		flag |= COLLISION_TOP;
+	}
+	// down
+	if (GetCellValue((int)dx1, (int)dy1) == TYPE_OBJECT_COLLISION || GetCellValue((int)dx2, (int)dy2) == TYPE_OBJECT_COLLISION) {
+		flag |= COLLISION_BOTTOM;
+	}
+	// left
+	if (GetCellValue((int)lx1, (int)ly1) == TYPE_OBJECT_COLLISION || GetCellValue((int)lx2, (int)ly2) == TYPE_OBJECT_COLLISION) {
+		flag |= COLLISION_LEFT;
+	}
+	// right
+	if (GetCellValue((int)rx1, (int)ry1) == TYPE_OBJECT_COLLISION || GetCellValue((int)rx2, (int)ry2) == TYPE_OBJECT_COLLISION) {
+		flag |= COLLISION_RIGHT;
+	}
+	return flag;
+}
+
+/******************************************************************************/
+/*!
+
+*/
+/******************************************************************************/
+void SnapToCell(float *Coordinate)
+{
+	*Coordinate = (float)((int)(*Coordinate)) + 0.5f;
+}
+
+/******************************************************************************/
+/*!
+	STATE_GOING_LEFT / STATE_GOING_RIGHT, each with an enter, update and exit
+	inner state. The enemy walks until it hits a wall or reaches a ledge,
+	idles for ENEMY_IDLE_TIME and turns around. Walking near the hero, it
+	switches to STATE_CHASE, whose enter state is PlanChases.
+*/
+/******************************************************************************/
+void PlatformWorld::EnemyStateMachine(EntityTable& enemies, unsigned int row, float dt)
+{
+	EntityTable& e = enemies;
+	unsigned int i = row;
+	bool check = false;
+	EnemyAIContext ai{ &Map.GetCollisionGrid(), HasChaseTarget, ChaseTarget.x, ChaseTarget.y };
+	float dx;
+	switch (e.state[i]) {
+	case (STATE_GOING_LEFT):
+		switch (e.innerState[i]) {
+		case (INNER_STATE_ON_ENTER):
+			e.velX[i] = -MOVE_VELOCITY_ENEMY;
+			e.innerState[i] = INNER_STATE_ON_UPDATE;
+			break;
+		case (INNER_STATE_ON_UPDATE):
+			check = (e.posX[i] - (int)e.posX[i] <= 0.5f) ? !GetCellValue((int)e.posX[i] - 1, (int)e.posY[i] - 1) : false;
+			if ((e.gridCollisionFlag[i] & COLLISION_LEFT) == COLLISION_LEFT || check) {
+				e.counter[i] = ENEMY_IDLE_TIME;
+				e.innerState[i] = INNER_STATE_ON_EXIT;
+				e.velX[i] = 0;
+			}
+			if (IsInChaseRange(ai, e.posX[i], e.posY[i])) {
+				e.state[i] = STATE_CHASE;
+				e.innerState[i] = INNER_STATE_ON_ENTER;
+			}
+			break;
+		case (INNER_STATE_ON_EXIT):
+			e.counter[i] -= dt;
+			if (e.counter[i] < 0.0) {
+				e.state[i] = STATE_GOING_RIGHT;
+				e.innerState[i] = INNER_STATE_ON_ENTER;
+			}
+			break;
+		}
+		break;
+	case (STATE_GOING_RIGHT):
+		switch (e.innerState[i]) {
+		case (INNER_STATE_ON_ENTER):
+			e.velX[i] = MOVE_VELOCITY_ENEMY;
+			e.innerState[i] = INNER_STATE_ON_UPDATE;
+			break;
+		case (INNER_STATE_ON_UPDATE):
+			check = (e.posX[i] - (int)e.posX[i] >= 0.5f) ? !GetCellValue((int)e.posX[i] + 1, (int)e.posY[i] - 1) : false;
+			if ((e.gridCollisionFlag[i] & COLLISION_RIGHT) == COLLISION_RIGHT || check) {
+				e.counter[i] = ENEMY_IDLE_TIME;
+				e.innerState[i] = INNER_STATE_ON_EXIT;
+				e.velX[i] = 0;
+			}
+			if (IsInChaseRange(ai, e.posX[i], e.posY[i])) {
+				e.state[i] = STATE_CHASE;
+				e.innerState[i] = INNER_STATE_ON_ENTER;
+			}
+			break;
+		case (INNER_STATE_ON_EXIT):
+			e.counter[i] -= dt;
+			if (e.counter[i] < 0.0) {
+				e.state[i] = STATE_GOING_LEFT;
+				e.innerState[i] = INNER_STATE_ON_ENTER;
+			}
+			break;
+		}
+		break;
+	case (STATE_CHASE):
+		switch (e.innerState[i]) {
+		case (INNER_STATE_ON_UPDATE):
+			dx = e.targetX[i] - e.posX[i];
+			check = fabsf(dx) <= ENEMY_CHASE_VELOCITY * dt;
+			e.counter[i] -= dt;
+			e.velX[i] = check ? 0.0f : (dx < 0.0f ? -ENEMY_CHASE_VELOCITY : ENEMY_CHASE_VELOCITY);
+			if (check || e.counter[i] < 0.0)
+				e.innerState[i] = INNER_STATE_ON_ENTER;
+			break;
+		default:
+			break;
+		}
+		break;
+	default:
+		break;
+	}
+}
+
+/******************************************************************************/
+/*!
+	Runs ahead of both pipelines, on the main thread since PathService
+	isn't thread safe. The requests of the chasers are answered by the same
+	Update as the ones made through RequestPath, so the waypoints are set
+	in the step the enemy asked. A chaser takes the end of the path's first
+	run of walks, or the cell its first jump or fall lands on, and jumps
+	right away if it has to.
+	Chases are short (ENEMY_CHASE_LOSE_RANGE), well under the distance at
+	which NavGraph searches a corridor, so these paths are the shortest.
+*/
+/******************************************************************************/
+void PlatformWorld::PlanChases(void)
+{
+	EntityTable& heroes		= sGameObjTables[TYPE_OBJECT_HERO];
+	EntityTable& enemies	= sGameObjTables[TYPE_OBJECT_ENEMY1];
+	unsigned int hero		= heroes.GetRow(hHero);
+
+	HasChaseTarget = hero != POOL_INVALID_INDEX && (heroes.flag[hero] & FLAG_VISIBLE);
+	ChaseTarget = HasChaseTarget ? SimVec2{ heroes.posX[hero], heroes.posY[hero] } : SimVec2{ 0.0f, 0.0f };
+
+	unsigned int* pRows = FrameScratch.AllocateArray<unsigned int>(enemies.count);
+	PathTicket* pTickets = FrameScratch.AllocateArray<PathTicket>(enemies.count);
+	unsigned int requestCount = 0;
+	for (unsigned int i = 0; i < enemies.count; ++i)
+	{
+		if (enemies.state[i] != STATE_CHASE || enemies.innerState[i] != INNER_STATE_ON_ENTER)
+			continue;
+		if (!HasChaseTarget || fabsf(ChaseTarget.x - enemies.posX[i]) > ENEMY_CHASE_LOSE_RANGE ||
+			fabsf(ChaseTarget.y - enemies.posY[i]) > ENEMY_CHASE_LOSE_RANGE) {
+			StopChase(enemies, i);
+			continue;
+		}
+		pRows[requestCount] = i;
+		pTickets[requestCount++] = Paths.Request((int)floorf(enemies.posX[i]), (int)floorf(enemies.posY[i]),
+												 (int)floorf(ChaseTarget.x), (int)floorf(ChaseTarget.y));
+	}
+	PROFILE_COUNTER_ADD("chase paths", requestCount);
+
+	Paths.Update(Map, Jobs);
+
+	for (unsigned int k = 0; k < requestCount; ++k)
+	{
+		unsigned int i = pRows[k];
+		const NavPath* pPath;
+		if (Paths.GetPath(pTickets[k], &pPath) != PATH_STATUS_FOUND || pPath->waypoints.empty()) {
+			StopChase(enemies, i);
+			continue;
+		}
+
+		const std::vector<NavWaypoint>& w = pPath->waypoints;
+		size_t n = w.size() > 1 ? 1 : 0;
+		while (n > 0 && w[n].link == NAV_LINK_WALK && n + 1 < w.size() && w[n + 1].link == NAV_LINK_WALK)
+			++n;
+
+		//a path of one cell: on the hero's ground already, walk under it
+		enemies.targetX[i] = n > 0 ? (float)w[n].x + 0.5f : ChaseTarget.x;
+		if (w[n].link == NAV_LINK_JUMP && (enemies.gridCollisionFlag[i] & COLLISION_BOTTOM))
+			enemies.velY[i] = JUMP_VELOCITY;
+		enemies.counter[i]		= ENEMY_CHASE_REPLAN_TIME;
+		enemies.innerState[i]	= INNER_STATE_ON_UPDATE;
+	}
+}
+
+/******************************************************************************/
+/*!
+	Lost the hero or has no way to it: idles, then patrols the other way
+*/
+/******************************************************************************/
+void PlatformWorld::StopChase(EntityTable& enemies, unsigned int row)
+{
+	enemies.state[row]		= enemies.velX[row] < 0.0f ? STATE_GOING_LEFT : STATE_GOING_RIGHT;
+	enemies.innerState[row]	= INNER_STATE_ON_EXIT;
+	enemies.counter[row]	= ENEMY_IDLE_TIME;
+	enemies.velX[row]		= 0.0f;
+}
+
+/******************************************************************************/
+/*!
+	Every chaser gives up once the hero is back at its spawn, or one that
+	caught it there would catch it again every step
+*/
+/******************************************************************************/
+void PlatformWorld::StopChases(void)
+{
+	EntityTable& enemies = sGameObjTables[TYPE_OBJECT_ENEMY1];
+	for (unsigned int i = 0; i < enemies.count; ++i)
+		if (enemies.state[i] == STATE_CHASE)
+			StopChase(enemies, i);
+}
+
+/******************************************************************************/
+/*!
+	Streams a binary level file, or the exported text format (see
+	TextChunkSource)
+*/
+/******************************************************************************/
+int PlatformWorld::StreamMapFromFile(const char *FileName)
+{
+	if (IsLevelFile(FileName)) {
+		BinaryChunkSource *pBinary = new BinaryChunkSource;
+		if (!pBinary->Open(FileName)) {
+			delete pBinary;
+			return 0;
+		}
+		return OpenStreamedMap(pBinary);
+	}
+
+	TextChunkSource *pSource = new TextChunkSource;
+	if (!pSource->Open(FileName)) {
+		delete pSource;
+		return 0;
+	}
+	return OpenStreamedMap(pSource);
+}
+
+/******************************************************************************/
+/*!
+	Nothing is loaded until Init, which puts the window around the hero
+*/
+/******************************************************************************/
+int PlatformWorld::OpenStreamedMap(ChunkSource *pSource)
+{
+	FreeMapData();
+	if (!pSource)
+		return 0;
+
+	Streamer.Open(pSource);
+	Map.Create(CHUNK_WINDOW * CHUNK_SIZE, CHUNK_WINDOW * CHUNK_SIZE, false, &Arena);
+	return 1;
+}
+
+/******************************************************************************/
+/*!
+
+*/
+/******************************************************************************/
+void PlatformWorld::GetResidentBounds(int *pX0, int *pY0, int *pX1, int *pY1) const
+{
+	if (!IsStreamed()) {
+		*pX0 = 0;
+		*pY0 = 0;
+		*pX1 = Map.GetWidth();
+		*pY1 = Map.GetHeight();
+		return;
+	}
+
+	if (!WindowValid) {
+		*pX0 = *pY0 = *pX1 = *pY1 = 0;
+		return;
+	}
+
+	int x0 = Map.GetOriginX(), y0 = Map.GetOriginY();
+	int x1 = x0 + Map.GetWidth(), y1 = y0 + Map.GetHeight();
+	*pX0 = x0 < 0 ? 0 : x0;
+	*pY0 = y0 < 0 ? 0 : y0;
+	*pX1 = x1 > Streamer.GetLevelWidth() ? Streamer.GetLevelWidth() : x1;
+	*pY1 = y1 > Streamer.GetLevelHeight() ? Streamer.GetLevelHeight() : y1;
+}
+
+/******************************************************************************/
+/*!
+	Runs before every step of a streamed level: keeps the window centered on
+	the hero's chunk, puts to sleep whatever left the active area, and has
+	the ring of chunks around the window loaded ahead
+*/
+/******************************************************************************/
+void PlatformWorld::UpdateStreaming(void)
+{
+	const EntityTable& heroes = sGameObjTables[TYPE_OBJECT_HERO];
+	unsigned int hero = heroes.GetRow(hHero);
+	int centerX, centerY;
+
+	if (hero != POOL_INVALID_INDEX) {
+		centerX = ChunkOfCell((int)floorf(heroes.posX[hero]));
+		centerY = ChunkOfCell((int)floorf(heroes.posY[hero]));
+	}
+	else if (WindowValid) {
+		centerX = WindowChunkX + CHUNK_WINDOW / 2;
+		centerY = WindowChunkY + CHUNK_WINDOW / 2;
+	}
+	else {
+		centerX = centerY = 0;
+	}
+
+	int windowX = centerX - CHUNK_WINDOW / 2, windowY = centerY - CHUNK_WINDOW / 2;
+	if (!WindowValid || windowX != WindowChunkX || windowY != WindowChunkY)
+		MoveWindow(windowX, windowY);
+	else
+		DeactivateOutside(centerX - CHUNK_ACTIVE / 2, centerY - CHUNK_ACTIVE / 2);
+
+	Streamer.Request(centerX, centerY, CHUNK_PREFETCH_RADIUS);
+	// one ring of slack so walking back and forth over a chunk edge
+	// doesn't reload anything
+	Streamer.Evict(centerX, centerY, CHUNK_PREFETCH_RADIUS + 1);
+}
+
+/******************************************************************************/
+/*!
+	Refills the map window from the streamer's cache, waiting for any chunk
+	that isn't loaded yet (only when the hero outruns the prefetch or is
+	teleported), and wakes up the chunks that entered the active area
+*/
+/******************************************************************************/
+void PlatformWorld::MoveWindow(int chunkX, int chunkY)
+{
+	const int border = (CHUNK_WINDOW - CHUNK_ACTIVE) / 2;
+	int oldActiveX = WindowChunkX + border, oldActiveY = WindowChunkY + border;
+	int activeX = chunkX + border, activeY = chunkY + border;
+	bool wasValid = WindowValid;
+
+	DeactivateOutside(activeX, activeY);
+
+	Map.Clear();
+	Map.SetOrigin(chunkX * CHUNK_SIZE, chunkY * CHUNK_SIZE);
+	Paths.Reset();
+	for (int cy = chunkY; cy < chunkY + CHUNK_WINDOW; ++cy)
+		for (int cx = chunkX; cx < chunkX + CHUNK_WINDOW; ++cx)
+		{
+			const unsigned char *types = Streamer.GetChunk(cx, cy, true);
+			for (int y = 0; y < CHUNK_SIZE; ++y)
+				for (int x = 0; x < CHUNK_SIZE; ++x)
+					Map.SetCell(cx * CHUNK_SIZE + x, cy * CHUNK_SIZE + y, types[y * CHUNK_SIZE + x]);
+		}
+
+	WindowChunkX = chunkX;
+	WindowChunkY = chunkY;
+	WindowValid = true;
+
+	for (int cy = activeY; cy < activeY + CHUNK_ACTIVE; ++cy)
+		for (int cx = activeX; cx < activeX + CHUNK_ACTIVE; ++cx)
+		{
+			bool wasActive = wasValid &&
+							 cx >= oldActiveX && cx < oldActiveX + CHUNK_ACTIVE &&
+							 cy >= oldActiveY && cy < oldActiveY + CHUNK_ACTIVE;
+			if (!wasActive)
+				ActivateChunk(cx, cy);
+		}
+}
+
+/******************************************************************************/
+/*!
+	First visit: creates the chunk's enemies and coins from the map, in the
+	same column by column order as Init. Later visits: brings back the
+	instances that went to sleep in it.
+*/
+/******************************************************************************/
+void PlatformWorld::ActivateChunk(int chunkX, int chunkY)
+{
+	ChunkRecord& record = ChunkRecords[ChunkKey(chunkX, chunkY)];
+
+	if (!record.spawned) {
+		record.spawned = true;
+		for (int i = chunkX * CHUNK_SIZE; i < (chunkX + 1) * CHUNK_SIZE; ++i)
+			for (int j = chunkY * CHUNK_SIZE; j < (chunkY + 1) * CHUNK_SIZE; ++j)
+			{
+				unsigned int type = Map.GetType(i, j);
+				SimVec2 pos{ (float)i + 0.5f, (float)j + 0.5f };
+				// the hero is created by Init
+				if (type == TYPE_OBJECT_ENEMY1)
+					gameObjInstCreate(type, 1.0f, &pos, nullptr, 0.0f, STATE::STATE_GOING_RIGHT);
+				else if (type == TYPE_OBJECT_COIN)
+					gameObjInstCreate(type, 1.0f, &pos, nullptr, 0.0f, STATE::STATE_NONE);
+			}
+	}
+
+	// the tables grow, but a pool that can't give out another index still
+	// fails the add: that sleeper stays asleep
+	std::vector<DormantEntity> asleep;
+	for (const DormantEntity& d : record.dormant)
+	{
+		SimVec2 pos{ d.posX, d.posY }, vel{ d.velX, d.velY };
+		GameObjHandle handle = gameObjInstCreate(d.type, d.scale, &pos, &vel, d.dirCurr, (STATE)d.state);
+		EntityTable& t = sGameObjTables[d.type];
+		unsigned int row = t.GetRow(handle);
+		if (row == POOL_INVALID_INDEX) {
+			asleep.push_back(d);
+			continue;
+		}
+		t.flag[row]			= d.flag;
+		//a chaser's waypoint isn't kept, it plans again
+		t.innerState[row]	= d.state == STATE_CHASE ? INNER_STATE_ON_ENTER : (INNER_STATE)d.innerState;
+		t.counter[row]		= d.counter;
+		BuildTransform(t, row);
+	}
+	record.dormant.swap(asleep);
+}
+
+/******************************************************************************/
+/*!
+	Puts every enemy and coin outside the CHUNK_ACTIVE chunks from
+	(activeX, activeY) to sleep in the chunk it is in. That chunk may not
+	have been visited yet, it then still creates its own instances later.
+*/
+/******************************************************************************/
+void PlatformWorld::DeactivateOutside(int activeX, int activeY)
+{
+	for (unsigned int type = TYPE_OBJECT_ENEMY1; type <= TYPE_OBJECT_COIN; ++type)
+	{
+		EntityTable& t = sGameObjTables[type];
+
+		// back to front, Remove moves the last row (already visited) here
+		for (unsigned int i = t.count; i-- > 0; )
+		{
+			int cx = ChunkOfCell((int)floorf(t.posX[i]));
+			int cy = ChunkOfCell((int)floorf(t.posY[i]));
+			if (cx >= activeX && cx < activeX + CHUNK_ACTIVE && cy >= activeY && cy < activeY + CHUNK_ACTIVE)
+				continue;
+
+			DormantEntity d{ type, t.posX[i], t.posY[i], t.velX[i], t.velY[i], t.scale[i], t.dirCurr[i],
+							 t.flag[i], (int)t.state[i], (int)t.innerState[i], t.counter[i] };
+			ChunkRecords[ChunkKey(cx, cy)].dormant.push_back(d);
+			RemoveRow(t, i);
+		}
+	}
+}
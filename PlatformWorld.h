@@ -0,0 +1,371 @@
+/******************************************************************************/
+/*!
+\file		PlatformWorld.h
+\author 	DigiPen
+\par    	email: digipen\@digipen.edu
+\date   	February 01, 20xx
+\brief
+Headless platformer simulation. Owns the binary map and every game object
+instance and advances them with Step(). It has no graphics or input
+dependency: GameState_Platform.cpp samples the keyboard into an InputFrame
+and draws whatever the world exposes.
+
+Copyright (C) 20xx DigiPen Institute of Technology.
+Reproduction or disclosure of this file or its contents without the
+prior written consent of DigiPen Institute of Technology is prohibited.
+ */
+/******************************************************************************/
+
+#ifndef PLATFORM_WORLD_H
+#define PLATFORM_WORLD_H
+
+#include "PlatformTypes.h"
+#include "EntityTable.h"
+#include "TileMap.h"
+#include "ChunkStreamer.h"
+#include "LevelFile.h"
+#include "RenderQueue.h"
+#include "ViewCulling.h"
+#include "JobSystem.h"
+#include "CommandBuffer.h"
+#include "PathService.h"
+#include "InputLog.h"
+#include "WorldSnapshot.h"
+#include "LevelArena.h"
+#include <map>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+/******************************************************************************/
+/*!
+	Defines
+*/
+/******************************************************************************/
+const unsigned int	ENTITY_TABLE_NUM		= TYPE_OBJECT_COIN + 1;	//One table per TYPE_OBJECT
+
+//Streamed levels, in chunks per side. Entities are simulated in the
+//CHUNK_ACTIVE chunks around the hero; the map window is wider so every
+//active entity has a chunk of real cells around it, and the chunks one
+//ring farther out are loaded ahead.
+const int			CHUNK_ACTIVE			= 3;
+const int			CHUNK_WINDOW			= CHUNK_ACTIVE + 2;
+const int			CHUNK_PREFETCH_RADIUS	= CHUNK_WINDOW / 2 + 1;
+
+const size_t		FRAME_SCRATCH_BLOCK_SIZE	= 256 << 10;	//Block of the per step scratch arena
+
+/******************************************************************************/
+/*!
+	Struct/Class Definitions
+*/
+/******************************************************************************/
+class SpatialHash;
+
+//Everything the simulation needs to know about the player's input for one step
+struct InputFrame
+{
+	bool			moveLeft;
+	bool			moveRight;
+	bool			jump;
+};
+
+//Memory of the loaded level, see PlatformWorld::GetLevelMemoryStats
+struct LevelMemoryStats
+{
+	size_t			arenaBytes;			// level arena, in use
+	size_t			arenaPeakBytes;		// level arena, most in use since the load
+	size_t			arenaReservedBytes;	// level arena, held, kept across loads
+	unsigned int	arenaHeapAllocations;	// blocks the level arena ever took from the heap
+	size_t			scratchPeakBytes;	// most per step scratch in use at once
+	size_t			entityBytes;		// GetEntityMemoryBytes
+	size_t			mapBytes;			// tile map, in the arena or the mapped level file
+};
+
+//What the caller has to do after a step
+enum STEP_RESULT
+{
+	STEP_RESULT_CONTINUE,
+	STEP_RESULT_RESTART			//The hero ran out of lives
+};
+
+class PlatformWorld
+{
+public:
+	PlatformWorld();
+	~PlatformWorld();
+
+	//Level lifetime (matches GameStatePlatformLoad/Unload). Takes either the
+	//exported text format or a binary level file (see LevelFile.h), which is
+	//memory mapped and used in place. Returns 0 for a missing or malformed
+	//file. Whatever the level holds with level lifetime comes from one
+	//arena, which FreeMapData resets at once and keeps for the next level.
+	int					ImportMapDataFromFile(const char *FileName);
+	void				FreeMapData(void);
+	LevelMemoryStats	GetLevelMemoryStats(void) const;
+
+	//Streamed levels: only the chunks around the hero are kept, loaded on a
+	//background thread as the hero moves. The world takes ownership of
+	//"pSource". Returns 0 if the level can't be opened.
+	int					StreamMapFromFile(const char *FileName);
+	int					OpenStreamedMap(ChunkSource *pSource);
+	bool				IsStreamed(void) const		{ return Streamer.IsOpen(); }
+	//A chunk of the streamed level couldn't be read, or held an unknown
+	//type. It was loaded empty, the level is corrupt.
+	bool				HasStreamingFailed(void) const	{ return Streamer.GetFailedCount() != 0; }
+	//Cells [X0, X1) x [Y0, Y1) currently in memory, the whole level unless
+	//it is streamed
+	void				GetResidentBounds(int *pX0, int *pY0, int *pX1, int *pY1) const;
+
+	//Instance lifetime (matches GameStatePlatformInit/Free)
+	void				Init(void);
+	void				Free(void);
+
+	//Advances the simulation by "dt" seconds
+	STEP_RESULT			Step(float dt, const InputFrame& input);
+
+	//Snapshots of everything Step depends on, see WorldSnapshot.h. Level
+	//cells edited with SetCell are saved as a delta against the loaded
+	//level. Streamed levels keep part of their state in the streamer and
+	//can't be saved. Restore fails for a snapshot of another load of the
+	//level; a malformed one leaves the world to be Free'd.
+	bool				SaveSnapshot(WorldSnapshot* pSnapshot) const;
+	bool				RestoreSnapshot(const WorldSnapshot& snapshot);
+	//Puts the level back how Init left it, by restoring the snapshot Init
+	//took. Free then Init for a streamed level.
+	void				Restart(void);
+
+	//Debug mode: every Step also runs the original multi pass update on a
+	//copy of the tables and counts the steps whose results differ by a bit
+	void				SetPipelineVerify(bool enable);
+	unsigned int		GetPipelineMismatchCount(void) const	{ return PipelineMismatches; }
+
+	//Session recording, see InputLog.h. While a log is set every Step
+	//appends its input and dt to it, and the HashState after the step on
+	//the ticks the log keeps hashes for. nullptr stops recording.
+	void				SetInputRecorder(InputLog* pLog)	{ Recorder = pLog; }
+	//Plays a recorded session back, as fast as Step runs, on a world that
+	//has loaded the log's level and been Init'ed. The world Restarts when
+	//the hero runs out of lives, as the game does.
+	//Stops after the first hashed tick whose state differs from the
+	//recording and returns it, INPUT_LOG_NO_TICK if every hashed tick
+	//matched or the log has no hashes.
+	unsigned int		Replay(const InputLog& log, unsigned int* pTicksRun = nullptr);
+	//Hash of every instance's state and the hero's lives, see EntityTable::Hash
+	uint64_t			HashState(void) const;
+
+	//Threads besides the caller's that share the per entity stages and the
+	//object collision narrow phase, 0 (the default) runs Step on the calling
+	//thread only. Results are identical at any count.
+	void				SetWorkerCount(unsigned int count);
+	unsigned int		GetWorkerCount(void) const			{ return Jobs.GetWorkerCount(); }
+
+	//Advances the simulation by a rendered frame's time. In fixed timestep
+	//mode this runs as many FixedStep ticks as the accumulator holds,
+	//otherwise it is a single variable Step
+	STEP_RESULT			Advance(float frameTime, const InputFrame& input);
+	void				SetFixedTimestep(float fixedStep, unsigned int maxSubsteps = FIXED_SUBSTEPS_MAX);
+	float				GetFixedTimestep(void) const		{ return FixedStep; }
+	unsigned int		GetLastSubstepCount(void) const		{ return LastSubstepCount; }
+	//How far between posPrev (0) and posCurr (1) the rendered frame is
+	float				GetInterpolationAlpha(void) const	{ return InterpolationAlpha; }
+	SimVec2				GetInterpolatedPosition(const EntityTable& table, unsigned int row) const;
+	//False if the handle's instance has been destroyed since
+	bool				GetInterpolatedPosition(GameObjHandle handle, SimVec2* pPos) const;
+
+	//Grid collision: by default an instance is tested at 8 hot spots where
+	//it ends up and snapped to the cell center on the sides that hit, which
+	//misses walls a fast instance moves through in one step. Swept, its box
+	//is moved along the step's motion and stopped at the first face it
+	//meets (see GridSweep.h), at any scale and step length.
+	void				SetSweptCollision(bool enable)		{ SweptCollision = enable; }
+	bool				IsSweptCollision(void) const		{ return SweptCollision; }
+
+	//Binary map queries. The whole collision map is also exposed as a padded
+	//grid for the batch query in SimKernels.h
+	int					GetCellValue(int X, int Y) const	{ return Map.GetCollision(X, Y); }
+	int					CheckInstanceBinaryMapCollision(float PosX, float PosY,
+														float scaleX, float scaleY) const;
+	int					GetMapWidth(void) const		{ return IsStreamed() ? Streamer.GetLevelWidth() : Map.GetWidth(); }
+	int					GetMapHeight(void) const	{ return IsStreamed() ? Streamer.GetLevelHeight() : Map.GetHeight(); }
+	const CollisionGrid&	GetCollisionGrid(void) const	{ return Map.GetCollisionGrid(); }
+	const TileMap&		GetTileMap(void) const		{ return Map; }
+	//Changes every time the map is loaded, freed or edited, so whatever is
+	//built from its cells knows when to rebuild
+	unsigned int		GetMapRevision(void) const	{ return MapRevision; }
+	//Changes one cell of a level loaded from a text file. Binary levels are
+	//read only and streamed ones reload their cells, both return false, as
+	//does a type outside TYPE_OBJECT_EMPTY..TYPE_OBJECT_COIN.
+	bool				SetCell(int X, int Y, unsigned char type);
+
+	//Paths between the ground under two level cells, see PathService.h. A
+	//request is answered at the start of the next Step, along with the
+	//ones of the enemies chasing the hero.
+	PathTicket			RequestPath(int fromX, int fromY, int toX, int toY)	{ return Paths.Request(fromX, fromY, toX, toY); }
+	//Builds the navigation graph in Init instead of in the Step that first
+	//answers a request, seconds on the largest levels. On by default: any
+	//enemy may chase, and the first chase shouldn't stall a step.
+	void				SetBuildPathsOnLoad(bool enable)	{ BuildPathsOnLoad = enable; }
+	PATH_STATUS			GetPath(PathTicket ticket, const NavPath** ppPath) const	{ return Paths.GetPath(ticket, ppPath); }
+	const NavGraph&		GetNavGraph(void) const		{ return Paths.GetGraph(); }
+
+	//Instances, one table per object type. Only TYPE_OBJECT_HERO,
+	//TYPE_OBJECT_ENEMY1 and TYPE_OBJECT_COIN ever hold rows. Tables grow
+	//with the level, Init reserves the level's spawn count up front; the
+	//soft cap only counts the rows added past it (EntityTable::GetStats).
+	const EntityTable&	GetTable(unsigned int type) const	{ return sGameObjTables[type]; }
+	unsigned int		GetLiveCount(void) const;
+	void				SetEntitySoftCap(unsigned int rows);
+	size_t				GetEntityMemoryBytes(void) const;
+	GameObjHandle		GetHeroHandle(void) const	{ return hHero; }
+	int					GetHeroLives(void) const	{ return HeroLives; }
+
+	//One record per visible instance the culler keeps, at its interpolated
+	//position, with the TYPE_OBJECT as the mesh id
+	void				EmitDrawRecords(RenderQueue *pQueue, ViewCuller *pCuller) const;
+
+private:
+	// function to create/destroy a game object instance
+	GameObjHandle		gameObjInstCreate (unsigned int type, float scale,
+											const SimVec2* pPos, const SimVec2* pVel,
+											float dir, enum STATE startState);
+	void				gameObjInstDestroy(GameObjHandle handle);
+	void				ReserveSpawns(const unsigned int spawnCount[ENTITY_TABLE_NUM]);
+
+	//Step pipeline, see SimPipeline.h for what each stage reads and writes
+	STEP_RESULT			StepFused(float dt, const InputFrame& input);
+	STEP_RESULT			StepMultiPass(float dt, const InputFrame& input);
+	STEP_RESULT			StepVerified(float dt, const InputFrame& input);
+	void				ApplyInput(const InputFrame& input, unsigned int hero);
+	void				UpdateEntities(EntityTable& t, float dt);
+	void				UpdateEntityBlock(EntityTable& t, unsigned int begin, unsigned int end, float dt);
+	void				UpdateEntityGrid(EntityTable& t, unsigned int i, int gridFlag) const;
+	void				SweepEntityGrid(EntityTable& t, unsigned int i) const;
+	void				FindBroadPhaseMoves(const EntityTable& t, unsigned int begin, unsigned int end, float dt);
+	void				RemoveRow(EntityTable& t, unsigned int row);
+	void				ResolveObjectCollisions(float dt, unsigned int hero);
+	STEP_RESULT			ResolveObjectCollisionsAll(float dt, unsigned int hero, bool* pHeroMoved);
+
+	//Deferred commands, see CommandBuffer.h. The buffer of the calling
+	//thread, safe to record into from any job
+	CommandBuffer&		GetCommandBuffer(void)	{ return Commands[Jobs.GetThreadIndex()]; }
+	STEP_RESULT			ApplyCommands(void);
+
+	//State machine functions. The fused step runs the table driven version
+	//in EnemyAI.h, this one is the multi pass reference
+	void				EnemyStateMachine(EntityTable& enemies, unsigned int row, float dt);
+	//Where the hero is, then the waypoint of every enemy entering
+	//STATE_CHASE, with every pending path request answered in between
+	void				PlanChases(void);
+	void				StopChase(EntityTable& enemies, unsigned int row);
+	void				StopChases(void);
+
+	//Streaming, see StreamMapFromFile
+	void				UpdateStreaming(void);
+	void				MoveWindow(int chunkX, int chunkY);
+	void				ActivateChunk(int chunkX, int chunkY);
+	void				DeactivateOutside(int activeX, int activeY);
+
+	PlatformWorld(const PlatformWorld&) = delete;
+	PlatformWorld& operator=(const PlatformWorld&) = delete;
+
+	int					HeroLives;
+	int					Hero_Initial_X;
+	int					Hero_Initial_Y;
+	int					TotalCoins;
+
+	// object instances, one structure of arrays table per type
+	EntityTable			sGameObjTables[ENTITY_TABLE_NUM];
+
+	//Level lifetime allocations, reset by FreeMapData
+	LevelArena			Arena;
+
+	//Map data: cell types and the binary collision map. For a streamed
+	//level, a CHUNK_WINDOW chunks wide window of it
+	TileMap				Map;
+	//Mapped binary level the map is attached to, with its spawn table
+	LevelFile			Level;
+	unsigned int		MapRevision;
+	PathService			Paths;
+	bool				BuildPathsOnLoad;
+
+	//Cells SetCell changed since the level was loaded (y * width + x), with
+	//the type they were loaded with
+	std::map<unsigned int, unsigned char>	EditedCells;
+	unsigned int		LoadSerial;			// bumped by every load and free of the map
+	WorldSnapshot		InitSnapshot;
+
+	//An enemy or coin whose chunk left the active area
+	struct DormantEntity
+	{
+		unsigned int	type;
+		float			posX, posY;
+		float			velX, velY;
+		float			scale;
+		float			dirCurr;
+		unsigned int	flag;
+		int				state;
+		int				innerState;
+		double			counter;
+	};
+
+	struct ChunkRecord
+	{
+		bool						spawned;	// the chunk's enemies and coins have been created
+		std::vector<DormantEntity>	dormant;
+	};
+
+	//Streamed level state
+	ChunkStreamer		Streamer;
+	std::unordered_map<long long, ChunkRecord>	ChunkRecords;	// chunks visited since Init
+	int					WindowChunkX;		// chunk at the window's min corner
+	int					WindowChunkY;
+	bool				WindowValid;
+
+	//We need a handle to the hero's instance for input purposes
+	GameObjHandle		hHero;
+	//Where the hero was at the start of the step, what enemies chase. Both
+	//pipelines read it, the fused one moves the hero before the enemies.
+	bool				HasChaseTarget;
+	SimVec2				ChaseTarget;
+
+	//Fixed timestep state, FixedStep == 0 means variable timestep
+	float				FixedStep;
+	unsigned int		MaxSubsteps;
+	float				Accumulator;
+	float				InterpolationAlpha;
+	unsigned int		LastSubstepCount;
+
+	bool				SweptCollision;
+
+	//Rewound at the end of every Step. Holds the lists that only live for
+	//one: the hero's contacts and the rows the commands destroy.
+	LevelArena			FrameScratch;
+
+	//Object collision broad phase: every enemy and coin tracked by row from
+	//step to step (SpatialHash.h). The block pass lists the rows whose swept
+	//box changed cells, per job thread, and they are moved once their table
+	//is done.
+	struct ObjectContact
+	{
+		unsigned int	type;
+		unsigned int	row;
+	};
+	std::unique_ptr<SpatialHash>	Broad;
+	std::vector<std::vector<unsigned int>>	BroadMoves;		// one per job system thread
+	std::vector<unsigned int>	BroadFound;		// keys around the hero
+
+	JobSystem			Jobs;
+	std::vector<CommandBuffer>	Commands;		// one per job system thread
+	std::vector<WorldCommand>	SortedCommands;
+
+	InputLog			*Recorder;
+
+	//Pipeline verification
+	bool				PipelineVerify;
+	unsigned int		PipelineMismatches;
+	EntityTable			sVerifyTables[ENTITY_TABLE_NUM];
+};
+
+void					SnapToCell(float *Coordinate);
+
+#endif // PLATFORM_WORLD_H
@@ -0,0 +1,108 @@
+/******************************************************************************/
+/*!
+\file		ProcessMemory.cpp
+\author 	DigiPen
+\par    	email: digipen\@digipen.edu
+\date   	February 01, 20xx
+\brief
+Resident memory of the process. See ProcessMemory.h.
+
+Copyright (C) 20xx DigiPen Institute of Technology.
+Reproduction or disclosure of this file or its contents without the
+prior written consent of DigiPen Institute of Technology is prohibited.
+ */
+/******************************************************************************/
+
+#include "ProcessMemory.h"
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#include <psapi.h>
+#else
+#include <cstdio>
+#include <sys/resource.h>
+#include <unistd.h>
+#endif
+
+/******************************************************************************/
+/*!
+
+*/
+/******************************************************************************/
+size_t GetResidentBytes(void)
+{
+#ifdef _WIN32
+	PROCESS_MEMORY_COUNTERS counters;
+	if (!GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters)))
+		return 0;
+	return counters.WorkingSetSize;
+#else
+	//the second field of statm is the resident page count
+	unsigned long pages = 0, resident = 0;
+	FILE *file = fopen("/proc/self/statm", "r");
+	if (!file)
+		return 0;
+	if (fscanf(file, "%lu %lu", &pages, &resident) != 2)
+		resident = 0;
+	fclose(file);
+	return (size_t)resident * (size_t)sysconf(_SC_PAGESIZE);
+#endif
+}
+
+/******************************************************************************/
+/*!
+
+*/
+/******************************************************************************/
+size_t GetPeakResidentBytes(void)
+{
+#ifdef _WIN32
+	PROCESS_MEMORY_COUNTERS counters;
+	if (!GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters)))
+		return 0;
+	return counters.PeakWorkingSetSize;
+#else
+#ifdef __linux__
+	//VmHWM follows ResetPeakResidentBytes, ru_maxrss doesn't
+	char line[128];
+	size_t kiB = 0;
+	FILE *file = fopen("/proc/self/status", "r");
+	if (file) {
+		while (fgets(line, sizeof(line), file))
+			if (sscanf(line, "VmHWM: %zu kB", &kiB) == 1)
+				break;
+		fclose(file);
+	}
+	if (kiB)
+		return kiB * 1024;
+#endif
+	struct rusage usage;
+	if (getrusage(RUSAGE_SELF, &usage) != 0)
+		return 0;
+#ifdef __APPLE__
+	return (size_t)usage.ru_maxrss;				// bytes
+#else
+	return (size_t)usage.ru_maxrss * 1024;		// KiB
+#endif
+#endif
+}
+
+/******************************************************************************/
+/*!
+	Writing 5 to clear_refs sets the high water mark to the resident size
+*/
+/******************************************************************************/
+bool ResetPeakResidentBytes(void)
+{
+#ifdef __linux__
+	FILE *file = fopen("/proc/self/clear_refs", "w");
+	if (!file)
+		return false;
+	bool reset = fputs("5", file) >= 0;
+	return fclose(file) == 0 && reset;
+#else
+	return false;
+#endif
+}
@@ -0,0 +1,30 @@
+/******************************************************************************/
+/*!
+\file		ProcessMemory.h
+\author 	DigiPen
+\par    	email: digipen\@digipen.edu
+\date   	February 01, 20xx
+\brief
+Resident memory of the whole process, as the OS reports it. The peak never
+goes down by itself, so it only tells about one workload when that
+workload is the largest run so far, or when the peak could be reset to
+the current resident size before it (Linux only).
+
+Copyright (C) 20xx DigiPen Institute of Technology.
+Reproduction or disclosure of this file or its contents without the
+prior written consent of DigiPen Institute of Technology is prohibited.
+ */
+/******************************************************************************/
+
+#ifndef PROCESS_MEMORY_H
+#define PROCESS_MEMORY_H
+
+#include <cstddef>
+
+//Bytes, 0 where the OS doesn't tell
+size_t					GetResidentBytes(void);
+size_t					GetPeakResidentBytes(void);
+//False where the OS can't, the peak then still covers the whole run
+bool					ResetPeakResidentBytes(void);
+
+#endif // PROCESS_MEMORY_H
@@ -0,0 +1,339 @@
+/******************************************************************************/
+/*!
+\file		Profiler.cpp
+\author 	DigiPen
+\par    	email: digipen\@digipen.edu
+\date   	February 01, 20xx
+\brief
+Frame profiler. See Profiler.h.
+
+Copyright (C) 20xx DigiPen Institute of Technology.
+Reproduction or disclosure of this file or its contents without the
+prior written consent of DigiPen Institute of Technology is prohibited.
+ */
+/******************************************************************************/
+
+#include "Profiler.h"
+
+#if SS_PROFILE
+
+#include <algorithm>
+#include <cstring>
+
+thread_local bool Profiler::sProfiledThread = false;
+
+/******************************************************************************/
+/*!
+
+*/
+/******************************************************************************/
+Profiler& Profiler::Instance(void)
+{
+	static Profiler sProfiler;
+	return sProfiler;
+}
+
+/******************************************************************************/
+/*!
+
+*/
+/******************************************************************************/
+Profiler::Profiler() :
+	Depth{ 0 }, FrameStart{ 0 }, FrameZone{ PROFILE_NO_ID }, Frames{ 0 }, TraceCount{ 0 }
+{
+	ZoneNames.reserve(PROFILE_MAX_ZONES);
+	CounterNames.reserve(PROFILE_MAX_COUNTERS);
+	ZoneHistory.assign(PROFILE_HISTORY * PROFILE_MAX_ZONES, 0.0);
+	CounterHistory.assign(PROFILE_HISTORY * PROFILE_MAX_COUNTERS, 0.0);
+	FrameStarts.assign(PROFILE_HISTORY, 0);
+	Trace.resize(PROFILE_TRACE_EVENTS);
+	memset(ZoneFrame, 0, sizeof(ZoneFrame));
+	memset(CounterFrame, 0, sizeof(CounterFrame));
+
+	FrameZone = RegisterZone("frame");
+}
+
+/******************************************************************************/
+/*!
+
+*/
+/******************************************************************************/
+unsigned int Profiler::Find(const std::vector<const char *>& names, const char *name) const
+{
+	for (unsigned int i = 0; i < names.size(); ++i)
+		if (strcmp(names[i], name) == 0)
+			return i;
+	return PROFILE_NO_ID;
+}
+
+/******************************************************************************/
+/*!
+	Called once per PROFILE_ZONE, the first time it runs. "name" has to
+	outlive the profiler, a string literal.
+*/
+/******************************************************************************/
+unsigned int Profiler::RegisterZone(const char *name)
+{
+	std::lock_guard<std::mutex> lock(NamesLock);
+	unsigned int zone = Find(ZoneNames, name);
+	if (zone == PROFILE_NO_ID && ZoneNames.size() < PROFILE_MAX_ZONES) {
+		zone = (unsigned int)ZoneNames.size();
+		ZoneNames.push_back(name);
+	}
+	return zone;
+}
+
+/******************************************************************************/
+/*!
+
+*/
+/******************************************************************************/
+unsigned int Profiler::RegisterCounter(const char *name)
+{
+	std::lock_guard<std::mutex> lock(NamesLock);
+	unsigned int counter = Find(CounterNames, name);
+	if (counter == PROFILE_NO_ID && CounterNames.size() < PROFILE_MAX_COUNTERS) {
+		counter = (unsigned int)CounterNames.size();
+		CounterNames.push_back(name);
+	}
+	return counter;
+}
+
+/******************************************************************************/
+/*!
+	Zones still open from a frame that never ended are dropped
+*/
+/******************************************************************************/
+void Profiler::BeginFrame(void)
+{
+	sProfiledThread = true;
+	Depth = 0;
+	memset(ZoneFrame, 0, sizeof(ZoneFrame));
+	memset(CounterFrame, 0, sizeof(CounterFrame));
+
+	FrameStart = Now();
+	BeginZone(FrameZone);
+}
+
+/******************************************************************************/
+/*!
+	Closes whatever is still open, down to the frame zone, and moves the
+	frame's totals into the history
+*/
+/******************************************************************************/
+void Profiler::EndFrame(void)
+{
+	if (!sProfiledThread)
+		return;
+	while (Depth)
+		EndZone();
+
+	unsigned int slot = Frames % PROFILE_HISTORY;
+	for (unsigned int z = 0; z < PROFILE_MAX_ZONES; ++z)
+		ZoneHistory[slot * PROFILE_MAX_ZONES + z] = (double)ZoneFrame[z] / 1000000.0;
+	for (unsigned int c = 0; c < PROFILE_MAX_COUNTERS; ++c)
+		CounterHistory[slot * PROFILE_MAX_COUNTERS + c] = CounterFrame[c];
+	FrameStarts[slot] = FrameStart;
+	++Frames;
+}
+
+/******************************************************************************/
+/*!
+
+*/
+/******************************************************************************/
+void Profiler::Close(unsigned int zone, uint64_t start, uint64_t end)
+{
+	ZoneFrame[zone] += end - start;
+
+	TraceEvent& event = Trace[TraceCount % PROFILE_TRACE_EVENTS];
+	event.zone		= zone;
+	event.depth		= Depth;
+	event.start		= start;
+	event.duration	= end - start;
+	++TraceCount;
+}
+
+/******************************************************************************/
+/*!
+	Counters are only taken from the thread that runs the frame
+*/
+/******************************************************************************/
+void Profiler::SetCounter(unsigned int counter, double value)
+{
+	if (sProfiledThread && counter != PROFILE_NO_ID)
+		CounterFrame[counter] = value;
+}
+
+/******************************************************************************/
+/*!
+
+*/
+/******************************************************************************/
+void Profiler::AddCounter(unsigned int counter, double value)
+{
+	if (sProfiledThread && counter != PROFILE_NO_ID)
+		CounterFrame[counter] += value;
+}
+
+/******************************************************************************/
+/*!
+	Column "column" of the "stride" wide rows of "history", over the frames
+	kept
+*/
+/******************************************************************************/
+void Profiler::Stats(const std::vector<double>& history, unsigned int stride, unsigned int column,
+					 ProfileStats* pStats) const
+{
+	double sorted[PROFILE_HISTORY];
+	unsigned int frames = std::min(Frames, PROFILE_HISTORY);
+
+	for (unsigned int f = 0; f < frames; ++f)
+		sorted[f] = history[f * stride + column];
+	pStats->last	= history[((Frames - 1) % PROFILE_HISTORY) * stride + column];
+	std::sort(sorted, sorted + frames);
+
+	pStats->frames	= frames;
+	pStats->p50		= sorted[(frames - 1) / 2];
+	pStats->p99		= sorted[(frames - 1) * 99 / 100];
+	pStats->max		= sorted[frames - 1];
+}
+
+/******************************************************************************/
+/*!
+
+*/
+/******************************************************************************/
+bool Profiler::GetZoneStats(const char *name, ProfileStats* pStats) const
+{
+	unsigned int zone = Find(ZoneNames, name);
+	if (zone == PROFILE_NO_ID || Frames == 0)
+		return false;
+	Stats(ZoneHistory, PROFILE_MAX_ZONES, zone, pStats);
+	return true;
+}
+
+/******************************************************************************/
+/*!
+
+*/
+/******************************************************************************/
+bool Profiler::GetCounterStats(const char *name, ProfileStats* pStats) const
+{
+	unsigned int counter = Find(CounterNames, name);
+	if (counter == PROFILE_NO_ID || Frames == 0)
+		return false;
+	Stats(CounterHistory, PROFILE_MAX_COUNTERS, counter, pStats);
+	return true;
+}
+
+/******************************************************************************/
+/*!
+
+*/
+/******************************************************************************/
+bool Profiler::GetZoneLast(const char *name, double* pMs) const
+{
+	unsigned int zone = Find(ZoneNames, name);
+	if (zone == PROFILE_NO_ID || Frames == 0)
+		return false;
+	*pMs = ZoneHistory[((Frames - 1) % PROFILE_HISTORY) * PROFILE_MAX_ZONES + zone];
+	return true;
+}
+
+/******************************************************************************/
+/*!
+
+*/
+/******************************************************************************/
+void Profiler::Report(FILE *file) const
+{
+	ProfileStats stats;
+	if (Frames == 0)
+		return;
+
+	fprintf(file, "zone\tlast_ms\tp50_ms\tp99_ms\tmax_ms\n");
+	for (unsigned int z = 0; z < ZoneNames.size(); ++z)
+	{
+		Stats(ZoneHistory, PROFILE_MAX_ZONES, z, &stats);
+		fprintf(file, "%s\t%.3f\t%.3f\t%.3f\t%.3f\n", ZoneNames[z], stats.last, stats.p50, stats.p99, stats.max);
+	}
+	fprintf(file, "counter\tlast\tp50\tp99\tmax\n");
+	for (unsigned int c = 0; c < CounterNames.size(); ++c)
+	{
+		Stats(CounterHistory, PROFILE_MAX_COUNTERS, c, &stats);
+		fprintf(file, "%s\t%.0f\t%.0f\t%.0f\t%.0f\n", CounterNames[c], stats.last, stats.p50, stats.p99, stats.max);
+	}
+}
+
+/******************************************************************************/
+/*!
+	Chrome trace event format: a complete ("X") event per zone kept and a
+	counter ("C") event per counter per frame kept, times in us from the
+	oldest event. Zone and counter names are written as they are, they are
+	literals in the code and have nothing to escape.
+*/
+/******************************************************************************/
+bool Profiler::WriteChromeTrace(const char *FileName) const
+{
+	FILE *file = fopen(FileName, "w");
+	if (!file)
+		return false;
+
+	size_t events = std::min(TraceCount, (size_t)PROFILE_TRACE_EVENTS);
+	size_t first = TraceCount - events;
+	unsigned int frames = std::min(Frames, PROFILE_HISTORY);
+	unsigned int firstFrame = Frames - frames;
+
+	uint64_t origin = UINT64_MAX;
+	if (events)
+		origin = Trace[first % PROFILE_TRACE_EVENTS].start;
+	for (size_t e = first; e < TraceCount; ++e)
+		origin = std::min(origin, Trace[e % PROFILE_TRACE_EVENTS].start);
+	if (frames)
+		origin = std::min(origin, FrameStarts[firstFrame % PROFILE_HISTORY]);
+
+	const char *separator = "";
+	fprintf(file, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n");
+	for (size_t e = first; e < TraceCount; ++e)
+	{
+		const TraceEvent& event = Trace[e % PROFILE_TRACE_EVENTS];
+		fprintf(file, "%s{\"name\":\"%s\",\"ph\":\"X\",\"pid\":1,\"tid\":1,\"ts\":%.3f,\"dur\":%.3f,\"args\":{\"depth\":%u}}",
+				separator, ZoneNames[event.zone], (double)(event.start - origin) / 1000.0,
+				(double)event.duration / 1000.0, event.depth);
+		separator = ",\n";
+	}
+	for (unsigned int f = firstFrame; f < Frames; ++f)
+	{
+		unsigned int slot = f % PROFILE_HISTORY;
+		if (FrameStarts[slot] < origin)
+			continue;
+		for (unsigned int c = 0; c < CounterNames.size(); ++c)
+		{
+			fprintf(file, "%s{\"name\":\"%s\",\"ph\":\"C\",\"pid\":1,\"tid\":1,\"ts\":%.3f,\"args\":{\"value\":%.17g}}",
+					separator, CounterNames[c], (double)(FrameStarts[slot] - origin) / 1000.0,
+					CounterHistory[slot * PROFILE_MAX_COUNTERS + c]);
+			separator = ",\n";
+		}
+	}
+	fprintf(file, "\n]}\n");
+
+	bool written = !ferror(file);
+	return fclose(file) == 0 && written;
+}
+
+/******************************************************************************/
+/*!
+
+*/
+/******************************************************************************/
+void Profiler::Reset(void)
+{
+	Frames = 0;
+	TraceCount = 0;
+	Depth = 0;
+	memset(ZoneFrame, 0, sizeof(ZoneFrame));
+	memset(CounterFrame, 0, sizeof(CounterFrame));
+}
+
+#endif // SS_PROFILE
@@ -0,0 +1,211 @@
+/******************************************************************************/
+/*!
+\file		Profiler.h
+\author 	DigiPen
+\par    	email: digipen\@digipen.edu
+\date   	February 01, 20xx
+\brief
+Frame profiler. PROFILE_ZONE("name") times the rest of the enclosing scope
+and PROFILE_COUNTER_SET/ADD("name", value) set or add to a counter of the
+current frame. The frame runs from PROFILE_FRAME_BEGIN to
+PROFILE_FRAME_END.
+
+Only the thread that began the frame is timed. Zones on job worker
+threads are skipped, the zone around the ParallelFor that started them
+covers them. Every zone keeps the total of each of the last
+PROFILE_HISTORY frames, and so does every counter, for p50/p99/max stats.
+The last PROFILE_TRACE_EVENTS zones are kept one by one, for
+WriteChromeTrace (load the file in chrome://tracing or Perfetto) when a
+frame spiked.
+
+Timing reads std::chrono::steady_clock, a few tens of ns per zone.
+Building with SS_PROFILE defined to 0 compiles every macro to nothing and
+Profiler.cpp to an empty file.
+
+Copyright (C) 20xx DigiPen Institute of Technology.
+Reproduction or disclosure of this file or its contents without the
+prior written consent of DigiPen Institute of Technology is prohibited.
+ */
+/******************************************************************************/
+
+#ifndef PROFILER_H
+#define PROFILER_H
+
+#ifndef SS_PROFILE
+#define SS_PROFILE 1
+#endif
+
+#if SS_PROFILE
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <mutex>
+#include <vector>
+
+/******************************************************************************/
+/*!
+	Defines
+*/
+/******************************************************************************/
+const unsigned int	PROFILE_HISTORY			= 256;		//Frames of stats kept
+const unsigned int	PROFILE_MAX_ZONES		= 64;
+const unsigned int	PROFILE_MAX_COUNTERS	= 32;
+const unsigned int	PROFILE_MAX_DEPTH		= 32;		//Zones open at once
+const unsigned int	PROFILE_TRACE_EVENTS	= 1 << 16;	//Zones kept for the trace
+const unsigned int	PROFILE_NO_ID			= 0xFFFFFFFF;
+
+/******************************************************************************/
+/*!
+	Struct/Class Definitions
+*/
+/******************************************************************************/
+
+//Over the frames in the history: ms for a zone, the value for a counter
+struct ProfileStats
+{
+	double			last;
+	double			p50;
+	double			p99;
+	double			max;
+	unsigned int	frames;
+};
+
+class Profiler
+{
+public:
+	static Profiler&	Instance(void);
+
+	//Ids of a name, the same one for every call with that name. Returns
+	//PROFILE_NO_ID once all are taken, the zone or counter is then ignored.
+	unsigned int		RegisterZone(const char *name);
+	unsigned int		RegisterCounter(const char *name);
+
+	//The calling thread becomes the one timed
+	void				BeginFrame(void);
+	void				EndFrame(void);
+
+	void				BeginZone(unsigned int zone)
+	{
+		if (!sProfiledThread || Depth >= PROFILE_MAX_DEPTH || zone == PROFILE_NO_ID)
+			return;
+		Open[Depth].zone = zone;
+		Open[Depth].start = Now();
+		++Depth;
+	}
+	void				EndZone(void)
+	{
+		if (!sProfiledThread || Depth == 0)
+			return;
+		--Depth;
+		Close(Open[Depth].zone, Open[Depth].start, Now());
+	}
+
+	void				SetCounter(unsigned int counter, double value);
+	void				AddCounter(unsigned int counter, double value);
+
+	//False for a name never registered or no frame ended yet
+	bool				GetZoneStats(const char *name, ProfileStats* pStats) const;
+	bool				GetCounterStats(const char *name, ProfileStats* pStats) const;
+	//Just the last frame's ms, without sorting the history
+	bool				GetZoneLast(const char *name, double* pMs) const;
+	//One line per zone then per counter: name, last, p50, p99, max
+	void				Report(FILE *file) const;
+	//The zones kept and the counters of the frames in the history
+	bool				WriteChromeTrace(const char *FileName) const;
+	//Drops the history and the trace, keeps the names
+	void				Reset(void);
+
+	unsigned int		GetFrameCount(void) const	{ return Frames; }
+
+private:
+	struct OpenZone
+	{
+		unsigned int	zone;
+		uint64_t		start;
+	};
+
+	struct TraceEvent
+	{
+		unsigned int	zone;
+		unsigned int	depth;
+		uint64_t		start;		// ns
+		uint64_t		duration;	// ns
+	};
+
+	Profiler();
+
+	static uint64_t		Now(void)
+	{
+		return (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(
+			std::chrono::steady_clock::now().time_since_epoch()).count();
+	}
+	void				Close(unsigned int zone, uint64_t start, uint64_t end);
+	void				Stats(const std::vector<double>& history, unsigned int stride, unsigned int column,
+							  ProfileStats* pStats) const;
+	unsigned int		Find(const std::vector<const char *>& names, const char *name) const;
+
+	static thread_local bool	sProfiledThread;
+
+	std::mutex			NamesLock;			// first use of a zone or counter
+
+	std::vector<const char *>	ZoneNames;
+	std::vector<const char *>	CounterNames;
+
+	OpenZone			Open[PROFILE_MAX_DEPTH];
+	unsigned int		Depth;
+	uint64_t			FrameStart;
+	unsigned int		FrameZone;			// the "frame" zone, around everything
+
+	//this frame's totals, then one row of PROFILE_HISTORY per frame
+	uint64_t			ZoneFrame[PROFILE_MAX_ZONES];
+	double				CounterFrame[PROFILE_MAX_COUNTERS];
+	std::vector<double>	ZoneHistory;		// ms, [frame % PROFILE_HISTORY][zone]
+	std::vector<double>	CounterHistory;		// [frame % PROFILE_HISTORY][counter]
+	std::vector<uint64_t>	FrameStarts;	// ns, [frame % PROFILE_HISTORY]
+	unsigned int		Frames;
+
+	std::vector<TraceEvent>	Trace;			// ring of PROFILE_TRACE_EVENTS
+	size_t				TraceCount;			// ever recorded
+};
+
+//Times its scope
+class ProfileScope
+{
+public:
+	explicit ProfileScope(unsigned int zone)	{ Profiler::Instance().BeginZone(zone); }
+	~ProfileScope()								{ Profiler::Instance().EndZone(); }
+
+	ProfileScope(const ProfileScope&) = delete;
+	ProfileScope& operator=(const ProfileScope&) = delete;
+};
+
+#define PROFILE_JOIN2(a, b)		a##b
+#define PROFILE_JOIN(a, b)		PROFILE_JOIN2(a, b)
+
+#define PROFILE_ZONE(name) \
+	static const unsigned int PROFILE_JOIN(sProfileZone, __LINE__) = Profiler::Instance().RegisterZone(name); \
+	ProfileScope PROFILE_JOIN(profileScope, __LINE__)(PROFILE_JOIN(sProfileZone, __LINE__))
+
+#define PROFILE_COUNTER_SET(name, value) do { \
+	static const unsigned int sProfileCounter = Profiler::Instance().RegisterCounter(name); \
+	Profiler::Instance().SetCounter(sProfileCounter, (double)(value)); } while (0)
+
+#define PROFILE_COUNTER_ADD(name, value) do { \
+	static const unsigned int sProfileCounter = Profiler::Instance().RegisterCounter(name); \
+	Profiler::Instance().AddCounter(sProfileCounter, (double)(value)); } while (0)
+
+#define PROFILE_FRAME_BEGIN()	Profiler::Instance().BeginFrame()
+#define PROFILE_FRAME_END()		Profiler::Instance().EndFrame()
+
+#else
+
+#define PROFILE_ZONE(name)
+#define PROFILE_COUNTER_SET(name, value)	do {} while (0)
+#define PROFILE_COUNTER_ADD(name, value)	do {} while (0)
+#define PROFILE_FRAME_BEGIN()				do {} while (0)
+#define PROFILE_FRAME_END()					do {} while (0)
+
+#endif // SS_PROFILE
+
+#endif // PROFILER_H
@@ -0,0 +1,174 @@
+/******************************************************************************/
+/*!
+\file		RenderQueue.cpp
+\author 	DigiPen
+\par    	email: digipen\@digipen.edu
+\date   	February 01, 20xx
+\brief
+Instance draw queue. See RenderQueue.h.
+
+Copyright (C) 20xx DigiPen Institute of Technology.
+Reproduction or disclosure of this file or its contents without the
+prior written consent of DigiPen Institute of Technology is prohibited.
+ */
+/******************************************************************************/
+
+#include "RenderQueue.h"
+
+static const int		KEY_LAYER_SHIFT		= 56;
+static const int		KEY_TEXTURE_SHIFT	= 40;
+static const int		KEY_MESH_SHIFT		= 24;
+static const unsigned long long	KEY_ORDER_MASK	= RENDER_RECORD_MAX - 1;
+
+/******************************************************************************/
+/*!
+
+*/
+/******************************************************************************/
+void RenderQueue::SetShape(unsigned int mesh, const TileVertex *vertices, unsigned int count)
+{
+	if (mesh >= RENDER_MESH_MAX)
+		return;
+	if (mesh >= Shapes.size())
+		Shapes.resize(mesh + 1);
+	Shapes[mesh].assign(vertices, vertices + count);
+}
+
+/******************************************************************************/
+/*!
+
+*/
+/******************************************************************************/
+void RenderQueue::Clear(void)
+{
+	Keys.clear();
+	Transforms.clear();
+	Batches.clear();
+	Vertices.clear();
+}
+
+/******************************************************************************/
+/*!
+
+*/
+/******************************************************************************/
+void RenderQueue::Submit(unsigned int layer, unsigned int texture, unsigned int mesh,
+						 const SimMtx33& transform)
+{
+	unsigned long long order = Keys.size();
+	if (order >= RENDER_RECORD_MAX)
+		return;
+
+	Keys.push_back(((unsigned long long)(layer & 0xFF) << KEY_LAYER_SHIFT) |
+				   ((unsigned long long)(texture & 0xFFFF) << KEY_TEXTURE_SHIFT) |
+				   ((unsigned long long)(mesh & 0xFFFF) << KEY_MESH_SHIFT) |
+				   order);
+	Transforms.push_back(transform);
+}
+
+/******************************************************************************/
+/*!
+	LSD radix sort, a byte per pass. The keys are submitted with increasing
+	order bits and every pass is stable, so the order bytes never need a
+	pass of their own; a pass whose byte is the same in every key is
+	skipped too, which with a handful of meshes is most of the rest. After
+	the sort the order bits still tell which record each key came from.
+*/
+/******************************************************************************/
+void RenderQueue::SortKeys(void)
+{
+	size_t count = Keys.size();
+	SortScratch.resize(count);
+
+	unsigned long long *pSrc = Keys.data(), *pDst = SortScratch.data();
+	for (int shift = KEY_MESH_SHIFT; shift < 64; shift += 8)
+	{
+		size_t histogram[256] = { 0 };
+		for (size_t i = 0; i < count; ++i)
+			++histogram[(pSrc[i] >> shift) & 0xFF];
+		if (histogram[(pSrc[0] >> shift) & 0xFF] == count)
+			continue;
+
+		size_t offset = 0;
+		for (int b = 0; b < 256; ++b)
+		{
+			size_t n = histogram[b];
+			histogram[b] = offset;
+			offset += n;
+		}
+		for (size_t i = 0; i < count; ++i)
+			pDst[histogram[(pSrc[i] >> shift) & 0xFF]++] = pSrc[i];
+
+		unsigned long long *pTemp = pSrc;
+		pSrc = pDst;
+		pDst = pTemp;
+	}
+
+	if (pSrc != Keys.data())
+		Keys.swap(SortScratch);
+}
+
+/******************************************************************************/
+/*!
+	A batch ends wherever the layer, texture or mesh changes. Its vertices
+	are the mesh's shape once per instance, through the instance's matrix;
+	the camera isn't baked in, the renderer sets it once for all batches.
+*/
+/******************************************************************************/
+void RenderQueue::Build(void)
+{
+	size_t count = Keys.size();
+	Batches.clear();
+	Vertices.clear();
+	if (count == 0)
+		return;
+
+	SortKeys();
+
+	size_t vertexCount = 0;
+	for (size_t i = 0; i < count; ++i)
+	{
+		unsigned long long group = Keys[i] >> KEY_MESH_SHIFT;
+		if (i == 0 || group != (Keys[i - 1] >> KEY_MESH_SHIFT)) {
+			RenderBatch batch;
+			batch.layer			= (unsigned int)(Keys[i] >> KEY_LAYER_SHIFT) & 0xFF;
+			batch.texture		= (unsigned int)(Keys[i] >> KEY_TEXTURE_SHIFT) & 0xFFFF;
+			batch.mesh			= (unsigned int)(Keys[i] >> KEY_MESH_SHIFT) & 0xFFFF;
+			batch.count			= 0;
+			batch.vertexBegin	= (unsigned int)vertexCount;
+			batch.vertexCount	= 0;
+			Batches.push_back(batch);
+		}
+
+		RenderBatch& batch = Batches.back();
+		++batch.count;
+		if (batch.mesh < Shapes.size())
+			batch.vertexCount += (unsigned int)Shapes[batch.mesh].size();
+		vertexCount = batch.vertexBegin + (size_t)batch.vertexCount;
+	}
+
+	Vertices.resize(vertexCount);
+	const unsigned long long *pKey = Keys.data();
+	for (const RenderBatch& batch : Batches)
+	{
+		TileVertex *pOut = Vertices.data() + batch.vertexBegin;
+		if (batch.vertexCount == 0) {
+			pKey += batch.count;
+			continue;
+		}
+
+		const TileVertex *pShape = Shapes[batch.mesh].data();
+		size_t shapeCount = Shapes[batch.mesh].size();
+		for (unsigned int k = 0; k < batch.count; ++k, ++pKey)
+		{
+			const SimMtx33& t = Transforms[*pKey & KEY_ORDER_MASK];
+			for (size_t v = 0; v < shapeCount; ++v, ++pOut)
+			{
+				SimVec2 p = SimMtx33MultPoint(&t, { pShape[v].x, pShape[v].y });
+				pOut->x		= p.x;
+				pOut->y		= p.y;
+				pOut->color	= pShape[v].color;
+			}
+		}
+	}
+}
@@ -0,0 +1,98 @@
+/******************************************************************************/
+/*!
+\file		RenderQueue.h
+\author 	DigiPen
+\par    	email: digipen\@digipen.edu
+\date   	February 01, 20xx
+\brief
+Instance draw queue. The simulation emits one compact record per visible
+instance (layer, texture, mesh and its map space matrix); Build() radix
+sorts them on a 64 bit key and cuts the sorted list into batches that
+share a mesh and a texture. Every batch is baked into one triangle list
+in map coordinates, each instance's copy of its mesh's shape put through
+its matrix, so like a tile chunk it draws with one call under the
+camera's MapTransform instead of a transform and a call per instance.
+
+Key, high to low: layer (8 bits), texture (16), mesh (16), submission
+order (24). The order bits keep the instances of a batch in the order
+they were emitted.
+
+Copyright (C) 20xx DigiPen Institute of Technology.
+Reproduction or disclosure of this file or its contents without the
+prior written consent of DigiPen Institute of Technology is prohibited.
+ */
+/******************************************************************************/
+
+#ifndef RENDER_QUEUE_H
+#define RENDER_QUEUE_H
+
+#include "PlatformTypes.h"
+#include <vector>
+
+/******************************************************************************/
+/*!
+	Defines
+*/
+/******************************************************************************/
+const unsigned int	RENDER_TEXTURE_NONE		= 0;
+const unsigned int	RENDER_RECORD_MAX		= 1u << 24;	//Submission order bits of the key
+const unsigned int	RENDER_MESH_MAX			= 1u << 16;
+
+/******************************************************************************/
+/*!
+	Struct/Class Definitions
+*/
+/******************************************************************************/
+//A triangle list vertex, of the instance batches here and of the tile
+//chunks of TileBatch.h
+struct TileVertex
+{
+	float			x, y;		// level cells
+	unsigned int	color;		// ARGB
+};
+
+struct RenderBatch
+{
+	unsigned int	layer;
+	unsigned int	texture;
+	unsigned int	mesh;
+	unsigned int	count;			// instances
+	unsigned int	vertexBegin;	// first vertex in GetVertices()
+	unsigned int	vertexCount;	// 0 if the mesh has no shape
+};
+
+class RenderQueue
+{
+public:
+	//The triangle list, in the instance's own coordinates, that every
+	//record of "mesh" is drawn with. Kept across Clear.
+	void				SetShape(unsigned int mesh, const TileVertex *vertices, unsigned int count);
+
+	void				Clear(void);
+
+	//Records past RENDER_RECORD_MAX are dropped. Layers draw in increasing
+	//order; "layer" < 256, "texture" and "mesh" < 65536.
+	void				Submit(unsigned int layer, unsigned int texture, unsigned int mesh,
+							   const SimMtx33& transform);
+
+	//Sorts the records, cuts the batches and bakes their vertices
+	void				Build(void);
+
+	unsigned int		GetCount(void) const		{ return (unsigned int)Keys.size(); }
+	//After Build: the batches in drawing order and the vertices they index,
+	//each batch's instances in submission order
+	const std::vector<RenderBatch>&	GetBatches(void) const	{ return Batches; }
+	const TileVertex*	GetVertices(void) const		{ return Vertices.data(); }
+
+private:
+	void				SortKeys(void);
+
+	std::vector<unsigned long long>	Keys;
+	std::vector<SimMtx33>			Transforms;		// submission order
+	std::vector<unsigned long long>	SortScratch;
+	std::vector<RenderBatch>		Batches;
+	std::vector<TileVertex>			Vertices;
+	std::vector<std::vector<TileVertex>>	Shapes;	// by mesh
+};
+
+#endif // RENDER_QUEUE_H
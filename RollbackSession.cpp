@@ -0,0 +1,220 @@
+/******************************************************************************/
+/*!
+\file		RollbackSession.cpp
+\author 	DigiPen
+\par    	email: digipen\@digipen.edu
+\date   	February 01, 20xx
+\brief
+Rollback networking and the loopback link. See RollbackSession.h.
+
+Copyright (C) 20xx DigiPen Institute of Technology.
+Reproduction or disclosure of this file or its contents without the
+prior written consent of DigiPen Institute of Technology is prohibited.
+ */
+/******************************************************************************/
+
+#include "RollbackSession.h"
+
+/******************************************************************************/
+/*!
+
+*/
+/******************************************************************************/
+static bool SameInput(const InputFrame& a, const InputFrame& b)
+{
+	return a.moveLeft == b.moveLeft && a.moveRight == b.moveRight && a.jump == b.jump;
+}
+
+/******************************************************************************/
+/*!
+
+*/
+/******************************************************************************/
+void LoopbackLink::Open(unsigned int latency)
+{
+	Latency = latency;
+	Queues[0].clear();
+	Queues[1].clear();
+}
+
+/******************************************************************************/
+/*!
+
+*/
+/******************************************************************************/
+void LoopbackLink::Send(unsigned int toPeer, const RollbackInput& message, unsigned int now)
+{
+	Queues[toPeer & 1].push_back(Packet{ now + Latency, message });
+}
+
+/******************************************************************************/
+/*!
+
+*/
+/******************************************************************************/
+bool LoopbackLink::Receive(unsigned int peer, unsigned int now, RollbackInput* pMessage)
+{
+	std::deque<Packet>& queue = Queues[peer & 1];
+	if (queue.empty() || queue.front().arrival > now)
+		return false;
+	*pMessage = queue.front().message;
+	queue.pop_front();
+	return true;
+}
+
+/******************************************************************************/
+/*!
+
+*/
+/******************************************************************************/
+RollbackSession::RollbackSession() :
+	World{ nullptr }, LocalPlayer{ 0 }, Step{ 0.0f }, CurrentTick{ 0 }, RollbackFrom{ SNAPSHOT_NO_TICK }
+{
+}
+
+/******************************************************************************/
+/*!
+	The world's current state is tick 0.
+*/
+/******************************************************************************/
+bool RollbackSession::Start(PlatformWorld* pWorld, unsigned int localPlayer, float step)
+{
+	WorldSnapshot probe;
+	if (!pWorld->SaveSnapshot(&probe) || localPlayer >= ROLLBACK_PLAYERS)
+		return false;
+
+	World = pWorld;
+	LocalPlayer = localPlayer;
+	Step = step;
+	CurrentTick = 0;
+	RollbackFrom = SNAPSHOT_NO_TICK;
+
+	for (TickInputs& inputs : History)
+		inputs.tick = SNAPSHOT_NO_TICK;
+	for (unsigned int p = 0; p < ROLLBACK_PLAYERS; ++p) {
+		LastReceived[p] = InputFrame{ false, false, false };
+		LastReceivedTick[p] = SNAPSHOT_NO_TICK;
+	}
+	Snapshots.Create(ROLLBACK_WINDOW);
+	Stats = RollbackStats{ 0, 0, 0, 0 };
+	return true;
+}
+
+/******************************************************************************/
+/*!
+	The inputs of "tick", emptied the first time the slot is used for it.
+*/
+/******************************************************************************/
+RollbackSession::TickInputs& RollbackSession::GetInputs(unsigned int tick)
+{
+	TickInputs& inputs = History[tick % ROLLBACK_HISTORY];
+	if (inputs.tick != tick) {
+		inputs.tick = tick;
+		inputs.known = 0;
+	}
+	return inputs;
+}
+
+/******************************************************************************/
+/*!
+	An input for a tick already run is compared with the prediction that
+	tick used; only a difference costs a rollback. Inputs come in order from
+	each player, so the newest one received is also the best prediction for
+	the ticks after it.
+*/
+/******************************************************************************/
+void RollbackSession::AddRemoteInput(const RollbackInput& remote)
+{
+	unsigned int player = remote.player;
+	if (player >= ROLLBACK_PLAYERS || player == LocalPlayer)
+		return;
+
+	//too old to roll back to, or so far ahead it would overwrite the window
+	if (remote.tick + ROLLBACK_WINDOW < CurrentTick || remote.tick >= CurrentTick + ROLLBACK_WINDOW) {
+		++Stats.lostInputs;
+		return;
+	}
+
+	TickInputs& inputs = GetInputs(remote.tick);
+	if (remote.tick < CurrentTick && !SameInput(inputs.input[player], remote.input) &&
+		(RollbackFrom == SNAPSHOT_NO_TICK || remote.tick < RollbackFrom))
+		RollbackFrom = remote.tick;
+	inputs.input[player] = remote.input;
+	inputs.known |= 1u << player;
+
+	if (LastReceivedTick[player] == SNAPSHOT_NO_TICK || remote.tick >= LastReceivedTick[player]) {
+		LastReceived[player] = remote.input;
+		LastReceivedTick[player] = remote.tick;
+	}
+}
+
+/******************************************************************************/
+/*!
+	Saves the state before "tick", fills in the inputs not received with
+	their prediction and runs the tick.
+*/
+/******************************************************************************/
+void RollbackSession::Simulate(unsigned int tick)
+{
+	TickInputs& inputs = GetInputs(tick);
+	World->SaveSnapshot(&Snapshots.Push(tick));
+
+	InputFrame merged{ false, false, false };
+	for (unsigned int p = 0; p < ROLLBACK_PLAYERS; ++p)
+	{
+		if (!(inputs.known & (1u << p)))
+			inputs.input[p] = LastReceived[p];
+		merged.moveLeft		|= inputs.input[p].moveLeft;
+		merged.moveRight	|= inputs.input[p].moveRight;
+		merged.jump			|= inputs.input[p].jump;
+	}
+
+	if (World->Step(Step, merged) == STEP_RESULT_RESTART)
+		World->Restart();
+}
+
+/******************************************************************************/
+/*!
+
+*/
+/******************************************************************************/
+void RollbackSession::Synchronize(void)
+{
+	if (RollbackFrom == SNAPSHOT_NO_TICK)
+		return;
+
+	const WorldSnapshot *pSnapshot = Snapshots.Find(RollbackFrom);
+	unsigned int from = RollbackFrom;
+	RollbackFrom = SNAPSHOT_NO_TICK;
+	if (!pSnapshot || !World->RestoreSnapshot(*pSnapshot)) {
+		++Stats.lostInputs;
+		return;
+	}
+
+	unsigned int length = CurrentTick - from;
+	++Stats.rollbacks;
+	Stats.ticksResimulated += length;
+	if (length > Stats.longestRollback)
+		Stats.longestRollback = length;
+
+	for (unsigned int tick = from; tick < CurrentTick; ++tick)
+		Simulate(tick);
+}
+
+/******************************************************************************/
+/*!
+
+*/
+/******************************************************************************/
+void RollbackSession::Tick(const InputFrame& local)
+{
+	Synchronize();
+
+	TickInputs& inputs = GetInputs(CurrentTick);
+	inputs.input[LocalPlayer] = local;
+	inputs.known |= 1u << LocalPlayer;
+	LastReceived[LocalPlayer] = local;
+	LastReceivedTick[LocalPlayer] = CurrentTick;
+
+	Simulate(CurrentTick++);
+}
@@ -0,0 +1,131 @@
+/******************************************************************************/
+/*!
+\file		RollbackSession.h
+\author 	DigiPen
+\par    	email: digipen\@digipen.edu
+\date   	February 01, 20xx
+\brief
+Rollback networking over PlatformWorld snapshots. Every peer runs the same
+simulation at a fixed step. A tick's input is the union of every player's
+buttons (the game has one hero, the players share it), and a player's
+input that hasn't arrived yet is predicted to be the last one received.
+When an input arrives that differs from its prediction, the world is
+restored to the snapshot before that tick and the ticks since are run
+again, so every peer ends up with the state the real inputs produce.
+
+LoopbackLink stands in for the network: both peers live in one process and
+what one sends reaches the other a fixed number of ticks later.
+
+Copyright (C) 20xx DigiPen Institute of Technology.
+Reproduction or disclosure of this file or its contents without the
+prior written consent of DigiPen Institute of Technology is prohibited.
+ */
+/******************************************************************************/
+
+#ifndef ROLLBACK_SESSION_H
+#define ROLLBACK_SESSION_H
+
+#include "PlatformWorld.h"
+#include "WorldSnapshot.h"
+#include <deque>
+
+/******************************************************************************/
+/*!
+	Defines
+*/
+/******************************************************************************/
+const unsigned int	ROLLBACK_PLAYERS		= 2;
+const unsigned int	ROLLBACK_WINDOW			= 16;	//Ticks an input may arrive late and still be rolled back to
+const unsigned int	ROLLBACK_HISTORY		= 2 * ROLLBACK_WINDOW;	//Inputs kept: the window and as many ticks ahead
+
+/******************************************************************************/
+/*!
+	Struct/Class Definitions
+*/
+/******************************************************************************/
+
+//One player's input for one tick, what the peers send each other
+struct RollbackInput
+{
+	unsigned int	tick;
+	unsigned int	player;
+	InputFrame		input;
+};
+
+//Both ends of a pretend connection: what is sent to one peer can be
+//received "latency" ticks later, in the order it was sent
+class LoopbackLink
+{
+public:
+	void				Open(unsigned int latency);
+	void				Send(unsigned int toPeer, const RollbackInput& message, unsigned int now);
+	//The next message due at "now", false if none
+	bool				Receive(unsigned int peer, unsigned int now, RollbackInput* pMessage);
+
+private:
+	struct Packet
+	{
+		unsigned int	arrival;
+		RollbackInput	message;
+	};
+
+	std::deque<Packet>	Queues[2];
+	unsigned int		Latency;
+};
+
+struct RollbackStats
+{
+	unsigned int	rollbacks;
+	unsigned int	ticksResimulated;
+	unsigned int	longestRollback;	// ticks
+	unsigned int	lostInputs;			// arrived too late or too early to be used, the peers diverge
+};
+
+class RollbackSession
+{
+public:
+	RollbackSession();
+
+	//Runs "pWorld", loaded and Init'ed, as player "localPlayer". False for a
+	//level that can't be snapshot (streamed)
+	bool				Start(PlatformWorld* pWorld, unsigned int localPlayer, float step);
+
+	//Another player's input, whenever it arrives
+	void				AddRemoteInput(const RollbackInput& remote);
+	//Runs again from the earliest mispredicted tick, if any, then one tick
+	//with "local" as this player's input. The caller sends "local" for
+	//GetTick() (before the call) to the other peers.
+	void				Tick(const InputFrame& local);
+	//Only the rollback: the world catches up with the inputs received so
+	//far without running a new tick
+	void				Synchronize(void);
+
+	//The tick the next call to Tick runs
+	unsigned int		GetTick(void) const			{ return CurrentTick; }
+	const RollbackStats&	GetStats(void) const	{ return Stats; }
+
+private:
+	struct TickInputs
+	{
+		unsigned int	tick;
+		InputFrame		input[ROLLBACK_PLAYERS];	// received, or the prediction used
+		unsigned int	known;						// bit per player whose input was received
+	};
+
+	TickInputs&			GetInputs(unsigned int tick);
+	void				Simulate(unsigned int tick);
+
+	PlatformWorld		*World;
+	unsigned int		LocalPlayer;
+	float				Step;
+	unsigned int		CurrentTick;
+	unsigned int		RollbackFrom;		// earliest mispredicted tick, SNAPSHOT_NO_TICK if none
+
+	TickInputs			History[ROLLBACK_HISTORY];
+	InputFrame			LastReceived[ROLLBACK_PLAYERS];
+	unsigned int		LastReceivedTick[ROLLBACK_PLAYERS];
+	SnapshotRing		Snapshots;			// the state before each of the last ROLLBACK_WINDOW ticks
+	RollbackStats		Stats;
+};
+
+#endif // ROLLBACK_SESSION_H
@@ -0,0 +1,639 @@
+/******************************************************************************/
+/*!
+\file		SimKernels.cpp
+\author 	DigiPen
+\par    	email: digipen\@digipen.edu
+\date   	February 01, 20xx
+\brief
+Batch kernels over EntityTable columns. See SimKernels.h.
+
+No fused multiply-add is used anywhere so the vector versions round exactly
+like the scalar one.
+
+Copyright (C) 20xx DigiPen Institute of Technology.
+Reproduction or disclosure of this file or its contents without the
+prior written consent of DigiPen Institute of Technology is prohibited.
+ */
+/******************************************************************************/
+
+#include "SimKernels.h"
+#include "SpatialHash.h"
+#include <atomic>
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+#define SIM_KERNELS_X86		1
+#include <immintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+#endif
+
+//MSVC compiles any intrinsic as is, GCC and Clang need the target enabled per function
+#if defined(SIM_KERNELS_X86) && (defined(__GNUC__) || defined(__clang__))
+#define SIM_TARGET_SSE2		__attribute__((target("sse2")))
+#define SIM_TARGET_AVX2		__attribute__((target("avx2")))
+#else
+#define SIM_TARGET_SSE2
+#define SIM_TARGET_AVX2
+#endif
+
+/******************************************************************************/
+/*!
+	File globals
+*/
+/******************************************************************************/
+//SIMD_LEVEL in use, -1 until detected. The first batch can come from
+//several workers at once; each detects the same level and stores it.
+static std::atomic<int>	sLevel{ -1 };
+
+/******************************************************************************/
+/*!
+
+*/
+/******************************************************************************/
+static void IntegrateAndBound_Scalar(const IntegrateBatch& b, unsigned int begin, float dt,
+									 float gravityStep, bool applyGravity, float halfSize)
+{
+	for (unsigned int i = begin; i < b.count; ++i)
+	{
+		b.posPrevX[i] = b.posX[i];
+		b.posPrevY[i] = b.posY[i];
+
+		if (applyGravity)
+			b.velY[i] += gravityStep;
+
+		b.posX[i] += b.velX[i] * dt;
+		b.posY[i] += b.velY[i] * dt;
+
+		float half = halfSize * b.scale[i];
+		b.minX[i] = b.posX[i] - half;
+		b.minY[i] = b.posY[i] - half;
+		b.maxX[i] = b.posX[i] + half;
+		b.maxY[i] = b.posY[i] + half;
+	}
+}
+
+#ifdef SIM_KERNELS_X86
+/******************************************************************************/
+/*!
+	Returns the first row it did not process
+*/
+/******************************************************************************/
+SIM_TARGET_SSE2
+static unsigned int IntegrateAndBound_SSE2(const IntegrateBatch& b, float dt,
+										   float gravityStep, bool applyGravity, float halfSize)
+{
+	const __m128 vDt	= _mm_set1_ps(dt);
+	const __m128 vG		= _mm_set1_ps(gravityStep);
+	const __m128 vHalf	= _mm_set1_ps(halfSize);
+	unsigned int i = 0;
+
+	for (; i + 4 <= b.count; i += 4)
+	{
+		__m128 px = _mm_loadu_ps(b.posX + i);
+		__m128 py = _mm_loadu_ps(b.posY + i);
+		__m128 vx = _mm_loadu_ps(b.velX + i);
+		__m128 vy = _mm_loadu_ps(b.velY + i);
+
+		_mm_storeu_ps(b.posPrevX + i, px);
+		_mm_storeu_ps(b.posPrevY + i, py);
+
+		if (applyGravity) {
+			vy = _mm_add_ps(vy, vG);
+			_mm_storeu_ps(b.velY + i, vy);
+		}
+
+		px = _mm_add_ps(px, _mm_mul_ps(vx, vDt));
+		py = _mm_add_ps(py, _mm_mul_ps(vy, vDt));
+		_mm_storeu_ps(b.posX + i, px);
+		_mm_storeu_ps(b.posY + i, py);
+
+		__m128 half = _mm_mul_ps(vHalf, _mm_loadu_ps(b.scale + i));
+		_mm_storeu_ps(b.minX + i, _mm_sub_ps(px, half));
+		_mm_storeu_ps(b.minY + i, _mm_sub_ps(py, half));
+		_mm_storeu_ps(b.maxX + i, _mm_add_ps(px, half));
+		_mm_storeu_ps(b.maxY + i, _mm_add_ps(py, half));
+	}
+	return i;
+}
+
+/******************************************************************************/
+/*!
+	Returns the first row it did not process
+*/
+/******************************************************************************/
+SIM_TARGET_AVX2
+static unsigned int IntegrateAndBound_AVX2(const IntegrateBatch& b, float dt,
+										   float gravityStep, bool applyGravity, float halfSize)
+{
+	const __m256 vDt	= _mm256_set1_ps(dt);
+	const __m256 vG		= _mm256_set1_ps(gravityStep);
+	const __m256 vHalf	= _mm256_set1_ps(halfSize);
+	unsigned int i = 0;
+
+	for (; i + 8 <= b.count; i += 8)
+	{
+		__m256 px = _mm256_loadu_ps(b.posX + i);
+		__m256 py = _mm256_loadu_ps(b.posY + i);
+		__m256 vx = _mm256_loadu_ps(b.velX + i);
+		__m256 vy = _mm256_loadu_ps(b.velY + i);
+
+		_mm256_storeu_ps(b.posPrevX + i, px);
+		_mm256_storeu_ps(b.posPrevY + i, py);
+
+		if (applyGravity) {
+			vy = _mm256_add_ps(vy, vG);
+			_mm256_storeu_ps(b.velY + i, vy);
+		}
+
+		px = _mm256_add_ps(px, _mm256_mul_ps(vx, vDt));
+		py = _mm256_add_ps(py, _mm256_mul_ps(vy, vDt));
+		_mm256_storeu_ps(b.posX + i, px);
+		_mm256_storeu_ps(b.posY + i, py);
+
+		__m256 half = _mm256_mul_ps(vHalf, _mm256_loadu_ps(b.scale + i));
+		_mm256_storeu_ps(b.minX + i, _mm256_sub_ps(px, half));
+		_mm256_storeu_ps(b.minY + i, _mm256_sub_ps(py, half));
+		_mm256_storeu_ps(b.maxX + i, _mm256_add_ps(px, half));
+		_mm256_storeu_ps(b.maxY + i, _mm256_add_ps(py, half));
+	}
+	return i;
+}
+#endif // SIM_KERNELS_X86
+
+/******************************************************************************/
+/*!
+
+*/
+/******************************************************************************/
+void IntegrateAndBound(const IntegrateBatch& batch, float dt, float gravity,
+					   bool applyGravity, float halfSize)
+{
+	float gravityStep = gravity * dt;
+	unsigned int done = 0;
+
+#ifdef SIM_KERNELS_X86
+	switch (SimKernelsGetLevel()) {
+	case SIMD_LEVEL_AVX2:
+		done = IntegrateAndBound_AVX2(batch, dt, gravityStep, applyGravity, halfSize);
+		break;
+	case SIMD_LEVEL_SSE2:
+		done = IntegrateAndBound_SSE2(batch, dt, gravityStep, applyGravity, halfSize);
+		break;
+	default:
+		break;
+	}
+#endif
+
+	// remainder, or everything on the scalar level
+	IntegrateAndBound_Scalar(batch, done, dt, gravityStep, applyGravity, halfSize);
+}
+
+/******************************************************************************/
+/*!
+	Hot spots, as offsets from the position in units of the scale:
+	two on the top and bottom edges at +-1/4 across, two on the left and
+	right edges at +-1/4 up. x/4 and x/2 are computed as x*0.25 and x*0.5,
+	which round identically.
+*/
+/******************************************************************************/
+static void CheckGridCollision_Scalar(const CollisionGrid& g, const float* posX, const float* posY,
+									  const float* scale, int* flags, unsigned int begin, unsigned int count)
+{
+	for (unsigned int i = begin; i < count; ++i)
+	{
+		float x = posX[i], y = posY[i];
+		float q = scale[i] * 0.25f, h = scale[i] * 0.5f;
+		int flag = 0;
+
+		if (CollisionGridCell(g, (int)(x + q), (int)(y + h)) | CollisionGridCell(g, (int)(x - q), (int)(y + h)))
+			flag |= COLLISION_TOP;
+		if (CollisionGridCell(g, (int)(x + q), (int)(y - h)) | CollisionGridCell(g, (int)(x - q), (int)(y - h)))
+			flag |= COLLISION_BOTTOM;
+		if (CollisionGridCell(g, (int)(x - h), (int)(y + q)) | CollisionGridCell(g, (int)(x - h), (int)(y - q)))
+			flag |= COLLISION_LEFT;
+		if (CollisionGridCell(g, (int)(x + h), (int)(y + q)) | CollisionGridCell(g, (int)(x + h), (int)(y - q)))
+			flag |= COLLISION_RIGHT;
+
+		flags[i] = flag;
+	}
+}
+
+#ifdef SIM_KERNELS_X86
+/******************************************************************************/
+/*!
+	Clamped bit index of 4 hot spots. cvtt truncates toward zero like the
+	(int) cast; out of range floats come back as INT_MIN and clamp to the
+	low border. lo/hi are the border cells on each axis.
+*/
+/******************************************************************************/
+SIM_TARGET_SSE2
+static inline __m128i GridBitIndex_SSE2(__m128 x, __m128 y, __m128i loX, __m128i hiX,
+										__m128i loY, __m128i hiY, __m128i rowBits)
+{
+	__m128i ix = _mm_cvttps_epi32(x);
+	__m128i iy = _mm_cvttps_epi32(y);
+
+	// SSE2 has no 32 bit min/max, select through compares instead
+	__m128i lo = _mm_cmplt_epi32(ix, loX);
+	ix = _mm_or_si128(_mm_and_si128(lo, loX), _mm_andnot_si128(lo, ix));
+	__m128i hi = _mm_cmpgt_epi32(ix, hiX);
+	ix = _mm_or_si128(_mm_and_si128(hi, hiX), _mm_andnot_si128(hi, ix));
+	lo = _mm_cmplt_epi32(iy, loY);
+	iy = _mm_or_si128(_mm_and_si128(lo, loY), _mm_andnot_si128(lo, iy));
+	hi = _mm_cmpgt_epi32(iy, hiY);
+	iy = _mm_or_si128(_mm_and_si128(hi, hiY), _mm_andnot_si128(hi, iy));
+
+	// (iy - loY) * rowBits + ix - loX, only the low 32 bits of each product are kept
+	__m128i row = _mm_sub_epi32(iy, loY);
+	__m128i rowLo = _mm_mul_epu32(row, rowBits);
+	__m128i rowHi = _mm_mul_epu32(_mm_srli_epi64(row, 32), rowBits);
+	__m128i rowOffset = _mm_unpacklo_epi32(_mm_shuffle_epi32(rowLo, _MM_SHUFFLE(0, 0, 2, 0)),
+										   _mm_shuffle_epi32(rowHi, _MM_SHUFFLE(0, 0, 2, 0)));
+	return _mm_add_epi32(rowOffset, _mm_sub_epi32(ix, loX));
+}
+
+static inline unsigned int GridBit(const unsigned int* bits, int index)
+{
+	return (bits[(unsigned int)index >> 5] >> (index & 31)) & 1;
+}
+
+/******************************************************************************/
+/*!
+	Hot spot math is vectorized, SSE2 has no gather or per lane shift so the
+	4 cells of each hot spot are read one by one
+*/
+/******************************************************************************/
+SIM_TARGET_SSE2
+static unsigned int CheckGridCollision_SSE2(const CollisionGrid& g, const float* posX, const float* posY,
+											const float* scale, int* flags, unsigned int count)
+{
+	const __m128i loX		= _mm_set1_epi32(g.originX - 1);
+	const __m128i hiX		= _mm_set1_epi32(g.originX + g.width);
+	const __m128i loY		= _mm_set1_epi32(g.originY - 1);
+	const __m128i hiY		= _mm_set1_epi32(g.originY + g.height);
+	const __m128i rowBits	= _mm_set1_epi32(g.wordsPerRow * 32);
+	const __m128 quarter	= _mm_set1_ps(0.25f);
+	const __m128 halfS		= _mm_set1_ps(0.5f);
+	unsigned int i = 0;
+
+	for (; i + 4 <= count; i += 4)
+	{
+		__m128 x = _mm_loadu_ps(posX + i);
+		__m128 y = _mm_loadu_ps(posY + i);
+		__m128 s = _mm_loadu_ps(scale + i);
+		__m128 q = _mm_mul_ps(s, quarter);
+		__m128 h = _mm_mul_ps(s, halfS);
+
+		__m128 xpq = _mm_add_ps(x, q), xmq = _mm_sub_ps(x, q);
+		__m128 xph = _mm_add_ps(x, h), xmh = _mm_sub_ps(x, h);
+		__m128 ypq = _mm_add_ps(y, q), ymq = _mm_sub_ps(y, q);
+		__m128 yph = _mm_add_ps(y, h), ymh = _mm_sub_ps(y, h);
+
+		alignas(16) int off[8][4];
+		_mm_store_si128((__m128i*)off[0], GridBitIndex_SSE2(xpq, yph, loX, hiX, loY, hiY, rowBits));	// top
+		_mm_store_si128((__m128i*)off[1], GridBitIndex_SSE2(xmq, yph, loX, hiX, loY, hiY, rowBits));
+		_mm_store_si128((__m128i*)off[2], GridBitIndex_SSE2(xpq, ymh, loX, hiX, loY, hiY, rowBits));	// bottom
+		_mm_store_si128((__m128i*)off[3], GridBitIndex_SSE2(xmq, ymh, loX, hiX, loY, hiY, rowBits));
+		_mm_store_si128((__m128i*)off[4], GridBitIndex_SSE2(xmh, ypq, loX, hiX, loY, hiY, rowBits));	// left
+		_mm_store_si128((__m128i*)off[5], GridBitIndex_SSE2(xmh, ymq, loX, hiX, loY, hiY, rowBits));
+		_mm_store_si128((__m128i*)off[6], GridBitIndex_SSE2(xph, ypq, loX, hiX, loY, hiY, rowBits));	// right
+		_mm_store_si128((__m128i*)off[7], GridBitIndex_SSE2(xph, ymq, loX, hiX, loY, hiY, rowBits));
+
+		for (int lane = 0; lane < 4; ++lane)
+		{
+			const unsigned int* b = g.bits;
+			flags[i + lane] =
+				  ((GridBit(b, off[0][lane]) | GridBit(b, off[1][lane])) ? (int)COLLISION_TOP : 0)
+				| ((GridBit(b, off[2][lane]) | GridBit(b, off[3][lane])) ? (int)COLLISION_BOTTOM : 0)
+				| ((GridBit(b, off[4][lane]) | GridBit(b, off[5][lane])) ? (int)COLLISION_LEFT : 0)
+				| ((GridBit(b, off[6][lane]) | GridBit(b, off[7][lane])) ? (int)COLLISION_RIGHT : 0);
+		}
+	}
+	return i;
+}
+
+/******************************************************************************/
+/*!
+	Clamped cell of 8 hot spots: the bitmap word holding each cell is
+	gathered, then shifted right by the cell's bit and masked
+*/
+/******************************************************************************/
+SIM_TARGET_AVX2
+static inline __m256i GridGather_AVX2(const CollisionGrid& g, __m256 x, __m256 y,
+									  __m256i loX, __m256i hiX, __m256i loY, __m256i hiY, __m256i rowBits)
+{
+	const __m256i one		= _mm256_set1_epi32(1);
+	__m256i ix = _mm256_min_epi32(_mm256_max_epi32(_mm256_cvttps_epi32(x), loX), hiX);
+	__m256i iy = _mm256_min_epi32(_mm256_max_epi32(_mm256_cvttps_epi32(y), loY), hiY);
+	__m256i bit = _mm256_add_epi32(_mm256_mullo_epi32(_mm256_sub_epi32(iy, loY), rowBits),
+								   _mm256_sub_epi32(ix, loX));
+	__m256i words = _mm256_i32gather_epi32((const int*)g.bits, _mm256_srli_epi32(bit, 5), 4);
+	words = _mm256_srlv_epi32(words, _mm256_and_si256(bit, _mm256_set1_epi32(31)));
+	return _mm256_and_si256(words, one);
+}
+
+/******************************************************************************/
+/*!
+
+*/
+/******************************************************************************/
+SIM_TARGET_AVX2
+static unsigned int CheckGridCollision_AVX2(const CollisionGrid& g, const float* posX, const float* posY,
+											const float* scale, int* flags, unsigned int count)
+{
+	const __m256i loX		= _mm256_set1_epi32(g.originX - 1);
+	const __m256i hiX		= _mm256_set1_epi32(g.originX + g.width);
+	const __m256i loY		= _mm256_set1_epi32(g.originY - 1);
+	const __m256i hiY		= _mm256_set1_epi32(g.originY + g.height);
+	const __m256i rowBits	= _mm256_set1_epi32(g.wordsPerRow * 32);
+	const __m256i zero		= _mm256_setzero_si256();
+	const __m256 quarter	= _mm256_set1_ps(0.25f);
+	const __m256 halfS		= _mm256_set1_ps(0.5f);
+	unsigned int i = 0;
+
+	for (; i + 8 <= count; i += 8)
+	{
+		__m256 x = _mm256_loadu_ps(posX + i);
+		__m256 y = _mm256_loadu_ps(posY + i);
+		__m256 s = _mm256_loadu_ps(scale + i);
+		__m256 q = _mm256_mul_ps(s, quarter);
+		__m256 h = _mm256_mul_ps(s, halfS);
+
+		__m256 xpq = _mm256_add_ps(x, q), xmq = _mm256_sub_ps(x, q);
+		__m256 xph = _mm256_add_ps(x, h), xmh = _mm256_sub_ps(x, h);
+		__m256 ypq = _mm256_add_ps(y, q), ymq = _mm256_sub_ps(y, q);
+		__m256 yph = _mm256_add_ps(y, h), ymh = _mm256_sub_ps(y, h);
+
+		__m256i top		= _mm256_or_si256(GridGather_AVX2(g, xpq, yph, loX, hiX, loY, hiY, rowBits),
+										  GridGather_AVX2(g, xmq, yph, loX, hiX, loY, hiY, rowBits));
+		__m256i bottom	= _mm256_or_si256(GridGather_AVX2(g, xpq, ymh, loX, hiX, loY, hiY, rowBits),
+										  GridGather_AVX2(g, xmq, ymh, loX, hiX, loY, hiY, rowBits));
+		__m256i left	= _mm256_or_si256(GridGather_AVX2(g, xmh, ypq, loX, hiX, loY, hiY, rowBits),
+										  GridGather_AVX2(g, xmh, ymq, loX, hiX, loY, hiY, rowBits));
+		__m256i right	= _mm256_or_si256(GridGather_AVX2(g, xph, ypq, loX, hiX, loY, hiY, rowBits),
+										  GridGather_AVX2(g, xph, ymq, loX, hiX, loY, hiY, rowBits));
+
+		// lane all ones where the side hit, masked down to its flag bit
+		__m256i flag = _mm256_and_si256(_mm256_xor_si256(_mm256_cmpeq_epi32(top, zero), _mm256_set1_epi32(-1)),
+										_mm256_set1_epi32(COLLISION_TOP));
+		flag = _mm256_or_si256(flag, _mm256_andnot_si256(_mm256_cmpeq_epi32(bottom, zero), _mm256_set1_epi32(COLLISION_BOTTOM)));
+		flag = _mm256_or_si256(flag, _mm256_andnot_si256(_mm256_cmpeq_epi32(left, zero), _mm256_set1_epi32(COLLISION_LEFT)));
+		flag = _mm256_or_si256(flag, _mm256_andnot_si256(_mm256_cmpeq_epi32(right, zero), _mm256_set1_epi32(COLLISION_RIGHT)));
+		_mm256_storeu_si256((__m256i*)(flags + i), flag);
+	}
+	return i;
+}
+#endif // SIM_KERNELS_X86
+
+/******************************************************************************/
+/*!
+
+*/
+/******************************************************************************/
+void CheckGridCollisionBatch(const CollisionGrid& grid, const float* posX, const float* posY,
+							 const float* scale, int* flags, unsigned int count)
+{
+	unsigned int done = 0;
+
+#ifdef SIM_KERNELS_X86
+	switch (SimKernelsGetLevel()) {
+	case SIMD_LEVEL_AVX2:
+		done = CheckGridCollision_AVX2(grid, posX, posY, scale, flags, count);
+		break;
+	case SIMD_LEVEL_SSE2:
+		done = CheckGridCollision_SSE2(grid, posX, posY, scale, flags, count);
+		break;
+	default:
+		break;
+	}
+#endif
+
+	CheckGridCollision_Scalar(grid, posX, posY, scale, flags, done, count);
+}
+
+/******************************************************************************/
+/*!
+
+*/
+/******************************************************************************/
+static void SweptCells_Scalar(const SweptCellBatch& b, unsigned int begin, float dt, float margin,
+							  int* cellX, int* cellY)
+{
+	for (unsigned int i = begin; i < b.count; ++i)
+	{
+		float dx = b.velX[i] * dt, dy = b.velY[i] * dt;
+		float x0 = b.minX[i] + (dx < 0.0f ? dx : 0.0f) - margin;
+		float y0 = b.minY[i] + (dy < 0.0f ? dy : 0.0f) - margin;
+		float x1 = b.maxX[i] + (dx > 0.0f ? dx : 0.0f) + margin;
+		float y1 = b.maxY[i] + (dy > 0.0f ? dy : 0.0f) + margin;
+
+		bool large = x1 - x0 > SPATIAL_HASH_CELL_SIZE || y1 - y0 > SPATIAL_HASH_CELL_SIZE;
+		cellX[i] = large ? SPATIAL_HASH_LARGE_CELL : SpatialCellOf(x0);
+		cellY[i] = large ? 0 : SpatialCellOf(y0);
+	}
+}
+
+#ifdef SIM_KERNELS_X86
+/******************************************************************************/
+/*!
+	SpatialCellOf of 4 coordinates: clamp, truncate, and one less where
+	that rounded a negative value up
+*/
+/******************************************************************************/
+SIM_TARGET_SSE2
+static inline __m128i CellOf_SSE2(__m128 coordinate)
+{
+	__m128 scaled = _mm_mul_ps(coordinate, _mm_set1_ps(1.0f / SPATIAL_HASH_CELL_SIZE));
+	scaled = _mm_min_ps(_mm_max_ps(scaled, _mm_set1_ps(-SPATIAL_HASH_CELL_LIMIT)), _mm_set1_ps(SPATIAL_HASH_CELL_LIMIT));
+	__m128i cell = _mm_cvttps_epi32(scaled);
+	return _mm_add_epi32(cell, _mm_castps_si128(_mm_cmplt_ps(scaled, _mm_cvtepi32_ps(cell))));
+}
+
+/******************************************************************************/
+/*!
+	Returns the first row it did not process
+*/
+/******************************************************************************/
+SIM_TARGET_SSE2
+static unsigned int SweptCells_SSE2(const SweptCellBatch& b, float dt, float margin,
+									int* cellX, int* cellY)
+{
+	const __m128 vDt	= _mm_set1_ps(dt);
+	const __m128 vM		= _mm_set1_ps(margin);
+	const __m128 vCell	= _mm_set1_ps((float)SPATIAL_HASH_CELL_SIZE);
+	const __m128 zero	= _mm_setzero_ps();
+	const __m128i vLarge	= _mm_set1_epi32(SPATIAL_HASH_LARGE_CELL);
+	unsigned int i = 0;
+
+	for (; i + 4 <= b.count; i += 4)
+	{
+		__m128 dx = _mm_mul_ps(_mm_loadu_ps(b.velX + i), vDt);
+		__m128 dy = _mm_mul_ps(_mm_loadu_ps(b.velY + i), vDt);
+		__m128 x0 = _mm_sub_ps(_mm_add_ps(_mm_loadu_ps(b.minX + i), _mm_min_ps(dx, zero)), vM);
+		__m128 y0 = _mm_sub_ps(_mm_add_ps(_mm_loadu_ps(b.minY + i), _mm_min_ps(dy, zero)), vM);
+		__m128 x1 = _mm_add_ps(_mm_add_ps(_mm_loadu_ps(b.maxX + i), _mm_max_ps(dx, zero)), vM);
+		__m128 y1 = _mm_add_ps(_mm_add_ps(_mm_loadu_ps(b.maxY + i), _mm_max_ps(dy, zero)), vM);
+
+		__m128i large = _mm_castps_si128(_mm_or_ps(_mm_cmpgt_ps(_mm_sub_ps(x1, x0), vCell),
+												   _mm_cmpgt_ps(_mm_sub_ps(y1, y0), vCell)));
+		__m128i cx = _mm_or_si128(_mm_and_si128(large, vLarge), _mm_andnot_si128(large, CellOf_SSE2(x0)));
+		__m128i cy = _mm_andnot_si128(large, CellOf_SSE2(y0));
+		_mm_storeu_si128((__m128i*)(cellX + i), cx);
+		_mm_storeu_si128((__m128i*)(cellY + i), cy);
+	}
+	return i;
+}
+
+/******************************************************************************/
+/*!
+
+*/
+/******************************************************************************/
+SIM_TARGET_AVX2
+static inline __m256i CellOf_AVX2(__m256 coordinate)
+{
+	__m256 scaled = _mm256_mul_ps(coordinate, _mm256_set1_ps(1.0f / SPATIAL_HASH_CELL_SIZE));
+	scaled = _mm256_min_ps(_mm256_max_ps(scaled, _mm256_set1_ps(-SPATIAL_HASH_CELL_LIMIT)),
+						   _mm256_set1_ps(SPATIAL_HASH_CELL_LIMIT));
+	__m256i cell = _mm256_cvttps_epi32(scaled);
+	return _mm256_add_epi32(cell, _mm256_castps_si256(_mm256_cmp_ps(scaled, _mm256_cvtepi32_ps(cell), _CMP_LT_OQ)));
+}
+
+/******************************************************************************/
+/*!
+	Returns the first row it did not process
+*/
+/******************************************************************************/
+SIM_TARGET_AVX2
+static unsigned int SweptCells_AVX2(const SweptCellBatch& b, float dt, float margin,
+									int* cellX, int* cellY)
+{
+	const __m256 vDt	= _mm256_set1_ps(dt);
+	const __m256 vM		= _mm256_set1_ps(margin);
+	const __m256 vCell	= _mm256_set1_ps((float)SPATIAL_HASH_CELL_SIZE);
+	const __m256 zero	= _mm256_setzero_ps();
+	const __m256i vLarge	= _mm256_set1_epi32(SPATIAL_HASH_LARGE_CELL);
+	unsigned int i = 0;
+
+	for (; i + 8 <= b.count; i += 8)
+	{
+		__m256 dx = _mm256_mul_ps(_mm256_loadu_ps(b.velX + i), vDt);
+		__m256 dy = _mm256_mul_ps(_mm256_loadu_ps(b.velY + i), vDt);
+		__m256 x0 = _mm256_sub_ps(_mm256_add_ps(_mm256_loadu_ps(b.minX + i), _mm256_min_ps(dx, zero)), vM);
+		__m256 y0 = _mm256_sub_ps(_mm256_add_ps(_mm256_loadu_ps(b.minY + i), _mm256_min_ps(dy, zero)), vM);
+		__m256 x1 = _mm256_add_ps(_mm256_add_ps(_mm256_loadu_ps(b.maxX + i), _mm256_max_ps(dx, zero)), vM);
+		__m256 y1 = _mm256_add_ps(_mm256_add_ps(_mm256_loadu_ps(b.maxY + i), _mm256_max_ps(dy, zero)), vM);
+
+		__m256i large = _mm256_castps_si256(_mm256_or_ps(_mm256_cmp_ps(_mm256_sub_ps(x1, x0), vCell, _CMP_GT_OQ),
+														 _mm256_cmp_ps(_mm256_sub_ps(y1, y0), vCell, _CMP_GT_OQ)));
+		__m256i cx = _mm256_blendv_epi8(CellOf_AVX2(x0), vLarge, large);
+		__m256i cy = _mm256_andnot_si256(large, CellOf_AVX2(y0));
+		_mm256_storeu_si256((__m256i*)(cellX + i), cx);
+		_mm256_storeu_si256((__m256i*)(cellY + i), cy);
+	}
+	return i;
+}
+#endif // SIM_KERNELS_X86
+
+/******************************************************************************/
+/*!
+
+*/
+/******************************************************************************/
+void SweptCells(const SweptCellBatch& batch, float dt, float margin, int* cellX, int* cellY)
+{
+	unsigned int done = 0;
+
+#ifdef SIM_KERNELS_X86
+	switch (SimKernelsGetLevel()) {
+	case SIMD_LEVEL_AVX2:
+		done = SweptCells_AVX2(batch, dt, margin, cellX, cellY);
+		break;
+	case SIMD_LEVEL_SSE2:
+		done = SweptCells_SSE2(batch, dt, margin, cellX, cellY);
+		break;
+	default:
+		break;
+	}
+#endif
+
+	SweptCells_Scalar(batch, done, dt, margin, cellX, cellY);
+}
+
+/******************************************************************************/
+/*!
+
+*/
+/******************************************************************************/
+SIMD_LEVEL SimKernelsDetectLevel(void)
+{
+#ifdef SIM_KERNELS_X86
+#if defined(_MSC_VER)
+	int info[4];
+	__cpuid(info, 0);
+	int maxLeaf = info[0];
+
+	__cpuid(info, 1);
+	bool sse2		= (info[3] & (1 << 26)) != 0;
+	bool osxsave	= (info[2] & (1 << 27)) != 0;
+	bool avx		= (info[2] & (1 << 28)) != 0;
+	bool avx2		= false;
+	if (maxLeaf >= 7 && osxsave && avx && (_xgetbv(0) & 0x6) == 0x6) {
+		__cpuidex(info, 7, 0);
+		avx2 = (info[1] & (1 << 5)) != 0;
+	}
+	if (avx2)
+		return SIMD_LEVEL_AVX2;
+	if (sse2)
+		return SIMD_LEVEL_SSE2;
+#else
+	__builtin_cpu_init();
+	if (__builtin_cpu_supports("avx2"))
+		return SIMD_LEVEL_AVX2;
+	if (__builtin_cpu_supports("sse2"))
+		return SIMD_LEVEL_SSE2;
+#endif
+#endif // SIM_KERNELS_X86
+	return SIMD_LEVEL_SCALAR;
+}
+
+/******************************************************************************/
+/*!
+
+*/
+/******************************************************************************/
+SIMD_LEVEL SimKernelsGetLevel(void)
+{
+	int level = sLevel.load(std::memory_order_relaxed);
+	if (level < 0) {
+		level = SimKernelsDetectLevel();
+		sLevel.store(level, std::memory_order_relaxed);
+	}
+	return (SIMD_LEVEL)level;
+}
+
+/******************************************************************************/
+/*!
+
+*/
+/******************************************************************************/
+void SimKernelsSetLevel(SIMD_LEVEL level)
+{
+	SIMD_LEVEL best = SimKernelsDetectLevel();
+	sLevel.store(level > best ? best : level, std::memory_order_relaxed);
+}
+
+/******************************************************************************/
+/*!
+
+*/
+/******************************************************************************/
+const char* SimKernelsLevelName(SIMD_LEVEL level)
+{
+	switch (level) {
+	case SIMD_LEVEL_AVX2:	return "avx2";
+	case SIMD_LEVEL_SSE2:	return "sse2";
+	default:				return "scalar";
+	}
+}
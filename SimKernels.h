@@ -0,0 +1,137 @@
+/******************************************************************************/
+/*!
+\file		SimKernels.h
+\author 	DigiPen
+\par    	email: digipen\@digipen.edu
+\date   	February 01, 20xx
+\brief
+Batch kernels over the packed columns of an EntityTable. Each kernel has a
+scalar version and SSE2/AVX2 versions that process 4/8 rows at a time; the
+widest one the CPU supports is picked the first time a kernel runs. All
+versions do the same float operations in the same order, so results are
+bit identical whichever one runs.
+
+Copyright (C) 20xx DigiPen Institute of Technology.
+Reproduction or disclosure of this file or its contents without the
+prior written consent of DigiPen Institute of Technology is prohibited.
+ */
+/******************************************************************************/
+
+#ifndef SIM_KERNELS_H
+#define SIM_KERNELS_H
+
+#include "PlatformTypes.h"
+
+/******************************************************************************/
+/*!
+	Struct/Class Definitions
+*/
+/******************************************************************************/
+enum SIMD_LEVEL
+{
+	SIMD_LEVEL_SCALAR,
+	SIMD_LEVEL_SSE2,			//4 rows per iteration
+	SIMD_LEVEL_AVX2				//8 rows per iteration
+};
+
+//Columns the integration kernel reads and writes, "count" rows from each
+struct IntegrateBatch
+{
+	float			*posX, *posY;
+	float			*posPrevX, *posPrevY;
+	float			*velX, *velY;
+	const float		*scale;
+	float			*minX, *minY;
+	float			*maxX, *maxY;
+	unsigned int	count;
+};
+
+//Binary collision map, one bit per cell, row major, with one cell of
+//padding on every side (see TileMap). The grid covers the cells from
+//(originX, originY) on, which is (0, 0) unless the map is streamed; cell
+//(X, Y) is bit X - originX + 1 of bitmap row Y - originY + 1, so any cell
+//clamped to the border around the grid can be read without a bounds check.
+struct CollisionGrid
+{
+	const unsigned int	*bits;			// wordsPerRow * (height + 2) words
+	int					width;
+	int					height;
+	int					wordsPerRow;	// (width + 2 + 31) / 32
+	int					originX;
+	int					originY;
+};
+
+//Columns the swept cell kernel reads, "count" rows from each
+struct SweptCellBatch
+{
+	const float		*minX, *minY;
+	const float		*maxX, *maxY;
+	const float		*velX, *velY;
+	unsigned int	count;
+};
+
+/******************************************************************************/
+/*!
+	Branch free cell lookup: clamp into the border, then shift and mask.
+	1 for a collision cell, outside the map whatever the border holds.
+*/
+/******************************************************************************/
+inline int CollisionGridCell(const CollisionGrid& grid, int X, int Y)
+{
+	int loX = grid.originX - 1, hiX = grid.originX + grid.width;
+	int loY = grid.originY - 1, hiY = grid.originY + grid.height;
+	X = X < loX ? loX : X;
+	X = X > hiX ? hiX : X;
+	Y = Y < loY ? loY : Y;
+	Y = Y > hiY ? hiY : Y;
+	unsigned int bit = (unsigned int)((Y - loY) * grid.wordsPerRow * 32 + (X - loX));
+	return (grid.bits[bit >> 5] >> (bit & 31)) & 1;
+}
+
+/******************************************************************************/
+/*!
+	For every row:
+		posPrev = pos
+		velY   += gravity * dt			(only if applyGravity)
+		pos    += vel * dt
+		min     = pos - halfSize * scale
+		max     = pos + halfSize * scale
+*/
+/******************************************************************************/
+void				IntegrateAndBound(const IntegrateBatch& batch, float dt, float gravity,
+									  bool applyGravity, float halfSize);
+
+/******************************************************************************/
+/*!
+	Batch version of CheckInstanceBinaryMapCollision for "count" instances
+	with a uniform scale. Same 8 hot spots and the same COLLISION_ flags,
+	written to "flags".
+*/
+/******************************************************************************/
+void				CheckGridCollisionBatch(const CollisionGrid& grid,
+											const float* posX, const float* posY,
+											const float* scale, int* flags,
+											unsigned int count);
+
+/******************************************************************************/
+/*!
+	For every row, the box stretched by its velocity over dt and grown by
+	"margin":
+		min = min + min(vel * dt, 0) - margin
+		max = max + max(vel * dt, 0) + margin
+	and the cell SpatialHash tracks that box in: SpatialCellOf of min, or
+	(SPATIAL_HASH_LARGE_CELL, 0) if the box is wider or taller than a cell.
+*/
+/******************************************************************************/
+void				SweptCells(const SweptCellBatch& batch, float dt, float margin,
+							   int* cellX, int* cellY);
+
+//Best level this CPU can run
+SIMD_LEVEL			SimKernelsDetectLevel(void);
+//Level in use, detected on first use unless set
+SIMD_LEVEL			SimKernelsGetLevel(void);
+//Forces a level (benchmarks, debugging), clamped to what the CPU supports
+void				SimKernelsSetLevel(SIMD_LEVEL level);
+const char*			SimKernelsLevelName(SIMD_LEVEL level);
+
+#endif // SIM_KERNELS_H
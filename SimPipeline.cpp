@@ -0,0 +1,90 @@
+/******************************************************************************/
+/*!
+\file		SimPipeline.cpp
+\author 	DigiPen
+\par    	email: digipen\@digipen.edu
+\date   	February 01, 20xx
+\brief
+Stage table of PlatformWorld::Step. See SimPipeline.h.
+
+Copyright (C) 20xx DigiPen Institute of Technology.
+Reproduction or disclosure of this file or its contents without the
+prior written consent of DigiPen Institute of Technology is prohibited.
+ */
+/******************************************************************************/
+
+#include "SimPipeline.h"
+
+/******************************************************************************/
+/*!
+	Keep in step with PlatformWorld::StepFused. The per entity stages run a
+	block of rows at a time: state machine, then the IntegrateAndBound kernel
+	(previous position to bounding box), then grid collision and transform.
+	Object collision was one stage in the reference; it now only records
+	commands, and applying them is the stage after it.
+*/
+/******************************************************************************/
+const SimStage SIM_STAGES[] =
+{
+	//name					phase						ref	reads																	writes											fixupOf
+	{ "hero input",			SIM_PHASE_CROSS_ENTITY,		1,	SIM_DATA_INPUT | SIM_DATA_GRID_FLAG,									SIM_DATA_VEL,									SIM_STAGE_NONE },
+	{ "enemy state machine",SIM_PHASE_PER_ENTITY,		2,	SIM_DATA_POS | SIM_DATA_GRID_FLAG | SIM_DATA_AI | SIM_DATA_MAP | SIM_DATA_CHASE_TARGET,	SIM_DATA_VEL | SIM_DATA_AI,	SIM_STAGE_NONE },
+	{ "previous position",	SIM_PHASE_PER_ENTITY,		0,	SIM_DATA_POS,															SIM_DATA_POS_PREV,								SIM_STAGE_NONE },
+	{ "gravity",			SIM_PHASE_PER_ENTITY,		3,	SIM_DATA_VEL,															SIM_DATA_VEL,									SIM_STAGE_NONE },
+	{ "integration",		SIM_PHASE_PER_ENTITY,		4,	SIM_DATA_POS | SIM_DATA_VEL,											SIM_DATA_POS,									SIM_STAGE_NONE },
+	{ "bounding box",		SIM_PHASE_PER_ENTITY,		5,	SIM_DATA_POS | SIM_DATA_SCALE_DIR,										SIM_DATA_BOUNDS,								SIM_STAGE_NONE },
+	//swept grid collision also reads posPrev and refits the bounds
+	{ "grid collision",		SIM_PHASE_PER_ENTITY,		6,	SIM_DATA_POS | SIM_DATA_POS_PREV | SIM_DATA_SCALE_DIR | SIM_DATA_VISIBLE | SIM_DATA_MAP,	SIM_DATA_POS | SIM_DATA_VEL | SIM_DATA_BOUNDS | SIM_DATA_GRID_FLAG,	SIM_STAGE_NONE },
+	{ "transform",			SIM_PHASE_PER_ENTITY,		9,	SIM_DATA_POS | SIM_DATA_SCALE_DIR,										SIM_DATA_TRANSFORM,								SIM_STAGE_NONE },
+	{ "object collision",	SIM_PHASE_CROSS_ENTITY,		7,	SIM_DATA_BOUNDS | SIM_DATA_VEL,											SIM_DATA_COMMANDS,								SIM_STAGE_NONE },
+	//a respawn also ends every chase
+	{ "apply commands",		SIM_PHASE_CROSS_ENTITY,		8,	SIM_DATA_COMMANDS | SIM_DATA_HERO_LIVES | SIM_DATA_AI,					SIM_DATA_POS | SIM_DATA_POS_PREV | SIM_DATA_VEL | SIM_DATA_AI | SIM_DATA_HERO_LIVES | SIM_DATA_ROWS,	SIM_STAGE_NONE },
+	{ "transform fix-up",	SIM_PHASE_CROSS_ENTITY,		10,	SIM_DATA_POS | SIM_DATA_SCALE_DIR,										SIM_DATA_TRANSFORM,								7 },
+};
+
+const unsigned int SIM_STAGE_NUM = sizeof(SIM_STAGES) / sizeof(SIM_STAGES[0]);
+
+/******************************************************************************/
+/*!
+
+*/
+/******************************************************************************/
+bool ValidateSimPipeline(const char** ppError)
+{
+	const char* pError = 0;
+
+	for (unsigned int i = 0; i < SIM_STAGE_NUM && !pError; ++i)
+	{
+		const SimStage& a = SIM_STAGES[i];
+
+		//a fused stage can't publish anything another row could see
+		if (a.phase == SIM_PHASE_PER_ENTITY && (a.writes & SIM_DATA_SHARED_MASK))
+			pError = "per entity stage writes shared data";
+
+		for (unsigned int j = i + 1; j < SIM_STAGE_NUM && !pError; ++j)
+		{
+			const SimStage& b = SIM_STAGES[j];
+
+			//"a" runs first now, only a problem if it used to run after "b"
+			if (a.referenceOrder < b.referenceOrder)
+				continue;
+
+			bool conflict = (a.writes & b.reads) || (a.reads & b.writes) || (a.writes & b.writes);
+			if (!conflict)
+				continue;
+
+			//fine if a later stage redoes what "a" wrote
+			bool fixed = false;
+			for (unsigned int k = j + 1; k < SIM_STAGE_NUM; ++k)
+				if (SIM_STAGES[k].fixupOf == i && (SIM_STAGES[k].writes & a.writes) == a.writes)
+					fixed = true;
+
+			if (!fixed)
+				pError = "stage moved ahead of a stage it shares data with";
+		}
+	}
+
+	if (ppError)
+		*ppError = pError;
+	return pError == 0;
+}
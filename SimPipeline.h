@@ -0,0 +1,83 @@
+/******************************************************************************/
+/*!
+\file		SimPipeline.h
+\author 	DigiPen
+\par    	email: digipen\@digipen.edu
+\date   	February 01, 20xx
+\brief
+Description of the stages PlatformWorld::Step runs, in the order it runs
+them, with the data each one reads and writes. Per entity stages touch only
+their own row (plus shared read-only data such as the map) and are fused
+into a single loop. Cross entity stages keep a phase of their own.
+
+ValidateSimPipeline() checks the description against the original multi
+pass order: any stage that now runs before a stage it used to follow must
+not share data with it, unless a fix-up stage redoes its writes afterwards.
+
+Copyright (C) 20xx DigiPen Institute of Technology.
+Reproduction or disclosure of this file or its contents without the
+prior written consent of DigiPen Institute of Technology is prohibited.
+ */
+/******************************************************************************/
+
+#ifndef SIM_PIPELINE_H
+#define SIM_PIPELINE_H
+
+/******************************************************************************/
+/*!
+	Defines
+*/
+/******************************************************************************/
+//Per row columns
+const unsigned int	SIM_DATA_POS			= 0x00000001;
+const unsigned int	SIM_DATA_POS_PREV		= 0x00000002;
+const unsigned int	SIM_DATA_VEL			= 0x00000004;
+const unsigned int	SIM_DATA_SCALE_DIR		= 0x00000008;
+const unsigned int	SIM_DATA_BOUNDS			= 0x00000010;
+const unsigned int	SIM_DATA_GRID_FLAG		= 0x00000020;
+const unsigned int	SIM_DATA_AI				= 0x00000040;	//state, innerState, counter, targetX
+const unsigned int	SIM_DATA_TRANSFORM		= 0x00000080;
+const unsigned int	SIM_DATA_VISIBLE		= 0x00000100;	//instance flag
+const unsigned int	SIM_DATA_ROW_MASK		= 0x0000FFFF;
+
+//Shared data
+const unsigned int	SIM_DATA_MAP			= 0x00010000;
+const unsigned int	SIM_DATA_INPUT			= 0x00020000;
+const unsigned int	SIM_DATA_HERO_LIVES		= 0x00040000;
+const unsigned int	SIM_DATA_ROWS			= 0x00080000;	//creating/removing rows
+const unsigned int	SIM_DATA_COMMANDS		= 0x00100000;	//deferred commands, see CommandBuffer.h
+const unsigned int	SIM_DATA_CHASE_TARGET	= 0x00200000;	//hero position at the start of the step
+const unsigned int	SIM_DATA_SHARED_MASK	= 0xFFFF0000;
+
+const unsigned int	SIM_STAGE_NONE			= 0xFFFFFFFF;
+
+/******************************************************************************/
+/*!
+	Struct/Class Definitions
+*/
+/******************************************************************************/
+enum SIM_PHASE
+{
+	SIM_PHASE_PER_ENTITY,		//fused, one row at a time
+	SIM_PHASE_CROSS_ENTITY		//own phase, may read and write any row
+};
+
+struct SimStage
+{
+	const char*		name;
+	SIM_PHASE		phase;
+	unsigned int	referenceOrder;	//position in the original multi pass Step
+	unsigned int	reads;			//SIM_DATA_ bits
+	unsigned int	writes;			//SIM_DATA_ bits
+	unsigned int	fixupOf;		//stage index whose writes this one redoes, or SIM_STAGE_NONE
+};
+
+//Execution order of PlatformWorld::Step
+extern const SimStage		SIM_STAGES[];
+extern const unsigned int	SIM_STAGE_NUM;
+
+//Returns false and the reason in "ppError" if the fused order can give
+//different results from the reference order
+bool						ValidateSimPipeline(const char** ppError);
+
+#endif // SIM_PIPELINE_H
@@ -0,0 +1,424 @@
+/******************************************************************************/
+/*!
+\file		SpatialHash.cpp
+\author 	DigiPen
+\par    	email: digipen\@digipen.edu
+\date   	February 01, 20xx
+\brief
+Broad phase for object vs object collision. See SpatialHash.h.
+
+Copyright (C) 20xx DigiPen Institute of Technology.
+Reproduction or disclosure of this file or its contents without the
+prior written consent of DigiPen Institute of Technology is prohibited.
+ */
+/******************************************************************************/
+
+#include "SpatialHash.h"
+#include <algorithm>
+
+static unsigned int CellHash(int cellX, int cellY)
+{
+	return (unsigned int)cellX * 73856093u ^ (unsigned int)cellY * 19349663u;
+}
+
+static const unsigned int	NO_KEY = 0xFFFFFFFF;
+
+static bool Overlaps(const SimAABB& a, const SimAABB& b)
+{
+	return !(a.max.x < b.min.x || a.min.x > b.max.x ||
+			 a.max.y < b.min.y || a.min.y > b.max.y);
+}
+
+/******************************************************************************/
+/*!
+
+*/
+/******************************************************************************/
+SpatialHash::SpatialHash() :
+	BucketMask{ 0 }, CellMask{ 0 }, TrackedCount{ 0 }
+{
+}
+
+/******************************************************************************/
+/*!
+
+*/
+/******************************************************************************/
+void SpatialHash::Clear(void)
+{
+	Proxies.clear();
+	Entries.clear();
+	Large.clear();
+	IsLarge.clear();
+}
+
+/******************************************************************************/
+/*!
+
+*/
+/******************************************************************************/
+void SpatialHash::Insert(unsigned int type, unsigned int row, const SimAABB& box)
+{
+	unsigned int proxy = (unsigned int)Proxies.size();
+	Proxies.push_back({ type, row, box });
+
+	int x0 = SpatialCellOf(box.min.x), y0 = SpatialCellOf(box.min.y);
+	int x1 = SpatialCellOf(box.max.x), y1 = SpatialCellOf(box.max.y);
+	bool large = (unsigned long long)(x1 - x0 + 1) * (unsigned long long)(y1 - y0 + 1) > SPATIAL_HASH_CELLS_MAX;
+	IsLarge.push_back(large);
+	if (large) {
+		Large.push_back(proxy);
+		return;
+	}
+
+	for (int y = y0; y <= y1; ++y)
+		for (int x = x0; x <= x1; ++x)
+			Entries.push_back({ x, y, proxy });
+}
+
+/******************************************************************************/
+/*!
+
+*/
+/******************************************************************************/
+unsigned int SpatialHash::Bucket(int cellX, int cellY) const
+{
+	return CellHash(cellX, cellY) & BucketMask;
+}
+
+/******************************************************************************/
+/*!
+	Twice as many buckets as entries, so few unrelated cells share one;
+	a counting sort groups the entries by bucket, keeping insertion order
+*/
+/******************************************************************************/
+void SpatialHash::Build(LevelArena& scratch)
+{
+	unsigned int buckets = 16;
+	while (buckets < Entries.size() * 2)
+		buckets <<= 1;
+	BucketMask = buckets - 1;
+
+	BucketStart.assign(buckets + 1, 0);
+	for (const Entry& e : Entries)
+		++BucketStart[Bucket(e.cellX, e.cellY) + 1];
+	for (unsigned int b = 0; b < buckets; ++b)
+		BucketStart[b + 1] += BucketStart[b];
+
+	Scratch.resize(Entries.size());
+	ArenaScratch scope(scratch);
+	unsigned int *next = scratch.AllocateArray<unsigned int>(buckets);
+	std::copy(BucketStart.begin(), BucketStart.end() - 1, next);
+	for (const Entry& e : Entries)
+		Scratch[next[Bucket(e.cellX, e.cellY)]++] = e;
+	Entries.swap(Scratch);
+}
+
+/******************************************************************************/
+/*!
+
+*/
+/******************************************************************************/
+void SpatialHash::AddPair(unsigned int p, unsigned int q, unsigned int maskA, unsigned int maskB,
+						  std::vector<SpatialPair> *pPairs) const
+{
+	unsigned int typeP = SpatialTypeBit(Proxies[p].type), typeQ = SpatialTypeBit(Proxies[q].type);
+	bool pq = (typeP & maskA) && (typeQ & maskB);
+	bool qp = (typeQ & maskA) && (typeP & maskB);
+	if ((!pq && !qp) || !Overlaps(Proxies[p].box, Proxies[q].box))
+		return;
+
+	if (pq)
+		pPairs->push_back({ p, q });
+	if (qp)
+		pPairs->push_back({ q, p });
+}
+
+/******************************************************************************/
+/*!
+	Two overlapping boxes share several cells; the pair is only reported in
+	the cell holding the min corner of their overlap, which both cover
+*/
+/******************************************************************************/
+void SpatialHash::FindPairs(unsigned int maskA, unsigned int maskB, std::vector<SpatialPair> *pPairs) const
+{
+	pPairs->clear();
+
+	for (unsigned int b = 0; b + 1 < BucketStart.size(); ++b)
+		for (unsigned int i = BucketStart[b]; i < BucketStart[b + 1]; ++i)
+		{
+			const Entry& e = Entries[i];
+			for (unsigned int j = i + 1; j < BucketStart[b + 1]; ++j)
+			{
+				const Entry& f = Entries[j];
+				if (f.cellX != e.cellX || f.cellY != e.cellY)
+					continue;
+
+				const SimAABB& p = Proxies[e.proxy].box;
+				const SimAABB& q = Proxies[f.proxy].box;
+				if (SpatialCellOf(std::max(p.min.x, q.min.x)) != e.cellX ||
+					SpatialCellOf(std::max(p.min.y, q.min.y)) != e.cellY)
+					continue;
+				AddPair(e.proxy, f.proxy, maskA, maskB, pPairs);
+			}
+		}
+
+	// the large ones against everything, each pair of them once
+	for (unsigned int l = 0; l < Large.size(); ++l)
+		for (unsigned int q = 0; q < Proxies.size(); ++q)
+		{
+			if (q == Large[l] || (IsLarge[q] && q < Large[l]))
+				continue;
+			AddPair(Large[l], q, maskA, maskB, pPairs);
+		}
+
+	std::sort(pPairs->begin(), pPairs->end(), [](const SpatialPair& x, const SpatialPair& y) {
+		return x.a != y.a ? x.a < y.a : x.b < y.b;
+	});
+}
+
+/******************************************************************************/
+/*!
+	A box that fits in a cell is tracked in the cell of its min corner,
+	anything wider on the list everything is tested against. The same
+	cells SweptCells gives.
+*/
+/******************************************************************************/
+SpatialHash::TrackedCell SpatialHash::CellOfBox(const SimAABB& box)
+{
+	if (box.max.x - box.min.x > SPATIAL_HASH_CELL_SIZE || box.max.y - box.min.y > SPATIAL_HASH_CELL_SIZE)
+		return { TRACKED_LARGE, 0 };
+	return { SpatialCellOf(box.min.x), SpatialCellOf(box.min.y) };
+}
+
+/******************************************************************************/
+/*!
+
+*/
+/******************************************************************************/
+bool SpatialHash::IsTrackedAt(unsigned int key, const SimAABB& box) const
+{
+	const std::vector<TrackedCell>& cells = TrackedCells[SpatialKeyType(key)];
+	if (SpatialKeyId(key) >= cells.size())
+		return false;
+
+	TrackedCell at = CellOfBox(box);
+	return cells[SpatialKeyId(key)].x == at.x && cells[SpatialKeyId(key)].y == at.y;
+}
+
+/******************************************************************************/
+/*!
+	Ids past the end of the tracked ones aren't tracked anywhere
+*/
+/******************************************************************************/
+void SpatialHash::FindMoved(unsigned int type, unsigned int firstId, const int* cellX, const int* cellY,
+							unsigned int count, std::vector<unsigned int> *pIds) const
+{
+	const std::vector<TrackedCell>& cells = TrackedCells[type];
+	unsigned int tracked = firstId < cells.size() ? std::min(count, (unsigned int)cells.size() - firstId) : 0;
+	const TrackedCell* pCells = cells.data() + firstId;
+	unsigned int i;
+
+	for (i = 0; i < tracked; ++i)
+		if ((pCells[i].x != cellX[i]) | (pCells[i].y != cellY[i]))
+			pIds->push_back(firstId + i);
+	for (; i < count; ++i)
+		pIds->push_back(firstId + i);
+}
+
+/******************************************************************************/
+/*!
+	Makes room for "key", untracked if it is new
+*/
+/******************************************************************************/
+void SpatialHash::ReserveKey(unsigned int key)
+{
+	unsigned int type = SpatialKeyType(key), id = SpatialKeyId(key);
+	if (id < TrackedCells[type].size())
+		return;
+	TrackedCells[type].resize(id + 1, { TRACKED_NONE, 0 });
+	TrackedLinks[type].resize(id + 1, { NO_KEY, NO_KEY });
+}
+
+/******************************************************************************/
+/*!
+
+*/
+/******************************************************************************/
+void SpatialHash::LinkKey(unsigned int key)
+{
+	const TrackedCell& cell = GetCell(key);
+	TrackedLink& link = GetLink(key);
+	unsigned int& head = CellHeads[CellHash(cell.x, cell.y) & CellMask];
+	link.prev = NO_KEY;
+	link.next = head;
+	if (head != NO_KEY)
+		GetLink(head).prev = key;
+	head = key;
+}
+
+/******************************************************************************/
+/*!
+
+*/
+/******************************************************************************/
+void SpatialHash::UnlinkKey(unsigned int key)
+{
+	const TrackedCell& cell = GetCell(key);
+	const TrackedLink& link = GetLink(key);
+	if (link.prev != NO_KEY)
+		GetLink(link.prev).next = link.next;
+	else
+		CellHeads[CellHash(cell.x, cell.y) & CellMask] = link.next;
+	if (link.next != NO_KEY)
+		GetLink(link.next).prev = link.prev;
+}
+
+/******************************************************************************/
+/*!
+	Twice as many buckets as keys in cells, as Build sizes its table; every
+	chain is linked again
+*/
+/******************************************************************************/
+void SpatialHash::GrowCells(void)
+{
+	unsigned int buckets = CellHeads.empty() ? 16 : (unsigned int)CellHeads.size() * 2;
+	CellHeads.assign(buckets, NO_KEY);
+	CellMask = buckets - 1;
+
+	for (unsigned int type = 0; type < SPATIAL_HASH_TYPES_MAX; ++type)
+		for (unsigned int id = 0; id < TrackedCells[type].size(); ++id)
+			if (TrackedCells[type][id].x != TRACKED_NONE && TrackedCells[type][id].x != TRACKED_LARGE)
+				LinkKey(SpatialKey(type, id));
+}
+
+/******************************************************************************/
+/*!
+
+*/
+/******************************************************************************/
+void SpatialHash::Track(unsigned int key, const SimAABB& box)
+{
+	if (IsTrackedAt(key, box))
+		return;
+	ReserveKey(key);
+	Untrack(key);
+
+	// set after a grow, which links every key already in a cell
+	TrackedCell cell = CellOfBox(box);
+	if (cell.x == TRACKED_LARGE) {
+		GetCell(key) = cell;
+		TrackedLarge.push_back(key);
+		return;
+	}
+
+	if ((TrackedCount + 1) * 2 > CellHeads.size())
+		GrowCells();
+	GetCell(key) = cell;
+	LinkKey(key);
+	++TrackedCount;
+}
+
+/******************************************************************************/
+/*!
+
+*/
+/******************************************************************************/
+void SpatialHash::Untrack(unsigned int key)
+{
+	if (SpatialKeyId(key) >= TrackedCells[SpatialKeyType(key)].size())
+		return;
+
+	TrackedCell& cell = GetCell(key);
+	if (cell.x == TRACKED_LARGE) {
+		TrackedLarge.erase(std::find(TrackedLarge.begin(), TrackedLarge.end(), key));
+	}
+	else if (cell.x != TRACKED_NONE) {
+		UnlinkKey(key);
+		--TrackedCount;
+	}
+	cell.x = TRACKED_NONE;
+}
+
+/******************************************************************************/
+/*!
+	The chain around it is relinked to the new key, nothing moves
+*/
+/******************************************************************************/
+void SpatialHash::Renumber(unsigned int from, unsigned int to)
+{
+	if (SpatialKeyId(from) >= TrackedCells[SpatialKeyType(from)].size() || GetCell(from).x == TRACKED_NONE)
+		return;
+
+	ReserveKey(to);
+	TrackedCell& cell = GetCell(to);
+	const TrackedLink& link = GetLink(to);
+	cell = GetCell(from);
+	GetLink(to) = GetLink(from);
+	GetCell(from).x = TRACKED_NONE;
+
+	if (cell.x == TRACKED_LARGE) {
+		*std::find(TrackedLarge.begin(), TrackedLarge.end(), from) = to;
+		return;
+	}
+	if (link.prev != NO_KEY)
+		GetLink(link.prev).next = to;
+	else
+		CellHeads[CellHash(cell.x, cell.y) & CellMask] = to;
+	if (link.next != NO_KEY)
+		GetLink(link.next).prev = to;
+}
+
+/******************************************************************************/
+/*!
+	Keeps the bucket table's memory
+*/
+/******************************************************************************/
+void SpatialHash::ClearTracked(void)
+{
+	for (unsigned int type = 0; type < SPATIAL_HASH_TYPES_MAX; ++type)
+	{
+		TrackedCells[type].clear();
+		TrackedLinks[type].clear();
+	}
+	TrackedLarge.clear();
+	std::fill(CellHeads.begin(), CellHeads.end(), NO_KEY);
+	TrackedCount = 0;
+}
+
+/******************************************************************************/
+/*!
+	A tracked box is at most a cell wide, so any that touches "box" has its
+	min corner in the cells from one left of and below box's min corner to
+	its max corner. A query covering more cells than there are buckets
+	walks the keys instead.
+*/
+/******************************************************************************/
+void SpatialHash::Query(const SimAABB& box, std::vector<unsigned int> *pKeys) const
+{
+	pKeys->clear();
+
+	int x0 = SpatialCellOf(box.min.x - SPATIAL_HASH_CELL_SIZE), y0 = SpatialCellOf(box.min.y - SPATIAL_HASH_CELL_SIZE);
+	int x1 = SpatialCellOf(box.max.x), y1 = SpatialCellOf(box.max.y);
+	if ((unsigned long long)(x1 - x0 + 1) * (unsigned long long)(y1 - y0 + 1) > CellHeads.size()) {
+		for (unsigned int type = 0; type < SPATIAL_HASH_TYPES_MAX; ++type)
+			for (unsigned int id = 0; id < TrackedCells[type].size(); ++id)
+			{
+				const TrackedCell& cell = TrackedCells[type][id];
+				if (cell.x >= x0 && cell.x <= x1 && cell.y >= y0 && cell.y <= y1)
+					pKeys->push_back(SpatialKey(type, id));
+			}
+	}
+	else {
+		for (int y = y0; y <= y1; ++y)
+			for (int x = x0; x <= x1; ++x)
+				for (unsigned int key = CellHeads[CellHash(x, y) & CellMask]; key != NO_KEY; key = GetLink(key).next)
+				{
+					const TrackedCell& cell = TrackedCells[SpatialKeyType(key)][SpatialKeyId(key)];
+					if (cell.x == x && cell.y == y)
+						pKeys->push_back(key);
+				}
+	}
+
+	pKeys->insert(pKeys->end(), TrackedLarge.begin(), TrackedLarge.end());
+}
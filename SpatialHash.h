@@ -0,0 +1,187 @@
+/******************************************************************************/
+/*!
+\file		SpatialHash.h
+\author 	DigiPen
+\par    	email: digipen\@digipen.edu
+\date   	February 01, 20xx
+\brief
+Broad phase for object vs object collision. Every entity's box is
+bucketed into a uniform grid of SPATIAL_HASH_CELL_SIZE tile cells, hashed
+into a power of two bucket table that is rebuilt each tick with a counting
+sort. Only entities sharing a cell become candidate pairs, so the cost
+follows the number of entities instead of its square; the narrow phase
+stays CollisionIntersection_RectRect.
+It can also be kept from tick to tick: Track puts an entity in the cell of
+its box's min corner, FindMoved lists the ones whose corner changed cell
+so only those are moved, and Query visits just the cells around one box.
+That is what the hero's object collision stage uses, a single query
+doesn't pay for a rebuild or for a walk over every bucket.
+
+Copyright (C) 20xx DigiPen Institute of Technology.
+Reproduction or disclosure of this file or its contents without the
+prior written consent of DigiPen Institute of Technology is prohibited.
+ */
+/******************************************************************************/
+
+#ifndef SPATIAL_HASH_H
+#define SPATIAL_HASH_H
+
+#include "PlatformTypes.h"
+#include "LevelArena.h"
+#include <climits>
+#include <vector>
+
+/******************************************************************************/
+/*!
+	Defines
+*/
+/******************************************************************************/
+const int			SPATIAL_HASH_CELL_SIZE	= 2;	//Tiles per side of a cell, cell edges are on tile edges
+const unsigned int	SPATIAL_HASH_CELLS_MAX	= 16;	//Boxes covering more cells are tested against everything
+const unsigned int	SPATIAL_HASH_TYPES_MAX	= 8;	//TYPE_OBJECT values a tracked key can hold
+const float			SPATIAL_HASH_CELL_LIMIT	= 1 << 24;	//Cells are clamped to +-this, far outside any level
+const int			SPATIAL_HASH_LARGE_CELL	= INT_MIN + 1;	//Tracked cell x of a box wider than a cell
+
+//Bit of a TYPE_OBJECT in a type mask
+inline unsigned int SpatialTypeBit(unsigned int type)	{ return 1u << type; }
+
+//Key of a tracked entity: its type and an id, e.g. its row
+inline unsigned int SpatialKey(unsigned int type, unsigned int id)	{ return id * SPATIAL_HASH_TYPES_MAX + type; }
+inline unsigned int SpatialKeyType(unsigned int key)	{ return key % SPATIAL_HASH_TYPES_MAX; }
+inline unsigned int SpatialKeyId(unsigned int key)		{ return key / SPATIAL_HASH_TYPES_MAX; }
+
+/******************************************************************************/
+/*!
+	Cell of a coordinate. Rounds down without floorf, which is a library
+	call unless SSE4.1 is on; SweptCells (SimKernels.h) does the same float
+	operations 4 or 8 at a time. The clamp keeps the cell count of a box
+	from overflowing.
+*/
+/******************************************************************************/
+inline int SpatialCellOf(float coordinate)
+{
+	const float limit = SPATIAL_HASH_CELL_LIMIT;
+	float scaled = coordinate * (1.0f / SPATIAL_HASH_CELL_SIZE);
+	scaled = scaled < -limit ? -limit : scaled > limit ? limit : scaled;
+	int cell = (int)scaled;
+	return cell - (scaled < (float)cell);
+}
+
+/******************************************************************************/
+/*!
+	Struct/Class Definitions
+*/
+/******************************************************************************/
+struct SpatialProxy
+{
+	unsigned int	type;		// TYPE_OBJECT
+	unsigned int	row;		// row in the type's table
+	SimAABB			box;
+};
+
+//"a" matched the first mask of FindPairs, "b" the second
+struct SpatialPair
+{
+	unsigned int	a;			// index in GetProxies()
+	unsigned int	b;
+};
+
+class SpatialHash
+{
+public:
+	SpatialHash();
+
+	//Starts a new tick
+	void				Clear(void);
+	//"box" should already cover wherever the entity can be during the tick
+	void				Insert(unsigned int type, unsigned int row, const SimAABB& box);
+	//Buckets everything inserted since Clear, with temporaries from "scratch"
+	void				Build(LevelArena& scratch);
+
+	//Every pair of proxies whose boxes overlap (touching counts), "a" of a
+	//type in "maskA" and "b" of a type in "maskB". A pair that fits the
+	//masks both ways comes out both ways. Sorted by a, then b.
+	void				FindPairs(unsigned int maskA, unsigned int maskB, std::vector<SpatialPair> *pPairs) const;
+
+	const SpatialProxy&	GetProxy(unsigned int index) const	{ return Proxies[index]; }
+	unsigned int		GetProxyCount(void) const	{ return (unsigned int)Proxies.size(); }
+
+	//Tracked entities, kept until untracked and separate from the proxies
+	//above. Each is in the cell of its box's min corner, or tested against
+	//every query if its box is wider than a cell. True if "key" is tracked
+	//where "box" would put it.
+	bool				IsTrackedAt(unsigned int key, const SimAABB& box) const;
+	//Appends the ids from "firstId" on, of "type", that aren't tracked in
+	//the cells SweptCells gave for them. Read only, so a parallel pass can
+	//find what has to move.
+	void				FindMoved(unsigned int type, unsigned int firstId, const int* cellX, const int* cellY,
+								  unsigned int count, std::vector<unsigned int> *pIds) const;
+	//Tracks "key" where "box" puts it, moving it if it was elsewhere
+	void				Track(unsigned int key, const SimAABB& box);
+	void				Untrack(unsigned int key);
+	//What was tracked as "from" is now "to", which must not be tracked,
+	//e.g. the row a swap and pop moved
+	void				Renumber(unsigned int from, unsigned int to);
+	void				ClearTracked(void);
+	//Keys whose box can touch "box", each once, in no set order. Only the
+	//cells around it are visited; the boxes themselves aren't kept, the
+	//caller tests them.
+	void				Query(const SimAABB& box, std::vector<unsigned int> *pKeys) const;
+	//Every tracked key of "type" has an id below this
+	unsigned int		GetTrackedIdEnd(unsigned int type) const	{ return (unsigned int)TrackedCells[type].size(); }
+
+private:
+	struct Entry
+	{
+		int				cellX, cellY;
+		unsigned int	proxy;
+	};
+
+	//The cell of a tracked key, or one of these in x (SpatialCellOf never
+	//goes that low). A large one has 0 in y.
+	enum TRACKED_WHERE
+	{
+		TRACKED_NONE	= INT_MIN,
+		TRACKED_LARGE	= SPATIAL_HASH_LARGE_CELL
+	};
+
+	struct TrackedCell
+	{
+		int				x, y;
+	};
+
+	//Keys before and after one in its bucket's chain
+	struct TrackedLink
+	{
+		unsigned int	prev, next;
+	};
+
+	unsigned int		Bucket(int cellX, int cellY) const;
+	static TrackedCell	CellOfBox(const SimAABB& box);
+	TrackedCell&		GetCell(unsigned int key)	{ return TrackedCells[SpatialKeyType(key)][SpatialKeyId(key)]; }
+	TrackedLink&		GetLink(unsigned int key)	{ return TrackedLinks[SpatialKeyType(key)][SpatialKeyId(key)]; }
+	const TrackedLink&	GetLink(unsigned int key) const	{ return TrackedLinks[SpatialKeyType(key)][SpatialKeyId(key)]; }
+	void				ReserveKey(unsigned int key);
+	void				LinkKey(unsigned int key);
+	void				UnlinkKey(unsigned int key);
+	void				GrowCells(void);
+	void				AddPair(unsigned int p, unsigned int q, unsigned int maskA, unsigned int maskB,
+								std::vector<SpatialPair> *pPairs) const;
+
+	std::vector<SpatialProxy>	Proxies;
+	std::vector<Entry>			Entries;		// one per covered cell, grouped by bucket after Build
+	std::vector<Entry>			Scratch;
+	std::vector<unsigned int>	BucketStart;	// BucketCount + 1 offsets into Entries
+	std::vector<unsigned int>	Large;			// proxies over SPATIAL_HASH_CELLS_MAX cells
+	std::vector<bool>			IsLarge;		// per proxy
+	unsigned int				BucketMask;
+
+	std::vector<TrackedCell>	TrackedCells[SPATIAL_HASH_TYPES_MAX];	// per type, by id: all FindMoved reads
+	std::vector<TrackedLink>	TrackedLinks[SPATIAL_HASH_TYPES_MAX];
+	std::vector<unsigned int>	CellHeads;		// first key of each bucket
+	std::vector<unsigned int>	TrackedLarge;	// keys wider than a cell
+	unsigned int				CellMask;
+	unsigned int				TrackedCount;	// keys in cells
+};
+
+#endif // SPATIAL_HASH_H
@@ -0,0 +1,165 @@
+/******************************************************************************/
+/*!
+\file		TileBatch.cpp
+\author 	DigiPen
+\par    	email: digipen\@digipen.edu
+\date   	February 01, 20xx
+\brief
+Static geometry of the tile map. See TileBatch.h.
+
+Copyright (C) 20xx DigiPen Institute of Technology.
+Reproduction or disclosure of this file or its contents without the
+prior written consent of DigiPen Institute of Technology is prohibited.
+ */
+/******************************************************************************/
+
+#include "TileBatch.h"
+
+/******************************************************************************/
+/*!
+	Same winding as the old cell mesh
+*/
+/******************************************************************************/
+static void AddQuad(std::vector<TileVertex> *pVertices, float x0, float y0, float x1, float y1, unsigned int color)
+{
+	pVertices->push_back({ x0, y0, color });
+	pVertices->push_back({ x1, y0, color });
+	pVertices->push_back({ x0, y1, color });
+
+	pVertices->push_back({ x0, y1, color });
+	pVertices->push_back({ x1, y0, color });
+	pVertices->push_back({ x1, y1, color });
+}
+
+/******************************************************************************/
+/*!
+
+*/
+/******************************************************************************/
+unsigned int BuildTileBatch(const PlatformWorld& world, int X0, int Y0, int X1, int Y1,
+							std::vector<TileVertex> *pVertices)
+{
+	unsigned int quads = 0;
+
+	for (int y = Y0; y < Y1; ++y)
+	{
+		int runStart = X0;
+		int runValue = world.GetCellValue(X0, y);
+		for (int x = X0 + 1; x <= X1; ++x)
+		{
+			int value = x < X1 ? world.GetCellValue(x, y) : -1;
+			if (value == runValue)
+				continue;
+
+			AddQuad(pVertices, (float)runStart, (float)y, (float)x, (float)(y + 1),
+					runValue == TYPE_OBJECT_COLLISION ? TILE_COLOR_COLLISION : TILE_COLOR_EMPTY);
+			++quads;
+			runStart = x;
+			runValue = value;
+		}
+	}
+	return quads;
+}
+
+/******************************************************************************/
+/*!
+
+*/
+/******************************************************************************/
+TileBatchCache::TileBatchCache() :
+	Backend{ nullptr }, Frame{ 0 }, Stats{ 0, 0, 0, 0 }
+{
+}
+
+/******************************************************************************/
+/*!
+
+*/
+/******************************************************************************/
+TileBatchCache::~TileBatchCache()
+{
+	Clear();
+}
+
+/******************************************************************************/
+/*!
+	Chunks are clipped to the cells in memory; a chunk of a streamed level
+	is always resident as a whole, at the edges of a level it is cut short
+*/
+/******************************************************************************/
+void TileBatchCache::Draw(const PlatformWorld& world, int chunkX0, int chunkY0, int chunkX1, int chunkY1)
+{
+	int residentX0, residentY0, residentX1, residentY1;
+	unsigned int revision = world.GetMapRevision();
+
+	++Frame;
+	Stats.drawCalls		= 0;
+	Stats.chunksBuilt	= 0;
+	Stats.quadsDrawn	= 0;
+
+	if (!Backend)
+		return;
+
+	world.GetResidentBounds(&residentX0, &residentY0, &residentX1, &residentY1);
+	for (int cy = chunkY0; cy < chunkY1; ++cy)
+		for (int cx = chunkX0; cx < chunkX1; ++cx)
+		{
+			int x0 = cx * CHUNK_SIZE, y0 = cy * CHUNK_SIZE;
+			int x1 = x0 + CHUNK_SIZE, y1 = y0 + CHUNK_SIZE;
+			x0 = x0 < residentX0 ? residentX0 : x0;
+			y0 = y0 < residentY0 ? residentY0 : y0;
+			x1 = x1 > residentX1 ? residentX1 : x1;
+			y1 = y1 > residentY1 ? residentY1 : y1;
+			if (x0 >= x1 || y0 >= y1)
+				continue;
+
+			auto it = Entries.find(ChunkKey(cx, cy));
+			if (it == Entries.end() || it->second.revision != revision) {
+				if (it == Entries.end())
+					it = Entries.insert({ ChunkKey(cx, cy), Entry{ nullptr, 0, 0, 0 } }).first;
+				else if (it->second.mesh)
+					Backend->FreeMesh(it->second.mesh);
+
+				Scratch.clear();
+				it->second.quads	= BuildTileBatch(world, x0, y0, x1, y1, &Scratch);
+				it->second.mesh		= Scratch.empty() ? nullptr : Backend->CreateMesh(Scratch.data(), (unsigned int)Scratch.size());
+				it->second.revision	= revision;
+				++Stats.chunksBuilt;
+			}
+
+			it->second.lastFrame = Frame;
+			if (it->second.mesh) {
+				Backend->DrawMesh(it->second.mesh);
+				++Stats.drawCalls;
+				Stats.quadsDrawn += it->second.quads;
+			}
+		}
+
+	// meshes of chunks that haven't been on screen for a while
+	for (auto it = Entries.begin(); it != Entries.end(); )
+	{
+		if (Frame - it->second.lastFrame > TILE_BATCH_KEEP_FRAMES) {
+			if (it->second.mesh)
+				Backend->FreeMesh(it->second.mesh);
+			it = Entries.erase(it);
+		}
+		else {
+			++it;
+		}
+	}
+	Stats.chunksCached = (unsigned int)Entries.size();
+}
+
+/******************************************************************************/
+/*!
+
+*/
+/******************************************************************************/
+void TileBatchCache::Clear(void)
+{
+	for (auto& entry : Entries)
+		if (entry.second.mesh && Backend)
+			Backend->FreeMesh(entry.second.mesh);
+	Entries.clear();
+	Stats.chunksCached = 0;
+}
@@ -0,0 +1,105 @@
+/******************************************************************************/
+/*!
+\file		TileBatch.h
+\author 	DigiPen
+\par    	email: digipen\@digipen.edu
+\date   	February 01, 20xx
+\brief
+Static geometry of the tile map. Every CHUNK_SIZE x CHUNK_SIZE chunk of
+cells is merged into one triangle list in level coordinates, so a whole
+chunk draws with one call under the camera's MapTransform. Runs of equal
+cells along a row become a single quad. The meshes are cached and only
+rebuilt when the level changes; the renderer itself sits behind
+TileMeshBackend so building and counting can run without graphics.
+
+Copyright (C) 20xx DigiPen Institute of Technology.
+Reproduction or disclosure of this file or its contents without the
+prior written consent of DigiPen Institute of Technology is prohibited.
+ */
+/******************************************************************************/
+
+#ifndef TILE_BATCH_H
+#define TILE_BATCH_H
+
+#include "PlatformWorld.h"
+#include "RenderQueue.h"
+#include <unordered_map>
+#include <vector>
+
+/******************************************************************************/
+/*!
+	Defines
+*/
+/******************************************************************************/
+const unsigned int	TILE_COLOR_EMPTY		= 0xFF000000;	//Same colors as the old per cell meshes
+const unsigned int	TILE_COLOR_COLLISION	= 0xFFFFFFFF;
+const unsigned int	TILE_BATCH_KEEP_FRAMES	= 120;			//Frames a chunk's mesh is kept after it was last drawn
+
+/******************************************************************************/
+/*!
+	Struct/Class Definitions
+*/
+/******************************************************************************/
+//What the cache needs from the renderer
+class TileMeshBackend
+{
+public:
+	virtual ~TileMeshBackend() {}
+
+	//"vertices" is a triangle list, "count" a multiple of 3 and never 0
+	virtual void*		CreateMesh(const TileVertex *vertices, unsigned int count) = 0;
+	virtual void		FreeMesh(void *mesh) = 0;
+	virtual void		DrawMesh(void *mesh) = 0;
+};
+
+struct TileBatchStats
+{
+	unsigned int	drawCalls;		// last Draw
+	unsigned int	chunksBuilt;	// last Draw
+	unsigned int	quadsDrawn;		// last Draw
+	unsigned int	chunksCached;
+};
+
+class TileBatchCache
+{
+public:
+	TileBatchCache();
+	~TileBatchCache();
+
+	void				SetBackend(TileMeshBackend *pBackend)	{ Backend = pBackend; }
+
+	//Draws the chunks [chunkX0, chunkX1) x [chunkY0, chunkY1) that are in
+	//memory, building the ones missing or out of date. The caller sets the
+	//camera transform once before.
+	void				Draw(const PlatformWorld& world, int chunkX0, int chunkY0, int chunkX1, int chunkY1);
+	//Frees every mesh (call before the backend goes away)
+	void				Clear(void);
+
+	const TileBatchStats&	GetStats(void) const	{ return Stats; }
+
+private:
+	TileBatchCache(const TileBatchCache&) = delete;
+	TileBatchCache& operator=(const TileBatchCache&) = delete;
+
+	struct Entry
+	{
+		void			*mesh;			// nullptr for a chunk with no cells
+		unsigned int	revision;		// world map revision it was built from
+		unsigned int	lastFrame;
+		unsigned int	quads;
+	};
+
+	TileMeshBackend		*Backend;
+	std::unordered_map<long long, Entry>	Entries;
+	std::vector<TileVertex>	Scratch;
+	unsigned int		Frame;
+	TileBatchStats		Stats;
+};
+
+//Appends the quads of cells [X0, X1) x [Y0, Y1) of the world's map to
+//"pVertices", two triangles each, merging equal cells along rows. Returns
+//the number of quads.
+unsigned int			BuildTileBatch(const PlatformWorld& world, int X0, int Y0, int X1, int Y1,
+									   std::vector<TileVertex> *pVertices);
+
+#endif // TILE_BATCH_H
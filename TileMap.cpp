@@ -0,0 +1,254 @@
+/******************************************************************************/
+/*!
+\file		TileMap.cpp
+\author 	DigiPen
+\par    	email: digipen\@digipen.edu
+\date   	February 01, 20xx
+\brief
+Tile map of a level. See TileMap.h.
+
+Copyright (C) 20xx DigiPen Institute of Technology.
+Reproduction or disclosure of this file or its contents without the
+prior written consent of DigiPen Institute of Technology is prohibited.
+ */
+/******************************************************************************/
+
+#include "TileMap.h"
+#include "LevelArena.h"
+#include <cstdint>
+#include <cstring>
+
+//What an empty map's grid points at, so lookups before Create read 0
+//instead of needing a check
+static const unsigned int	sEmptyBits[1] = { 0 };
+
+/******************************************************************************/
+/*!
+
+*/
+/******************************************************************************/
+TileMap::TileMap() :
+	Memory{ nullptr }, ByteSize{ 0 }, OwnsMemory{ false },
+	Bits{ nullptr }, Types{ nullptr },
+	Grid{ sEmptyBits, 0, 0, 0, 0, 0 }, SolidBorder{ false }
+{
+}
+
+/******************************************************************************/
+/*!
+
+*/
+/******************************************************************************/
+TileMap::~TileMap()
+{
+	Destroy();
+}
+
+/******************************************************************************/
+/*!
+	Layout: (height + 2) bitmap rows of wordsPerRow 32 bit words, each row
+	holding the left border bit, width cells and the right border bit, then
+	the type layer. The bitmap is aligned to TILE_MAP_ALIGNMENT.
+*/
+/******************************************************************************/
+void TileMap::Create(int width, int height, bool solidBorder, LevelArena *pArena)
+{
+	Destroy();
+
+	int wordsPerRow		= TileMapWordsPerRow(width);
+	size_t bitBytes		= TileMapCollisionLayerSize(width, height);
+	size_t typeBytes	= (size_t)width * height;
+
+	if (pArena) {
+		ByteSize	= bitBytes + typeBytes;
+		Memory		= (unsigned char*)pArena->Allocate(ByteSize, TILE_MAP_ALIGNMENT);
+		OwnsMemory	= false;
+	}
+	else {
+		ByteSize	= bitBytes + typeBytes + TILE_MAP_ALIGNMENT - 1;
+		Memory		= new unsigned char[ByteSize];
+		OwnsMemory	= true;
+	}
+	uintptr_t aligned = ((uintptr_t)Memory + TILE_MAP_ALIGNMENT - 1) & ~(uintptr_t)(TILE_MAP_ALIGNMENT - 1);
+	Bits		= (unsigned int*)aligned;
+	Types		= (unsigned char*)aligned + bitBytes;
+	Grid		= CollisionGrid{ Bits, width, height, wordsPerRow, 0, 0 };
+	SolidBorder	= solidBorder;
+
+	Clear();
+}
+
+/******************************************************************************/
+/*!
+
+*/
+/******************************************************************************/
+void TileMap::Attach(const unsigned int *bits, const unsigned char *types, int width, int height)
+{
+	Destroy();
+
+	// never written through, SetCell and Clear check Memory
+	Bits		= const_cast<unsigned int*>(bits);
+	Types		= const_cast<unsigned char*>(types);
+	ByteSize	= TileMapCollisionLayerSize(width, height) + (size_t)width * height;
+	Grid		= CollisionGrid{ bits, width, height, TileMapWordsPerRow(width), 0, 0 };
+}
+
+/******************************************************************************/
+/*!
+	Empties every cell, the border keeps the value given to Create
+*/
+/******************************************************************************/
+void TileMap::Clear(void)
+{
+	if (!Memory)
+		return;
+
+	int width = Grid.width, height = Grid.height, rowBits = Grid.wordsPerRow * 32;
+	memset(Bits, 0, (size_t)Grid.wordsPerRow * (height + 2) * sizeof(unsigned int));
+	memset(Types, TYPE_OBJECT_EMPTY, (size_t)width * height);
+
+	if (SolidBorder) {
+		for (int X = 0; X < width + 2; ++X) {
+			int top = (height + 1) * rowBits + X;
+			Bits[X >> 5]	|= 1u << (X & 31);
+			Bits[top >> 5]	|= 1u << (top & 31);
+		}
+		for (int Y = 1; Y <= height; ++Y) {
+			int left = Y * rowBits, right = left + width + 1;
+			Bits[left >> 5]		|= 1u << (left & 31);
+			Bits[right >> 5]	|= 1u << (right & 31);
+		}
+	}
+}
+
+/******************************************************************************/
+/*!
+
+*/
+/******************************************************************************/
+void TileMap::Destroy(void)
+{
+	if (OwnsMemory)
+		delete[] Memory;
+
+	Memory		= nullptr;
+	ByteSize	= 0;
+	OwnsMemory	= false;
+	Bits		= nullptr;
+	Types		= nullptr;
+	Grid		= CollisionGrid{ sEmptyBits, 0, 0, 0, 0, 0 };
+	SolidBorder	= false;
+}
+
+/******************************************************************************/
+/*!
+	Moves the map over the level, the cells keep their contents
+*/
+/******************************************************************************/
+void TileMap::SetOrigin(int X, int Y)
+{
+	Grid.originX = X;
+	Grid.originY = Y;
+}
+
+/******************************************************************************/
+/*!
+	Stores the type and sets the collision bit for TYPE_OBJECT_COLLISION
+*/
+/******************************************************************************/
+void TileMap::SetCell(int X, int Y, unsigned char type)
+{
+	if (!Memory)
+		return;
+
+	X -= Grid.originX;
+	Y -= Grid.originY;
+	if (X < 0 || X >= Grid.width || Y < 0 || Y >= Grid.height)
+		return;
+
+	Types[Y * Grid.width + X] = type;
+
+	int bit = (Y + 1) * Grid.wordsPerRow * 32 + X + 1;
+	if (type == TYPE_OBJECT_COLLISION)
+		Bits[bit >> 5] |= 1u << (bit & 31);
+	else
+		Bits[bit >> 5] &= ~(1u << (bit & 31));
+}
+
+/******************************************************************************/
+/*!
+
+*/
+/******************************************************************************/
+unsigned char TileMap::GetType(int X, int Y) const
+{
+	X -= Grid.originX;
+	Y -= Grid.originY;
+	if (X < 0 || X >= Grid.width || Y < 0 || Y >= Grid.height)
+		return TYPE_OBJECT_EMPTY;
+	return Types[Y * Grid.width + X];
+}
+
+/******************************************************************************/
+/*!
+	Masks off the partial words at both ends, whole words in between
+*/
+/******************************************************************************/
+bool TileMap::RowSpanAny(int Y, int X0, int X1) const
+{
+	if (!Bits || X0 > X1)
+		return false;
+
+	X0 -= Grid.originX;
+	X1 -= Grid.originX;
+	Y -= Grid.originY;
+
+	X0 = X0 < -1 ? -1 : (X0 > Grid.width ? Grid.width : X0);
+	X1 = X1 < -1 ? -1 : (X1 > Grid.width ? Grid.width : X1);
+	Y = Y < -1 ? -1 : Y;
+	Y = Y > Grid.height ? Grid.height : Y;
+
+	const unsigned int* row = Bits + (Y + 1) * Grid.wordsPerRow;
+	int first = X0 + 1, last = X1 + 1;
+	int w0 = first >> 5, w1 = last >> 5;
+	unsigned int headMask = ~0u << (first & 31);
+	unsigned int tailMask = ~0u >> (31 - (last & 31));
+
+	if (w0 == w1)
+		return (row[w0] & headMask & tailMask) != 0;
+
+	if (row[w0] & headMask)
+		return true;
+	for (int w = w0 + 1; w < w1; ++w)
+		if (row[w])
+			return true;
+	return (row[w1] & tailMask) != 0;
+}
+
+/******************************************************************************/
+/*!
+	Column cells are a row apart, one word test per cell
+*/
+/******************************************************************************/
+bool TileMap::ColumnSpanAny(int X, int Y0, int Y1) const
+{
+	if (!Bits || Y0 > Y1)
+		return false;
+
+	Y0 -= Grid.originY;
+	Y1 -= Grid.originY;
+	X -= Grid.originX;
+
+	Y0 = Y0 < -1 ? -1 : (Y0 > Grid.height ? Grid.height : Y0);
+	Y1 = Y1 < -1 ? -1 : (Y1 > Grid.height ? Grid.height : Y1);
+	X = X < -1 ? -1 : X;
+	X = X > Grid.width ? Grid.width : X;
+
+	const unsigned int* word = Bits + (Y0 + 1) * Grid.wordsPerRow + ((X + 1) >> 5);
+	unsigned int mask = 1u << ((X + 1) & 31);
+	for (int Y = Y0; Y <= Y1; ++Y, word += Grid.wordsPerRow)
+		if (*word & mask)
+			return true;
+	return false;
+}
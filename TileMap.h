@@ -0,0 +1,115 @@
+/******************************************************************************/
+/*!
+\file		TileMap.h
+\author 	DigiPen
+\par    	email: digipen\@digipen.edu
+\date   	February 01, 20xx
+\brief
+Tile map of a level in a single aligned allocation: a collision bitmap with
+one bit per cell and a border of padding cells around the map, followed by
+an 8 bit layer holding each cell's TYPE_OBJECT. Collision lookups clamp into
+the border instead of bounds checking, and whole row or column spans can be
+tested a word at a time.
+All coordinates are level cells. A map normally covers the level from
+(0, 0); a streamed level keeps a window of it and moves the origin.
+
+Copyright (C) 20xx DigiPen Institute of Technology.
+Reproduction or disclosure of this file or its contents without the
+prior written consent of DigiPen Institute of Technology is prohibited.
+ */
+/******************************************************************************/
+
+#ifndef TILE_MAP_H
+#define TILE_MAP_H
+
+#include "SimKernels.h"
+#include <cstddef>
+
+class LevelArena;
+
+/******************************************************************************/
+/*!
+	Defines
+*/
+/******************************************************************************/
+const size_t		TILE_MAP_ALIGNMENT		= 64;	//Cache line
+
+//Layout of the collision layer: rows of 32 bit words, one row per level row
+//plus the top and bottom border rows
+inline int TileMapWordsPerRow(int width)
+{
+	return (width + 2 + 31) / 32;
+}
+
+inline size_t TileMapCollisionLayerSize(int width, int height)
+{
+	return (size_t)TileMapWordsPerRow(width) * (height + 2) * sizeof(unsigned int);
+}
+
+/******************************************************************************/
+/*!
+	Struct/Class Definitions
+*/
+/******************************************************************************/
+class TileMap
+{
+public:
+	TileMap();
+	~TileMap();
+
+	//Every cell starts empty. "solidBorder" sets the padding cells, i.e. what
+	//the collision queries see outside the map. With an arena the layers come
+	//from it and Destroy leaves them there, the arena's Reset frees them.
+	void				Create(int width, int height, bool solidBorder, LevelArena *pArena = nullptr);
+	//Uses layers laid out exactly as Create would (e.g. a memory mapped level
+	//file) without copying them. The map is then read only and "bits" and
+	//"types" must outlive it.
+	void				Attach(const unsigned int *bits, const unsigned char *types, int width, int height);
+	void				Destroy(void);
+	//Empties every cell
+	void				Clear(void);
+	//Level cell the map's (0, 0) corresponds to
+	void				SetOrigin(int X, int Y);
+	int					GetOriginX(void) const				{ return Grid.originX; }
+	int					GetOriginY(void) const				{ return Grid.originY; }
+
+	void				SetCell(int X, int Y, unsigned char type);
+	//Outside the map: TYPE_OBJECT_EMPTY
+	unsigned char		GetType(int X, int Y) const;
+	//1 for a collision cell, outside the map the border value. Safe to call
+	//on an empty map, which reads 0 everywhere
+	int					GetCollision(int X, int Y) const	{ return CollisionGridCell(Grid, X, Y); }
+
+	//True if any collision cell lies in row Y from X0 to X1, or in
+	//column X from Y0 to Y1 (inclusive, clamped into the border)
+	bool				RowSpanAny(int Y, int X0, int X1) const;
+	bool				ColumnSpanAny(int X, int Y0, int Y1) const;
+
+	int					GetWidth(void) const				{ return Grid.width; }
+	int					GetHeight(void) const				{ return Grid.height; }
+	bool				IsLoaded(void) const				{ return Bits != nullptr; }
+	const CollisionGrid&	GetCollisionGrid(void) const	{ return Grid; }
+	//Bytes held by the map, padding included
+	size_t				GetByteSize(void) const				{ return ByteSize; }
+
+	//Raw layers, for writing them out
+	const unsigned int*	GetCollisionLayer(void) const		{ return Bits; }
+	size_t				GetCollisionLayerSize(void) const	{ return TileMapCollisionLayerSize(Grid.width, Grid.height); }
+	const unsigned char*	GetTypeLayer(void) const		{ return Types; }
+	size_t				GetTypeLayerSize(void) const		{ return (size_t)Grid.width * Grid.height; }
+
+private:
+	TileMap(const TileMap&) = delete;
+	TileMap& operator=(const TileMap&) = delete;
+
+	unsigned char		*Memory;		// as allocated, Bits is this aligned up. nullptr when attached
+	size_t				ByteSize;
+	bool				OwnsMemory;		// false when Memory is in an arena
+
+	unsigned int		*Bits;			// collision bitmap, see CollisionGrid
+	unsigned char		*Types;			// width * height, row major, no border
+	CollisionGrid		Grid;
+	bool				SolidBorder;
+};
+
+#endif // TILE_MAP_H
@@ -0,0 +1,103 @@
+/******************************************************************************/
+/*!
+\file		InputReplay.cpp
+\author 	DigiPen
+\par    	email: digipen\@digipen.edu
+\date   	February 01, 20xx
+\brief
+Replays a recorded session (see InputLog.h) headless, as fast as the
+simulation runs, and checks every tick's state hash against the
+recording. The game saves its last session to
+../Resources/LastSession.input. Build it together with every source file
+of the simulation (all the .cpp files but GameState_Platform.cpp), no
+Alpha Engine needed:
+
+	InputReplay <log> [level] [workers] [--verify]
+
+"level" overrides the level file named in the log. "--verify" also runs
+the multi pass reference each tick (see PlatformWorld::SetPipelineVerify).
+Prints the tick count, the time taken and either "match" or the first
+tick that diverged; exits with 0, 1 if the replay diverged or 2 on error.
+
+Copyright (C) 20xx DigiPen Institute of Technology.
+Reproduction or disclosure of this file or its contents without the
+prior written consent of DigiPen Institute of Technology is prohibited.
+ */
+/******************************************************************************/
+
+#include "../PlatformWorld.h"
+#include "../InputLog.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+/******************************************************************************/
+/*!
+
+*/
+/******************************************************************************/
+int main(int argc, char** argv)
+{
+	const char *logName = nullptr, *levelName = nullptr;
+	unsigned int workers = 0;
+	bool verify = false, haveWorkers = false;
+
+	for (int i = 1; i < argc; ++i)
+	{
+		if (strcmp(argv[i], "--verify") == 0)
+			verify = true;
+		else if (!logName)
+			logName = argv[i];
+		else if (!levelName)
+			levelName = argv[i];
+		else if (!haveWorkers) {
+			workers = (unsigned int)atoi(argv[i]);
+			haveWorkers = true;
+		}
+	}
+	if (!logName) {
+		fprintf(stderr, "usage: InputReplay <log> [level] [workers] [--verify]\n");
+		return 2;
+	}
+
+	InputLog log;
+	const char *pError = nullptr;
+	if (!log.Load(logName, &pError)) {
+		fprintf(stderr, "%s: %s\n", logName, pError);
+		return 2;
+	}
+	if (!levelName)
+		levelName = log.GetLevelName().c_str();
+
+	PlatformWorld world;
+	int loaded = (log.GetFlags() & INPUT_LOG_FLAG_STREAMED) ? world.StreamMapFromFile(levelName)
+															: world.ImportMapDataFromFile(levelName);
+	if (!loaded) {
+		fprintf(stderr, "%s: can't load the level\n", levelName);
+		return 2;
+	}
+	world.SetWorkerCount(workers);
+	world.SetSweptCollision((log.GetFlags() & INPUT_LOG_FLAG_SWEPT) != 0);
+	world.SetPipelineVerify(verify);
+	world.Init();
+
+	unsigned int ticks;
+	auto start = std::chrono::steady_clock::now();
+	unsigned int diverged = world.Replay(log, &ticks);
+	double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+	printf("%u ticks in %.3f ms (%.1f us per tick)\n", ticks, ms, ticks ? ms * 1000.0 / ticks : 0.0);
+	if (verify)
+		printf("pipeline mismatches: %u\n", world.GetPipelineMismatchCount());
+	if (!log.HasHashes())
+		printf("no state hashes in the log, nothing checked\n");
+	else if (diverged != INPUT_LOG_NO_TICK)
+		printf("diverged at tick %u (checked every %u ticks)\n", diverged, log.GetHashInterval());
+	else
+		printf("match (checked every %u ticks)\n", log.GetHashInterval());
+
+	world.Free();
+	world.FreeMapData();
+	return diverged != INPUT_LOG_NO_TICK ? 1 : 0;
+}
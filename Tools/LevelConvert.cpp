@@ -0,0 +1,215 @@
+/******************************************************************************/
+/*!
+\file		LevelConvert.cpp
+\author 	DigiPen
+\par    	email: digipen\@digipen.edu
+\date   	February 01, 20xx
+\brief
+Converts an exported text level ("Width W Height H" followed by W * H cell
+types) into the binary level format of LevelFile.h, or writes the side index a
+streamed text level opens with (ChunkStreamer.h). Build it together with
+LevelFile.cpp, TileMap.cpp, LevelArena.cpp, MappedFile.cpp, ChunkStreamer.cpp
+and SimKernels.cpp:
+
+	LevelConvert <in.txt> <out.lvl>		convert
+	LevelConvert --verify <file.lvl>	check header, sections and checksum
+	LevelConvert --index <in.txt>		write <in.txt>.idx
+
+Unlike the game's old loader the text is parsed strictly: the header, the
+cell count and every cell type are checked, and nothing depends on the
+C++ locale.
+
+Copyright (C) 20xx DigiPen Institute of Technology.
+Reproduction or disclosure of this file or its contents without the
+prior written consent of DigiPen Institute of Technology is prohibited.
+ */
+/******************************************************************************/
+
+#include "../ChunkStreamer.h"
+#include "../LevelFile.h"
+#include "../PlatformTypes.h"
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+/******************************************************************************/
+/*!
+	Minimal tokenizer over the whole file
+*/
+/******************************************************************************/
+struct TextCursor
+{
+	const char		*p;
+	const char		*end;
+
+	void SkipSpace(void)
+	{
+		while (p < end && (*p == ' ' || *p == '\t' || *p == '\r' || *p == '\n'))
+			++p;
+	}
+
+	bool Word(const char *word)
+	{
+		size_t length = strlen(word);
+		SkipSpace();
+		if ((size_t)(end - p) < length || memcmp(p, word, length) != 0)
+			return false;
+		p += length;
+		return true;
+	}
+
+	bool Int(int *pValue)
+	{
+		long long value = 0;
+		bool negative = false;
+
+		SkipSpace();
+		if (p < end && *p == '-') {
+			negative = true;
+			++p;
+		}
+		if (p == end || *p < '0' || *p > '9')
+			return false;
+		while (p < end && *p >= '0' && *p <= '9') {
+			value = value * 10 + (*p++ - '0');
+			if (value > 0x7FFFFFFF)
+				return false;
+		}
+		*pValue = (int)(negative ? -value : value);
+		return true;
+	}
+};
+
+/******************************************************************************/
+/*!
+
+*/
+/******************************************************************************/
+static bool ReadWholeFile(const char *FileName, std::vector<char> *pData)
+{
+	FILE *file = fopen(FileName, "rb");
+	if (!file)
+		return false;
+
+	char buffer[65536];
+	size_t read;
+	while ((read = fread(buffer, 1, sizeof(buffer), file)) > 0)
+		pData->insert(pData->end(), buffer, buffer + read);
+
+	bool ok = !ferror(file);
+	fclose(file);
+	return ok;
+}
+
+/******************************************************************************/
+/*!
+
+*/
+/******************************************************************************/
+static int Convert(const char *inName, const char *outName)
+{
+	std::vector<char> text;
+	int width, height, value;
+
+	if (!ReadWholeFile(inName, &text)) {
+		fprintf(stderr, "%s: can't read\n", inName);
+		return 1;
+	}
+
+	TextCursor cursor{ text.data(), text.data() + text.size() };
+	if (!cursor.Word("Width") || !cursor.Int(&width) || !cursor.Word("Height") || !cursor.Int(&height) ||
+		width <= 0 || height <= 0) {
+		fprintf(stderr, "%s: bad header, expected \"Width W Height H\"\n", inName);
+		return 1;
+	}
+
+	std::vector<unsigned char> types((size_t)width * height);
+	for (int y = 0; y < height; ++y)
+		for (int x = 0; x < width; ++x)
+		{
+			if (!cursor.Int(&value)) {
+				fprintf(stderr, "%s: cell (%d, %d): missing or not a number\n", inName, x, y);
+				return 1;
+			}
+			if (value < TYPE_OBJECT_EMPTY || value > TYPE_OBJECT_COIN) {
+				fprintf(stderr, "%s: cell (%d, %d): unknown type %d\n", inName, x, y, value);
+				return 1;
+			}
+			types[(size_t)y * width + x] = (unsigned char)value;
+		}
+
+	cursor.SkipSpace();
+	if (cursor.p != cursor.end)
+		fprintf(stderr, "%s: warning: data after the last cell ignored\n", inName);
+
+	if (!WriteLevelFile(outName, types.data(), width, height)) {
+		fprintf(stderr, "%s: can't write\n", outName);
+		return 1;
+	}
+
+	LevelFile level;
+	const char *error = "";
+	if (!level.Open(outName, true, &error)) {
+		fprintf(stderr, "%s: written file doesn't check out: %s\n", outName, error);
+		return 1;
+	}
+
+	const LevelFileHeader& header = level.GetHeader();
+	printf("%s: %d x %d, %u spawns, %llu bytes\n", outName, header.width, header.height,
+		   header.spawnCount, (unsigned long long)header.fileSize);
+	return 0;
+}
+
+/******************************************************************************/
+/*!
+
+*/
+/******************************************************************************/
+static int Verify(const char *FileName)
+{
+	LevelFile level;
+	const char *error = "";
+
+	if (!level.Open(FileName, true, &error)) {
+		fprintf(stderr, "%s: %s\n", FileName, error);
+		return 1;
+	}
+	printf("%s: ok\n", FileName);
+	return 0;
+}
+
+/******************************************************************************/
+/*!
+	The index is only offsets: the cells are still checked when they are
+	streamed, Convert is the strict check
+*/
+/******************************************************************************/
+static int Index(const char *FileName)
+{
+	if (!TextChunkSource::WriteIndex(FileName)) {
+		fprintf(stderr, "%s: can't index, or can't write %s%s\n", FileName, FileName, TEXT_INDEX_EXTENSION);
+		return 1;
+	}
+	printf("%s%s: ok\n", FileName, TEXT_INDEX_EXTENSION);
+	return 0;
+}
+
+/******************************************************************************/
+/*!
+
+*/
+/******************************************************************************/
+int main(int argc, char** argv)
+{
+	if (argc == 3 && strcmp(argv[1], "--verify") == 0)
+		return Verify(argv[2]);
+	if (argc == 3 && strcmp(argv[1], "--index") == 0)
+		return Index(argv[2]);
+	if (argc == 3)
+		return Convert(argv[1], argv[2]);
+
+	fprintf(stderr, "usage: LevelConvert <in.txt> <out.lvl>\n"
+					"       LevelConvert --verify <file.lvl>\n"
+					"       LevelConvert --index <in.txt>\n");
+	return 2;
+}
@@ -0,0 +1,106 @@
+/******************************************************************************/
+/*!
+\file		ViewCulling.cpp
+\author 	DigiPen
+\par    	email: digipen\@digipen.edu
+\date   	February 01, 20xx
+\brief
+Camera rectangle culling. See ViewCulling.h.
+
+Copyright (C) 20xx DigiPen Institute of Technology.
+Reproduction or disclosure of this file or its contents without the
+prior written consent of DigiPen Institute of Technology is prohibited.
+ */
+/******************************************************************************/
+
+#include "ViewCulling.h"
+#include <cfloat>
+
+/******************************************************************************/
+/*!
+
+*/
+/******************************************************************************/
+ViewCuller::ViewCuller() :
+	View{ { -FLT_MAX, -FLT_MAX }, { FLT_MAX, FLT_MAX } }, Stats{ 0, 0, 0, 0 }
+{
+}
+
+/******************************************************************************/
+/*!
+	The four window corners go through the inverse, the view is their
+	bounding box (the camera may be rotated)
+*/
+/******************************************************************************/
+bool ViewCuller::Begin(const SimMtx33& mapTransform, float winMinX, float winMinY, float winMaxX, float winMaxY)
+{
+	SimMtx33 inverse;
+
+	Stats = { 0, 0, 0, 0 };
+	View = { { -FLT_MAX, -FLT_MAX }, { FLT_MAX, FLT_MAX } };
+	if (!SimMtx33Inverse(&inverse, &mapTransform))
+		return false;
+
+	const SimVec2 corners[4] = { { winMinX, winMinY }, { winMaxX, winMinY },
+								 { winMinX, winMaxY }, { winMaxX, winMaxY } };
+	for (int c = 0; c < 4; ++c)
+	{
+		SimVec2 p = SimMtx33MultPoint(&inverse, corners[c]);
+		if (c == 0) {
+			View.min = View.max = p;
+			continue;
+		}
+		View.min.x = p.x < View.min.x ? p.x : View.min.x;
+		View.min.y = p.y < View.min.y ? p.y : View.min.y;
+		View.max.x = p.x > View.max.x ? p.x : View.max.x;
+		View.max.y = p.y > View.max.y ? p.y : View.max.y;
+	}
+	return true;
+}
+
+/******************************************************************************/
+/*!
+	Cell i covers [i, i + 1), so the range is floor(min) to floor(max) + 1.
+	The view is clamped to the bounds in float first so an unbounded view
+	doesn't overflow the int conversion.
+*/
+/******************************************************************************/
+void ViewCuller::GetCellRange(int X0, int Y0, int X1, int Y1,
+							  int *pX0, int *pY0, int *pX1, int *pY1)
+{
+	float minX = View.min.x < (float)X0 ? (float)X0 : View.min.x;
+	float minY = View.min.y < (float)Y0 ? (float)Y0 : View.min.y;
+	float maxX = View.max.x > (float)X1 ? (float)X1 : View.max.x;
+	float maxY = View.max.y > (float)Y1 ? (float)Y1 : View.max.y;
+
+	*pX0 = *pX1 = X0;
+	*pY0 = *pY1 = Y0;
+	if (X0 < X1 && Y0 < Y1)
+		Stats.cellsInBounds += (unsigned int)(X1 - X0) * (unsigned int)(Y1 - Y0);
+	if (minX > maxX || minY > maxY || X0 >= X1 || Y0 >= Y1)
+		return;
+
+	int x0 = (int)floorf(minX), y0 = (int)floorf(minY);
+	int x1 = (int)floorf(maxX) + 1, y1 = (int)floorf(maxY) + 1;
+	*pX0 = x0;
+	*pY0 = y0;
+	*pX1 = x1 > X1 ? X1 : x1;
+	*pY1 = y1 > Y1 ? Y1 : y1;
+	Stats.cellsInView += (unsigned int)(*pX1 - *pX0) * (unsigned int)(*pY1 - *pY0);
+}
+
+/******************************************************************************/
+/*!
+
+*/
+/******************************************************************************/
+bool ViewCuller::IsVisible(const SimAABB& box)
+{
+	++Stats.instancesTested;
+	if (box.max.x < View.min.x || box.min.x > View.max.x ||
+		box.max.y < View.min.y || box.min.y > View.max.y) {
+		++Stats.instancesCulled;
+		return false;
+	}
+	return true;
+}
@@ -0,0 +1,66 @@
+/******************************************************************************/
+/*!
+\file		ViewCulling.h
+\author 	DigiPen
+\par    	email: digipen\@digipen.edu
+\date   	February 01, 20xx
+\brief
+Camera rectangle culling. The window is taken back into map coordinates
+through the inverse of the MapTransform once per frame; the tile loops
+get the range of cells under it and every instance is tested with its
+bounding box. Counts what was kept and what was culled.
+
+Copyright (C) 20xx DigiPen Institute of Technology.
+Reproduction or disclosure of this file or its contents without the
+prior written consent of DigiPen Institute of Technology is prohibited.
+ */
+/******************************************************************************/
+
+#ifndef VIEW_CULLING_H
+#define VIEW_CULLING_H
+
+#include "PlatformTypes.h"
+
+/******************************************************************************/
+/*!
+	Struct/Class Definitions
+*/
+/******************************************************************************/
+struct ViewCullStats
+{
+	unsigned int	cellsInBounds;		// cells the tile range was clipped to
+	unsigned int	cellsInView;
+	unsigned int	instancesTested;
+	unsigned int	instancesCulled;
+};
+
+class ViewCuller
+{
+public:
+	ViewCuller();
+
+	//Starts a frame. "mapTransform" takes map coordinates to the window,
+	//whose rectangle is [winMinX, winMaxX] x [winMinY, winMaxY]. If the
+	//transform can't be inverted nothing is culled and false is returned.
+	bool				Begin(const SimMtx33& mapTransform, float winMinX, float winMinY, float winMaxX, float winMaxY);
+
+	//The view in map coordinates
+	const SimAABB&		GetView(void) const		{ return View; }
+
+	//Cells [*pX0, *pX1) x [*pY0, *pY1) under the view, clipped to
+	//[X0, X1) x [Y0, Y1). The range is empty (*pX0 == *pX1) when the view is
+	//outside of them.
+	void				GetCellRange(int X0, int Y0, int X1, int Y1,
+									 int *pX0, int *pY0, int *pX1, int *pY1);
+
+	//True if "box" (map coordinates) overlaps the view
+	bool				IsVisible(const SimAABB& box);
+
+	const ViewCullStats&	GetStats(void) const	{ return Stats; }
+
+private:
+	SimAABB				View;
+	ViewCullStats		Stats;
+};
+
+#endif // VIEW_CULLING_H
@@ -0,0 +1,122 @@
+/******************************************************************************/
+/*!
+\file		WorldSnapshot.h
+\author 	DigiPen
+\par    	email: digipen\@digipen.edu
+\date   	February 01, 20xx
+\brief
+Saved simulation state of a PlatformWorld, as one flat block of bytes: the
+world's scalars, every table's live rows column by column with the part of
+its instance pool that has ever been used, and the level cells edited
+since the level was loaded. Saving and restoring copy only that much, so
+both cost what the live state does, not what the tables could hold.
+
+A SnapshotRing keeps the snapshots of the last few ticks for rollback,
+see RollbackSession.h.
+
+Copyright (C) 20xx DigiPen Institute of Technology.
+Reproduction or disclosure of this file or its contents without the
+prior written consent of DigiPen Institute of Technology is prohibited.
+ */
+/******************************************************************************/
+
+#ifndef WORLD_SNAPSHOT_H
+#define WORLD_SNAPSHOT_H
+
+#include <cstring>
+#include <vector>
+
+/******************************************************************************/
+/*!
+	Defines
+*/
+/******************************************************************************/
+const unsigned int	SNAPSHOT_NO_TICK		= 0xFFFFFFFF;
+
+/******************************************************************************/
+/*!
+	Struct/Class Definitions
+*/
+/******************************************************************************/
+struct WorldSnapshot
+{
+	std::vector<unsigned char>	data;		// see PlatformWorld::SaveSnapshot, empty if none
+	unsigned int				tick;		// whatever the owner counts, SNAPSHOT_NO_TICK if unused
+
+	WorldSnapshot() : tick{ SNAPSHOT_NO_TICK } {}
+};
+
+//Appends to a snapshot. Saving over an old snapshot reuses its memory.
+class SnapshotWriter
+{
+public:
+	explicit SnapshotWriter(std::vector<unsigned char>* pData) : Data{ pData } { Data->clear(); }
+
+	void				Write(const void* data, size_t size)
+	{
+		size_t at = Data->size();
+		Data->resize(at + size);
+		if (size)
+			memcpy(Data->data() + at, data, size);
+	}
+	template <typename T>
+	void				Write(const T& value)	{ Write(&value, sizeof(T)); }
+
+private:
+	std::vector<unsigned char>	*Data;
+};
+
+//Reads a snapshot back, every read fails once one ran past the end
+class SnapshotReader
+{
+public:
+	explicit SnapshotReader(const std::vector<unsigned char>& data) :
+		P{ data.data() }, End{ data.data() + data.size() } {}
+
+	bool				Read(void* data, size_t size)
+	{
+		if ((size_t)(End - P) < size) {
+			P = End + 1;
+			return false;
+		}
+		if (size)
+			memcpy(data, P, size);
+		P += size;
+		return true;
+	}
+	template <typename T>
+	bool				Read(T* pValue)			{ return Read(pValue, sizeof(T)); }
+	bool				IsValid(void) const		{ return P <= End; }
+
+private:
+	const unsigned char	*P;
+	const unsigned char	*End;
+};
+
+//The snapshots of the last "size" ticks, tick t in slot t % size
+class SnapshotRing
+{
+public:
+	void				Create(unsigned int size)	{ Slots.assign(size ? size : 1, WorldSnapshot()); }
+	void				Clear(void)					{ for (WorldSnapshot& s : Slots) s.tick = SNAPSHOT_NO_TICK; }
+	unsigned int		GetSize(void) const			{ return (unsigned int)Slots.size(); }
+
+	//The slot to save tick "tick" into, whatever it held is dropped
+	WorldSnapshot&		Push(unsigned int tick)
+	{
+		WorldSnapshot& slot = Slots[tick % Slots.size()];
+		slot.tick = tick;
+		return slot;
+	}
+	//nullptr once the tick has been overwritten
+	const WorldSnapshot*	Find(unsigned int tick) const
+	{
+		const WorldSnapshot& slot = Slots[tick % Slots.size()];
+		return slot.tick == tick ? &slot : nullptr;
+	}
+
+private:
+	std::vector<WorldSnapshot>	Slots;
+};
+
+#endif // WORLD_SNAPSHOT_H